@@ -0,0 +1,144 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <new>
+#include <atomic>
+#include <mutex>
+
+#include "AllocationTracker.h"
+#include "PerfHud.h"
+
+#ifdef ALLOCATION_TRACKER
+#include <execinfo.h>
+
+//Call site, identified by its return addresses
+struct ALLOCATIONSITE
+{
+	void *address[ALLOCATION_SITE_DEPTH];
+	int depth;	//0 if this site's unused
+	uint32_t hash;
+	uint32_t frameAllocations;
+};
+
+static ALLOCATIONSITE allocationSite[ALLOCATION_SITES];
+static std::mutex siteMutex;
+static std::atomic<uint32_t> frameAllocations(0);
+static thread_local bool tracking = false;	//Set while an allocation's being tracked, so anything backtrace allocates isn't
+
+//Allocation tracking, inlined into operator new so we know how many of its return addresses to skip
+static inline __attribute__((always_inline)) void TrackAllocation()
+{
+	frameAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (tracking)
+		return;
+	tracking = true;
+	
+	//Get our call site (skipping operator new itself) and hash it
+	void *address[ALLOCATION_SITE_DEPTH + 1];
+	int depth = backtrace(address, ALLOCATION_SITE_DEPTH + 1) - 1;
+	
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < depth; i++)
+	{
+		uintptr_t value = (uintptr_t)address[i + 1];
+		for (size_t v = 0; v < sizeof(value); v++)
+			hash = (hash ^ (uint8_t)(value >> (v * 8))) * 16777619u;
+	}
+	
+	//Count this allocation at its site, taking an unused one if it's new
+	if (depth > 0)
+	{
+		std::lock_guard<std::mutex> lock(siteMutex);
+		
+		for (uint32_t i = 0; i < ALLOCATION_SITES; i++)
+		{
+			ALLOCATIONSITE *site = &allocationSite[(hash + i) & (ALLOCATION_SITES - 1)];
+			if (site->depth == 0)
+			{
+				memcpy(site->address, address + 1, depth * sizeof(void*));
+				site->depth = depth;
+				site->hash = hash;
+			}
+			else if (site->hash != hash || site->depth != depth || memcmp(site->address, address + 1, depth * sizeof(void*)) != 0)
+			{
+				continue;
+			}
+			
+			site->frameAllocations++;
+			break;
+		}
+	}
+	
+	tracking = false;
+}
+#endif
+
+#if defined(ALLOCATION_TRACKER) || defined(PERF_HUD)
+//Allocation counting (array and nothrow allocations go through these too)
+void *operator new(size_t size)
+{
+	PERF_COUNT(allocations);
+	#ifdef ALLOCATION_TRACKER
+		TrackAllocation();
+	#endif
+	
+	void *pointer = malloc((size != 0) ? size : 1);
+	if (pointer == nullptr)
+		throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+	free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept
+{
+	(void)size;
+	free(pointer);
+}
+#endif
+
+//Allocation tracker functions
+uint32_t EndAllocationFrame(const char *frameName, unsigned int frame)
+{
+	#ifdef ALLOCATION_TRACKER
+		//Take this frame's allocations
+		uint32_t allocations = frameAllocations.exchange(0, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(siteMutex);
+		
+		//Print the call sites with the most allocations this frame (backtrace_symbols uses malloc, so this isn't tracked)
+		if (allocations != 0 && frameName != nullptr)
+		{
+			printf("%s %u made %u allocations\n", frameName, frame, allocations);
+			
+			for (int i = 0; i < ALLOCATION_SITES_LOGGED; i++)
+			{
+				ALLOCATIONSITE *most = nullptr;
+				for (uint32_t v = 0; v < ALLOCATION_SITES; v++)
+					if (allocationSite[v].frameAllocations != 0 && (most == nullptr || allocationSite[v].frameAllocations > most->frameAllocations))
+						most = &allocationSite[v];
+				if (most == nullptr)
+					break;
+				
+				printf("%u from:\n", most->frameAllocations);
+				char **symbol = backtrace_symbols(most->address, most->depth);
+				for (int v = 0; v < most->depth; v++)
+					printf("\t%s\n", (symbol != nullptr) ? symbol[v] : "?");
+				free(symbol);
+				
+				most->frameAllocations = 0;
+			}
+		}
+		
+		//Start counting our next frame
+		for (uint32_t i = 0; i < ALLOCATION_SITES; i++)
+			allocationSite[i].frameAllocations = 0;
+		return allocations;
+	#else
+		(void)frameName;
+		(void)frame;
+		return 0;
+	#endif
+}
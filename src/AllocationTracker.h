@@ -0,0 +1,14 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//Allocation tracker, counts heap allocations (operator new) by frame and by call site, steady-state gameplay frames shouldn't allocate at all
+//#define ALLOCATION_TRACKER	//When set, each frame's allocations are counted with their call sites, and a frame that allocates logs them (Linux and macOS only, addresses can be resolved with addr2line -f -C -e <executable>)
+
+//Constants
+#define ALLOCATION_SITES		0x400	//Call sites kept (power of two, allocations from any more are counted without a site)
+#define ALLOCATION_SITE_DEPTH	6		//Return addresses kept for each call site (starting from operator new's caller)
+#define ALLOCATION_SITES_LOGGED	16		//Most call sites logged for a frame
+
+//Allocation tracker functions
+uint32_t EndAllocationFrame(const char *frameName, unsigned int frame);	//Returns how many allocations were made since the last call, and logs their call sites if there were any (frameName is nullptr to not log)
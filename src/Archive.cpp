@@ -0,0 +1,119 @@
+#include <string.h>
+
+#include "Archive.h"
+#include "Filesystem.h"
+#include "Log.h"
+
+//Mounted archive
+ARCHIVE *gArchive = nullptr;
+
+//Archive class
+ARCHIVE::ARCHIVE(std::string path)
+{
+	//Open our archive (this is memory mapped, and stays mapped for as long as we're mounted)
+	file = new FS_FILE(path, "rb");
+	if (file->fail != nullptr)
+	{
+		fail = file->fail;
+		return;
+	}
+	
+	dataSize = file->GetSize();
+	data = file->GetSpan(dataSize);
+	file->Seek(0, SEEK_SET);
+	
+	//Read our header
+	if (dataSize < ARCHIVE_HEADER_SIZE || file->ReadBE32() != ARCHIVE_SIGNATURE)
+	{
+		fail = "Archive has an invalid signature";
+		return;
+	}
+	if (file->ReadBE32() != ARCHIVE_VERSION)
+	{
+		fail = "Archive is an unsupported version";
+		return;
+	}
+	
+	entries = file->ReadBE32();
+	file->ReadBE32(); //RESERVED
+	
+	//Read our index
+	if (entries > (dataSize - ARCHIVE_HEADER_SIZE) / ARCHIVE_ENTRY_SIZE)
+	{
+		fail = "Archive index is cut off";
+		return;
+	}
+	
+	entry = new ARCHIVEENTRY[entries];
+	for (size_t i = 0; i < entries; i++)
+	{
+		entry[i].hash = file->ReadBE64();
+		entry[i].offset = file->ReadBE64();
+		entry[i].size = file->ReadBE32();
+		entry[i].storedSize = file->ReadBE32();
+		entry[i].flags = file->ReadBE32();
+		entry[i].name = file->ReadBE32();
+		
+		if (entry[i].offset > dataSize || entry[i].storedSize > dataSize - entry[i].offset)
+		{
+			fail = "Archive entry is out of bounds";
+			return;
+		}
+		if (!(entry[i].flags & ARCHIVEFLAG_LZ4) && entry[i].size != entry[i].storedSize)
+		{
+			fail = "Uncompressed archive entry's size doesn't match its stored size";
+			return;
+		}
+		if (i != 0 && entry[i].hash < entry[i - 1].hash)
+		{
+			fail = "Archive index isn't sorted";
+			return;
+		}
+	}
+	
+	//Our name table follows the index
+	names = (const char*)(data + file->Tell());
+	namesSize = dataSize - file->Tell();
+	
+	//Get where each bucket starts (entries are sorted by hash, so each bucket is a run of entries)
+	size_t thisEntry = 0;
+	for (size_t i = 0; i <= (1 << ARCHIVE_BUCKET_BITS); i++)
+	{
+		while (thisEntry < entries && (entry[thisEntry].hash >> (64 - ARCHIVE_BUCKET_BITS)) < i)
+			thisEntry++;
+		bucket[i] = (uint32_t)thisEntry;
+	}
+}
+
+ARCHIVE::~ARCHIVE()
+{
+	//Free our index and unmap our archive
+	delete[] entry;
+	delete file;
+}
+
+const ARCHIVEENTRY *ARCHIVE::Find(const char *path)
+{
+	//Check every entry in our path's bucket
+	uint64_t hash = GetArchiveHash(path);
+	size_t thisBucket = (size_t)(hash >> (64 - ARCHIVE_BUCKET_BITS));
+	
+	for (size_t i = bucket[thisBucket]; i < bucket[thisBucket + 1]; i++)
+	{
+		if (entry[i].hash != hash || entry[i].name >= namesSize)
+			continue;
+		
+		//Make sure it's actually our path, and not a hash collision
+		const char *name = names + entry[i].name;
+		const char *check = path;
+		while (*name != '\0' && (*check == '\\' ? '/' : *check) == *name)
+		{
+			name++;
+			check++;
+		}
+		if (*name == '\0' && *check == '\0')
+			return &entry[i];
+	}
+	
+	return nullptr;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+//Declare the file class
+class FS_FILE;
+
+//Archive format (big endian)
+//Header: "CSAR", version, entry count, reserved (4 bytes each)
+//Index: an entry for every file, sorted by path hash (see ARCHIVEENTRY, 32 bytes each)
+//Names: every entry's path relative to the base path, null terminated (so hash collisions can be told apart)
+//Data: every entry's data, aligned to ARCHIVE_ALIGNMENT bytes from the start of the archive
+#define ARCHIVE_NAME		"data.arc"	//Archive mounted from the base path
+#define ARCHIVE_SIGNATURE	0x43534152	//"CSAR"
+#define ARCHIVE_VERSION		1
+#define ARCHIVE_HEADER_SIZE	0x10
+#define ARCHIVE_ENTRY_SIZE	0x20
+#define ARCHIVE_ALIGNMENT	64
+
+#define ARCHIVE_BUCKET_BITS	12	//Bits of the hash used to index our buckets (entries whose hashes start the same), so lookups don't have to search the whole index
+
+enum ARCHIVEFLAG
+{
+	ARCHIVEFLAG_LZ4 = 1 << 0,	//Entry is stored as an LZ4 block
+};
+
+struct ARCHIVEENTRY
+{
+	uint64_t hash;			//Hash of the entry's path (see GetArchiveHash)
+	uint64_t offset;		//Offset of the entry's data from the start of the archive
+	uint32_t size;			//Size of the entry's data once decompressed
+	uint32_t storedSize;	//Size of the entry's data in the archive
+	uint32_t flags;
+	uint32_t name;			//Offset of the entry's path in the name table
+};
+
+//Path hash (FNV-1a, with backslashes treated as forward slashes)
+inline uint64_t GetArchiveHash(const char *path)
+{
+	uint64_t hash = 0xCBF29CE484222325;
+	for (; *path != '\0'; path++)
+		hash = (hash ^ (uint8_t)((*path == '\\') ? '/' : *path)) * 0x100000001B3;
+	return hash;
+}
+
+//Archive class
+class ARCHIVE
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Mapped archive
+		FS_FILE *file = nullptr;
+		const uint8_t *data = nullptr;
+		size_t dataSize = 0;
+		
+		//Index
+		ARCHIVEENTRY *entry = nullptr;
+		size_t entries = 0;
+		const char *names = nullptr;
+		size_t namesSize = 0;
+		uint32_t bucket[(1 << ARCHIVE_BUCKET_BITS) + 1];	//First entry of each bucket
+	
+	public:
+		ARCHIVE(std::string path);
+		~ARCHIVE();
+		
+		const ARCHIVEENTRY *Find(const char *path);
+};
+
+//Mounted archive (nullptr if none)
+extern ARCHIVE *gArchive;
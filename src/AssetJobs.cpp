@@ -0,0 +1,210 @@
+#include "AssetJobs.h"
+#include "Engine.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "MathUtil.h"
+
+//Amount of worker threads to decode level assets with
+unsigned int gAssetJobThreads = ASSETJOBS_DEFAULT_THREADS;
+
+//Constructor and destructor
+ASSETJOBS::ASSETJOBS(size_t workerThreads)
+{
+	//Start our worker threads (there's no point in having more than the hardware can run)
+	size_t hardwareThreads = std::thread::hardware_concurrency();
+	threads = mmin(workerThreads, (size_t)ASSETJOBS_MAX_THREADS);
+	if (hardwareThreads != 0)
+		threads = mmin(threads, hardwareThreads);
+	
+	thread = new std::thread[threads];
+	for (size_t i = 0; i < threads; i++)
+		thread[i] = std::thread(&ASSETJOBS::Worker, this);
+	
+	LOG(("Started %d asset job threads\n", (int)threads));
+}
+
+ASSETJOBS::~ASSETJOBS()
+{
+	//Stop our worker threads (any job that's been started is finished first)
+	mutex.lock();
+	quit = true;
+	mutex.unlock();
+	startCondition.notify_all();
+	
+	for (size_t i = 0; i < threads; i++)
+		thread[i].join();
+	delete[] thread;
+	
+	//Free our jobs, and any assets that were never taken
+	for (size_t i = 0; i < jobs; i++)
+	{
+		if (!job[i]->taken)
+		{
+			if (job[i]->type == ASSETJOB_TEXTURE)
+				delete job[i]->texture;
+			else
+				delete job[i]->mappings;
+		}
+		delete job[i];
+	}
+	delete[] job;
+}
+
+//Worker thread
+void ASSETJOBS::Worker()
+{
+	PROFILE_THREAD("Asset jobs");
+	
+	while (1)
+	{
+		//Wait for a job to start
+		ASSETJOB *decodeJob;
+		
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (1)
+			{
+				//Skip jobs the main thread has started itself
+				while (nextJob < jobs && job[nextJob]->started)
+					nextJob++;
+				if (quit || nextJob < jobs)
+					break;
+				startCondition.wait(lock);
+			}
+			if (quit)
+				return;
+			
+			decodeJob = job[nextJob++];
+			decodeJob->started = true;
+		}
+		
+		//Decode our asset
+		Decode(decodeJob);
+	}
+}
+
+void ASSETJOBS::Decode(ASSETJOB *decodeJob)
+{
+	//Decode our asset (nothing else touches this job until it's done)
+	if (decodeJob->type == ASSETJOB_TEXTURE)
+		decodeJob->texture = new TEXTURE(decodeJob->path);
+	else
+		decodeJob->mappings = new MAPPINGS(decodeJob->path);
+	
+	//Publish it to whoever's waiting for it
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		decodeJob->done = true;
+	}
+	doneCondition.notify_all();
+}
+
+//Queueing
+ASSETJOB *ASSETJOBS::Queue(ASSETJOB_TYPE type, std::string path)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	
+	//If this asset has already been queued, just use that job
+	for (size_t i = 0; i < jobs; i++)
+		if (job[i]->type == type && job[i]->path == path)
+			return job[i];
+	
+	//Grow our job array if full
+	if (jobs >= jobCapacity)
+	{
+		size_t newCapacity = mmax(jobCapacity * 2, (size_t)0x20);
+		ASSETJOB **newJob = new ASSETJOB*[newCapacity];
+		for (size_t i = 0; i < jobs; i++)
+			newJob[i] = job[i];
+		delete[] job;
+		job = newJob;
+		jobCapacity = newCapacity;
+	}
+	
+	//Create our job and wake a worker for it
+	ASSETJOB *newJob = new ASSETJOB;
+	newJob->type = type;
+	newJob->path = path;
+	job[jobs++] = newJob;
+	
+	lock.unlock();
+	startCondition.notify_one();
+	return newJob;
+}
+
+//Waiting
+ASSETJOB *ASSETJOBS::Wait(ASSETJOB_TYPE type, std::string path)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	
+	//Find this asset's job
+	ASSETJOB *waitJob = nullptr;
+	for (size_t i = 0; i < jobs; i++)
+	{
+		if (job[i]->type == type && job[i]->path == path && !job[i]->taken)
+		{
+			waitJob = job[i];
+			break;
+		}
+	}
+	
+	if (waitJob == nullptr)
+		return nullptr;
+	
+	//If it hasn't been started, decode it ourselves rather than waiting for a worker to get to it
+	if (!waitJob->started)
+	{
+		waitJob->started = true;
+		lock.unlock();
+		Decode(waitJob);
+		lock.lock();
+	}
+	
+	//Wait for it to be done, then take it
+	while (!waitJob->done)
+		doneCondition.wait(lock);
+	waitJob->taken = true;
+	return waitJob;
+}
+
+TEXTURE *ASSETJOBS::TakeTexture(std::string path)
+{
+	ASSETJOB *waitJob = Wait(ASSETJOB_TEXTURE, path);
+	return (waitJob != nullptr) ? waitJob->texture : nullptr;
+}
+
+MAPPINGS *ASSETJOBS::TakeMappings(std::string path)
+{
+	ASSETJOB *waitJob = Wait(ASSETJOB_MAPPINGS, path);
+	return (waitJob != nullptr) ? waitJob->mappings : nullptr;
+}
+
+void ASSETJOBS::Finish(LINKEDLIST<TEXTURE*> *textureCache, LINKEDLIST<MAPPINGS*> *mappingsCache)
+{
+	//Take every job's asset (in queue order, so our caches are always in the same order) and publish the ones that weren't already taken
+	for (size_t i = 0; i < jobs; i++)
+	{
+		if (job[i]->taken)
+			continue;
+		
+		if (job[i]->type == ASSETJOB_TEXTURE)
+			textureCache->link_back(TakeTexture(job[i]->path));
+		else
+			mappingsCache->link_back(TakeMappings(job[i]->path));
+	}
+}
+
+//Asset functions
+TEXTURE *TakeTexture(std::string path)
+{
+	//Take our texture from the job system, or decode it ourselves if it was never queued
+	TEXTURE *texture = (gEngine->assetJobs != nullptr) ? gEngine->assetJobs->TakeTexture(path) : nullptr;
+	return (texture != nullptr) ? texture : new TEXTURE(path);
+}
+
+MAPPINGS *TakeMappings(std::string path)
+{
+	//Take our mappings from the job system, or decode them ourselves if they were never queued
+	MAPPINGS *mappings = (gEngine->assetJobs != nullptr) ? gEngine->assetJobs->TakeMappings(path) : nullptr;
+	return (mappings != nullptr) ? mappings : new MAPPINGS(path);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "LinkedList.h"
+#include "Render.h"
+#include "Mappings.h"
+
+//Constants
+#define ASSETJOBS_MAX_THREADS		8
+#define ASSETJOBS_DEFAULT_THREADS	4	//Worker threads used for level loads by default (limited to the hardware's thread count)
+
+//Asset job types
+enum ASSETJOB_TYPE
+{
+	ASSETJOB_TEXTURE,
+	ASSETJOB_MAPPINGS,
+};
+
+//Asset job, a texture or mappings file being decoded on a worker thread
+struct ASSETJOB
+{
+	ASSETJOB_TYPE type;
+	std::string path;
+	
+	bool started = false;	//Picked up by a thread
+	bool done = false;		//Decoded, asset can be used
+	bool taken = false;		//Handed to its owner, no longer ours to free
+	
+	union
+	{
+		TEXTURE *texture;
+		MAPPINGS *mappings;
+	};
+};
+
+//Asset job system, decodes the textures and mappings a level needs in parallel while the rest of the level loads
+class ASSETJOBS
+{
+	public:
+		//Worker threads (the main thread also decodes queued jobs while waiting for one)
+		size_t threads = 0;
+		std::thread *thread = nullptr;
+		
+		std::mutex mutex;
+		std::condition_variable startCondition, doneCondition;
+		bool quit = false;
+		
+		//Queued jobs, in the order they were queued (workers start them in this order, skipping any the main thread has started)
+		ASSETJOB **job = nullptr;
+		size_t jobs = 0, jobCapacity = 0;
+		size_t nextJob = 0;
+	
+	public:
+		ASSETJOBS(size_t workerThreads);
+		~ASSETJOBS();
+		
+		//Queueing, returns the already queued job if this asset has been queued before
+		ASSETJOB *Queue(ASSETJOB_TYPE type, std::string path);
+		
+		//Waiting, takes ownership of the job's asset, returns nullptr if the asset was never queued
+		TEXTURE *TakeTexture(std::string path);
+		MAPPINGS *TakeMappings(std::string path);
+		
+		//Waits for every job, then publishes the assets nobody took into the given caches
+		void Finish(LINKEDLIST<TEXTURE*> *textureCache, LINKEDLIST<MAPPINGS*> *mappingsCache);
+	
+	private:
+		void Worker();
+		void Decode(ASSETJOB *decodeJob);
+		ASSETJOB *Wait(ASSETJOB_TYPE type, std::string path);
+};
+
+//Amount of worker threads to decode level assets with, 0 decodes them serially
+extern unsigned int gAssetJobThreads;
+
+//Asset functions, taking the asset from the job system if it's been queued, or decoding it on the spot if not
+TEXTURE *TakeTexture(std::string path);
+MAPPINGS *TakeMappings(std::string path);
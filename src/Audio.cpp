@@ -1,18 +1,21 @@
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <thread>
 
 #include "LinkedList.h"
+#include "RingQueue.h"
 #include "Audio.h"
+#include "AudioMix.h"
+#include "Music.h"
+#include "Engine.h"
+#include "Backend/Audio.h"
 #include "Filesystem.h"
 #include "MathUtil.h"
 #include "Log.h"
 #include "Error.h"
-
-//Playback constants
-#define AUDIO_FREQUENCY 48000
-#define AUDIO_SAMPLES	0x200
-#define AUDIO_CHANNELS	2
+#include "ObjectJobs.h"
 
 //Sound definitions
 SOUNDDEFINITION soundDefinition[SOUNDID_MAX] = {
@@ -72,32 +75,496 @@ SOUNDDEFINITION soundDefinition[SOUNDID_MAX] = {
 	{SOUNDCHANNEL_DAC,	"data/Audio/Sound/SplashJingle.wav", SOUNDID_NULL},
 };
 
+//Sound bank, every sound's samples are stored in one arena (aliases and sounds sharing a file point to the same samples)
+static float *soundArena = nullptr;
+static SOUNDBUFFER sounds[SOUNDID_MAX];
+static std::atomic<bool> soundsLoaded(false);	//Set once the sound bank is ready, the mixer doesn't touch it before then
+
+#ifdef AUDIO_PRELOAD_THREAD
+	static std::thread *soundLoadThread = nullptr;
+#endif
+
+//Mixer voices, these are only touched by the audio thread
+struct AUDIOVOICE
+{
+	bool playing;
+	SOUNDID id;
+	SOUNDCHANNEL_TYPE channel;
+	const SOUNDBUFFER *sound;
+	size_t position;
+	float volumeL, volumeR;
+};
+
+static AUDIOVOICE voice[AUDIO_VOICES];
+
+alignas(32) static float mixBuffer[AUDIO_SAMPLES * AUDIO_CHANNELS];	//Float stream we mix into before it's limited into the device's stream
+
+//Command queue, the game thread is the only writer and the audio thread is the only reader, so neither ever has to lock
+enum AUDIOCOMMAND_TYPE
+{
+	AUDIOCOMMAND_PLAY,
+	AUDIOCOMMAND_STOP,
+	AUDIOCOMMAND_STOPCHANNEL,
+};
+
+struct AUDIOCOMMAND
+{
+	AUDIOCOMMAND_TYPE type;
+	SOUNDID id;
+	SOUNDCHANNEL_TYPE channel;
+	float volumeL, volumeR;
+};
+
+static RINGQUEUE<AUDIOCOMMAND, AUDIO_COMMANDS> audioCommand;
+
+//State published by the audio thread for the game thread
+static_assert(SOUNDID_MAX <= 64, "Sound playing mask can't fit every sound id");
+static std::atomic<uint64_t> soundPlaying(0);	//Bit set for each sound id currently playing
+static std::atomic<uint64_t> mixedFrames(0);	//Frames mixed since starting, used as our clock
+
+//Mixer functions
+static void StopVoices(SOUNDCHANNEL_TYPE channel)
+{
+	//Stop every voice using any of the given channels
+	for (int i = 0; i < AUDIO_VOICES; i++)
+		if (voice[i].playing && (voice[i].channel & channel) != 0)
+			voice[i].playing = false;
+}
+
+static void StartVoice(const AUDIOCOMMAND *command)
+{
+	//Don't play sounds that haven't loaded or failed to load
+	if (!soundsLoaded.load(std::memory_order_acquire))
+		return;
+	
+	const SOUNDBUFFER *sound = &sounds[command->id];
+	if (sound->buffer == nullptr)
+		return;
+	
+	//Stop sounds using the same channels
+	StopVoices(command->channel);
+	
+	//Restart this sound if it's already playing, otherwise use a free voice, or the voice that's been playing the longest
+	AUDIOVOICE *thisVoice = nullptr;
+	for (int i = 0; i < AUDIO_VOICES && thisVoice == nullptr; i++)
+		if (voice[i].playing && voice[i].id == command->id)
+			thisVoice = &voice[i];
+	for (int i = 0; i < AUDIO_VOICES && thisVoice == nullptr; i++)
+		if (!voice[i].playing)
+			thisVoice = &voice[i];
+	
+	if (thisVoice == nullptr)
+	{
+		thisVoice = &voice[0];
+		for (int i = 1; i < AUDIO_VOICES; i++)
+			if (voice[i].position > thisVoice->position)
+				thisVoice = &voice[i];
+	}
+	
+	//Start our voice
+	thisVoice->playing = true;
+	thisVoice->id = command->id;
+	thisVoice->channel = command->channel;
+	thisVoice->sound = sound;
+	thisVoice->position = 0;
+	thisVoice->volumeL = command->volumeL;
+	thisVoice->volumeR = command->volumeR;
+}
+
+void MixAudio(int16_t *stream, int frames)
+{
+	//Handle the commands the game has sent us (if the queue was full, the command was dropped)
+	AUDIOCOMMAND command;
+	while (!audioCommand.pop(&command))
+	{
+		switch (command.type)
+		{
+			case AUDIOCOMMAND_PLAY:
+				StartVoice(&command);
+				break;
+			case AUDIOCOMMAND_STOP:
+				for (int i = 0; i < AUDIO_VOICES; i++)
+					if (voice[i].playing && voice[i].id == command.id)
+						voice[i].playing = false;
+				break;
+			case AUDIOCOMMAND_STOPCHANNEL:
+				StopVoices(command.channel);
+				break;
+		}
+	}
+	
+	//Mix in chunks of our mix buffer's size
+	uint64_t playing = 0;
+	
+	for (int chunk = 0; chunk < frames; chunk += AUDIO_SAMPLES)
+	{
+		int chunkFrames = mmin(frames - chunk, AUDIO_SAMPLES);
+		
+		//Clear our mix buffer, mix our music, then mix every playing voice into it
+		memset(mixBuffer, 0, chunkFrames * AUDIO_CHANNELS * sizeof(float));
+		MixMusic(mixBuffer, chunkFrames);
+		
+		playing = 0;
+		
+		for (int i = 0; i < AUDIO_VOICES; i++)
+		{
+			AUDIOVOICE *thisVoice = &voice[i];
+			if (!thisVoice->playing)
+				continue;
+			
+			//Get how many frames we have left, stopping once we've reached the end of the sound
+			const SOUNDBUFFER *sound = thisVoice->sound;
+			size_t mixFrames = sound->frames - thisVoice->position;
+			if (mixFrames <= (size_t)chunkFrames)
+				thisVoice->playing = false;
+			else
+				mixFrames = chunkFrames;
+			
+			//Mix our frames with our gain, the sound is already in the mixer's format
+			MixVoice(mixBuffer, sound->buffer + thisVoice->position * 2, mixFrames, thisVoice->volumeL, thisVoice->volumeR);
+			thisVoice->position += mixFrames;
+			
+			if (thisVoice->playing)
+				playing |= (uint64_t)1 << thisVoice->id;
+		}
+		
+		//Limit our mix into the device's stream
+		LimitAudio(stream + chunk * AUDIO_CHANNELS, mixBuffer, chunkFrames * AUDIO_CHANNELS);
+	}
+	
+	//Publish our state for the game
+	soundPlaying.store(playing, std::memory_order_relaxed);
+	mixedFrames.fetch_add(frames, std::memory_order_relaxed);
+}
+
 //Common audio functions
+static bool ringPanLeft = false;
+
+static unsigned int spindashPitch = 0;	//Spindash's pitch increase in semi-tones
+static uint64_t spindashTimer = 0;		//Time for the spindash pitch to reset (in mixed frames)
+static bool spindashLast = false;		//Set to 1 if spindash was the last sound, set to 0 if it wasn't (resets the spindash pitch)
+
+static void GetPanGain(float pan, float *gainL, float *gainR)
+{
+	//Get the gain of each channel for the given pan (-1.0 is fully left, 1.0 is fully right), the centre keeps full volume on both
+	*gainL = mmin(1.0f, 1.0f - pan);
+	*gainR = mmin(1.0f, 1.0f + pan);
+}
+
 void PlaySound(SOUNDID id)
 {
+	//Simulations that aren't being presented don't touch the mixer
+	if (gEngine->mute)
+		return;
+	
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_PLAYSOUND)->sound = id;
+		return;
+	}
 	
+	//Handle sound specific stuff
+	float volumeL = 1.0f, volumeR = 1.0f;
+	
+	if (id != SOUNDID_SPINDASH_REV)
+		spindashLast = false;
+	
+	switch (id)
+	{
+		case SOUNDID_WATERFALL:
+			//Play fade if wasn't starting, otherwise, play secondary
+			if (soundPlaying.load(std::memory_order_relaxed) & (((uint64_t)1 << SOUNDID_WATERFALL_1) | ((uint64_t)1 << SOUNDID_WATERFALL_2)))
+				id = SOUNDID_WATERFALL_2;
+			else
+				id = SOUNDID_WATERFALL_1;
+			break;
+		case SOUNDID_SPINDASH_REV:
+		{
+			//Check spindash pitch clear
+			uint64_t time = mixedFrames.load(std::memory_order_relaxed);
+			if (!spindashLast || time > spindashTimer)
+			{
+				spindashLast = true;
+				spindashPitch = 0;
+			}
+			
+			//Increment pitch
+			if (++spindashPitch > 11)
+				spindashPitch = 11;
+			
+			//Set sound id
+			id = (SOUNDID)((unsigned int)SOUNDID_SPINDASH_REV + spindashPitch);
+			
+			//Update timer
+			spindashTimer = time + AUDIO_FREQUENCY;
+			break;
+		}
+		case SOUNDID_RING:
+			//Flip between left and right every time the sound plays
+			ringPanLeft ^= 1;
+			id = ringPanLeft ? SOUNDID_RING_LEFT : SOUNDID_RING_RIGHT;
+			GetPanGain(ringPanLeft ? -AUDIO_RING_PAN : AUDIO_RING_PAN, &volumeL, &volumeR);
+			break;
+		default:
+			break;
+	}
+	
+	//Send to the mixer, which stops sounds of the same channel and plays the sound
+	audioCommand.push({AUDIOCOMMAND_PLAY, id, soundDefinition[id].channel, volumeL, volumeR});
 }
 
 void StopSound(SOUNDID id)
 {
+	if (gEngine->mute)
+		return;
 	
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_STOPSOUND)->sound = id;
+		return;
+	}
+	
+	audioCommand.push({AUDIOCOMMAND_STOP, id, 0, 0.0f, 0.0f});
 }
 
 void StopChannel(uint16_t channel)
 {
+	if (gEngine->mute)
+		return;
+	
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_STOPCHANNEL)->channel = channel;
+		return;
+	}
 	
+	audioCommand.push({AUDIOCOMMAND_STOPCHANNEL, SOUNDID_NULL, channel, 0.0f, 0.0f});
+}
+
+//WAV functions
+const char *OpenWAV(FS_FILE *file, WAVFORMAT *format)
+{
+	size_t fileSize = file->GetSize();
+	
+	//Check our header ("RIFF" and "WAVE")
+	if (file->ReadBE32() != 0x52494646 || (file->ReadLE32(), file->ReadBE32()) != 0x57415645)
+		return "File isn't a .wav file";
+	
+	//Read our chunks until we reach our data
+	bool hasFormat = false;
+	
+	while (file->Tell() + 8 <= fileSize)
+	{
+		uint32_t chunkId = file->ReadBE32();
+		uint32_t chunkSize = file->ReadLE32();
+		size_t chunkEnd = file->Tell() + chunkSize + (chunkSize & 1);
+		
+		if (chunkId == 0x666D7420) //"fmt "
+		{
+			//Read our format and check it's supported
+			unsigned int encoding = file->ReadLE16();
+			format->channels = file->ReadLE16();
+			format->frequency = file->ReadLE32();
+			file->ReadLE32();
+			file->ReadLE16();
+			format->bits = file->ReadLE16();
+			
+			if (encoding != 1 || (format->channels != 1 && format->channels != 2) || (format->bits != 8 && format->bits != 16) || format->frequency == 0)
+				return "Unsupported .wav format";
+			hasFormat = true;
+		}
+		else if (chunkId == 0x64617461) //"data"
+		{
+			//Leave the file at the start of our data
+			if (!hasFormat)
+				return ".wav file has no format";
+			format->frames = chunkSize / (format->channels * (format->bits / 8));
+			return nullptr;
+		}
+		
+		file->Seek(chunkEnd, SEEK_SET);
+	}
+	
+	return ".wav file has no data";
+}
+
+void ReadWAV(FS_FILE *file, const WAVFORMAT *format, float *buffer, size_t frames)
+{
+	//Read the given amount of frames, converting to stereo floats
+	for (size_t i = 0; i < frames; i++)
+	{
+		for (unsigned int v = 0; v < 2; v++)
+		{
+			if (v < format->channels)
+				buffer[i * 2 + v] = (format->bits == 16) ? ((int16_t)file->ReadLE16() / 32768.0f) : ((file->ReadU8() - 0x80) / 128.0f);
+			else
+				buffer[i * 2 + v] = buffer[i * 2];
+		}
+	}
+}
+
+//Sound loading functions
+static float *LoadSound(std::string path, WAVFORMAT *format)
+{
+	//Open the given file
+	FS_FILE file(path, "rb");
+	if (file.fail != nullptr)
+	{
+		Warn(file.fail);
+		return nullptr;
+	}
+	
+	const char *error = OpenWAV(&file, format);
+	if (error != nullptr)
+	{
+		Warn(error);
+		return nullptr;
+	}
+	
+	//Read our samples as stereo floats at the file's frequency
+	float *buffer = new float[format->frames * 2];
+	ReadWAV(&file, format, buffer, format->frames);
+	return buffer;
+}
+
+static size_t ResampledFrames(const WAVFORMAT *format)
+{
+	//Get how many frames the sound will be at the mixer's frequency
+	return (size_t)(((uint64_t)format->frames * AUDIO_FREQUENCY + format->frequency - 1) / format->frequency);
+}
+
+static void ResampleSound(float *out, const float *in, const WAVFORMAT *format)
+{
+	//Copy the sound as is if it's already at the mixer's frequency
+	size_t outFrames = ResampledFrames(format);
+	if (format->frequency == AUDIO_FREQUENCY)
+	{
+		memcpy(out, in, outFrames * 2 * sizeof(float));
+		return;
+	}
+	
+	//Resample the sound with linear interpolation (32.32 fixed point position)
+	uint64_t step = ((uint64_t)format->frequency << 32) / AUDIO_FREQUENCY;
+	uint64_t position = 0;
+	
+	for (size_t i = 0; i < outFrames; i++, position += step)
+	{
+		size_t frame = (size_t)(position >> 32);
+		size_t next = (frame + 1 < format->frames) ? (frame + 1) : (format->frames - 1);
+		float mix = (float)(position & 0xFFFFFFFF) / 4294967296.0f;
+		
+		for (int v = 0; v < 2; v++)
+			*out++ = in[frame * 2 + v] + (in[next * 2 + v] - in[frame * 2 + v]) * mix;
+	}
 }
 
-//Load sound function
 bool LoadAllSoundEffects()
 {
+	//Read every sound effect file, sounds that fail to load are silent
+	float *source[SOUNDID_MAX] = {nullptr};
+	WAVFORMAT format[SOUNDID_MAX];
+	SOUNDID shared[SOUNDID_MAX];	//Sound whose samples we use, either our alias parent or an earlier sound with the same file
+	size_t arenaFrames = 0;
+	
+	for (int i = 0; i < SOUNDID_MAX; i++)
+	{
+		shared[i] = (SOUNDID)i;
+		
+		if (soundDefinition[i].path == nullptr)
+		{
+			if (soundDefinition[i].parent != SOUNDID_NULL)
+				shared[i] = soundDefinition[i].parent;
+			continue;
+		}
+		
+		//Use an earlier sound's samples if it was loaded from the same file
+		for (int v = 0; v < i; v++)
+		{
+			if (soundDefinition[v].path != nullptr && strcmp(soundDefinition[v].path, soundDefinition[i].path) == 0)
+			{
+				shared[i] = (SOUNDID)v;
+				break;
+			}
+		}
+		if (shared[i] != i)
+			continue;
+		
+		LOG(("Loading sound from %s... ", soundDefinition[i].path));
+		if ((source[i] = LoadSound(gBasePath + soundDefinition[i].path, &format[i])) == nullptr)
+			continue;
+		LOG(("Success!\n"));
+		
+		//Reserve room for our resampled frames in the arena, keeping every sound aligned to 4 frames
+		arenaFrames += (ResampledFrames(&format[i]) + 3) & ~3;
+	}
+	
+	//Allocate our arena, then resample every sound into it
+	if (arenaFrames != 0)
+		soundArena = new float[arenaFrames * 2];
+	
+	float *arenaPosition = soundArena;
+	
+	for (int i = 0; i < SOUNDID_MAX; i++)
+	{
+		if (source[i] == nullptr)
+			continue;
+		
+		size_t frames = ResampledFrames(&format[i]);
+		ResampleSound(arenaPosition, source[i], &format[i]);
+		memset(arenaPosition + frames * 2, 0, (((frames + 3) & ~3) - frames) * 2 * sizeof(float));
+		delete[] source[i];
+		
+		sounds[i] = {arenaPosition, frames};
+		arenaPosition += ((frames + 3) & ~3) * 2;
+	}
+	
+	//Point aliases and sounds sharing a file to the same samples
+	for (int i = 0; i < SOUNDID_MAX; i++)
+		if (shared[i] != i)
+			sounds[i] = sounds[shared[i]];
+	
+	LOG(("Sound bank uses %d bytes\n", (int)(arenaFrames * 2 * sizeof(float))));
+	
+	//Let the mixer use our sounds
+	soundsLoaded.store(true, std::memory_order_release);
 	return false;
 }
 
+void UnloadAllSoundEffects()
+{
+	//Free our arena and clear every sound
+	soundsLoaded.store(false, std::memory_order_release);
+	
+	delete[] soundArena;
+	soundArena = nullptr;
+	
+	for (int i = 0; i < SOUNDID_MAX; i++)
+		sounds[i] = {nullptr, 0};
+}
+
 //Sub-system functions
 bool InitializeAudio()
 {
-	LOG(("Initializing audio... "));
+	LOG(("Initializing audio...\n"));
+	
+	//Load all of our sound effects (or start loading them on a worker thread) and start our music streamer
+	#ifdef AUDIO_PRELOAD_THREAD
+		soundLoadThread = new std::thread(LoadAllSoundEffects);
+	#else
+		if (LoadAllSoundEffects())
+			return true;
+	#endif
+	
+	if (InitializeMusic())
+		return true;
+	
+	//Open our audio device, which starts calling our mixer
+	if (Backend_InitAudio(AUDIO_FREQUENCY, AUDIO_SAMPLES, AUDIO_CHANNELS, MixAudio))
+		return Error("Failed to open audio device");
+	
 	LOG(("Success!\n"));
 	return false;
 }
@@ -105,6 +572,22 @@ bool InitializeAudio()
 void QuitAudio()
 {
 	LOG(("Ending audio... "));
+	
+	//Close our audio device, then unload our music and sound bank
+	Backend_QuitAudio();
+	QuitMusic();
+	
+	#ifdef AUDIO_PRELOAD_THREAD
+		if (soundLoadThread != nullptr)
+		{
+			soundLoadThread->join();
+			delete soundLoadThread;
+			soundLoadThread = nullptr;
+		}
+	#endif
+	
+	UnloadAllSoundEffects();
+	
 	LOG(("Success!\n"));
 	return;
 }
@@ -1,6 +1,22 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 
+//Declare the file class
+class FS_FILE;
+
+//Mixer format
+#define AUDIO_FREQUENCY	48000
+#define AUDIO_SAMPLES	0x200
+#define AUDIO_CHANNELS	2
+
+#define AUDIO_VOICES	16		//Most sounds that can play at once
+#define AUDIO_COMMANDS	0x100	//Size of the play / stop command queue between the game and the mixer
+
+#define AUDIO_RING_PAN	1.0f	//How far the ring sound pans to each side (1.0 is fully left / right like the originals)
+
+//#define AUDIO_PRELOAD_THREAD	//Load sound effects on a worker thread while the game starts up, sounds played before they've loaded are silent
+
 //Sound ids
 enum SOUNDID
 {
@@ -85,11 +101,34 @@ struct SOUNDDEFINITION
 	SOUNDID parent;
 };
 
+//Loaded sound (interleaved stereo floats at the mixer's frequency, stored in the sound bank's arena)
+struct SOUNDBUFFER
+{
+	const float *buffer;
+	size_t frames;
+};
+
+//WAV format
+struct WAVFORMAT
+{
+	unsigned int channels;
+	unsigned int frequency;
+	unsigned int bits;
+	size_t frames;
+};
+
+//WAV functions
+const char *OpenWAV(FS_FILE *file, WAVFORMAT *format);
+void ReadWAV(FS_FILE *file, const WAVFORMAT *format, float *buffer, size_t frames);
+
 //Sound functions
 void PlaySound(SOUNDID id);
 void StopSound(SOUNDID id);
 void StopChannel(SOUNDCHANNEL_TYPE channel);
 
+//Mixer function, called by the audio backend
+void MixAudio(int16_t *stream, int frames);
+
 //Audio subsystem functions
 bool InitializeAudio();
 void QuitAudio();
@@ -0,0 +1,179 @@
+#include <math.h>
+
+#include "AudioMix.h"
+
+#if defined(AUDIOMIX_AVX) || defined(AUDIOMIX_SSE)
+	#include <immintrin.h>
+#elif defined(AUDIOMIX_NEON)
+	#include <arm_neon.h>
+#endif
+
+//Scalar kernels
+void MixVoiceScalar(float *stream, const float *in, size_t frames, float gainL, float gainR)
+{
+	//Add the input to our stream with the given gain for each channel
+	for (size_t i = 0; i < frames; i++)
+	{
+		*stream++ += *in++ * gainL;
+		*stream++ += *in++ * gainR;
+	}
+}
+
+static inline float LimitSample(float sample)
+{
+	//Below our threshold, the sample is untouched, above it, it follows a tanh curve (rational approximation, reaching exactly 1.0 at 3.0) towards 1.0
+	const float range = 1.0f - AUDIOMIX_LIMIT_THRESHOLD;
+	float level = fabsf(sample);
+	float over = (level - AUDIOMIX_LIMIT_THRESHOLD) / range;
+	over = (over < 0.0f) ? 0.0f : ((over > 3.0f) ? 3.0f : over);
+	
+	float limited = ((level < AUDIOMIX_LIMIT_THRESHOLD) ? level : AUDIOMIX_LIMIT_THRESHOLD) + range * over * (27.0f + over * over) / (27.0f + 9.0f * over * over);
+	return (sample < 0.0f) ? -limited : limited;
+}
+
+void LimitAudioScalar(int16_t *out, const float *in, size_t samples)
+{
+	//Limit every sample, then convert it to a signed 16-bit integer (the limiter keeps us within -1.0 to 1.0)
+	for (size_t i = 0; i < samples; i++)
+		out[i] = (int16_t)(LimitSample(in[i]) * 32767.0f);
+}
+
+//Vector kernels
+#if defined(AUDIOMIX_AVX)
+	void MixVoice(float *stream, const float *in, size_t frames, float gainL, float gainR)
+	{
+		//Mix 4 frames at a time
+		__m256 gain = _mm256_setr_ps(gainL, gainR, gainL, gainR, gainL, gainR, gainL, gainR);
+		size_t i = 0;
+		for (; i + 4 <= frames; i += 4)
+			_mm256_storeu_ps(stream + i * 2, _mm256_add_ps(_mm256_loadu_ps(stream + i * 2), _mm256_mul_ps(_mm256_loadu_ps(in + i * 2), gain)));
+		MixVoiceScalar(stream + i * 2, in + i * 2, frames - i, gainL, gainR);
+	}
+	
+	void LimitAudio(int16_t *out, const float *in, size_t samples)
+	{
+		//Limit and convert 8 samples at a time (see LimitSample)
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		const __m256 threshold = _mm256_set1_ps(AUDIOMIX_LIMIT_THRESHOLD);
+		const __m256 range = _mm256_set1_ps(1.0f - AUDIOMIX_LIMIT_THRESHOLD);
+		const __m256 zero = _mm256_setzero_ps(), three = _mm256_set1_ps(3.0f), nine = _mm256_set1_ps(9.0f), twentySeven = _mm256_set1_ps(27.0f);
+		const __m256 scale = _mm256_set1_ps(32767.0f);
+		
+		size_t i = 0;
+		for (; i + 8 <= samples; i += 8)
+		{
+			__m256 sample = _mm256_loadu_ps(in + i);
+			__m256 sign = _mm256_and_ps(sample, signMask);
+			__m256 level = _mm256_andnot_ps(signMask, sample);
+			__m256 over = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(_mm256_sub_ps(level, threshold), range), zero), three);
+			__m256 over2 = _mm256_mul_ps(over, over);
+			__m256 knee = _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(range, over), _mm256_add_ps(twentySeven, over2)), _mm256_add_ps(twentySeven, _mm256_mul_ps(nine, over2)));
+			__m256 limited = _mm256_or_ps(_mm256_add_ps(_mm256_min_ps(level, threshold), knee), sign);
+			
+			__m256i converted = _mm256_cvttps_epi32(_mm256_mul_ps(limited, scale));
+			_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm256_castsi256_si128(converted), _mm256_extractf128_si256(converted, 1)));
+		}
+		LimitAudioScalar(out + i, in + i, samples - i);
+	}
+	
+	const char *GetMixKernelName() { return "AVX"; }
+#elif defined(AUDIOMIX_SSE)
+	void MixVoice(float *stream, const float *in, size_t frames, float gainL, float gainR)
+	{
+		//Mix 2 frames at a time
+		__m128 gain = _mm_setr_ps(gainL, gainR, gainL, gainR);
+		size_t i = 0;
+		for (; i + 2 <= frames; i += 2)
+			_mm_storeu_ps(stream + i * 2, _mm_add_ps(_mm_loadu_ps(stream + i * 2), _mm_mul_ps(_mm_loadu_ps(in + i * 2), gain)));
+		MixVoiceScalar(stream + i * 2, in + i * 2, frames - i, gainL, gainR);
+	}
+	
+	void LimitAudio(int16_t *out, const float *in, size_t samples)
+	{
+		//Limit and convert 8 samples at a time (see LimitSample)
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 threshold = _mm_set1_ps(AUDIOMIX_LIMIT_THRESHOLD);
+		const __m128 range = _mm_set1_ps(1.0f - AUDIOMIX_LIMIT_THRESHOLD);
+		const __m128 zero = _mm_setzero_ps(), three = _mm_set1_ps(3.0f), nine = _mm_set1_ps(9.0f), twentySeven = _mm_set1_ps(27.0f);
+		const __m128 scale = _mm_set1_ps(32767.0f);
+		
+		size_t i = 0;
+		for (; i + 8 <= samples; i += 8)
+		{
+			__m128i converted[2];
+			for (int v = 0; v < 2; v++)
+			{
+				__m128 sample = _mm_loadu_ps(in + i + v * 4);
+				__m128 sign = _mm_and_ps(sample, signMask);
+				__m128 level = _mm_andnot_ps(signMask, sample);
+				__m128 over = _mm_min_ps(_mm_max_ps(_mm_div_ps(_mm_sub_ps(level, threshold), range), zero), three);
+				__m128 over2 = _mm_mul_ps(over, over);
+				__m128 knee = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(range, over), _mm_add_ps(twentySeven, over2)), _mm_add_ps(twentySeven, _mm_mul_ps(nine, over2)));
+				__m128 limited = _mm_or_ps(_mm_add_ps(_mm_min_ps(level, threshold), knee), sign);
+				converted[v] = _mm_cvttps_epi32(_mm_mul_ps(limited, scale));
+			}
+			_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(converted[0], converted[1]));
+		}
+		LimitAudioScalar(out + i, in + i, samples - i);
+	}
+	
+	const char *GetMixKernelName() { return "SSE2"; }
+#elif defined(AUDIOMIX_NEON)
+	void MixVoice(float *stream, const float *in, size_t frames, float gainL, float gainR)
+	{
+		//Mix 2 frames at a time
+		const float gainArray[4] = {gainL, gainR, gainL, gainR};
+		float32x4_t gain = vld1q_f32(gainArray);
+		size_t i = 0;
+		for (; i + 2 <= frames; i += 2)
+			vst1q_f32(stream + i * 2, vmlaq_f32(vld1q_f32(stream + i * 2), vld1q_f32(in + i * 2), gain));
+		MixVoiceScalar(stream + i * 2, in + i * 2, frames - i, gainL, gainR);
+	}
+	
+	void LimitAudio(int16_t *out, const float *in, size_t samples)
+	{
+		//Limit and convert 8 samples at a time (see LimitSample, NEON has no divide on 32-bit ARM, so we use a refined reciprocal estimate)
+		const float32x4_t threshold = vdupq_n_f32(AUDIOMIX_LIMIT_THRESHOLD);
+		const float32x4_t rangeReciprocal = vdupq_n_f32(1.0f / (1.0f - AUDIOMIX_LIMIT_THRESHOLD));
+		const float32x4_t range = vdupq_n_f32(1.0f - AUDIOMIX_LIMIT_THRESHOLD);
+		const float32x4_t zero = vdupq_n_f32(0.0f), three = vdupq_n_f32(3.0f), nine = vdupq_n_f32(9.0f), twentySeven = vdupq_n_f32(27.0f);
+		const float32x4_t scale = vdupq_n_f32(32767.0f);
+		
+		size_t i = 0;
+		for (; i + 8 <= samples; i += 8)
+		{
+			int32x4_t converted[2];
+			for (int v = 0; v < 2; v++)
+			{
+				float32x4_t sample = vld1q_f32(in + i + v * 4);
+				float32x4_t level = vabsq_f32(sample);
+				float32x4_t over = vminq_f32(vmaxq_f32(vmulq_f32(vsubq_f32(level, threshold), rangeReciprocal), zero), three);
+				float32x4_t over2 = vmulq_f32(over, over);
+				float32x4_t denominator = vmlaq_f32(twentySeven, nine, over2);
+				float32x4_t reciprocal = vrecpeq_f32(denominator);
+				reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+				reciprocal = vmulq_f32(vrecpsq_f32(denominator, reciprocal), reciprocal);
+				float32x4_t knee = vmulq_f32(vmulq_f32(vmulq_f32(range, over), vaddq_f32(twentySeven, over2)), reciprocal);
+				float32x4_t limited = vminq_f32(vaddq_f32(vminq_f32(level, threshold), knee), vdupq_n_f32(1.0f));
+				limited = vbslq_f32(vcltq_f32(sample, zero), vnegq_f32(limited), limited);
+				converted[v] = vcvtq_s32_f32(vmulq_f32(limited, scale));
+			}
+			vst1q_s16(out + i, vcombine_s16(vqmovn_s32(converted[0]), vqmovn_s32(converted[1])));
+		}
+		LimitAudioScalar(out + i, in + i, samples - i);
+	}
+	
+	const char *GetMixKernelName() { return "NEON"; }
+#else
+	void MixVoice(float *stream, const float *in, size_t frames, float gainL, float gainR)
+	{
+		MixVoiceScalar(stream, in, frames, gainL, gainR);
+	}
+	
+	void LimitAudio(int16_t *out, const float *in, size_t samples)
+	{
+		LimitAudioScalar(out, in, samples);
+	}
+	
+	const char *GetMixKernelName() { return "Scalar"; }
+#endif
@@ -0,0 +1,26 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//Pick our vector instruction set from what the compiler's targeting
+#if defined(__AVX__)
+	#define AUDIOMIX_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define AUDIOMIX_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define AUDIOMIX_NEON
+#endif
+
+//Limiter constants
+#define AUDIOMIX_LIMIT_THRESHOLD	0.75f	//Samples quieter than this pass through untouched, louder samples are softly compressed towards 1.0
+
+//Mix kernels (stream and input are interleaved stereo)
+void MixVoice(float *stream, const float *in, size_t frames, float gainL, float gainR);
+void LimitAudio(int16_t *out, const float *in, size_t samples);
+
+//Scalar versions of the kernels, used for the ends of buffers and for comparison
+void MixVoiceScalar(float *stream, const float *in, size_t frames, float gainL, float gainR);
+void LimitAudioScalar(int16_t *out, const float *in, size_t samples);
+
+//Name of the instruction set the kernels use
+const char *GetMixKernelName();
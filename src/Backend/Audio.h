@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdint.h>
+
+//Audio callback, called on the audio device's thread to fill the stream with the given amount of interleaved signed 16-bit frames
+typedef void (*BACKEND_AUDIO_CALLBACK)(int16_t *stream, int frames);
+
+//Audio functions
+bool Backend_InitAudio(unsigned int frequency, unsigned int frames, unsigned int channels, BACKEND_AUDIO_CALLBACK callback);
+void Backend_QuitAudio();
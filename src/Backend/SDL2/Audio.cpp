@@ -0,0 +1,47 @@
+#include "SDL_audio.h"
+#include "../Audio.h"
+
+//Audio device and our mixer
+SDL_AudioDeviceID audioDevice;
+BACKEND_AUDIO_CALLBACK audioCallback;
+unsigned int audioChannels;
+
+static void AudioCallback(void *userdata, Uint8 *stream, int length)
+{
+	//Mix straight into SDL's stream
+	(void)userdata;
+	int frames = length / (sizeof(int16_t) * audioChannels);
+	audioCallback((int16_t*)stream, frames);
+}
+
+//Core initialization and quitting
+bool Backend_InitAudio(unsigned int frequency, unsigned int frames, unsigned int channels, BACKEND_AUDIO_CALLBACK callback)
+{
+	audioCallback = callback;
+	audioChannels = channels;
+	
+	//Open our audio device in signed 16-bit format
+	SDL_AudioSpec want;
+	SDL_zero(want);
+	want.freq = frequency;
+	want.samples = frames;
+	want.format = AUDIO_S16SYS;
+	want.channels = channels;
+	want.callback = AudioCallback;
+	
+	audioDevice = SDL_OpenAudioDevice(nullptr, 0, &want, nullptr, 0);
+	if (!audioDevice)
+		return true;
+	
+	//Start playing
+	SDL_PauseAudioDevice(audioDevice, 0);
+	return false;
+}
+
+void Backend_QuitAudio()
+{
+	//Close our audio device, this waits for the callback to finish
+	if (audioDevice)
+		SDL_CloseAudioDevice(audioDevice);
+	audioDevice = 0;
+}
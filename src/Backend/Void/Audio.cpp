@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+#include "../Audio.h"
+#include "../../Render.h"
+#include "../../Engine.h"
+#include "../../Filesystem.h"
+#include "AudioSink.h"
+
+//Headless audio sink, the mixer is pulled with exactly one rendered frame's worth of audio per frame (so output doesn't depend on how fast we run)
+//If the CUCKYSONIC_AUDIO_WAV environment variable is set, the audio is written to the given .wav file, and the time each pull took to <path>.timing.csv
+BACKEND_AUDIO_CALLBACK audioCallback = nullptr;
+unsigned int audioFrequency, audioChannels;
+
+int16_t *audioBuffer = nullptr;
+unsigned int audioBufferFrames = 0;
+
+uint64_t audioRenderFrames = 0;	//Frames rendered so far
+uint64_t audioPulledFrames = 0;	//Audio frames pulled from the mixer so far
+
+//Output file
+std::string audioPath;
+FS_FILE *audioFile = nullptr;
+
+//Timing statistics (nanoseconds each pull took)
+#define AUDIOSINK_MIN_FRAMERATE	24		//Lowest framerate our buffer's reserved for (lower ones grow it on their first pull)
+#define AUDIOSINK_TIMINGS		0x8000	//Pulls our timing statistics are reserved for (a little over 9 minutes at 60fps, past that they double)
+
+uint32_t *audioTiming = nullptr;
+size_t audioTimings = 0, audioTimingCapacity = 0;
+
+//Sink functions
+void Backend_PullAudioFrame()
+{
+	if (audioCallback == nullptr)
+		return;
+	
+	//Get how many frames we need this rendered frame (the framerate doesn't have to divide our frequency evenly)
+	uint64_t targetFrames = (uint64_t)((double)(++audioRenderFrames) * audioFrequency / gEngine->renderSpec.framerate);
+	unsigned int frames = (unsigned int)(targetFrames - audioPulledFrames);
+	audioPulledFrames = targetFrames;
+	if (frames == 0)
+		return;
+	
+	//Make sure our buffer's big enough
+	if (frames > audioBufferFrames)
+	{
+		delete[] audioBuffer;
+		audioBuffer = new int16_t[frames * audioChannels];
+		audioBufferFrames = frames;
+	}
+	
+	//Pull from the mixer, timing how long it takes
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	audioCallback(audioBuffer, frames);
+	uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	
+	if (audioTimings >= audioTimingCapacity)
+	{
+		audioTimingCapacity = (audioTimingCapacity == 0) ? AUDIOSINK_TIMINGS : (audioTimingCapacity * 2);
+		uint32_t *newTiming = new uint32_t[audioTimingCapacity];
+		if (audioTiming != nullptr)
+			memcpy(newTiming, audioTiming, audioTimings * sizeof(uint32_t));
+		delete[] audioTiming;
+		audioTiming = newTiming;
+	}
+	audioTiming[audioTimings++] = (uint32_t)((time > 0xFFFFFFFF) ? 0xFFFFFFFF : time);
+	
+	//Write to our file
+	if (audioFile != nullptr)
+		for (unsigned int i = 0; i < frames * audioChannels; i++)
+			audioFile->WriteLE16((uint16_t)audioBuffer[i]);
+}
+
+static int CompareTiming(const void *a, const void *b)
+{
+	uint32_t timeA = *((const uint32_t*)a), timeB = *((const uint32_t*)b);
+	return (timeA > timeB) - (timeA < timeB);
+}
+
+static void WriteTimingStatistics()
+{
+	if (audioTimings == 0)
+		return;
+	
+	//Write every pull's time to our timing file
+	if (!audioPath.empty())
+	{
+		FS_FILE file(audioPath + ".timing.csv", "wb");
+		if (file.fail == nullptr)
+		{
+			fprintf(file.fp, "frame,nanoseconds\n");
+			for (size_t i = 0; i < audioTimings; i++)
+				fprintf(file.fp, "%d,%u\n", (int)i, (unsigned int)audioTiming[i]);
+		}
+	}
+	
+	//Print a summary (in release builds too, since that's what offline renders are timed with)
+	uint64_t total = 0;
+	for (size_t i = 0; i < audioTimings; i++)
+		total += audioTiming[i];
+	
+	qsort(audioTiming, audioTimings, sizeof(uint32_t), CompareTiming);
+	
+	double audioSeconds = (double)audioPulledFrames / audioFrequency;
+	printf("Audio sink: %d pulls, %.1fs of audio mixed in %.1fms (%.0fx realtime)\n", (int)audioTimings, audioSeconds, total / 1000000.0, (total != 0) ? (audioSeconds * 1000000000.0 / total) : 0.0);
+	printf("Audio sink: pull time min %.2fus, average %.2fus, median %.2fus, 99th percentile %.2fus, max %.2fus\n",
+		audioTiming[0] / 1000.0,
+		(double)total / audioTimings / 1000.0,
+		audioTiming[audioTimings / 2] / 1000.0,
+		audioTiming[audioTimings * 99 / 100] / 1000.0,
+		audioTiming[audioTimings - 1] / 1000.0);
+}
+
+//Core initialization and quitting
+bool Backend_InitAudio(unsigned int frequency, unsigned int frames, unsigned int channels, BACKEND_AUDIO_CALLBACK callback)
+{
+	(void)frames;
+	audioCallback = callback;
+	audioFrequency = frequency;
+	audioChannels = channels;
+	audioRenderFrames = 0;
+	audioPulledFrames = 0;
+	
+	//Reserve our buffer and timing statistics, so pulls don't allocate
+	audioBufferFrames = frequency / AUDIOSINK_MIN_FRAMERATE + 1;
+	audioBuffer = new int16_t[audioBufferFrames * channels];
+	audioTimingCapacity = AUDIOSINK_TIMINGS;
+	audioTiming = new uint32_t[audioTimingCapacity];
+	audioTimings = 0;
+	
+	//Open our output file and write a .wav header (the sizes are filled in once we're done)
+	const char *path = getenv("CUCKYSONIC_AUDIO_WAV");
+	if (path != nullptr && path[0] != '\0')
+	{
+		audioPath = path;
+		audioFile = new FS_FILE(audioPath, "wb");
+		if (audioFile->fail != nullptr)
+		{
+			delete audioFile;
+			audioFile = nullptr;
+			return true;
+		}
+		
+		audioFile->WriteBE32(0x52494646); //"RIFF"
+		audioFile->WriteLE32(0);
+		audioFile->WriteBE32(0x57415645); //"WAVE"
+		audioFile->WriteBE32(0x666D7420); //"fmt "
+		audioFile->WriteLE32(16);
+		audioFile->WriteLE16(1);
+		audioFile->WriteLE16(channels);
+		audioFile->WriteLE32(frequency);
+		audioFile->WriteLE32(frequency * channels * sizeof(int16_t));
+		audioFile->WriteLE16(channels * sizeof(int16_t));
+		audioFile->WriteLE16(16);
+		audioFile->WriteBE32(0x64617461); //"data"
+		audioFile->WriteLE32(0);
+	}
+	
+	return false;
+}
+
+void Backend_QuitAudio()
+{
+	//Stop pulling from the mixer
+	audioCallback = nullptr;
+	
+	//Fill in our .wav's sizes and close it
+	if (audioFile != nullptr)
+	{
+		uint32_t dataSize = (uint32_t)(audioPulledFrames * audioChannels * sizeof(int16_t));
+		audioFile->Seek(4, SEEK_SET);
+		audioFile->WriteLE32(36 + dataSize);
+		audioFile->Seek(40, SEEK_SET);
+		audioFile->WriteLE32(dataSize);
+		delete audioFile;
+		audioFile = nullptr;
+	}
+	
+	//Write our timing statistics and free everything
+	WriteTimingStatistics();
+	
+	delete[] audioTiming;
+	audioTiming = nullptr;
+	audioTimings = audioTimingCapacity = 0;
+	
+	delete[] audioBuffer;
+	audioBuffer = nullptr;
+	audioBufferFrames = 0;
+	audioPath.clear();
+	return;
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+//Headless audio sink, called by the void render backend once per rendered frame to pull that frame's audio from the mixer
+void Backend_PullAudioFrame();
@@ -1,4 +1,5 @@
 #include "../Render.h"
+#include "AudioSink.h"
 
 //Buffer and render output
 bool Backend_GetOutputBuffer(void **buffer, int *pitch)
@@ -10,6 +11,8 @@ bool Backend_GetOutputBuffer(void **buffer, int *pitch)
 
 bool Backend_OutputBuffer()
 {
+	//Pull this frame's audio
+	Backend_PullAudioFrame();
 	return false;
 }
 
@@ -2,11 +2,12 @@
 #include "Background.h"
 #include "Game.h"
 #include "Error.h"
+#include "AssetJobs.h"
 
 BACKGROUND::BACKGROUND(std::string name, BACKGROUNDFUNCTION backFunction)
 {
 	//Load the given texture
-	texture = new TEXTURE(name);
+	texture = TakeTexture(name);
 	if (texture->fail)
 	{
 		fail = texture->fail;
@@ -28,8 +29,8 @@ void BACKGROUND::DrawStrip(RECT *src, int layer, int y, int fromX, int toX)
 	if (toX == fromX)
 	{
 		//Just draw the strip in its entirety
-		for (int x = -(-fromX % (unsigned)texture->width); x < gRenderSpec.width; x += texture->width)
-			gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, src, layer, x, y, false, false);
+		for (int x = -(-fromX % (unsigned)texture->width); x < gEngine->renderSpec.width; x += texture->width)
+			gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, src, layer, x, y, false, false);
 	}
 	else
 	{
@@ -38,8 +39,8 @@ void BACKGROUND::DrawStrip(RECT *src, int layer, int y, int fromX, int toX)
 		for (int sy = 0; sy < src->h; sy++)
 		{
 			int xp = fromX + ((toX - fromX) * sy / src->h);
-			for (int x = -(-xp % (unsigned)texture->width); x < gRenderSpec.width; x += texture->width)
-				gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &strip, layer, x, y + sy, false, false);
+			for (int x = -(-xp % (unsigned)texture->width); x < gEngine->renderSpec.width; x += texture->width)
+				gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &strip, layer, x, y + sy, false, false);
 			strip.y++;
 		}
 	}
@@ -0,0 +1,117 @@
+//Audio mixer microbenchmark, times a mixer callback (voice mixing, then limiting into the device's stream) with different amounts of voices
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "../Audio.h"
+#include "../AudioMix.h"
+
+//Constants
+#define BENCH_SOUND_FRAMES	AUDIO_FREQUENCY	//Frames in our test sound (1 second)
+#define BENCH_CALLBACKS		4000			//Callbacks timed for each test
+#define BENCH_MAX_VOICES	128
+
+//Test data
+float sound[BENCH_SOUND_FRAMES * 2];
+alignas(32) float mixBuffer[AUDIO_SAMPLES * AUDIO_CHANNELS];
+int16_t stream[AUDIO_SAMPLES * AUDIO_CHANNELS];
+
+struct BENCHVOICE
+{
+	size_t position;
+	float gainL, gainR;
+};
+
+BENCHVOICE voice[BENCH_MAX_VOICES];
+
+//Random number generator (so the test data is the same every run)
+static uint32_t benchSeed = 0x12345678;
+
+static float BenchRandom()
+{
+	benchSeed = benchSeed * 1664525 + 1013904223;
+	return (float)(benchSeed >> 8) / (float)(1 << 24);
+}
+
+//Benchmark function
+static double TimeCallbacks(int voices, bool scalar)
+{
+	//Start every voice at a different position with a different gain
+	for (int i = 0; i < voices; i++)
+	{
+		voice[i].position = (size_t)(BenchRandom() * (BENCH_SOUND_FRAMES - AUDIO_SAMPLES));
+		voice[i].gainL = BenchRandom();
+		voice[i].gainR = BenchRandom();
+	}
+	
+	//Run our callbacks
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	for (int callback = 0; callback < BENCH_CALLBACKS; callback++)
+	{
+		memset(mixBuffer, 0, sizeof(mixBuffer));
+		
+		for (int i = 0; i < voices; i++)
+		{
+			//Mix this voice, looping back to the start of the sound
+			if (scalar)
+				MixVoiceScalar(mixBuffer, sound + voice[i].position * 2, AUDIO_SAMPLES, voice[i].gainL, voice[i].gainR);
+			else
+				MixVoice(mixBuffer, sound + voice[i].position * 2, AUDIO_SAMPLES, voice[i].gainL, voice[i].gainR);
+			
+			if ((voice[i].position += AUDIO_SAMPLES) > BENCH_SOUND_FRAMES - AUDIO_SAMPLES)
+				voice[i].position = 0;
+		}
+		
+		if (scalar)
+			LimitAudioScalar(stream, mixBuffer, AUDIO_SAMPLES * AUDIO_CHANNELS);
+		else
+			LimitAudio(stream, mixBuffer, AUDIO_SAMPLES * AUDIO_CHANNELS);
+	}
+	
+	//Return the average time per callback in microseconds
+	std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+	return time.count() / BENCH_CALLBACKS;
+}
+
+int main()
+{
+	//Fill our test sound with noise
+	for (int i = 0; i < BENCH_SOUND_FRAMES * 2; i++)
+		sound[i] = BenchRandom() * 2.0f - 1.0f;
+	
+	//Check our vector kernels match our scalar kernels
+	static float scalarBuffer[AUDIO_SAMPLES * AUDIO_CHANNELS];
+	static int16_t scalarStream[AUDIO_SAMPLES * AUDIO_CHANNELS];
+	
+	memset(mixBuffer, 0, sizeof(mixBuffer));
+	memset(scalarBuffer, 0, sizeof(scalarBuffer));
+	for (int i = 0; i < 8; i++)
+	{
+		MixVoice(mixBuffer, sound + i * 1001 * 2, AUDIO_SAMPLES - i, 0.5f, 0.25f * i);
+		MixVoiceScalar(scalarBuffer, sound + i * 1001 * 2, AUDIO_SAMPLES - i, 0.5f, 0.25f * i);
+	}
+	LimitAudio(stream, mixBuffer, AUDIO_SAMPLES * AUDIO_CHANNELS - 3);
+	LimitAudioScalar(scalarStream, scalarBuffer, AUDIO_SAMPLES * AUDIO_CHANNELS - 3);
+	
+	int mismatches = 0;
+	for (int i = 0; i < AUDIO_SAMPLES * AUDIO_CHANNELS - 3; i++)
+		if (stream[i] - scalarStream[i] > 1 || scalarStream[i] - stream[i] > 1)
+			mismatches++;
+	
+	printf("Mix kernels: %s (%d samples differ from the scalar kernels)\n", GetMixKernelName(), mismatches);
+	
+	//Time our callbacks with different amounts of voices
+	const double budget = AUDIO_SAMPLES * 1000000.0 / AUDIO_FREQUENCY;
+	printf("Callback of %d frames at %dHz, budget %.1fus\n", AUDIO_SAMPLES, AUDIO_FREQUENCY, budget);
+	
+	const int voiceTests[] = {8, 32, 128};
+	for (int i = 0; i < 3; i++)
+	{
+		double scalarTime = TimeCallbacks(voiceTests[i], true);
+		double vectorTime = TimeCallbacks(voiceTests[i], false);
+		printf("%3d voices: scalar %8.2fus (%5.2f%%), %s %8.2fus (%5.2f%%), %.2fx\n", voiceTests[i], scalarTime, scalarTime * 100.0 / budget, GetMixKernelName(), vectorTime, vectorTime * 100.0 / budget, scalarTime / vectorTime);
+	}
+	
+	return mismatches != 0;
+}
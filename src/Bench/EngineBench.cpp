@@ -0,0 +1,441 @@
+//Engine microbenchmarks, times the engine's hot paths on GHZ1 and prints the results as JSON (to compare runs before and after a change)
+//Usage: enginebench [-samples <count>] [-filter <name>]
+//Run from the build directory like the game, the engine's logging is sent to stderr so stdout is only our results
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <chrono>
+
+#include "../Backend/Core.h"
+#include "../Filesystem.h"
+#include "../Render.h"
+#include "../Audio.h"
+#include "../Input.h"
+#include "../Mappings.h"
+#include "../Level.h"
+#include "../LevelCollision.h"
+#include "../Snapshot.h"
+#include "../Headless.h"
+#include "../Game.h"
+#include "../Error.h"
+
+//Constants
+#define BENCH_DEFAULT_SAMPLES	15
+#define BENCH_MAX_SAMPLES		0x100
+#define BENCH_MAX_RESULTS		0x20
+#define BENCH_NAME_LENGTH		0x40
+
+#define BENCH_LEVEL				LEVELID_GHZ1
+#define BENCH_CHARACTER			0	//Sonic alone
+#define BENCH_TEXTURE			"data/Sonic/Sonic.bmp"
+#define BENCH_MAPPINGS			"data/Sonic/Sonic.map"
+
+#define BENCH_RECORD_FRAMES		400	//Frames of the headless bot's input recorded (it dies at around frame 430 of GHZ1)
+#define BENCH_BLIT_FRAMES		3	//Frames whose render queues are recorded
+#define BENCH_CAMERA_POSITIONS	4	//Camera positions CheckObjectLoad is timed at (evenly across the level)
+
+static const unsigned int blitFrame[BENCH_BLIT_FRAMES] = {30, 200, 380};	//The first is during the title card
+
+//Benchmark function, runs the given amount of iterations and returns the time taken by them (not including any setup), returns true on error
+typedef bool (*BENCHFUNCTION)(unsigned int iterations, double *nanoseconds);
+
+//Benchmark result, times are in nanoseconds per iteration
+struct BENCHRESULT
+{
+	char name[BENCH_NAME_LENGTH];
+	unsigned int iterations;	//Iterations per sample
+	unsigned long items;		//Operations per iteration (cells, queue entries, frames)
+	double mean, variance, minimum, median, maximum;
+};
+
+//Options and results
+unsigned int samples = BENCH_DEFAULT_SAMPLES;
+const char *filter = nullptr;
+
+BENCHRESULT result[BENCH_MAX_RESULTS];
+unsigned int results = 0;
+
+//Recorded state, used by the benchmarks below
+SOFTWAREBUFFER *blitBuffer[BENCH_BLIT_FRAMES];
+uint32_t *blitOutput = nullptr;
+SNAPSHOT *recordSnapshot = nullptr;
+CONTROLMASK recordInput[BENCH_RECORD_FRAMES];
+unsigned int recordFrames = 0;
+int16_t cameraX = 0;
+int blitIndex = 0;
+
+//Kept so the compiler can't drop the work we're timing
+volatile int32_t benchSink;
+
+//Timer
+static inline double GetNanoseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+//Result functions
+static int CompareTime(const void *a, const void *b)
+{
+	double timeA = *(const double*)a, timeB = *(const double*)b;
+	return (timeA > timeB) - (timeA < timeB);
+}
+
+static bool RunBenchmark(const char *name, BENCHFUNCTION function, unsigned int iterations, unsigned long items)
+{
+	if (filter != nullptr && strstr(name, filter) == nullptr)
+		return false;
+	if (results >= BENCH_MAX_RESULTS)
+		return false;
+	
+	//Warm up once (this is also where anything first touched gets loaded), then time our samples
+	printf("Running %s...\n", name);
+	
+	double time[BENCH_MAX_SAMPLES];
+	if (function(iterations, &time[0]))
+		return true;
+	
+	for (unsigned int i = 0; i < samples; i++)
+	{
+		if (function(iterations, &time[i]))
+			return true;
+		time[i] /= iterations;
+	}
+	
+	//Get the mean and variance (of the samples, so it's over n - 1), then the minimum, median, and maximum
+	BENCHRESULT *entry = &result[results++];
+	snprintf(entry->name, BENCH_NAME_LENGTH, "%s", name);
+	entry->iterations = iterations;
+	entry->items = items;
+	
+	double sum = 0.0;
+	for (unsigned int i = 0; i < samples; i++)
+		sum += time[i];
+	entry->mean = sum / samples;
+	
+	double squares = 0.0;
+	for (unsigned int i = 0; i < samples; i++)
+		squares += (time[i] - entry->mean) * (time[i] - entry->mean);
+	entry->variance = (samples > 1) ? (squares / (samples - 1)) : 0.0;
+	
+	qsort(time, samples, sizeof(double), CompareTime);
+	entry->minimum = time[0];
+	entry->median = (samples & 1) ? time[samples / 2] : ((time[samples / 2 - 1] + time[samples / 2]) / 2.0);
+	entry->maximum = time[samples - 1];
+	
+	printf("%s: %.0fns (+/- %.0fns) per iteration\n", name, entry->mean, sqrt(entry->variance));
+	return false;
+}
+
+static void PrintResults(FILE *fp)
+{
+	fprintf(fp, "{\n\t\"level\": %d,\n\t\"samples\": %u,\n\t\"unit\": \"ns\",\n\t\"benchmarks\": [\n", BENCH_LEVEL, samples);
+	for (unsigned int i = 0; i < results; i++)
+	{
+		const BENCHRESULT *entry = &result[i];
+		fprintf(fp, "\t\t{\"name\": \"%s\", \"iterations\": %u, \"items\": %lu, \"mean\": %.1f, \"stddev\": %.1f, \"variance\": %.1f, \"min\": %.1f, \"median\": %.1f, \"max\": %.1f}%s\n",
+			entry->name, entry->iterations, entry->items, entry->mean, sqrt(entry->variance), entry->variance, entry->minimum, entry->median, entry->maximum, (i + 1 < results) ? "," : "");
+	}
+	fputs("\t]\n}\n", fp);
+}
+
+//Asset loading benchmarks
+static bool BenchTexture(unsigned int iterations, double *nanoseconds)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		TEXTURE *texture = new TEXTURE(BENCH_TEXTURE, false);
+		bool fail = texture->fail != nullptr;
+		delete texture;
+		if (fail)
+			return true;
+	}
+	*nanoseconds = GetNanoseconds(start);
+	return false;
+}
+
+static bool BenchMappings(unsigned int iterations, double *nanoseconds)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		MAPPINGS *mappings = new MAPPINGS(BENCH_MAPPINGS);
+		bool fail = mappings->fail != nullptr;
+		delete mappings;
+		if (fail)
+			return true;
+	}
+	*nanoseconds = GetNanoseconds(start);
+	return false;
+}
+
+static bool BenchLevel(unsigned int iterations, double *nanoseconds)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		LEVEL *level = new LEVEL(BENCH_LEVEL, GetCharacterSet(BENCH_CHARACTER));
+		bool fail = level->fail != nullptr;
+		delete level;
+		gEngine->level = nullptr;
+		if (fail)
+			return true;
+	}
+	*nanoseconds = GetNanoseconds(start);
+	return false;
+}
+
+//Collision benchmarks, probe the centre of every cell of the level's layout
+static bool SweepCollision(unsigned int iterations, double *nanoseconds, bool vertical)
+{
+	const LEVEL *level = gEngine->level;
+	int32_t total = 0;
+	uint8_t angle;
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		for (size_t y = 0; y < level->layout.height; y++)
+		{
+			for (size_t x = 0; x < level->layout.width; x++)
+			{
+				if (vertical)
+					total += GetCollisionV((int16_t)(x * 16 + 8), (int16_t)(y * 16 + 8), COLLISIONLAYER_NORMAL_TOP, false, &angle);
+				else
+					total += GetCollisionH((int16_t)(x * 16 + 8), (int16_t)(y * 16 + 8), COLLISIONLAYER_NORMAL_LRB, false, &angle);
+			}
+		}
+	}
+	*nanoseconds = GetNanoseconds(start);
+	
+	benchSink = total;
+	return false;
+}
+
+static bool BenchCollisionH(unsigned int iterations, double *nanoseconds) { return SweepCollision(iterations, nanoseconds, false); }
+static bool BenchCollisionV(unsigned int iterations, double *nanoseconds) { return SweepCollision(iterations, nanoseconds, true); }
+
+//Object load benchmark, checks the object loads with the camera at cameraX (objects coming into range are loaded in the warm-up)
+static bool BenchCheckObjectLoad(unsigned int iterations, double *nanoseconds)
+{
+	gEngine->level->camera->xPos = cameraX;
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+		gEngine->level->CheckObjectLoad();
+	*nanoseconds = GetNanoseconds(start);
+	return false;
+}
+
+//Blit benchmark, blits the render queue recorded on blitFrame[blitIndex] to a 32-bit buffer
+static bool BenchBlit(unsigned int iterations, double *nanoseconds)
+{
+	SOFTWAREBUFFER *buffer = blitBuffer[blitIndex];
+	const COLOUR *backgroundColour = &gEngine->level->background->texture->loadedPalette->colour[0];
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < iterations; i++)
+		buffer->BlitQueue<uint32_t>(backgroundColour, blitOutput, buffer->width);
+	*nanoseconds = GetNanoseconds(start);
+	
+	benchSink = (int32_t)blitOutput[buffer->width * buffer->height / 2];
+	return false;
+}
+
+//Player benchmark, restores the level to just after the title card, then updates the player with the recorded input (the rest of the level isn't updated)
+static bool BenchPlayerUpdate(unsigned int iterations, double *nanoseconds)
+{
+	*nanoseconds = 0.0;
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		if (recordSnapshot->Restore())
+			return true;
+		
+		PLAYER *player = gEngine->level->playerList[0];
+		CONTROLLER *controller = &gEngine->controller[player->controller];
+		
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (unsigned int v = 0; v < recordFrames; v++)
+		{
+			controller->SetHeld(recordInput[v]);
+			player->Update();
+		}
+		*nanoseconds += GetNanoseconds(start);
+		
+		benchSink = player->xLong;
+	}
+	return false;
+}
+
+//Recording, plays the level with the headless bot's input, recording its input from once the title card's gone, and the render queues of our blit frames
+static bool Record()
+{
+	LEVEL *level = gEngine->level;
+	SOFTWAREBUFFER *discardBuffer = gEngine->softwareBuffer;
+	unsigned int jumpTimer = 0;
+	recordFrames = 0;
+	
+	for (unsigned int frame = 0; frame < BENCH_RECORD_FRAMES; frame++)
+	{
+		//Save our snapshot once the title card's gone
+		if (!level->titleCard->activeLock && recordSnapshot->level == nullptr && recordSnapshot->Save())
+			return true;
+		
+		//Get our input
+		CONTROLMASK held = GetBotInput(level->playerList[0], frame, &jumpTimer);
+		for (size_t i = 0; i < CONTROLLERS; i++)
+			gEngine->controller[i].SetHeld((i == level->playerList[0]->controller) ? held : CONTROLMASK{});
+		if (recordSnapshot->level != nullptr)
+			recordInput[recordFrames++] = held;
+		
+		//Draw into a recorded buffer if this is one of our blit frames
+		for (int i = 0; i < BENCH_BLIT_FRAMES; i++)
+			if (frame == blitFrame[i])
+				gEngine->softwareBuffer = blitBuffer[i];
+		
+		//Run our frame
+		if (level->Update())
+			return true;
+		
+		if (level->fading)
+		{
+			if (!level->isFadingIn)
+				return Error("The level ended while recording");
+			level->fading = !level->UpdateFade();
+		}
+		
+		level->Draw();
+		gEngine->softwareBuffer = discardBuffer;
+	}
+	return false;
+}
+
+//Benchmarks
+static bool RunBenchmarks()
+{
+	char name[BENCH_NAME_LENGTH];
+	
+	//Asset loading and level construction
+	if (RunBenchmark("TEXTURE " BENCH_TEXTURE, BenchTexture, 20, 1) ||
+		RunBenchmark("MAPPINGS " BENCH_MAPPINGS, BenchMappings, 20, 1) ||
+		RunBenchmark("LEVEL construction", BenchLevel, 1, 1))
+		return true;
+	
+	//Load our level
+	LEVEL *level = gEngine->level = new LEVEL(BENCH_LEVEL, GetCharacterSet(BENCH_CHARACTER));
+	if (level->fail != nullptr)
+		return true;
+	level->SetFade(true, false);
+	
+	//Collision across every cell
+	unsigned long cells = (unsigned long)level->layout.width * level->layout.height;
+	if (RunBenchmark("GetCollisionH sweep", BenchCollisionH, 4, cells) ||
+		RunBenchmark("GetCollisionV sweep", BenchCollisionV, 4, cells))
+		return true;
+	
+	//Object loads at camera positions across the level (this loads objects, so reload the level after)
+	for (int i = 0; i < BENCH_CAMERA_POSITIONS; i++)
+	{
+		cameraX = (int16_t)(level->layout.width * 16 * i / BENCH_CAMERA_POSITIONS);
+		snprintf(name, sizeof(name), "CheckObjectLoad x=%d", cameraX);
+		if (RunBenchmark(name, BenchCheckObjectLoad, 1000, level->objectLoadList.size()))
+			return true;
+	}
+	
+	delete level;
+	level = gEngine->level = new LEVEL(BENCH_LEVEL, GetCharacterSet(BENCH_CHARACTER));
+	if (level->fail != nullptr)
+		return true;
+	level->SetFade(true, false);
+	
+	//Record our input and render queues
+	for (int i = 0; i < BENCH_BLIT_FRAMES; i++)
+		blitBuffer[i] = new SOFTWAREBUFFER(gEngine->renderSpec.width, gEngine->renderSpec.height);
+	blitOutput = new uint32_t[gEngine->renderSpec.width * gEngine->renderSpec.height];
+	recordSnapshot = new SNAPSHOT();
+	
+	if (Record())
+		return true;
+	
+	//Blitting our recorded render queues
+	for (blitIndex = 0; blitIndex < BENCH_BLIT_FRAMES; blitIndex++)
+	{
+		unsigned long entries = 0;
+		for (int i = 0; i < RENDERLAYERS; i++)
+			entries += blitBuffer[blitIndex]->queue[i].size();
+		
+		snprintf(name, sizeof(name), "BlitQueue<uint32_t> frame %u", blitFrame[blitIndex]);
+		if (RunBenchmark(name, BenchBlit, 50, entries))
+			return true;
+	}
+	
+	//Player updates with our recorded input
+	if (RunBenchmark("PLAYER::Update replay", BenchPlayerUpdate, 1, recordFrames))
+		return true;
+	return false;
+}
+
+int main(int argc, char *argv[])
+{
+	//Get our options
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-samples") == 0 && i + 1 < argc)
+			samples = (unsigned int)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "-filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else
+			fprintf(stderr, "Unknown argument %s\n", argv[i]);
+	}
+	
+	if (samples < 1)
+		samples = 1;
+	if (samples > BENCH_MAX_SAMPLES)
+		samples = BENCH_MAX_SAMPLES;
+	
+	//Keep stdout for our results, and send the engine's logging (and our progress) to stderr
+	FILE *resultFile = fdopen(dup(STDOUT_FILENO), "w");
+	dup2(STDERR_FILENO, STDOUT_FILENO);
+	
+	//Create our engine context, then initialize everything like the game does (nothing's queued to the main software buffer, or played)
+	gEngine = new ENGINE();
+	
+	bool error = false;
+	if ((error = (Backend_InitCore() || InitializePath() || InitializeRender() || InitializeAudio() || InitializeInput())) == false)
+	{
+		gEngine->softwareBuffer->discard = true;
+		gEngine->mute = true;
+		error = RunBenchmarks();
+	}
+	
+	//Free everything
+	delete recordSnapshot;
+	delete gEngine->level;
+	gEngine->level = nullptr;
+	for (int i = 0; i < BENCH_BLIT_FRAMES; i++)
+		delete blitBuffer[i];
+	delete[] blitOutput;
+	
+	QuitInput();
+	QuitAudio();
+	QuitRender();
+	QuitPath();
+	Backend_QuitCore();
+	
+	delete gEngine;
+	gEngine = nullptr;
+	
+	//Print our results
+	if (error)
+	{
+		printf("Benchmarks failed\n");
+		fclose(resultFile);
+		return -1;
+	}
+	
+	PrintResults(resultFile);
+	fclose(resultFile);
+	return 0;
+}
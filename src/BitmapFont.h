@@ -1,6 +1,7 @@
 #pragma once
-#include <string>
+#include <stddef.h>
 #include "Render.h"
+#include "Engine.h"
 
 class BITMAPFONT
 {
@@ -14,10 +15,10 @@ class BITMAPFONT
 		BITMAPFONT(TEXTURE *useBitmap, unsigned int useX0, unsigned int useY0, unsigned int useCw, unsigned int useCh, unsigned int useSx, unsigned int useSy, unsigned int useCpl, unsigned int useTlc) : bitmap(useBitmap), x0(useX0), y0(useY0), cw(useCw), ch(useCh), sx(useSx), sy(useSy), cpl(useCpl), tlc(useTlc) { return; }
 		~BITMAPFONT() { return; }
 		
-		inline void DrawString(std::string string, size_t layer, int x, int y)
+		inline void DrawString(const char *string, size_t layer, int x, int y)
 		{
 			//Draw every character of the string according to its size
-			for(size_t i = 0; i < string.size(); i++)
+			for(size_t i = 0; string[i] != '\0'; i++)
 			{
 				//Get our rect according to this character (from the top left of the font area, using size, seperation, and character info)
 				RECT thisCharRect = {
@@ -29,7 +30,7 @@ class BITMAPFONT
 				
 				//Draw character and draw at next position
 				if ((unsigned)string[i] >= tlc)
-					gSoftwareBuffer->DrawTexture(bitmap, bitmap->loadedPalette, &thisCharRect, layer, x, y, false, false);
+					gEngine->softwareBuffer->DrawTexture(bitmap, bitmap->loadedPalette, &thisCharRect, layer, x, y, false, false);
 				x += cw;
 			}
 		}
@@ -30,18 +30,18 @@
 CAMERA::CAMERA(PLAYER *trackPlayer)
 {
 	//Move to our given player
-	xPos = trackPlayer->x.pos - (gRenderSpec.width / 2);
-	yPos = trackPlayer->y.pos - (gRenderSpec.height / 2 + CAMERA_VSCROLL_OFFSET);
+	xPos = trackPlayer->x.pos - (gEngine->renderSpec.width / 2);
+	yPos = trackPlayer->y.pos - (gEngine->renderSpec.height / 2 + CAMERA_VSCROLL_OFFSET);
 	
 	//Keep inside level boundaries
-	if (xPos < gLevel->leftBoundary)
-		xPos = gLevel->leftBoundary;
-	if (xPos + gRenderSpec.width > gLevel->rightBoundary)
-		xPos = gLevel->rightBoundary - gRenderSpec.width;
-	if (yPos < gLevel->topBoundary)
-		yPos = gLevel->topBoundary;
-	if (yPos + gRenderSpec.height > gLevel->bottomBoundary)
-		yPos = gLevel->bottomBoundary - gRenderSpec.height;
+	if (xPos < gEngine->level->leftBoundary)
+		xPos = gEngine->level->leftBoundary;
+	if (xPos + gEngine->renderSpec.width > gEngine->level->rightBoundary)
+		xPos = gEngine->level->rightBoundary - gEngine->renderSpec.width;
+	if (yPos < gEngine->level->topBoundary)
+		yPos = gEngine->level->topBoundary;
+	if (yPos + gEngine->renderSpec.height > gEngine->level->bottomBoundary)
+		yPos = gEngine->level->bottomBoundary - gEngine->renderSpec.height;
 	return;
 }
 
@@ -153,7 +153,7 @@ void CAMERA::Track(PLAYER *trackPlayer)
 	int16_t hScrollOffset = trackX - xPos - xPan;
 	hScrollOffset += xShake;
 	
-	if ((hScrollOffset -= (gRenderSpec.width / 2 + CAMERA_HSCROLL_LEFT)) < 0) //Scroll to the left
+	if ((hScrollOffset -= (gEngine->renderSpec.width / 2 + CAMERA_HSCROLL_LEFT)) < 0) //Scroll to the left
 	{
 		//Cap our scrolling to 16 pixels per frame
 		if (hScrollOffset <= -16)
@@ -161,8 +161,8 @@ void CAMERA::Track(PLAYER *trackPlayer)
 		
 		//Scroll and keep within level boundaries
 		xPos += hScrollOffset;
-		if (xPos < gLevel->leftBoundary)
-			xPos = gLevel->leftBoundary + mmax(xShake, 0);
+		if (xPos < gEngine->level->leftBoundary)
+			xPos = gEngine->level->leftBoundary + mmax(xShake, 0);
 	}
 	else if ((hScrollOffset -= CAMERA_HSCROLL_SIZE) >= 0) //Scroll to the right
 	{
@@ -172,12 +172,12 @@ void CAMERA::Track(PLAYER *trackPlayer)
 		
 		//Scroll and keep within level boundaries
 		xPos += hScrollOffset;
-		if ((xPos + gRenderSpec.width) > gLevel->rightBoundary)
-			xPos = gLevel->rightBoundary - gRenderSpec.width + mmin(xShake, 0);
+		if ((xPos + gEngine->renderSpec.width) > gEngine->level->rightBoundary)
+			xPos = gEngine->level->rightBoundary - gEngine->renderSpec.width + mmin(xShake, 0);
 	}
 	
 	//Scroll vertically to the player
-	int16_t vScrollOffset = trackPlayer->y.pos - yPos - (gRenderSpec.height / 2 + CAMERA_VSCROLL_OFFSET) - lookPan;
+	int16_t vScrollOffset = trackPlayer->y.pos - yPos - (gEngine->renderSpec.height / 2 + CAMERA_VSCROLL_OFFSET) - lookPan;
 	
 	if (trackPlayer->status.reverseGravity)
 		vScrollOffset += yShift;
@@ -217,8 +217,8 @@ void CAMERA::Track(PLAYER *trackPlayer)
 		
 		//Scroll and keep within level boundaries
 		yPos += vScrollOffset;
-		if (yPos < gLevel->topBoundary)
-			yPos = gLevel->topBoundary + mmax(yShake, 0);
+		if (yPos < gEngine->level->topBoundary)
+			yPos = gEngine->level->topBoundary + mmax(yShake, 0);
 	}
 	else if (vScrollOffset > 0)
 	{
@@ -228,7 +228,7 @@ void CAMERA::Track(PLAYER *trackPlayer)
 		
 		//Keep within level boundaries
 		yPos += vScrollOffset;
-		if (yPos + gRenderSpec.height > gLevel->bottomBoundary)
-			yPos = gLevel->bottomBoundary - gRenderSpec.height + mmin(yShake, 0);
+		if (yPos + gEngine->renderSpec.height > gEngine->level->bottomBoundary)
+			yPos = gEngine->level->bottomBoundary - gEngine->renderSpec.height + mmin(yShake, 0);
 	}
 }
@@ -0,0 +1,79 @@
+#pragma once
+#include <stdint.h>
+
+#include "Render.h"
+#include "Input.h"
+#include "LevelSpecific.h"
+
+//Declare the level, replay, and asset job classes
+class LEVEL;
+class REPLAY;
+class ASSETJOBS;
+class STATEHASH;
+
+//Game modes
+enum GAMEMODE
+{
+	GAMEMODE_SPLASH,		//"Sega" screen, but can be used for general splash
+	GAMEMODE_TITLE,			//Title screen
+	GAMEMODE_DEMO,			//Identical to game, but uses demo inputs
+	GAMEMODE_GAME,			//Gameplay
+	GAMEMODE_SPECIALSTAGE,	//Special stage
+	GAMEMODE_CONTINUE,		//Continue screen
+	GAMEMODE_ENDING,		//Ending sequence
+	GAMEMODE_CREDITS,		//Credits sequence
+};
+
+//Score, ring, and life rewards and caps
+#define SCORE_REWARD 50000
+#define RINGS_REWARD 100
+
+#define RINGS_CAP 999
+#define LIVES_CAP 99
+
+#define INITIAL_LIVES 3
+
+//Engine context, everything a running game changes
+//Each thread binds the context it's running, so independent simulations can run in parallel in one process, only sharing read-only state (the level table, data archive, pixel format, and settings)
+class ENGINE
+{
+	public:
+		//Render specification and software buffer
+		RENDERSPEC renderSpec = {426, 240, 2, 60.001, false, false};
+		SOFTWAREBUFFER *softwareBuffer = nullptr;
+		
+		//Controllers, and the replay being recorded or played (nullptr if none)
+		CONTROLLER controller[CONTROLLERS];
+		REPLAY *replay = nullptr;
+		
+		//State hash log, nullptr if not logging
+		STATEHASH *stateHash = nullptr;
+		
+		//Score, time, rings, and lives
+		unsigned int score = 0;
+		unsigned int nextScoreReward = SCORE_REWARD;
+		unsigned int time = 0;
+		unsigned int rings = 0;
+		unsigned int nextRingReward = RINGS_REWARD;
+		unsigned int lives = INITIAL_LIVES;
+		
+		//Gamemode and level state
+		GAMEMODE gameMode = GAMEMODE_SPLASH;
+		LEVEL *level = nullptr;
+		ASSETJOBS *assetJobs = nullptr;	//Asset job system of the level being loaded, nullptr if assets should be decoded on the spot
+		
+		int loadLevel = 0;
+		int loadCharacter = 0;
+		
+		//Random number seed (0 is replaced with the original's initial seed on first use)
+		uint32_t randomSeed = 0;
+		
+		//Palette cycle and background scroll state of level specific code
+		LEVELSPECIFICSTATE levelSpecific;
+		
+		//When set, sounds and music aren't sent to the mixer (for simulations that aren't being presented)
+		bool mute = false;
+};
+
+//Engine context bound to this thread
+extern thread_local ENGINE *gEngine;
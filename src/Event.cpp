@@ -1,10 +1,14 @@
 #include "Backend/Event.h"
 #include "Input.h"
+#include "Profiler.h"
 
 bool HandleEvents()
 {
-	//Handle events on the backend
+	PROFILE_ZONE("HandleEvents");
+	
+	//Handle events on the backend, and dump our profile if asked to
 	bool exit = Backend_HandleEvents();
 	UpdateInput();
+	UpdateProfiler();
 	return exit;
 }
@@ -1,13 +1,250 @@
+#include <string.h>
 #include <string>
 #include "Backend/Filesystem.h"
 #include "Filesystem.h"
+#include "Archive.h"
+#include "LZ4.h"
 #include "GameConstants.h"
 #include "Error.h"
+#include "MathUtil.h"
 #include "Log.h"
 
+#ifdef FS_FILE_MMAP
+	#include <sys/mman.h>
+#endif
+
+#if defined(__SSSE3__)
+	#include <tmmintrin.h>
+	#define FS_FILE_SSE
+#elif defined(__SSE2__) || defined(_M_X64)
+	#include <emmintrin.h>
+	#define FS_FILE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define FS_FILE_NEON
+#endif
+
 std::string gBasePath;
 std::string gPrefPath;
 
+//File class
+void FS_FILE::Close()
+{
+	//Close our opened file and free our data
+	if (fp != nullptr)
+		fclose(fp);
+	
+	switch (dataType)
+	{
+		case FS_FILE_DATA_ALLOCATED:
+			delete[] data;
+			break;
+	#ifdef FS_FILE_MMAP
+		case FS_FILE_DATA_MAPPED:
+			munmap((void*)data, dataSize);
+			break;
+	#endif
+		default:
+			break;
+	}
+	
+	fail = nullptr;
+	fp = nullptr;
+	inMemory = false;
+	dataType = FS_FILE_DATA_NONE;
+	data = nullptr;
+	dataSize = dataPosition = 0;
+}
+
+bool FS_FILE::OpenFromArchive(const char *name)
+{
+	if (gArchive == nullptr)
+		return false;
+	
+	//Get our path relative to the base path, and find it in the archive
+	size_t basePathLength = gBasePath.length();
+	if (strncmp(name, gBasePath.c_str(), basePathLength) != 0)
+		return false;
+	
+	const ARCHIVEENTRY *entry = gArchive->Find(name + basePathLength);
+	if (entry == nullptr)
+		return false;
+	
+	//Use the data straight from the archive, or decompress it
+	dataSize = entry->size;
+	dataPosition = 0;
+	inMemory = true;
+	
+	if (entry->flags & ARCHIVEFLAG_LZ4)
+	{
+		uint8_t *buffer = new uint8_t[dataSize];
+		data = buffer;
+		dataType = FS_FILE_DATA_ALLOCATED;
+		
+		if (LZ4_Decompress(gArchive->data + entry->offset, entry->storedSize, buffer, dataSize) != dataSize)
+			fail = "Archive entry failed to decompress";
+	}
+	else
+	{
+		data = gArchive->data + entry->offset;
+		dataType = FS_FILE_DATA_ARCHIVE;
+	}
+	
+	return true;
+}
+
+void FS_FILE::LoadToMemory()
+{
+	//Get our size once
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (size < 0)
+	{
+		fail = "Failed to get file size";
+		return;
+	}
+	
+	dataSize = (size_t)size;
+	dataPosition = 0;
+	inMemory = true;
+	
+	if (dataSize != 0)
+	{
+		//Map our file, or read it in one go if we can't
+		#ifdef FS_FILE_MMAP
+			void *map = mmap(nullptr, dataSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+			if (map != MAP_FAILED)
+			{
+				data = (const uint8_t*)map;
+				dataType = FS_FILE_DATA_MAPPED;
+			}
+		#endif
+		
+		if (data == nullptr)
+		{
+			uint8_t *buffer = new uint8_t[dataSize];
+			if (fread(buffer, 1, dataSize, fp) != dataSize)
+			{
+				delete[] buffer;
+				fail = "Failed to read file";
+				return;
+			}
+			data = buffer;
+			dataType = FS_FILE_DATA_ALLOCATED;
+		}
+	}
+	
+	//We don't need the file anymore
+	fclose(fp);
+	fp = nullptr;
+}
+
+//Read functions
+size_t FS_FILE::Read(void *ptr, size_t size, size_t maxnum)
+{
+	//Copy as many whole elements as we have
+	if (!inMemory)
+		return fread(ptr, size, maxnum, fp);
+	
+	size_t num = (size == 0) ? 0 : mmin(maxnum, (dataSize - dataPosition) / size);
+	if (num != 0)
+		memcpy(ptr, GetSpan(num * size), num * size);
+	return num;
+}
+
+//Bulk read functions
+static void SwapBytes16(uint16_t *out, const uint8_t *in, size_t count)
+{
+	//Swap the bytes of each 16-bit value (8 values at a time)
+	size_t i = 0;
+	
+	#if defined(FS_FILE_SSE)
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i value = _mm_loadu_si128((const __m128i*)(in + i * 2));
+			_mm_storeu_si128((__m128i*)(out + i), _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8)));
+		}
+	#elif defined(FS_FILE_NEON)
+		for (; i + 8 <= count; i += 8)
+			vst1q_u8((uint8_t*)(out + i), vrev16q_u8(vld1q_u8(in + i * 2)));
+	#endif
+	
+	for (; i < count; i++)
+		out[i] = ((uint16_t)in[i * 2 + 0] << 8) | in[i * 2 + 1];
+}
+
+static void SwapBytes32(uint32_t *out, const uint8_t *in, size_t count)
+{
+	//Reverse the bytes of each 32-bit value (4 values at a time)
+	size_t i = 0;
+	
+	#if defined(__SSSE3__)
+		const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_si128((__m128i*)(out + i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i * 4)), shuffle));
+	#elif defined(FS_FILE_SSE)
+		for (; i + 4 <= count; i += 4)
+		{
+			//Swap the bytes of each 16-bit half, then swap the halves
+			__m128i value = _mm_loadu_si128((const __m128i*)(in + i * 4));
+			value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+			_mm_storeu_si128((__m128i*)(out + i), _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0xB1), 0xB1));
+		}
+	#elif defined(FS_FILE_NEON)
+		for (; i + 4 <= count; i += 4)
+			vst1q_u8((uint8_t*)(out + i), vrev32q_u8(vld1q_u8(in + i * 4)));
+	#endif
+	
+	for (; i < count; i++)
+		out[i] = ((uint32_t)in[i * 4 + 0] << 24) | ((uint32_t)in[i * 4 + 1] << 16) | ((uint32_t)in[i * 4 + 2] << 8) | in[i * 4 + 3];
+}
+
+static size_t ReadArray(FS_FILE *file, void *out, size_t count, size_t size, bool swap)
+{
+	//Get as many whole values as we have, zeroing the rest
+	size_t num = mmin(count, (file->GetSize() - file->Tell()) / size);
+	const uint8_t *in = file->GetSpan(num * size);
+	memset((uint8_t*)out + num * size, 0, (count - num) * size);
+	if (in == nullptr)
+		return 0;
+	
+	//Copy our values, swapping their bytes if they're not in our native order
+	if (!swap)
+		memcpy(out, in, num * size);
+	else if (size == 2)
+		SwapBytes16((uint16_t*)out, in, num);
+	else
+		SwapBytes32((uint32_t*)out, in, num);
+	return num;
+}
+
+#ifdef ENDIAN_BIG
+	size_t FS_FILE::ReadBE16(uint16_t *out, size_t count) { return ReadArray(this, out, count, 2, false); }
+	size_t FS_FILE::ReadBE32(uint32_t *out, size_t count) { return ReadArray(this, out, count, 4, false); }
+	size_t FS_FILE::ReadLE16(uint16_t *out, size_t count) { return ReadArray(this, out, count, 2, true); }
+	size_t FS_FILE::ReadLE32(uint32_t *out, size_t count) { return ReadArray(this, out, count, 4, true); }
+#else
+	size_t FS_FILE::ReadBE16(uint16_t *out, size_t count) { return ReadArray(this, out, count, 2, true); }
+	size_t FS_FILE::ReadBE32(uint32_t *out, size_t count) { return ReadArray(this, out, count, 4, true); }
+	size_t FS_FILE::ReadLE16(uint16_t *out, size_t count) { return ReadArray(this, out, count, 2, false); }
+	size_t FS_FILE::ReadLE32(uint32_t *out, size_t count) { return ReadArray(this, out, count, 4, false); }
+#endif
+
+//Seek function
+int FS_FILE::Seek(long int offset, int origin)
+{
+	if (!inMemory)
+		return fseek(fp, offset, origin);
+	
+	//Get our new position, failing if it's out of the file
+	long int base = (origin == SEEK_SET) ? 0 : ((origin == SEEK_CUR) ? (long int)dataPosition : (long int)dataSize);
+	if (base + offset < 0 || base + offset > (long int)dataSize)
+		return -1;
+	dataPosition = (size_t)(base + offset);
+	return 0;
+}
+
 //Sub-system functions
 bool InitializePath()
 {
@@ -15,12 +252,29 @@ bool InitializePath()
 	if (Backend_GetPaths(&gBasePath, &gPrefPath))
 		return Error("Failed to initialize paths");
 	LOG(("Success!\n"));
+	
+	//Mount our archive if we have one, otherwise we just use loose files
+	LOG(("Mounting archive... "));
+	ARCHIVE *archive = new ARCHIVE(gBasePath + ARCHIVE_NAME);
+	if (archive->fail != nullptr)
+	{
+		LOG(("Not mounted (%s), using loose files\n", archive->fail));
+		delete archive;
+	}
+	else
+	{
+		gArchive = archive;
+		LOG(("Success! (%d entries)\n", (int)archive->entries));
+	}
 	return false;
 }
 
 void QuitPath()
 {
 	LOG(("Ending paths... "));
-	//...
+	
+	//Unmount our archive
+	delete gArchive;
+	gArchive = nullptr;
 	LOG(("Success!\n"));
 }
@@ -2,6 +2,7 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <string>
 
 //Path globals
@@ -14,27 +15,57 @@ extern std::string gPrefPath;
 	#include <stringapiset.h>
 #endif
 
+//Files opened for reading are memory mapped where we can, otherwise they're read into memory in one go
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(SWITCH)
+	#define FS_FILE_MMAP
+#endif
+
+//Files in the mounted archive (see Archive.h) are read from it rather than opened
+//#define FS_LOOSE_OVERRIDE	//When set, loose files are used over the files in the archive (for development, costs an open attempt for every file)
+
+enum FS_FILE_DATA
+{
+	FS_FILE_DATA_NONE,		//Not in memory (opened for writing)
+	FS_FILE_DATA_ALLOCATED,	//Read into memory we allocated
+	FS_FILE_DATA_MAPPED,	//Memory mapped
+	FS_FILE_DATA_ARCHIVE,	//Points straight into the mounted archive
+};
+
 class FS_FILE
 {
 	public:
 		const char *fail = nullptr;
-		FILE *fp = nullptr;
+		FILE *fp = nullptr;	//Only used when writing, files opened for reading are closed once they're in memory
+		
+	private:
+		//Read file data
+		bool inMemory = false;
+		FS_FILE_DATA dataType = FS_FILE_DATA_NONE;
+		const uint8_t *data = nullptr;
+		size_t dataSize = 0, dataPosition = 0;
+		
 	public:
-		//Constructor - Open file
+		//Constructor - Open file (or not, to be opened with OpenFile later)
+		FS_FILE() {}
 		FS_FILE(const char *name, const char *mode) { OpenFile(name, mode); }
 		FS_FILE(std::string name, const char *mode) { OpenFile(name.c_str(), mode); }
 		
 		//Destructor - Close file
-		~FS_FILE()
-		{
-			if (fp != nullptr)
-			//Close our opened file
-			fclose(fp);
-		}
+		~FS_FILE() { Close(); }
+		
+		//Close function, so the file can be opened again
+		void Close();
 		
 		//File open function
 		inline void OpenFile(const char *name, const char *mode)
 		{
+			//If we're only reading, use our mounted archive's copy if it has one
+			bool reading = (mode[0] == 'r' && strchr(mode, '+') == nullptr);
+			#ifndef FS_LOOSE_OVERRIDE
+				if (reading && OpenFromArchive(name))
+					return;
+			#endif
+			
 			//Open the given file
 			#ifdef WINDOWS
 				//Convert name to UTF-16
@@ -58,63 +89,97 @@ class FS_FILE
 			
 			//Check for errors
 			if (fp == nullptr)
+			{
+				#ifdef FS_LOOSE_OVERRIDE
+					if (reading && OpenFromArchive(name))
+						return;
+				#endif
 				fail = "Failed to open file";
+				return;
+			}
+			
+			//If we're only reading, bring the whole file into memory
+			if (reading)
+				LoadToMemory();
+		}
+		
+		//Read functions (reading past the end of the file gives zeroes)
+		//Zero-copy span, returns a pointer to the next given amount of bytes and skips past them, or nullptr if there aren't enough left
+		inline const uint8_t *GetSpan(size_t bytes)
+		{
+			if (!inMemory || bytes > dataSize - dataPosition)
+				return nullptr;
+			const uint8_t *span = data + dataPosition;
+			dataPosition += bytes;
+			return span;
 		}
 		
-		//Read functions
 		//Any size
-		inline size_t Read(void *ptr, size_t size, size_t maxnum)	{ return fread(ptr, size, maxnum, fp); }
+		size_t Read(void *ptr, size_t size, size_t maxnum);
 		
 		//One byte
 		inline uint8_t	ReadU8()
 		{
-			return fgetc(fp);
+			const uint8_t *bytes = GetSpan(1);
+			return (bytes != nullptr) ? bytes[0] : 0;
 		}
 		
 		//Multi-byte big endian
 		inline uint16_t	ReadBE16()
 		{
-			uint8_t bytes[2];
-			Read(bytes, 1, 2);
+			const uint8_t *bytes = GetSpan(2);
+			if (bytes == nullptr)
+				return 0;
 			return ((uint16_t)bytes[0] << 8) | bytes[1];
 		}
 		
 		inline uint32_t	ReadBE32()
 		{
-			uint8_t bytes[4];
-			Read(bytes, 1, 4);
+			const uint8_t *bytes = GetSpan(4);
+			if (bytes == nullptr)
+				return 0;
 			return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint16_t)bytes[2] << 8) | bytes[3];
 		}
 		
 		inline uint64_t	ReadBE64()
 		{
-			uint8_t bytes[8];
-			Read(bytes, 1, 8);
-			return ((uint64_t)bytes[0] << 56) | ((uint64_t)bytes[1] << 48) | ((uint64_t)bytes[2] << 40) | ((uint64_t)bytes[3] << 32) | ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint16_t)bytes[2] << 8) | bytes[3];
+			const uint8_t *bytes = GetSpan(8);
+			if (bytes == nullptr)
+				return 0;
+			return ((uint64_t)bytes[0] << 56) | ((uint64_t)bytes[1] << 48) | ((uint64_t)bytes[2] << 40) | ((uint64_t)bytes[3] << 32) | ((uint32_t)bytes[4] << 24) | ((uint32_t)bytes[5] << 16) | ((uint16_t)bytes[6] << 8) | bytes[7];
 		}
 		
 		//Multi-byte little endian
 		inline uint16_t	ReadLE16()
 		{
-			uint8_t bytes[2];
-			Read(bytes, 1, 2);
+			const uint8_t *bytes = GetSpan(2);
+			if (bytes == nullptr)
+				return 0;
 			return ((uint16_t)bytes[1] << 8) | bytes[0];
 		}
 		
 		inline uint32_t	ReadLE32()
 		{
-			uint8_t bytes[4];
-			Read(bytes, 1, 4);
+			const uint8_t *bytes = GetSpan(4);
+			if (bytes == nullptr)
+				return 0;
 			return ((uint32_t)bytes[3] << 24) | ((uint32_t)bytes[2] << 16) | ((uint16_t)bytes[1] << 8) | bytes[0];
 		}
 		
 		inline uint64_t	ReadLE64()
 		{
-			uint8_t bytes[8];
-			Read(bytes, 1, 8);
+			const uint8_t *bytes = GetSpan(8);
+			if (bytes == nullptr)
+				return 0;
 			return ((uint64_t)bytes[7] << 56) | ((uint64_t)bytes[6] << 48) | ((uint64_t)bytes[5] << 40) | ((uint64_t)bytes[4] << 32) | ((uint32_t)bytes[3] << 24) | ((uint32_t)bytes[2] << 16) | ((uint16_t)bytes[1] << 8) | bytes[0];
 		}
 		
+		//Bulk reads, reads the given amount of values into the given array (returns how many were read, the rest are zeroed)
+		size_t ReadBE16(uint16_t *out, size_t count);
+		size_t ReadBE32(uint32_t *out, size_t count);
+		size_t ReadLE16(uint16_t *out, size_t count);
+		size_t ReadLE32(uint32_t *out, size_t count);
+		
 		//Write functions
 		//Any size
 		inline size_t Write(const void *ptr, size_t size, size_t maxnum)	{ return fwrite(ptr, size, maxnum, fp); }
@@ -164,11 +229,15 @@ class FS_FILE
 		}
 		
 		//Seek and tell functions
-		inline int Seek(long int offset, int origin)	{ return fseek(fp, offset, origin); }
-		inline size_t Tell()							{ return ftell(fp); }
+		int Seek(long int offset, int origin);
+		inline size_t Tell()	{ return inMemory ? dataPosition : ftell(fp); }
+		
+		//Size function (cached when reading)
+		inline size_t GetSize()	{ if (inMemory) return dataSize; size_t origP = Tell(); Seek(0, SEEK_END); size_t size = Tell(); Seek(origP, SEEK_SET); return size; }
 		
-		//Size function
-		inline size_t GetSize()	{ size_t origP = Tell(); Seek(0, SEEK_END); size_t size = Tell(); Seek(origP, SEEK_SET); return size; }
+	private:
+		bool OpenFromArchive(const char *name);
+		void LoadToMemory();
 };
 
 //Sub-system functions
@@ -1,3 +1,4 @@
+#include <stdlib.h>
 #include "Game.h"
 #include "GameConstants.h"
 #include "Error.h"
@@ -7,11 +8,14 @@
 #include "Render.h"
 #include "Fade.h"
 #include "Level.h"
-
-LEVEL *gLevel;
-
-int gGameLoadLevel = 0;
-int gGameLoadCharacter = 0;
+#include "HotReload.h"
+#include "Replay.h"
+#include "StateHash.h"
+#include "Snapshot.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+#include "MathUtil.h"
+#include "Filesystem.h"
 
 static const char *sonicAndTails[] =	{"data/Sonic/Sonic", "data/Sonic/Sonic", nullptr};
 static const char *sonicOnly[] =		{"data/Sonic/Sonic", nullptr};
@@ -23,63 +27,193 @@ static const char **characterSetList[] = {
 	sonicOnly,
 	tailsOnly,
 	knucklesOnly,
+	sonicAndTails,	//Two players, for netplay
+};
+
+const char **GetCharacterSet(int character)
+{
+	//Get the players of the given character set
+	if (character < 0 || character >= (int)(sizeof(characterSetList) / sizeof(characterSetList[0])))
+		return nullptr;
+	return characterSetList[character];
+}
+
+//Demo replays, played in turn each time we enter demo mode
+static const char *demoReplay[] = {
+	"data/Demo/Demo1.rep",
+	nullptr,
 };
 
+static int demoIndex = 0;
+
 bool GM_Game(bool *bError)
 {
+	//Start our replay, demos play one of our demo replays, otherwise we can play or record one (for testing and performance runs)
+	const char *playPath = getenv("CUCKYSONIC_REPLAY");
+	const char *recordPath = getenv("CUCKYSONIC_RECORD");
+	
+	if (gEngine->gameMode == GAMEMODE_DEMO || playPath != nullptr)
+	{
+		if (gEngine->gameMode == GAMEMODE_DEMO)
+		{
+			gEngine->replay = new REPLAY(gBasePath + demoReplay[demoIndex]);
+			if (demoReplay[++demoIndex] == nullptr)
+				demoIndex = 0;
+		}
+		else
+		{
+			gEngine->replay = new REPLAY(playPath);
+		}
+		
+		//Load the level and characters the replay was recorded in
+		if (gEngine->replay->fail == nullptr && (gEngine->replay->header.level >= LEVELID_MAX || GetCharacterSet(gEngine->replay->header.characterSet) == nullptr))
+			Error(gEngine->replay->fail = "Replay has an invalid level or character set");
+		
+		if (gEngine->replay->fail != nullptr)
+		{
+			//Demos without a replay go back to the splash screen, otherwise the given replay has to play
+			delete gEngine->replay;
+			gEngine->replay = nullptr;
+			if (gEngine->gameMode != GAMEMODE_DEMO)
+				return (*bError = true);
+			gEngine->gameMode = GAMEMODE_SPLASH;
+			return false;
+		}
+		
+		gEngine->loadLevel = gEngine->replay->header.level;
+		gEngine->loadCharacter = gEngine->replay->header.characterSet;
+		SetRandomSeed(gEngine->replay->header.randomSeed);
+	}
+	else if (recordPath != nullptr)
+	{
+		gEngine->replay = new REPLAY(gEngine->loadLevel, gEngine->loadCharacter, CONTROLLERS);
+	}
+	
+	//Log our state every frame if asked to, for comparing runs (each level played overwrites the log)
+	const char *stateHashPath = getenv("CUCKYSONIC_STATEHASH");
+	if (stateHashPath != nullptr && gEngine->gameMode != GAMEMODE_DEMO)
+		gEngine->stateHash = new STATEHASH(stateHashPath);
+	
 	//Load level with characters given
-	gLevel = new LEVEL(gGameLoadLevel, characterSetList[gGameLoadCharacter]);
-	if (gLevel->fail != nullptr)
+	gEngine->level = new LEVEL(gEngine->loadLevel, characterSetList[gEngine->loadCharacter]);
+	if (gEngine->level->fail != nullptr)
+	{
+		delete gEngine->replay;
+		gEngine->replay = nullptr;
+		delete gEngine->stateHash;
+		gEngine->stateHash = nullptr;
 		return (*bError = true);
+	}
 	
 	//Fade level from black
-	gLevel->SetFade(true, false);
+	gEngine->level->SetFade(true, false);
+	
+	//In practice mode, the level's state is saved once it starts, and restored whenever a player dies
+	SNAPSHOT *practice = (getenv("CUCKYSONIC_PRACTICE") != nullptr && gEngine->gameMode != GAMEMODE_DEMO) ? new SNAPSHOT() : nullptr;
+	
+	//Our loop (the level's loaded, so only count allocations from here on)
+	EndAllocationFrame(nullptr, 0);
 	
-	//Our loop
 	bool bExit = false;
 	
 	while (!(bExit || *bError))
 	{
+		PROFILE_ZONE("Frame");
+		if (gEngine->level->perfHud != nullptr)
+			gEngine->level->perfHud->BeginFrame();
+		
 		//Handle events
 		bExit = HandleEvents();
 		
+		//Reload any assets that have changed
+		UpdateHotReload();
+		
 		//Update level
-		if ((*bError = gLevel->Update()) == true)
+		if ((*bError = gEngine->level->Update()) == true)
 			break;
 		
+		//Save our practice snapshot once the level's started, then restore it instead of restarting the level
+		if (practice != nullptr)
+		{
+			if (practice->level == nullptr)
+			{
+				if (!gEngine->level->titleCard->activeLock && !gEngine->level->fading)
+					practice->Save();
+			}
+			else
+			{
+				bool died = false;
+				for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
+					died |= gEngine->level->playerList[i]->routine == PLAYERROUTINE_RESET_LEVEL;
+				
+				if (died && (*bError = practice->Restore()) == true)
+					break;
+			}
+		}
+		
+		//Once our replay's finished, fade out (demos go back to the splash screen), or exit if it was given to us
+		if (gEngine->replay != nullptr && gEngine->replay->finished)
+		{
+			if (gEngine->gameMode != GAMEMODE_DEMO)
+			{
+				bExit = true;
+				break;
+			}
+			if (!gEngine->level->fading)
+				gEngine->level->SetFade(false, false);
+		}
+		
 		//Handle level fading
 		bool breakThisState = false;
 		
-		if (gLevel->fading)
+		if (gEngine->level->fading)
 		{
-			if (gLevel->isFadingIn)
+			if (gEngine->level->isFadingIn)
 			{
-				gLevel->fading = !gLevel->UpdateFade();
+				gEngine->level->fading = !gEngine->level->UpdateFade();
 			}
 			else
 			{
 				//Fade out and enter next game state
-				if (gLevel->UpdateFade())
+				if (gEngine->level->UpdateFade())
 				{
-					gGameMode = gLevel->specialFade ? GAMEMODE_SPECIALSTAGE : (gGameMode == GAMEMODE_DEMO ? GAMEMODE_SPLASH : GAMEMODE_GAME);
+					gEngine->gameMode = gEngine->level->specialFade ? GAMEMODE_SPECIALSTAGE : (gEngine->gameMode == GAMEMODE_DEMO ? GAMEMODE_SPLASH : GAMEMODE_GAME);
 					breakThisState = true;
 				}
 			}
 		}
 		
 		//Draw level to the screen
-		gLevel->Draw();
+		gEngine->level->Draw();
 		
 		//Render our software buffer to the screen
-		if ((*bError = gSoftwareBuffer->RenderToScreen(&gLevel->background->texture->loadedPalette->colour[0])) == true)
+		if ((*bError = gEngine->softwareBuffer->RenderToScreen(&gEngine->level->background->texture->loadedPalette->colour[0])) == true)
 			break;
 		
+		//Log anything allocated this frame
+		#ifdef ALLOCATION_TRACKER
+			EndAllocationFrame("Frame", gEngine->level->frameCounter);
+		#endif
+		
 		//Go to next state if set to break this state
 		if (breakThisState)
 			break;
 	}
 	
+	//Save our recording, and stop our replay
+	if (gEngine->replay != nullptr)
+	{
+		if (gEngine->replay->mode == REPLAYMODE_RECORD)
+			gEngine->replay->Save(recordPath);
+		delete gEngine->replay;
+		gEngine->replay = nullptr;
+	}
+	
+	delete gEngine->stateHash;
+	gEngine->stateHash = nullptr;
+	delete practice;
+	
 	//Unload level and exit
-	delete gLevel;
+	delete gEngine->level;
 	return bExit;
 }
@@ -28,14 +28,14 @@ bool GM_SpecialStage(bool *bError)
 		stage.Draw();
 		
 		//Render our software buffer to the screen
-		if ((*bError = gSoftwareBuffer->RenderToScreen(&stage.backgroundTexture->loadedPalette->colour[0])) == true)
+		if ((*bError = gEngine->softwareBuffer->RenderToScreen(&stage.backgroundTexture->loadedPalette->colour[0])) == true)
 			break;
 		
-		if (gController[0].press.a)
+		if (gEngine->controller[0].press.a)
 			break;
 	}
 	
 	//Return to stage
-	gGameMode = GAMEMODE_GAME;
+	gEngine->gameMode = GAMEMODE_GAME;
 	return bExit;
 }
@@ -32,7 +32,7 @@ bool GM_Splash(bool *bError)
 		bExit = HandleEvents();
 		
 		//Handle fading
-		if (gController[0].press.a || gController[0].press.b || gController[0].press.c || gController[0].press.start)
+		if (gEngine->controller[0].press.a || gEngine->controller[0].press.b || gEngine->controller[0].press.c || gEngine->controller[0].press.start)
 			frame = mmax(frame, SPLASH_TIME);
 		
 		bool bBreak = false;
@@ -52,11 +52,11 @@ bool GM_Splash(bool *bError)
 		//Draw splash
 		RECT strip = {0, 0, splashTexture.width, 1};
 		
-		for (int y = 0; y < gRenderSpec.height; y++)
+		for (int y = 0; y < gEngine->renderSpec.height; y++)
 		{
 			//Get our distortion
 			int xOff;
-			int inY = y - (gRenderSpec.height - splashTexture.height) / 2;
+			int inY = y - (gEngine->renderSpec.height - splashTexture.height) / 2;
 			
 			xOff = GetSin((y) + (animFrame * 2)) * 15 / 0x100;
 			inY += GetCos((y) + (animFrame * 4)) * 4 / 0x100;
@@ -71,12 +71,12 @@ bool GM_Splash(bool *bError)
 			if (inY >= 0 && inY < splashTexture.height)
 			{
 				strip.y = inY;
-				gSoftwareBuffer->DrawTexture(&splashTexture, splashTexture.loadedPalette, &strip, 0, (gRenderSpec.width - splashTexture.width) / 2 + xOff, y, false, false);
+				gEngine->softwareBuffer->DrawTexture(&splashTexture, splashTexture.loadedPalette, &strip, 0, (gEngine->renderSpec.width - splashTexture.width) / 2 + xOff, y, false, false);
 			}
 		}
 		
 		//Render our software buffer to the screen (using the first colour of our splash texture, should be white)
-		if ((*bError = gSoftwareBuffer->RenderToScreen(&splashTexture.loadedPalette->colour[0])) == true)
+		if ((*bError = gEngine->softwareBuffer->RenderToScreen(&splashTexture.loadedPalette->colour[0])) == true)
 			break;
 		
 		//Exit if faded out
@@ -84,12 +84,12 @@ bool GM_Splash(bool *bError)
 			break;
 		
 		//Increment frame counter
-		if (!(gController[0].held.left && gController[0].held.right))
+		if (!(gEngine->controller[0].held.left && gEngine->controller[0].held.right))
 			frame++;
 		animFrame++;
 	}
 	
 	//Go to title
-	gGameMode = GAMEMODE_TITLE;
+	gEngine->gameMode = GAMEMODE_TITLE;
 	return bExit;
 }
@@ -29,6 +29,9 @@ const RECT titleBanner = {257, 106, 224, 74};
 const int titleBannerJoin = 70;
 const int titleBannerClipY = 10;
 
+//Frames the title screen waits for a selection before playing a demo
+const int titleDemoTime = 600;
+
 //Selection cursor
 const RECT titleSelectionCursor[4] = {
 	{257, 89, 8, 8},
@@ -64,7 +67,7 @@ void DrawText(TEXTURE *tex, const char *text, int x, int y)
 	for (const char *current = text; *current != 0; current++)
 	{
 		RECT thisCharRect = {((*current - 0x20) % 0x20) * 8, 234 + ((*current - 0x20) / 0x20) * 8, 8, 8};
-		gSoftwareBuffer->DrawTexture(tex, tex->loadedPalette, &thisCharRect, TITLELAYER_MENU, dx, y, false, false);
+		gEngine->softwareBuffer->DrawTexture(tex, tex->loadedPalette, &thisCharRect, TITLELAYER_MENU, dx, y, false, false);
 		dx += 8;
 	}
 }
@@ -132,8 +135,8 @@ void TitleBackground(BACKGROUND *background, bool doScroll, int cameraX, int cam
 	}
 	
 	//Clear screen with sky behind background
-	RECT backQuad = {0, 0, gRenderSpec.width, gRenderSpec.height};
-	gSoftwareBuffer->DrawQuad(TITLELAYER_BACKGROUND, &backQuad, &background->texture->loadedPalette->colour[0]);
+	RECT backQuad = {0, 0, gEngine->renderSpec.width, gEngine->renderSpec.height};
+	gEngine->softwareBuffer->DrawQuad(TITLELAYER_BACKGROUND, &backQuad, &background->texture->loadedPalette->colour[0]);
 }
 
 //Gamemode code
@@ -149,14 +152,14 @@ bool GM_Title(bool *bError)
 		return (*bError = !Error(background.fail));
 	
 	//Emblem and banner positions
-	const int emblemX = (gRenderSpec.width - titleEmblem.w) / 2;
-	const int emblemY = (gRenderSpec.height - titleEmblem.h) / 2;
+	const int emblemX = (gEngine->renderSpec.width - titleEmblem.w) / 2;
+	const int emblemY = (gEngine->renderSpec.height - titleEmblem.h) / 2;
 	
-	const int bannerX = (gRenderSpec.width - titleBanner.w) / 2;
+	const int bannerX = (gEngine->renderSpec.width - titleBanner.w) / 2;
 	const int bannerY = emblemY + titleBannerJoin;
 	
 	//Title state
-	int titleYShift = gRenderSpec.height * 0x100;
+	int titleYShift = gEngine->renderSpec.height * 0x100;
 	int titleYSpeed = -0x107E;
 	int titleYGoal = 0;
 	int frame = 0;
@@ -166,7 +169,7 @@ bool GM_Title(bool *bError)
 	//Sonic's animation and position
 	int sonicTime = 54;
 	
-	int sonicX = (gRenderSpec.width / 2) * 0x100;
+	int sonicX = (gEngine->renderSpec.width / 2) * 0x100;
 	int sonicY = (bannerY + 16) * 0x100;
 	
 	int sonicXsp = -0x400;
@@ -176,8 +179,9 @@ bool GM_Title(bool *bError)
 	int sonicHandFrame = 0;
 	int sonicAnimTimer = 0;
 	
-	//Selection state
+	//Selection state (a demo plays if nothing's selected in time)
 	bool selected = false;
+	bool demo = false;
 	
 	//Make our palette black for fade-in
 	FillPaletteWhite(titleTexture.loadedPalette);
@@ -224,8 +228,8 @@ bool GM_Title(bool *bError)
 		background.Draw(true, backgroundScroll, 0);
 		
 		//Render title screen banner and emblem
-		gSoftwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &titleEmblem, TITLELAYER_EMBLEM, emblemX, emblemY + titleYShift / 0x100, false, false);
-		gSoftwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &titleBanner, TITLELAYER_BANNER, bannerX, bannerY + titleYShift / 0x100, false, false);
+		gEngine->softwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &titleEmblem, TITLELAYER_EMBLEM, emblemX, emblemY + titleYShift / 0x100, false, false);
+		gEngine->softwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &titleBanner, TITLELAYER_BANNER, bannerX, bannerY + titleYShift / 0x100, false, false);
 		
 		if (sonicTime-- <= 0)
 		{
@@ -233,8 +237,8 @@ bool GM_Title(bool *bError)
 			sonicTime = 0;
 			
 			//Move Sonic
-			if ((sonicX += sonicXsp) > (gRenderSpec.width / 2) * 0x100)
-				sonicX = (gRenderSpec.width / 2) * 0x100;
+			if ((sonicX += sonicXsp) > (gEngine->renderSpec.width / 2) * 0x100)
+				sonicX = (gEngine->renderSpec.width / 2) * 0x100;
 			else
 				sonicXsp += 54;
 				
@@ -264,7 +268,7 @@ bool GM_Title(bool *bError)
 			{
 				if (bottomY > clipY)
 					bodyRect.h -= (bottomY - clipY);
-				gSoftwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &bodyRect, TITLELAYER_SONIC, midX - 40, topY + titleYShift / 0x100, false, false);
+				gEngine->softwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &bodyRect, TITLELAYER_SONIC, midX - 40, topY + titleYShift / 0x100, false, false);
 			}
 			
 			//If animation is complete
@@ -272,7 +276,7 @@ bool GM_Title(bool *bError)
 			{
 				//Draw Sonic's hand
 				int frame = sonicHandAnim[sonicHandFrame];
-				gSoftwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &titleSonicHand[frame].framerect, TITLELAYER_SONIC_HAND, midX + 20 - titleSonicHand[frame].jointPos.x, topY + 72 - titleSonicHand[frame].jointPos.y + titleYShift / 0x100, false, false);
+				gEngine->softwareBuffer->DrawTexture(&titleTexture, titleTexture.loadedPalette, &titleSonicHand[frame].framerect, TITLELAYER_SONIC_HAND, midX + 20 - titleSonicHand[frame].jointPos.x, topY + 72 - titleSonicHand[frame].jointPos.y + titleYShift / 0x100, false, false);
 				
 				//Update frame
 				if (sonicHandFrame + 1 < 14)
@@ -287,11 +291,19 @@ bool GM_Title(bool *bError)
 		}
 		
 		//Handle selection and menus
-		if (gController[0].press.a || gController[0].press.b || gController[0].press.c || gController[0].press.start)
+		if (gEngine->controller[0].press.a || gEngine->controller[0].press.b || gEngine->controller[0].press.c || gEngine->controller[0].press.start)
+		{
+			selected = true;
+			demo = false;
+		}
+		else if (!selected && frame >= titleDemoTime)
+		{
 			selected = true;
+			demo = true;
+		}
 		
 		//Render our software buffer to the screen
-		if ((*bError = gSoftwareBuffer->RenderToScreen(nullptr)) == true)
+		if ((*bError = gEngine->softwareBuffer->RenderToScreen(nullptr)) == true)
 			break;
 		
 		if (bBreak)
@@ -301,9 +313,23 @@ bool GM_Title(bool *bError)
 		frame++;
 	}
 	
-	//Continue to game
-	gGameLoadLevel = 0;
-	gGameLoadCharacter = 0;
-	gGameMode = GAMEMODE_GAME;
+	//Start fresh (a demo may have changed our score and lives)
+	gEngine->score = 0;
+	gEngine->nextScoreReward = SCORE_REWARD;
+	gEngine->time = 0;
+	gEngine->rings = 0;
+	gEngine->nextRingReward = RINGS_REWARD;
+	gEngine->lives = INITIAL_LIVES;
+	
+	//Play a demo, or continue to game
+	if (demo)
+	{
+		gEngine->gameMode = GAMEMODE_DEMO;
+		return bExit;
+	}
+	
+	gEngine->loadLevel = 0;
+	gEngine->loadCharacter = 0;
+	gEngine->gameMode = GAMEMODE_GAME;
 	return bExit;
 }
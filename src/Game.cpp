@@ -2,42 +2,34 @@
 #include "Log.h"
 #include "Error.h"
 #include "GM.h"
+#include "Music.h"
 
 //Debug bool
 bool gDebugEnabled = false;
 
-//Score, time, rings, and lives
-#define SCORE_REWARD 50000
-#define RINGS_REWARD 100
-
-#define RINGS_CAP 999
-#define LIVES_CAP 99
-
-#define INITIAL_LIVES 3
-
-unsigned int gScore = 0;
-unsigned int gNextScoreReward = SCORE_REWARD;
-
-unsigned int gTime = 0;
-
-unsigned int gRings = 0;
-unsigned int gNextRingReward = RINGS_REWARD;
-
-unsigned int gLives = INITIAL_LIVES;
+//Engine context bound to this thread
+thread_local ENGINE *gEngine = nullptr;
 
 //Generic game functions
 void AddToScore(unsigned int score)
 {
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_ADDTOSCORE)->value = score;
+		return;
+	}
+	
 	//Increase score
-	gScore += score;
+	gEngine->score += score;
 	
 	//Check for extra life rewards
-	if (gScore >= gNextScoreReward)
+	if (gEngine->score >= gEngine->nextScoreReward)
 	{
 		//Increase lives, update our reward, and play jingle
-		while (gScore >= gNextScoreReward)
+		while (gEngine->score >= gEngine->nextScoreReward)
 		{
-			gNextScoreReward += SCORE_REWARD;
+			gEngine->nextScoreReward += SCORE_REWARD;
 			AddToLives(1);
 		}
 	}
@@ -45,26 +37,33 @@ void AddToScore(unsigned int score)
 
 void AddToRings(unsigned int rings)
 {
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_ADDTORINGS)->value = rings;
+		return;
+	}
+	
 	//Update ring reward (if we've lost a bunch of rings then lower it)
-	if (gRings == 0)
-		gNextRingReward = RINGS_REWARD;
-	while (gRings + (RINGS_REWARD * 2) < gNextRingReward)
-		gNextRingReward -= RINGS_REWARD;
+	if (gEngine->rings == 0)
+		gEngine->nextRingReward = RINGS_REWARD;
+	while (gEngine->rings + (RINGS_REWARD * 2) < gEngine->nextRingReward)
+		gEngine->nextRingReward -= RINGS_REWARD;
 	
 	//Increase ring count and cap
-	if (gRings >= RINGS_CAP - rings)
-		gRings = RINGS_CAP;
+	if (gEngine->rings >= RINGS_CAP - rings)
+		gEngine->rings = RINGS_CAP;
 	else
-		gRings += rings;
+		gEngine->rings += rings;
 	
 	//Check for extra life rewards
-	if (gRings >= gNextRingReward)
+	if (gEngine->rings >= gEngine->nextRingReward)
 	{
 		//Increase lives, update our reward, and play jingle
-		while (gRings >= gNextRingReward)
+		while (gEngine->rings >= gEngine->nextRingReward)
 		{
 			AddToLives(1);
-			gNextRingReward += RINGS_REWARD;
+			gEngine->nextRingReward += RINGS_REWARD;
 		}
 	}
 	else
@@ -76,34 +75,42 @@ void AddToRings(unsigned int rings)
 
 void AddToLives(unsigned int lives)
 {
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_ADDTOLIVES)->value = lives;
+		return;
+	}
+	
 	//Increase lives and cap
-	if (gLives >= LIVES_CAP - lives)
-		gLives = LIVES_CAP;
+	if (gEngine->lives >= LIVES_CAP - lives)
+		gEngine->lives = LIVES_CAP;
 	else
-		gLives += lives;
+		gEngine->lives += lives;
+	
+	//Play the extra life jingle over our music
+	PushMusic("ExtraLife");
 }
 
 void InitializeScores()
 {
-	gTime = 0;
-	gRings = 0;
-	gNextRingReward = RINGS_REWARD;
+	gEngine->time = 0;
+	gEngine->rings = 0;
+	gEngine->nextRingReward = RINGS_REWARD;
 }
 
 //Game loop
-GAMEMODE gGameMode;
-
 bool EnterGameLoop()
 {
 	//Initialize game memory
-	gGameMode = GAMEMODE_SPECIALSTAGE; //Start at splash screen
+	gEngine->gameMode = GAMEMODE_SPECIALSTAGE; //Start at splash screen
 	
-	gScore = 0;
-	gNextScoreReward = SCORE_REWARD;
-	gTime = 0;
-	gRings = 0;
-	gNextRingReward = RINGS_REWARD;
-	gLives = INITIAL_LIVES;
+	gEngine->score = 0;
+	gEngine->nextScoreReward = SCORE_REWARD;
+	gEngine->time = 0;
+	gEngine->rings = 0;
+	gEngine->nextRingReward = RINGS_REWARD;
+	gEngine->lives = INITIAL_LIVES;
 	
 	//Run game code
 	bool bExit = false;
@@ -111,7 +118,7 @@ bool EnterGameLoop()
 	
 	while (!(bExit || bError))
 	{
-		switch (gGameMode)
+		switch (gEngine->gameMode)
 		{
 			case GAMEMODE_SPLASH:
 				bExit = GM_Splash(&bError);
@@ -1,35 +1,12 @@
 #pragma once
 #include "Level.h"
-
-enum GAMEMODE
-{
-	GAMEMODE_SPLASH,		//"Sega" screen, but can be used for general splash
-	GAMEMODE_TITLE,			//Title screen
-	GAMEMODE_DEMO,			//Identical to game, but uses demo inputs
-	GAMEMODE_GAME,			//Gameplay
-	GAMEMODE_SPECIALSTAGE,	//Special stage
-	GAMEMODE_CONTINUE,		//Continue screen
-	GAMEMODE_ENDING,		//Ending sequence
-	GAMEMODE_CREDITS,		//Credits sequence
-};
+#include "Engine.h"
 
 //Debug enabled boolean
 extern bool gDebugEnabled;
 
-//Score, time, rings, and lives
-extern unsigned int gScore;
-extern unsigned int gNextScoreReward;
-extern unsigned int gTime;
-extern unsigned int gRings;
-extern unsigned int gNextRingReward;
-extern unsigned int gLives;
-
-//Gamemode and level state
-extern GAMEMODE gGameMode;
-extern LEVEL *gLevel;
-
-extern int gGameLoadLevel;
-extern int gGameLoadCharacter;
+//Character sets
+const char **GetCharacterSet(int character);
 
 //Generic game functions
 void AddToScore(unsigned int score);
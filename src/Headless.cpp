@@ -0,0 +1,541 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+
+#include "Headless.h"
+#include "Game.h"
+#include "Level.h"
+#include "Input.h"
+#include "Replay.h"
+#include "StateHash.h"
+#include "Snapshot.h"
+#include "Netplay.h"
+#include "Profiler.h"
+#include "AllocationTracker.h"
+#include "ObjectJobs.h"
+#include "MathUtil.h"
+#include "Error.h"
+#include "Log.h"
+
+//Argument parsing, returns true if we weren't asked to run headless
+bool ParseHeadlessArguments(int argc, char *argv[], HEADLESSSPEC *spec)
+{
+	if (argc < 4 || strcmp(argv[1], "-headless") != 0)
+		return true;
+	
+	spec->level = atoi(argv[2]);
+	spec->frames = (unsigned int)strtoul(argv[3], nullptr, 0);
+	
+	for (int i = 4; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-character") == 0 && i + 1 < argc)
+			spec->character = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-replay") == 0 && i + 1 < argc)
+			spec->replay = argv[++i];
+		else if (strcmp(argv[i], "-bot") == 0)
+			spec->bot = true;
+		else if (strcmp(argv[i], "-instances") == 0 && i + 1 < argc)
+			spec->instances = (unsigned int)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "-statehash") == 0 && i + 1 < argc)
+			spec->stateHash = argv[++i];
+		else if (strcmp(argv[i], "-snapshot") == 0 && i + 1 < argc)
+			spec->snapshot = (unsigned int)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "-netplay") == 0 && i + 1 < argc)
+			spec->netplay = argv[++i];
+		else if (strcmp(argv[i], "-netplayer") == 0 && i + 1 < argc)
+			spec->netplayer = atoi(argv[++i]) & 1;
+		else if (strcmp(argv[i], "-inputdelay") == 0 && i + 1 < argc)
+			spec->inputDelay = (unsigned int)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "-netdelay") == 0 && i + 1 < argc)
+			spec->netDelay = (unsigned int)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "-netjitter") == 0 && i + 1 < argc)
+			spec->netJitter = (unsigned int)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "-jobs") == 0 && i + 1 < argc)
+			spec->objectJobs = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-noalloc") == 0)
+			spec->noAllocation = true;
+		else
+			printf("Unknown headless argument %s\n", argv[i]);
+	}
+	
+	return false;
+}
+
+//Scripted bot, runs right and jumps when stopped
+CONTROLMASK GetBotInput(PLAYER *player, unsigned int frame, unsigned int *jumpTimer)
+{
+	CONTROLMASK held;
+	held.right = true;
+	
+	if (*jumpTimer != 0)
+	{
+		held.a = true;
+		(*jumpTimer)--;
+	}
+	else if (!player->status.inAir && (mabs(player->inertia) < HEADLESS_BOT_STUCK_SPEED || (frame % HEADLESS_BOT_JUMP_INTERVAL) == 0))
+	{
+		*jumpTimer = HEADLESS_BOT_JUMP_FRAMES;
+	}
+	return held;
+}
+
+static void UpdateBot(unsigned int frame, unsigned int *jumpTimer)
+{
+	PLAYER *player = gEngine->level->playerList[0];
+	CONTROLMASK held = GetBotInput(player, frame, jumpTimer);
+	
+	for (size_t i = 0; i < CONTROLLERS; i++)
+		gEngine->controller[i].SetHeld((i == player->controller) ? held : CONTROLMASK{});
+}
+
+//Report formatting
+static void Report(HEADLESSINSTANCE *instance, const char *format, ...)
+{
+	char line[0x200];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	instance->report += line;
+}
+
+//End state, compared after re-running from a snapshot
+static std::string GetEndState(unsigned int frame)
+{
+	char line[0x200];
+	snprintf(line, sizeof(line), "frame=%u time=%u score=%u rings=%u lives=%u objects=%d hash=%016llx", frame, gEngine->time, gEngine->score, gEngine->rings, gEngine->lives, (int)gEngine->level->objectList.size(), (unsigned long long)OBJECTJOBS::Hash(&gEngine->level->objectList));
+	std::string state = line;
+	
+	for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
+	{
+		PLAYER *player = gEngine->level->playerList[i];
+		snprintf(line, sizeof(line), " player%d=%d,%d,%d,%d,%d", (int)i, player->xLong, player->yLong, player->xVel, player->yVel, player->inertia);
+		state += line;
+	}
+	return state;
+}
+
+//Frame loop, runs from the given frame until we've run all our frames, or the level ends
+static unsigned int RunFrames(HEADLESSINSTANCE *instance, unsigned int frame, unsigned int *jumpTimer, SNAPSHOT *snapshot, unsigned int *snapshotJumpTimer)
+{
+	const HEADLESSSPEC *spec = instance->spec;
+	
+	for (; frame < spec->frames; frame++)
+	{
+		PROFILE_ZONE("Frame");
+		
+		//Save our snapshot on its frame
+		if (snapshot != nullptr && frame == spec->snapshot)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			snapshot->Save();
+			std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+			*snapshotJumpTimer = *jumpTimer;
+			Report(instance, "Saved a %u byte snapshot on frame %u in %.1fus\n", (unsigned int)snapshot->size, frame, time.count());
+		}
+		
+		//Get our input
+		if (gEngine->replay != nullptr)
+		{
+			if (gEngine->replay->Play())
+				break;
+		}
+		else if (spec->bot)
+		{
+			UpdateBot(frame, jumpTimer);
+		}
+		
+		//Update our level
+		if ((instance->error = gEngine->level->Update()) == true)
+			break;
+		
+		//Stop once the level ends (finished, or the player died)
+		if (gEngine->level->fading)
+		{
+			if (!gEngine->level->isFadingIn)
+				break;
+			gEngine->level->fading = !gEngine->level->UpdateFade();
+		}
+		
+		gEngine->level->Draw();
+		
+		//Render our frame and check it didn't allocate
+		if (spec->noAllocation)
+		{
+			if ((instance->error = gEngine->softwareBuffer->RenderToScreen(&gEngine->level->background->texture->loadedPalette->colour[0])) == true)
+				break;
+			if (EndAllocationFrame("Frame", frame) != 0)
+			{
+				instance->error = Error("A frame allocated after the level started");
+				break;
+			}
+		}
+	}
+	
+	return frame;
+}
+
+//Headless simulation, runs on the instance's engine context
+static void SimulateInstance(HEADLESSINSTANCE *instance)
+{
+	//Bind our engine context to this thread
+	gEngine = instance->engine;
+	const HEADLESSSPEC *spec = instance->spec;
+	
+	//Start our replay, which decides our level and characters
+	int level = spec->level, character = spec->character;
+	
+	if (spec->replay != nullptr)
+	{
+		gEngine->replay = new REPLAY(spec->replay);
+		if (gEngine->replay->fail != nullptr)
+		{
+			delete gEngine->replay;
+			gEngine->replay = nullptr;
+			instance->error = true;
+			return;
+		}
+		
+		level = gEngine->replay->header.level;
+		character = gEngine->replay->header.characterSet;
+		SetRandomSeed(gEngine->replay->header.randomSeed);
+	}
+	
+	if (level < 0 || level >= LEVELID_MAX || GetCharacterSet(character) == nullptr)
+	{
+		delete gEngine->replay;
+		gEngine->replay = nullptr;
+		instance->error = Error("Invalid level or character set");
+		return;
+	}
+	
+	//Start our state hash log
+	if (spec->stateHash != nullptr)
+		gEngine->stateHash = new STATEHASH((spec->instances > 1) ? (std::string(spec->stateHash) + "." + std::to_string(instance->index)) : std::string(spec->stateHash));
+	
+	//Load our level
+	gEngine->gameMode = GAMEMODE_GAME;
+	
+	gEngine->level = new LEVEL(level, GetCharacterSet(character));
+	if (gEngine->level->fail != nullptr)
+	{
+		delete gEngine->level;
+		gEngine->level = nullptr;
+		delete gEngine->replay;
+		gEngine->replay = nullptr;
+		delete gEngine->stateHash;
+		gEngine->stateHash = nullptr;
+		instance->error = true;
+		return;
+	}
+	
+	gEngine->level->SetFade(true, false);
+	
+	//Run our frames (our level's loaded, so anything allocated from here on is counted)
+	SNAPSHOT *snapshot = (spec->snapshot != 0) ? new SNAPSHOT() : nullptr;
+	unsigned int jumpTimer = 0, snapshotJumpTimer = 0;
+	EndAllocationFrame(nullptr, 0);
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned int frame = RunFrames(instance, 0, &jumpTimer, snapshot, &snapshotJumpTimer);
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+	instance->frames = frame;
+	
+	//Restore our snapshot and run the rest again, it should end exactly the same (the re-run isn't logged to our state hash log)
+	if (snapshot != nullptr && snapshot->level != nullptr && !instance->error)
+	{
+		std::string endState = GetEndState(frame);
+		delete gEngine->stateHash;
+		gEngine->stateHash = nullptr;
+		
+		std::chrono::steady_clock::time_point restoreStart = std::chrono::steady_clock::now();
+		instance->error = snapshot->Restore();
+		std::chrono::duration<double, std::micro> restoreTime = std::chrono::steady_clock::now() - restoreStart;
+		
+		if (!instance->error)
+		{
+			jumpTimer = snapshotJumpTimer;
+			unsigned int rerunFrame = RunFrames(instance, spec->snapshot, &jumpTimer, nullptr, nullptr);
+			
+			bool matches = GetEndState(rerunFrame) == endState;
+			Report(instance, "Restored the snapshot in %.1fus, re-running from it %s\n", restoreTime.count(), matches ? "ended the same" : "DIVERGED");
+			if (!matches)
+				instance->error = Error("Re-running from a snapshot diverged");
+		}
+	}
+	delete snapshot;
+	
+	//Report our end state
+	Report(instance, "Simulated %u frames in %.1fms (%.0f frames per second, %.1fx realtime)\n", frame, time.count(), (time.count() > 0.0) ? (frame * 1000.0 / time.count()) : 0.0, (time.count() > 0.0) ? (frame * 1000.0 / time.count() / 60.0) : 0.0);
+	Report(instance, "frame=%u level=%d character=%d time=%u score=%u rings=%u lives=%u\n", frame, level, character, gEngine->time, gEngine->score, gEngine->rings, gEngine->lives);
+	for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
+	{
+		PLAYER *player = gEngine->level->playerList[i];
+		Report(instance, "player%d x=%d y=%d xVel=%d yVel=%d inertia=%d anim=%d inAir=%d\n", (int)i, player->x.pos, player->y.pos, player->xVel, player->yVel, player->inertia, (int)player->anim, (int)player->status.inAir);
+	}
+	Report(instance, "objects=%d hash=%016llx\n", (int)gEngine->level->objectList.size(), (unsigned long long)OBJECTJOBS::Hash(&gEngine->level->objectList));
+	
+	//Unload everything
+	delete gEngine->level;
+	gEngine->level = nullptr;
+	delete gEngine->replay;
+	gEngine->replay = nullptr;
+	delete gEngine->stateHash;
+	gEngine->stateHash = nullptr;
+}
+
+//Netplay side, with its own engine context when running over loopback
+struct NETPLAYSIDE
+{
+	ENGINE *engine = nullptr;
+	NETTRANSPORT *transport = nullptr;
+	ROLLBACK *rollback = nullptr;
+	int player = 0;
+	unsigned int jumpTimer = 0;
+	unsigned int linger = 0;
+	std::string endState;
+};
+
+static bool StartNetplaySide(const HEADLESSSPEC *spec, NETPLAYSIDE *side)
+{
+	//Load our level, it needs a player for each side
+	gEngine = side->engine;
+	gEngine->gameMode = GAMEMODE_GAME;
+	
+	gEngine->level = new LEVEL(spec->level, GetCharacterSet(spec->character));
+	if (gEngine->level->fail != nullptr)
+	{
+		delete gEngine->level;
+		gEngine->level = nullptr;
+		return true;
+	}
+	if (gEngine->level->playerList.size() < 2)
+		return Error("Netplay needs a character set with two players (-character 4)");
+	
+	gEngine->level->SetFade(true, false);
+	
+	//Start our session, our player's controller is local and the other's is remote
+	side->transport->SetDelay(spec->netDelay, spec->netJitter, side->player + 1);
+	side->rollback = new ROLLBACK(side->transport, gEngine->level->playerList[side->player]->controller, gEngine->level->playerList[side->player ^ 1]->controller, spec->inputDelay);
+	return side->rollback->fail != nullptr;
+}
+
+static bool UpdateNetplaySide(const HEADLESSSPEC *spec, NETPLAYSIDE *side, bool *running, bool *waiting)
+{
+	//Advance until we've run all our frames, then poll until we've got all of the other side's input (and corrected our prediction of it)
+	gEngine = side->engine;
+	ROLLBACK *rollback = side->rollback;
+	
+	if (rollback->frame < spec->frames)
+	{
+		PLAYER *player = gEngine->level->playerList[side->player];
+		CONTROLMASK input = spec->bot ? GetBotInput(player, rollback->frame, &side->jumpTimer) : CONTROLMASK{};
+		
+		bool advanced;
+		if (rollback->Advance(input, &advanced))
+			return true;
+		if (advanced)
+			gEngine->level->Draw();
+		else
+			*waiting = true;
+		*running = true;
+	}
+	else if (!rollback->Synchronized() || side->linger != 0)
+	{
+		if (rollback->Poll())
+			return true;
+		if (rollback->Synchronized() && side->linger != 0)
+			side->linger--;
+		*waiting = true;
+		*running = true;
+	}
+	return false;
+}
+
+static bool RunNetplay(const HEADLESSSPEC *spec)
+{
+	//Get our transport, loopback runs both sides here (each on its own engine context), a UNIX socket runs our side on the main engine context
+	bool loopback = strcmp(spec->netplay, "loopback") == 0;
+	if (!loopback && strncmp(spec->netplay, "unix:", 5) != 0)
+		return Error("Netplay transport must be loopback or unix:<path>");
+	if (spec->level < 0 || spec->level >= LEVELID_MAX || GetCharacterSet(spec->character) == nullptr)
+		return Error("Invalid level or character set");
+	
+	ENGINE *mainEngine = gEngine;
+	NETPLAYSIDE side[2];
+	int sides = loopback ? 2 : 1;
+	
+	if (loopback)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			ENGINE *engine = new ENGINE();
+			engine->renderSpec = mainEngine->renderSpec;
+			engine->randomSeed = mainEngine->randomSeed;
+			engine->softwareBuffer = new SOFTWAREBUFFER(engine->renderSpec.width, engine->renderSpec.height);
+			engine->softwareBuffer->discard = true;
+			engine->mute = true;
+			
+			side[i].engine = engine;
+			side[i].player = i;
+			side[i].transport = new NETTRANSPORT((i == 0) ? nullptr : side[0].transport);
+		}
+	}
+	else
+	{
+		mainEngine->softwareBuffer->discard = true;
+		side[0].engine = mainEngine;
+		side[0].player = spec->netplayer;
+		side[0].transport = new NETTRANSPORT(std::string(spec->netplay + 5), spec->netplayer);
+		side[0].linger = HEADLESS_NETPLAY_LINGER;
+	}
+	
+	bool error = false;
+	for (int i = 0; i < sides && !error; i++)
+		error = side[i].transport->fail != nullptr || StartNetplaySide(spec, &side[i]);
+	
+	//Run both sides until they've run all their frames and are synchronized
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	while (!error)
+	{
+		bool running = false, waiting = false;
+		for (int i = 0; i < sides && !error; i++)
+			error = UpdateNetplaySide(spec, &side[i], &running, &waiting);
+		if (!running)
+			break;
+		
+		if (!loopback && waiting)
+			std::this_thread::sleep_for(std::chrono::microseconds(HEADLESS_NETPLAY_WAIT));
+	}
+	
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+	
+	//Report each side's statistics and end state
+	for (int i = 0; i < sides && !error; i++)
+	{
+		gEngine = side[i].engine;
+		const ROLLBACKSTATS *stats = &side[i].rollback->stats;
+		side[i].endState = GetEndState(side[i].rollback->frame);
+		
+		printf("Side %d (player %d):\n", i, side[i].player);
+		printf("Advanced %u frames (%u predicted) in %.1fms, stalled %u times\n", stats->frames, stats->predictedFrames, time.count(), stats->stalls);
+		printf("Rolled back %u times, %u frames re-simulated (%.2f deep on average, %u deepest)\n", stats->rollbacks, stats->rollbackFrames, (stats->rollbacks != 0) ? ((double)stats->rollbackFrames / stats->rollbacks) : 0.0, stats->maxDepth);
+		printf("Re-simulation took %.1fus in total (%.1fus on average, %.1fus longest)\n", stats->resimulateTime, (stats->rollbacks != 0) ? (stats->resimulateTime / stats->rollbacks) : 0.0, stats->maxResimulateTime);
+		printf("%s\n", side[i].endState.c_str());
+	}
+	
+	if (loopback && !error)
+	{
+		bool matches = side[0].endState == side[1].endState;
+		printf("Both sides %s\n", matches ? "ended the same" : "DIVERGED");
+		if (!matches)
+			error = Error("Netplay sides diverged");
+	}
+	
+	//Unload everything
+	for (int i = 0; i < sides; i++)
+	{
+		gEngine = side[i].engine;
+		delete gEngine->level;
+		gEngine->level = nullptr;
+		delete side[i].rollback;
+		delete side[i].transport;
+		
+		if (loopback)
+		{
+			delete side[i].engine->softwareBuffer;
+			delete side[i].engine;
+		}
+	}
+	
+	gEngine = mainEngine;
+	gEngine->softwareBuffer->discard = false;
+	return error;
+}
+
+bool RunHeadless(const HEADLESSSPEC *spec)
+{
+	//Checking for allocations needs the allocation tracker, and can only be done on one simulation (allocations are counted across every thread)
+	if (spec->noAllocation)
+	{
+		#ifndef ALLOCATION_TRACKER
+			return Error("-noalloc needs ALLOCATION_TRACKER to be defined (see AllocationTracker.h)");
+		#endif
+		if (spec->netplay != nullptr || spec->instances > 1 || spec->snapshot != 0)
+			return Error("-noalloc can't be used with -netplay, -instances, or -snapshot");
+	}
+	
+	//Use the object job threads we were asked for
+	if (spec->objectJobs >= 0)
+		gObjectJobThreads = (unsigned int)spec->objectJobs;
+	
+	//Run netplay sessions
+	if (spec->netplay != nullptr)
+		return RunNetplay(spec);
+	
+	//Run a single simulation on the main engine context, drawing is still done (it updates state like objects being on-screen), but nothing's queued or rendered
+	if (spec->instances <= 1)
+	{
+		HEADLESSINSTANCE instance;
+		instance.engine = gEngine;
+		instance.spec = spec;
+		
+		gEngine->softwareBuffer->discard = !spec->noAllocation;
+		SimulateInstance(&instance);
+		gEngine->softwareBuffer->discard = false;
+		
+		fputs(instance.report.c_str(), stdout);
+		return instance.error;
+	}
+	
+	//Otherwise, give each simulation its own muted engine context and discarding software buffer, and run them all in parallel
+	ENGINE *mainEngine = gEngine;
+	HEADLESSINSTANCE *instance = new HEADLESSINSTANCE[spec->instances];
+	std::thread *thread = new std::thread[spec->instances];
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	for (unsigned int i = 0; i < spec->instances; i++)
+	{
+		ENGINE *engine = new ENGINE();
+		engine->renderSpec = mainEngine->renderSpec;
+		engine->randomSeed = mainEngine->randomSeed;
+		engine->softwareBuffer = new SOFTWAREBUFFER(engine->renderSpec.width, engine->renderSpec.height);
+		engine->softwareBuffer->discard = true;
+		engine->mute = true;
+		
+		instance[i].engine = engine;
+		instance[i].spec = spec;
+		instance[i].index = i;
+		thread[i] = std::thread(SimulateInstance, &instance[i]);
+	}
+	
+	for (unsigned int i = 0; i < spec->instances; i++)
+		thread[i].join();
+	
+	std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+	
+	//Print each simulation's end state in order, then free them
+	bool error = false;
+	unsigned long long frames = 0;
+	
+	for (unsigned int i = 0; i < spec->instances; i++)
+	{
+		printf("Instance %u:\n%s", i, instance[i].report.c_str());
+		error |= instance[i].error;
+		frames += instance[i].frames;
+		
+		delete instance[i].engine->softwareBuffer;
+		delete instance[i].engine;
+	}
+	
+	printf("Ran %u instances in %.1fms (%.0f frames per second in total)\n", spec->instances, time.count(), (time.count() > 0.0) ? (frames * 1000.0 / time.count()) : 0.0);
+	
+	delete[] thread;
+	delete[] instance;
+	return error;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+//Declare the engine, player, and control mask classes
+class ENGINE;
+class PLAYER;
+struct CONTROLMASK;
+
+//Headless simulation, runs a level as fast as possible without rendering, then prints its end state
+//Usage: CuckySonic -headless <level> <frames> [-character <set>] [-replay <path>] [-bot] [-instances <count>] [-statehash <path>] [-snapshot <frame>] [-jobs <threads>] [-noalloc]
+//Netplay: CuckySonic -headless <level> <frames> -character 4 -netplay <loopback | unix:<path>> [-netplayer <0 | 1>] [-inputdelay <frames>] [-netdelay <frames>] [-netjitter <frames>] [-bot]
+//Loopback runs both sides in one process and checks they end the same, a UNIX socket runs one side, with the other side run by another process on the same path
+
+//Constants
+#define HEADLESS_BOT_JUMP_FRAMES	16	//Frames the bot holds jump for
+#define HEADLESS_BOT_JUMP_INTERVAL	97	//Frames between the bot's jumps when it's not stuck
+#define HEADLESS_BOT_STUCK_SPEED	0x100	//Ground speed below which the bot thinks it's stuck and jumps
+
+#define HEADLESS_NETPLAY_WAIT	1000	//Microseconds to wait when we can't advance over a UNIX socket (the other side's running in another process)
+#define HEADLESS_NETPLAY_LINGER	60		//Polls to keep acknowledging the other side for once we're synchronized over a UNIX socket
+
+//Headless simulation specification
+struct HEADLESSSPEC
+{
+	int level = 0;
+	int character = 0;
+	unsigned int frames = 0;
+	const char *replay = nullptr;	//Replay to take input from (overrides the level and character)
+	bool bot = false;				//Use the scripted bot for input rather than holding nothing
+	unsigned int instances = 1;		//Simulations to run in parallel, each on its own thread and engine context
+	const char *stateHash = nullptr;	//State hash log to write (each instance's log has its index appended when running several)
+	unsigned int snapshot = 0;			//Frame to save a snapshot on, once the run's finished it's restored and the rest is run again to check it ends the same (0 for none)
+	const char *netplay = nullptr;		//Netplay transport ("loopback", or "unix:<path>"), nullptr if not running netplay
+	int netplayer = 0;					//Our side over a UNIX socket (0 or 1), side 0 plays player 0 and side 1 plays player 1
+	unsigned int inputDelay = 0;		//Frames local input is delayed by
+	unsigned int netDelay = 0;			//Artificial packet delay (in frames)
+	unsigned int netJitter = 0;			//Artificial packet jitter (in frames, added to the delay)
+	int objectJobs = -1;				//Object job threads to update the level's objects with (see ObjectJobs.h), -1 to keep the CUCKYSONIC_OBJECT_JOBS setting
+	bool noAllocation = false;			//Render every frame, and fail if any frame allocates once the level's loaded (needs ALLOCATION_TRACKER, see AllocationTracker.h)
+};
+
+//Headless simulation instance
+struct HEADLESSINSTANCE
+{
+	ENGINE *engine = nullptr;
+	const HEADLESSSPEC *spec = nullptr;
+	unsigned int index = 0;
+	
+	bool error = false;
+	unsigned int frames = 0;
+	std::string report;	//End state, printed once every instance has finished
+};
+
+//Headless functions
+bool ParseHeadlessArguments(int argc, char *argv[], HEADLESSSPEC *spec);
+bool RunHeadless(const HEADLESSSPEC *spec);
+CONTROLMASK GetBotInput(PLAYER *player, unsigned int frame, unsigned int *jumpTimer);	//Also used by the engine benchmark to record input
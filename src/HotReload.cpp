@@ -0,0 +1,257 @@
+#include "HotReload.h"
+#include "Log.h"
+
+#ifdef HOTRELOAD_INOTIFY
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+#include "Error.h"
+#include "Filesystem.h"
+#include "Archive.h"
+#include "Game.h"
+#include "Level.h"
+
+//Constants
+#define HOTRELOAD_EVENT_BUFFER	0x1000	//Bytes of inotify events read at a time
+#define HOTRELOAD_MAX_CHANGES	0x40	//Most changed files collected at once (past this, they're reloaded in batches of this size)
+
+//Watched folder
+struct HOTRELOADWATCH
+{
+	int descriptor;
+	std::string path;	//Relative to our base path (e.g. data/Object)
+};
+
+//Watcher state
+static int inotifyFd = -1;
+static HOTRELOADWATCH *watch = nullptr;
+static size_t watches = 0, watchCapacity = 0;
+
+//Watching functions
+static void WatchFolder(std::string path)
+{
+	//Watch the given folder for files being written or moved into it
+	int descriptor = inotify_add_watch(inotifyFd, (gBasePath + path).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (descriptor < 0)
+		return;
+	
+	if (watches >= watchCapacity)
+	{
+		watchCapacity = (watchCapacity == 0) ? 0x20 : (watchCapacity * 2);
+		HOTRELOADWATCH *newWatch = new HOTRELOADWATCH[watchCapacity];
+		for (size_t i = 0; i < watches; i++)
+			newWatch[i] = watch[i];
+		delete[] watch;
+		watch = newWatch;
+	}
+	
+	watch[watches].descriptor = descriptor;
+	watch[watches].path = path;
+	watches++;
+	
+	//Watch our sub-folders too
+	DIR *dir = opendir((gBasePath + path).c_str());
+	if (dir == nullptr)
+		return;
+	
+	for (dirent *dirEntry = readdir(dir); dirEntry != nullptr; dirEntry = readdir(dir))
+	{
+		if (strcmp(dirEntry->d_name, ".") == 0 || strcmp(dirEntry->d_name, "..") == 0)
+			continue;
+		
+		std::string entryPath = path + "/" + dirEntry->d_name;
+		struct stat entryStat;
+		if (stat((gBasePath + entryPath).c_str(), &entryStat) == 0 && S_ISDIR(entryStat.st_mode))
+			WatchFolder(entryPath);
+	}
+	
+	closedir(dir);
+}
+
+//Reloading functions
+static bool EndsWith(const std::string &path, const char *extension)
+{
+	size_t length = strlen(extension);
+	return path.length() > length && path.compare(path.length() - length, length, extension) == 0;
+}
+
+static void ReloadTexture(TEXTURE *texture, std::string path, bool cooked)
+{
+	if (texture == nullptr || texture->source != path)
+		return;
+	
+	LOG(("Hot-reloading %s\n", path.c_str()));
+	if (texture->Reload(cooked))
+	{
+		Warn(("Failed to reload " + path + ", keeping the old texture").c_str());
+	}
+}
+
+static void ReloadAsset(std::string path)
+{
+	//Textures (a changed bitmap is loaded over its cooked texture, as that'll be out of date)
+	bool isCooked = EndsWith(path, TEXTURE_COOKED_EXTENSION);
+	if (isCooked || EndsWith(path, ".bmp"))
+	{
+		std::string source = isCooked ? (path.substr(0, path.length() - strlen(TEXTURE_COOKED_EXTENSION)) + ".bmp") : path;
+		
+		ReloadTexture(gEngine->level->tileTexture, source, isCooked);
+		if (gEngine->level->background != nullptr)
+			ReloadTexture(gEngine->level->background->texture, source, isCooked);
+		for (LL_NODE<TEXTURE*> *node = gEngine->level->objTextureCache.head; node != nullptr; node = node->next)
+			ReloadTexture(node->node_entry, source, isCooked);
+		return;
+	}
+	
+	//Mappings
+	if (EndsWith(path, ".map"))
+	{
+		for (LL_NODE<MAPPINGS*> *node = gEngine->level->objMappingsCache.head; node != nullptr; node = node->next)
+		{
+			if (node->node_entry->source != path)
+				continue;
+			
+			LOG(("Hot-reloading %s\n", path.c_str()));
+			if (node->node_entry->Reload())
+			{
+				Warn(("Failed to reload " + path + ", keeping the old mappings").c_str());
+			}
+		}
+		return;
+	}
+	
+	//Collision (tile maps and collision tiles are reloaded together, as their sizes have to match)
+	LEVELTABLE *tableEntry = &gLevelTable[gEngine->level->levelId];
+	if (path == tableEntry->chunkTileReferencePath + ".nor" || path == tableEntry->chunkTileReferencePath + ".alt"
+	 || path == tableEntry->collisionReferencePath + ".can" || path == tableEntry->collisionReferencePath + ".car" || path == tableEntry->collisionReferencePath + ".ang")
+	{
+		LOG(("Hot-reloading %s\n", path.c_str()));
+		if (gEngine->level->ReloadCollisionTiles())
+		{
+			Warn(("Failed to reload " + path + ", keeping the old collision").c_str());
+		}
+	}
+}
+
+static void ReloadAssets(const std::string *changed, size_t changes)
+{
+	if (gEngine->level == nullptr)
+		return;
+	for (size_t i = 0; i < changes; i++)
+		ReloadAsset(changed[i]);
+}
+
+//Hot-reload functions
+void UpdateHotReload()
+{
+	if (inotifyFd < 0)
+		return;
+	
+	//Get every file that's changed since last frame (without duplicates, editors tend to write files more than once)
+	std::string changed[HOTRELOAD_MAX_CHANGES];
+	size_t changes = 0;
+	
+	alignas(struct inotify_event) char buffer[HOTRELOAD_EVENT_BUFFER];
+	ssize_t length;
+	
+	while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+	{
+		for (char *eventPointer = buffer; eventPointer < buffer + length;)
+		{
+			const struct inotify_event *event = (const struct inotify_event*)eventPointer;
+			eventPointer += sizeof(struct inotify_event) + event->len;
+			
+			if (event->len == 0 || (event->mask & IN_ISDIR))
+				continue;
+			
+			//Get the file's path from the folder it's in
+			for (size_t i = 0; i < watches; i++)
+			{
+				if (watch[i].descriptor != event->wd)
+					continue;
+				
+				std::string path = watch[i].path + "/" + event->name;
+				size_t v;
+				for (v = 0; v < changes; v++)
+					if (changed[v] == path)
+						break;
+				if (v != changes)
+					break;
+				
+				//If our list is full, reload what's in it first (the events we've read can't be put back)
+				if (changes >= HOTRELOAD_MAX_CHANGES)
+				{
+					ReloadAssets(changed, changes);
+					changes = 0;
+				}
+				changed[changes++] = path;
+				break;
+			}
+		}
+	}
+	
+	//Reload our changed assets
+	ReloadAssets(changed, changes);
+}
+
+//Hot-reload sub-system functions
+bool InitializeHotReload()
+{
+	LOG(("Initializing hot-reloading... "));
+	
+	//Assets in an archive can't change under us
+	#ifndef FS_LOOSE_OVERRIDE
+		if (gArchive != nullptr)
+		{
+			LOG(("Disabled (an archive is mounted)\n"));
+			return false;
+		}
+	#endif
+	
+	//Watch our data folder
+	if ((inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+	{
+		LOG(("Disabled (failed to initialize inotify)\n"));
+		return false;
+	}
+	
+	WatchFolder("data");
+	LOG(("Success! (watching %d folders)\n", (int)watches));
+	return false;
+}
+
+void QuitHotReload()
+{
+	//Stop watching
+	if (inotifyFd >= 0)
+		close(inotifyFd);
+	inotifyFd = -1;
+	
+	delete[] watch;
+	watch = nullptr;
+	watches = watchCapacity = 0;
+}
+
+#else
+
+//Hot-reloading is disabled, so there's nothing to do
+void UpdateHotReload()
+{
+	return;
+}
+
+bool InitializeHotReload()
+{
+	return false;
+}
+
+void QuitHotReload()
+{
+	return;
+}
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+//Asset hot-reloading, watches the data folder for changes and reloads the level's textures, mappings, and collision in place
+//#define HOTRELOAD	//When set, changed assets are reloaded at the start of the next frame (Linux only, uses inotify, reads loose files so it's disabled when an archive is mounted)
+
+#if defined(HOTRELOAD) && defined(__linux__)
+	#define HOTRELOAD_INOTIFY
+#endif
+
+//Hot-reload functions
+void UpdateHotReload();
+
+//Hot-reload sub-system functions
+bool InitializeHotReload();
+void QuitHotReload();
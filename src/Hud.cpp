@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <string.h>
 
 #include "Hud.h"
@@ -20,7 +21,7 @@
 #define RINGS_LEFT	16
 #define RINGS_RIGHT	96
 
-#define LIVES_Y	(gRenderSpec.height - 24)
+#define LIVES_Y	(gEngine->renderSpec.height - 24)
 #define LIVES_LEFT 16
 #define LIVES_NUM_LEFT	44
 
@@ -28,7 +29,7 @@
 HUD::HUD()
 {
 	//Load HUD texture
-	texture = gLevel->GetObjectTexture("data/HUD.bmp");
+	texture = gEngine->level->GetObjectTexture("data/HUD.bmp");
 	if (texture->fail != nullptr)
 	{
 		Error(fail = texture->fail);
@@ -36,7 +37,7 @@ HUD::HUD()
 	}
 	
 	//Load font
-	TEXTURE *fontTexture = gLevel->GetObjectTexture("data/GenericFont.bmp");
+	TEXTURE *fontTexture = gEngine->level->GetObjectTexture("data/GenericFont.bmp");
 	font = new BITMAPFONT(fontTexture, 0, 49, 8, 11, 0, 0, 0x20, 0x20);
 }
 
@@ -50,12 +51,10 @@ HUD::~HUD()
 void HUD::DrawLabel(int xPos, int yPos, int srcX, int srcY)
 {
 	RECT src = {srcX * 48, srcY * 16, 48, 16};
-	gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &src, LEVEL_RENDERLAYER_HUD, xPos, yPos, false, false);
+	gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &src, LEVEL_RENDERLAYER_HUD, xPos, yPos, false, false);
 }
 
 //Core draw function
-#define PAD_NUMBER_STRING(padString, len) (std::string(len - padString.length(), '0').append(padString))
-
 void HUD::Draw()
 {
 	//Blink the time and ring labels
@@ -63,11 +62,11 @@ void HUD::Draw()
 	bool timeAlt = false;
 	bool ringAlt = false;
 	
-	if (gLevel->frameCounter & 0x8)
+	if (gEngine->level->frameCounter & 0x8)
 	{
-		if (gTime >= (60 * 60 * 9))
+		if (gEngine->time >= (60 * 60 * 9))
 			timeAlt = true;
-		if (gRings == 0)
+		if (gEngine->rings == 0)
 			ringAlt = true;
 	}
 	
@@ -77,27 +76,32 @@ void HUD::Draw()
 	DrawLabel(RINGS_LEFT,	RINGS_Y,	2, ringAlt ?	1 : 0);
 	DrawLabel(LIVES_LEFT,	LIVES_Y,	3, 0);
 	
-	//Draw score value
-	std::string score = std::to_string(gScore);
-	font->DrawString(score, LEVEL_RENDERLAYER_HUD, SCORE_RIGHT - (8 * score.length()), SCORE_Y);
+	//Draw score value (written into buffers on the stack, so drawing the HUD doesn't allocate)
+	char score[16];
+	snprintf(score, sizeof(score), "%u", gEngine->score);
+	font->DrawString(score, LEVEL_RENDERLAYER_HUD, SCORE_RIGHT - (8 * strlen(score)), SCORE_Y);
 	
 	//Draw time value
-	std::string mins = std::to_string((gTime / 60) / 60);
-	std::string secs = std::to_string((gTime / 60) % 60);
+	char time[16];
+	unsigned int mins = (gEngine->time / 60) / 60;
+	unsigned int secs = (gEngine->time / 60) % 60;
 	
 	#ifdef SONICCD_LONG_TIME
-		std::string mils = std::to_string((gTime * 100 / 60) % 100);
-		std::string time = mins + "'" + PAD_NUMBER_STRING(secs, 2) + "\"" + PAD_NUMBER_STRING(mils, 2); //M'ss"mm
+		unsigned int mils = (gEngine->time * 100 / 60) % 100;
+		snprintf(time, sizeof(time), "%u'%02u\"%02u", mins, secs, mils); //M'ss"mm
 	#else
-		std::string time = mins + ":" + PAD_NUMBER_STRING(secs, 2); //M:ss
+		snprintf(time, sizeof(time), "%u:%02u", mins, secs); //M:ss
 	#endif
 	
-	font->DrawString(time, LEVEL_RENDERLAYER_HUD, TIME_RIGHT - (8 * time.length()), TIME_Y);
+	font->DrawString(time, LEVEL_RENDERLAYER_HUD, TIME_RIGHT - (8 * strlen(time)), TIME_Y);
 	
 	//Draw rings value
-	std::string rings = std::to_string(gRings);
-	font->DrawString(rings, LEVEL_RENDERLAYER_HUD, RINGS_RIGHT - (8 * rings.length()), RINGS_Y);
+	char rings[16];
+	snprintf(rings, sizeof(rings), "%u", gEngine->rings);
+	font->DrawString(rings, LEVEL_RENDERLAYER_HUD, RINGS_RIGHT - (8 * strlen(rings)), RINGS_Y);
 	
 	//Draw lives value
-	font->DrawString(std::to_string(gLives), LEVEL_RENDERLAYER_HUD, LIVES_NUM_LEFT, LIVES_Y + 2);
+	char lives[16];
+	snprintf(lives, sizeof(lives), "%u", gEngine->lives);
+	font->DrawString(lives, LEVEL_RENDERLAYER_HUD, LIVES_NUM_LEFT, LIVES_Y + 2);
 }
@@ -1,18 +1,18 @@
 #include <string.h>
 #include "Backend/Input.h"
 #include "Input.h"
+#include "Engine.h"
 #include "Filesystem.h"
 #include "MathUtil.h"
 #include "Log.h"
 #include "Error.h"
+#include "Replay.h"
 
 //Binding save constants
 #define BINDSAVE_NAME	"InputBind.ibs"	//The name of the file
 const char *bindsaveSign = "IBV01";		//The signature, change this if you change the bindings structure or the binding enums in any way
 
-//Controller state and default bindings
-CONTROLLER gController[CONTROLLERS];
-
+//Default bindings
 const BUTTONBINDS defaultBinds[CONTROLLERS] = {
 	{ //Controller 1
 		{{IBK_RETURN,	IBB_START},			{IBK_UNKNOWN,	IBB_UNKNOWN}},	//Start
@@ -141,23 +141,62 @@ void CONTROLLER::Update(size_t controllerIndex)
 	lastHeld = held;
 }
 
+void CONTROLLER::SetHeld(CONTROLMASK setHeld)
+{
+	//Use the given held buttons (from a replay) in place of our bindings
+	held = setHeld;
+	
+	//Get our pressed buttons
+	DO_PRESS_CHECK(start);
+	DO_PRESS_CHECK(a);
+	DO_PRESS_CHECK(b);
+	DO_PRESS_CHECK(c);
+	DO_PRESS_CHECK(right);
+	DO_PRESS_CHECK(left);
+	DO_PRESS_CHECK(down);
+	DO_PRESS_CHECK(up);
+	
+	//Copy our last held for next update
+	lastHeld = held;
+}
+
 //Accessible input functions
 void ClearControllerInput()
 {
 	//Clear each controller's current input state
 	for (size_t i = 0; i < CONTROLLERS; i++)
 	{
-		gController[i].held = {};
-		gController[i].lastHeld = {};
-		gController[i].press = {};
+		gEngine->controller[i].held = {};
+		gEngine->controller[i].lastHeld = {};
+		gEngine->controller[i].press = {};
 	}
 }
 
 void UpdateInput()
 {
+	//If playing a replay, our input comes from that instead
+	if (gEngine->replay != nullptr && gEngine->replay->mode == REPLAYMODE_PLAY)
+	{
+		//Demos end once start is held on the first controller (checked on a copy, so the replay's pressed buttons are left alone)
+		if (gEngine->gameMode == GAMEMODE_DEMO)
+		{
+			CONTROLLER skip = gEngine->controller[0];
+			skip.Update(0);
+			if (skip.held.start)
+				gEngine->replay->finished = true;
+		}
+		
+		gEngine->replay->Play();
+		return;
+	}
+	
 	//Update each controller
 	for (size_t i = 0; i < CONTROLLERS; i++)
-		gController[i].Update(i);
+		gEngine->controller[i].Update(i);
+	
+	//Record our input if recording a replay
+	if (gEngine->replay != nullptr && gEngine->replay->mode == REPLAYMODE_RECORD)
+		gEngine->replay->Record();
 }
 
 //Subsystem initialization and quitting
@@ -189,7 +228,7 @@ bool InitializeInput()
 		{
 			//Read bindings from file now that the signature's been confirmed
 			for (size_t i = 0; i < CONTROLLERS; i++)
-				fp.Read(&gController[i].binds, 1, sizeof(BUTTONBINDS));
+				fp.Read(&gEngine->controller[i].binds, 1, sizeof(BUTTONBINDS));
 		}
 	}
 	else
@@ -219,7 +258,7 @@ bool InitializeInput()
 		//Print failure and use default bindings
 		LOG(("NOTE: Using default input bindings - %s\n", failstr));
 		for (size_t i = 0; i < CONTROLLERS; i++)
-			gController[i].binds = defaultBinds[i];
+			gEngine->controller[i].binds = defaultBinds[i];
 	}
 	
 	LOG(("Success!\n"));
@@ -243,7 +282,7 @@ void QuitInput()
 		//Save our bindings
 		fp.Write(bindsaveSign, 1, strlen(bindsaveSign));
 		for (size_t i = 0; i < CONTROLLERS; i++)
-			fp.Write(&gController[i].binds, 1, sizeof(BUTTONBINDS));
+			fp.Write(&gEngine->controller[i].binds, 1, sizeof(BUTTONBINDS));
 	}
 	
 	LOG(("Success!\n"));
@@ -375,11 +375,9 @@ class CONTROLLER
 	public:
 		CONTROLMASK GetAxisState(int16_t chkAxisX, int16_t chkAxisY);
 		void Update(size_t controllerIndex);
+		void SetHeld(CONTROLMASK setHeld);
 };
 
-//Controller state global
-extern CONTROLLER gController[CONTROLLERS];
-
 //Subsystem functions
 void ClearControllerInput();
 void UpdateInput();
@@ -0,0 +1,170 @@
+#include <string.h>
+
+#include "LZ4.h"
+
+//Constants
+#define LZ4_MIN_MATCH		4
+#define LZ4_LAST_LITERALS	5	//The last 5 bytes of a block are always literals
+#define LZ4_MATCH_LIMIT		12	//The last match has to start at least 12 bytes before the end of a block
+#define LZ4_MAX_OFFSET		0xFFFF
+#define LZ4_HASH_BITS		12
+
+//Compression
+static inline uint32_t Read32(const uint8_t *in)
+{
+	uint32_t value;
+	memcpy(&value, in, 4);
+	return value;
+}
+
+static bool WriteLength(uint8_t **out, const uint8_t *outEnd, size_t length)
+{
+	//Write the rest of a length that didn't fit in the token
+	for (; length >= 0xFF; length -= 0xFF)
+	{
+		if (*out >= outEnd)
+			return true;
+		*(*out)++ = 0xFF;
+	}
+	
+	if (*out >= outEnd)
+		return true;
+	*(*out)++ = (uint8_t)length;
+	return false;
+}
+
+static bool WriteSequence(uint8_t **out, const uint8_t *outEnd, const uint8_t *literal, size_t literals, size_t offset, size_t matchLength)
+{
+	//Write our token
+	if (*out >= outEnd)
+		return true;
+	uint8_t *token = (*out)++;
+	*token = (uint8_t)((literals >= 15 ? 15 : literals) << 4);
+	
+	//Write our literals
+	if (literals >= 15 && WriteLength(out, outEnd, literals - 15))
+		return true;
+	if ((size_t)(outEnd - *out) < literals)
+		return true;
+	memcpy(*out, literal, literals);
+	*out += literals;
+	
+	//Write our match (the last sequence has none)
+	if (matchLength == 0)
+		return false;
+	
+	if (outEnd - *out < 2)
+		return true;
+	*(*out)++ = (uint8_t)(offset >> 0);
+	*(*out)++ = (uint8_t)(offset >> 8);
+	
+	matchLength -= LZ4_MIN_MATCH;
+	*token |= (uint8_t)(matchLength >= 15 ? 15 : matchLength);
+	if (matchLength >= 15 && WriteLength(out, outEnd, matchLength - 15))
+		return true;
+	return false;
+}
+
+size_t LZ4_Compress(const uint8_t *in, size_t inSize, uint8_t *out, size_t outCapacity)
+{
+	//Greedily find matches using a hash table of the last position each 4-byte sequence was seen at
+	int64_t table[1 << LZ4_HASH_BITS];
+	for (size_t i = 0; i < (1 << LZ4_HASH_BITS); i++)
+		table[i] = -1;
+	
+	uint8_t *outPoint = out;
+	const uint8_t *outEnd = out + outCapacity;
+	size_t anchor = 0, i = 0;
+	size_t matchStartLimit = (inSize > LZ4_MATCH_LIMIT) ? (inSize - LZ4_MATCH_LIMIT) : 0;
+	
+	while (i < matchStartLimit)
+	{
+		uint32_t sequence = Read32(in + i);
+		uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+		int64_t candidate = table[hash];
+		table[hash] = (int64_t)i;
+		
+		if (candidate < 0 || i - (size_t)candidate > LZ4_MAX_OFFSET || Read32(in + candidate) != sequence)
+		{
+			i++;
+			continue;
+		}
+		
+		//Extend our match, leaving the last literals alone
+		size_t length = LZ4_MIN_MATCH;
+		while (i + length < inSize - LZ4_LAST_LITERALS && in[candidate + length] == in[i + length])
+			length++;
+		
+		if (WriteSequence(&outPoint, outEnd, in + anchor, i - anchor, i - (size_t)candidate, length))
+			return 0;
+		i += length;
+		anchor = i;
+	}
+	
+	//Write our last literals
+	if (WriteSequence(&outPoint, outEnd, in + anchor, inSize - anchor, 0, 0))
+		return 0;
+	return outPoint - out;
+}
+
+//Decompression
+static bool ReadLength(const uint8_t **in, const uint8_t *inEnd, size_t *length)
+{
+	//Read the rest of a length that didn't fit in the token
+	uint8_t byte;
+	do
+	{
+		if (*in >= inEnd)
+			return true;
+		byte = *(*in)++;
+		*length += byte;
+	} while (byte == 0xFF);
+	return false;
+}
+
+size_t LZ4_Decompress(const uint8_t *in, size_t inSize, uint8_t *out, size_t outSize)
+{
+	const uint8_t *inEnd = in + inSize;
+	uint8_t *outPoint = out;
+	uint8_t *outEnd = out + outSize;
+	
+	while (in < inEnd)
+	{
+		//Read our literals
+		uint8_t token = *in++;
+		size_t literals = token >> 4;
+		if (literals == 15 && ReadLength(&in, inEnd, &literals))
+			return (size_t)-1;
+		if (literals > (size_t)(inEnd - in) || literals > (size_t)(outEnd - outPoint))
+			return (size_t)-1;
+		
+		memcpy(outPoint, in, literals);
+		in += literals;
+		outPoint += literals;
+		
+		//The last sequence has no match
+		if (in >= inEnd)
+			break;
+		
+		//Read our match
+		if (inEnd - in < 2)
+			return (size_t)-1;
+		size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+		
+		size_t length = token & 0xF;
+		if (length == 15 && ReadLength(&in, inEnd, &length))
+			return (size_t)-1;
+		length += LZ4_MIN_MATCH;
+		
+		if (offset == 0 || offset > (size_t)(outPoint - out) || length > (size_t)(outEnd - outPoint))
+			return (size_t)-1;
+		
+		//Copy our match (byte by byte, as it can overlap with itself)
+		const uint8_t *match = outPoint - offset;
+		for (size_t i = 0; i < length; i++)
+			*outPoint++ = *match++;
+	}
+	
+	return outPoint - out;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//LZ4 block format (raw blocks, no frame header)
+#define LZ4_COMPRESS_BOUND(size)	((size) + (size) / 255 + 16)	//Largest a block of the given size can compress to
+
+//LZ4 functions
+size_t LZ4_Compress(const uint8_t *in, size_t inSize, uint8_t *out, size_t outCapacity);		//Returns the compressed size, or 0 if it didn't fit
+size_t LZ4_Decompress(const uint8_t *in, size_t inSize, uint8_t *out, size_t outSize);	//Returns the decompressed size, or (size_t)-1 if the block is invalid
@@ -3,12 +3,16 @@
 
 #include "Filesystem.h"
 #include "Audio.h"
+#include "Music.h"
 #include "Level.h"
 #include "MathUtil.h"
 #include "Game.h"
 #include "Fade.h"
 #include "Error.h"
 #include "Log.h"
+#include "StateHash.h"
+#include "Profiler.h"
+#include "PerfHud.h"
 
 //Object function lists
 #include "Objects.h"
@@ -201,11 +205,14 @@ bool LEVEL::LoadMappings(LEVELTABLE *tableEntry)
 			}
 			
 			//Read the mapping data
+			uint16_t *mappingData = new uint16_t[chunks * (8 * 8)];
+			mappingFile.ReadBE16(mappingData, chunks * (8 * 8));
+			
 			for (size_t i = 0; i < chunks; i++)
 			{
 				for (int v = 0; v < (8 * 8); v++)
 				{
-					uint16_t tmap = mappingFile.ReadBE16();
+					uint16_t tmap = mappingData[i * (8 * 8) + v];
 					chunkMapping[i].tile[v].altLRB	= (tmap & 0x8000) != 0;
 					chunkMapping[i].tile[v].altTop	= (tmap & 0x4000) != 0;
 					chunkMapping[i].tile[v].norLRB	= (tmap & 0x2000) != 0;
@@ -216,6 +223,8 @@ bool LEVEL::LoadMappings(LEVELTABLE *tableEntry)
 					chunkMapping[i].tile[v].srcChunk = i;
 				}
 			}
+			
+			delete[] mappingData;
 			break;
 		}
 		
@@ -260,16 +269,24 @@ bool LEVEL::LoadLayout(LEVELTABLE *tableEntry)
 			for (size_t cy = 0; cy < layout.height; cy += 8)
 			{
 				//Read foreground line
+				const uint8_t *line = layoutFile.GetSpan(layout.width / 8);
+				if (line == nullptr)
+				{
+					Error(fail = "Layout is cut off");
+					return true;
+				}
+				
 				for (size_t cx = 0; cx < layout.width; cx += 8)
 				{
 					//Read our chunks as their 8x8 tiles
-					uint8_t chunk = layoutFile.ReadU8();
+					uint8_t chunk = *line++;
 					for (size_t tv = 0; tv < 8 * 8; tv++)
 						layout.foreground[(cy + (tv / 8)) * layout.width + (cx + (tv % 8))] = chunkMapping[chunk].tile[tv];
 				}
 			}
 			break;
 		case LEVELFORMAT_TILE16:
+		{
 			//Get our level dimensions
 			layout.width = layoutFile.ReadBE32();
 			layout.height = layoutFile.ReadBE32();
@@ -283,9 +300,12 @@ bool LEVEL::LoadLayout(LEVELTABLE *tableEntry)
 			}
 			
 			//Read our layout file
+			uint16_t *layoutData = new uint16_t[layout.width * layout.height];
+			layoutFile.ReadBE16(layoutData, layout.width * layout.height);
+			
 			for (size_t tv = 0; tv < layout.width * layout.height; tv++)
 			{
-				uint16_t tmap = layoutFile.ReadBE16();
+				uint16_t tmap = layoutData[tv];
 				layout.foreground[tv].altLRB	= (tmap & 0x8000) != 0;
 				layout.foreground[tv].altTop	= (tmap & 0x4000) != 0;
 				layout.foreground[tv].norLRB	= (tmap & 0x2000) != 0;
@@ -294,15 +314,21 @@ bool LEVEL::LoadLayout(LEVELTABLE *tableEntry)
 				layout.foreground[tv].xFlip		= (tmap & 0x0400) != 0;
 				layout.foreground[tv].tile		= (tmap & 0x3FF);
 			}
+			
+			delete[] layoutData;
 			break;
+		}
 		default:
 			Error(fail = "Unimplemented level format");
 			return true;
 	}
 	
+	//Create our object grid to cover the level
+	objectGrid = new OBJECTGRID(layout.width * 16, layout.height * 16);
+	
 	//Initialize boundaries
 	leftBoundary = tableEntry->leftBoundary;
-	rightBoundary = tableEntry->rightBoundary + gRenderSpec.width / 2;
+	rightBoundary = tableEntry->rightBoundary + gEngine->renderSpec.width / 2;
 	topBoundary = tableEntry->topBoundary;
 	bottomBoundary = tableEntry->bottomBoundary;
 	
@@ -342,10 +368,13 @@ bool LEVEL::LoadCollisionTiles(LEVELTABLE *tableEntry)
 		return true;
 	}
 	
+	const uint8_t *norMap = norMapFile.GetSpan(tiles);
+	const uint8_t *altMap = altMapFile.GetSpan(tiles);
+	
 	for (size_t i = 0; i < tiles; i++)
 	{
-		tileMapping[i].normalColTile = norMapFile.ReadU8();
-		tileMapping[i].alternateColTile = altMapFile.ReadU8();
+		tileMapping[i].normalColTile = norMap[i];
+		tileMapping[i].alternateColTile = altMap[i];
 	}
 	
 	//Open our collision tile files
@@ -381,20 +410,47 @@ bool LEVEL::LoadCollisionTiles(LEVELTABLE *tableEntry)
 	}
 	
 	//Read our collision tile data
+	const uint8_t *colNormal = colNormalFile.GetSpan(collisionTiles * 0x10);
+	const uint8_t *colRotated = colRotatedFile.GetSpan(collisionTiles * 0x10);
+	const uint8_t *colAngle = colAngleFile.GetSpan(collisionTiles);
+	
 	for (size_t i = 0; i < collisionTiles; i++)
 	{
-		for (int v = 0; v < 0x10; v++)
-		{
-			collisionTile[i].normal[v] = colNormalFile.ReadU8();
-			collisionTile[i].rotated[v] = colRotatedFile.ReadU8();
-		}
-		collisionTile[i].angle = colAngleFile.ReadU8();
+		memcpy(collisionTile[i].normal, colNormal + i * 0x10, 0x10);
+		memcpy(collisionTile[i].rotated, colRotated + i * 0x10, 0x10);
+		collisionTile[i].angle = colAngle[i];
 	}
 	
 	LOG(("Success!\n"));
 	return false;
 }
 
+bool LEVEL::ReloadCollisionTiles()
+{
+	//Load our collision tiles again, keeping our current ones if that fails
+	size_t oldTiles = tiles, oldCollisionTiles = collisionTiles;
+	TILEMAPPING *oldTileMapping = tileMapping;
+	COLLISIONTILE *oldCollisionTile = collisionTile;
+	tileMapping = nullptr;
+	collisionTile = nullptr;
+	
+	if (LoadCollisionTiles(&gLevelTable[levelId]))
+	{
+		delete[] tileMapping;
+		delete[] collisionTile;
+		tiles = oldTiles;
+		collisionTiles = oldCollisionTiles;
+		tileMapping = oldTileMapping;
+		collisionTile = oldCollisionTile;
+		fail = nullptr;
+		return true;
+	}
+	
+	delete[] oldTileMapping;
+	delete[] oldCollisionTile;
+	return false;
+}
+
 bool LEVEL::LoadObjects(LEVELTABLE *tableEntry)
 {
 	LOG(("Loading objects... "));
@@ -407,6 +463,9 @@ bool LEVEL::LoadObjects(LEVELTABLE *tableEntry)
 		return true;
 	}
 	
+	//Create our ring manager
+	ringManager = new RINGMANAGER;
+	
 	//Read our object data
 	switch (tableEntry->objectFormat)
 	{
@@ -453,6 +512,13 @@ bool LEVEL::LoadObjects(LEVELTABLE *tableEntry)
 					xFlip = (word2 & 0x2000) != 0;
 				}
 				
+				//Sonic 1 ring spawners are given to the ring manager rather than loaded as objects
+				if (tableEntry->objectFunctionList[id] == &ObjRingSpawner)
+				{
+					ringManager->AddSonic1Rings(xPos, yPos, subtype);
+					continue;
+				}
+				
 				//Create and link object load from data
 				OBJECT_LOAD *objectLoad = new OBJECT_LOAD;
 				objectLoad->function = tableEntry->objectFunctionList[id];
@@ -470,55 +536,18 @@ bool LEVEL::LoadObjects(LEVELTABLE *tableEntry)
 		}
 	}
 	
-	/*
-	//Open external ring file
-	char *ringPath = AllocPath(gBasePath, tableEntry->levelReferencePath, ".ring");
-	BACKEND_FILE *ringFile = OpenFile(ringPath, "rb");
-	delete[] ringPath;
-	
-	if (ringFile == nullptr)
+	//Load our external ring file and sort our rings
+	if (ringManager->LoadRingFile(gBasePath + tableEntry->levelReferencePath + ".ring"))
 	{
-		Error(fail = GetFileError());
+		Error(fail = ringManager->fail);
 		return true;
 	}
 	
-	//Read external ring data
-	int rings = GetFileSize(ringFile) / 4;
+	ringManager->Sort();
 	
-	for (int i = 0; i < rings; i++)
-	{
-		int16_t xPos = ReadFile_BE16(ringFile);
-		int16_t word2 = ReadFile_BE16(ringFile);
-		int16_t yPos = word2 & 0x0FFF;
-		
-		int type = (word2 & 0xF000) >> 12;
-		
-		for (int v = 0; v <= (type & 0x7); v++)
-		{
-			//Create and link object load from data
-			OBJECT_LOAD *objectLoad = new OBJECT_LOAD;
-			objectLoad->function = &ObjRing;
-			objectLoad->status = {false, false, false, false, false};
-			objectLoad->xLong = xPos << 16;
-			objectLoad->yLong = yPos << 16;
-			objectLoad->subtype = 0;
-			
-			objectLoad->loaded = nullptr;
-			objectLoad->loadRange = false;
-			objectLoad->specificBit = false;
-			
-			objectLoadList.link_back(objectLoad);
-			
-			//Offset next position
-			if (type & 0x8)
-				yPos += 0x18;
-			else
-				xPos += 0x18;
-		}
-	}
+	//Reserve our objects
+	ReserveObjects(OBJECT_RESERVE);
 	
-	CloseFile(ringFile);
-	*/
 	LOG(("Success!\n"));
 	return false;
 }
@@ -533,7 +562,7 @@ bool LEVEL::LoadArt(LEVELTABLE *tableEntry)
 		case ARTFORMAT_BMP:
 		{
 			//Load our foreground tilemap
-			tileTexture = new TEXTURE(tableEntry->artReferencePath + ".tileset.bmp");
+			tileTexture = TakeTexture(tableEntry->artReferencePath + ".tileset.bmp");
 			if (tileTexture->fail != nullptr)
 			{
 				Error(fail = tileTexture->fail);
@@ -563,9 +592,45 @@ bool LEVEL::LoadArt(LEVELTABLE *tableEntry)
 	return false;
 }
 
+//Queue the art our level needs to be decoded by the asset job system
+void LEVEL::QueueAssets(LEVELTABLE *tableEntry, const char *players[])
+{
+	//Level art (largest first)
+	if (tableEntry->artFormat == ARTFORMAT_BMP)
+		gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, tableEntry->artReferencePath + ".tileset.bmp");
+	gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, tableEntry->artReferencePath + ".background.bmp");
+	
+	//Object, player, title card, and HUD textures
+	for (int i = 0; preloadTexture[i] != ""; i++)
+		gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, preloadTexture[i]);
+	for (int i = 0; tableEntry->preloadTexture[i] != ""; i++)
+		gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, tableEntry->preloadTexture[i]);
+	for (int i = 0; players[i] != nullptr; i++)
+		gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, std::string(players[i]) + ".bmp");
+	
+	gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, "data/TitleCard.bmp");
+	gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, "data/HUD.bmp");
+	gEngine->assetJobs->Queue(ASSETJOB_TEXTURE, "data/GenericFont.bmp");
+	
+	//Mappings
+	for (int i = 0; preloadMappings[i] != ""; i++)
+		gEngine->assetJobs->Queue(ASSETJOB_MAPPINGS, preloadMappings[i]);
+	for (int i = 0; tableEntry->preloadMappings[i] != ""; i++)
+		gEngine->assetJobs->Queue(ASSETJOB_MAPPINGS, tableEntry->preloadMappings[i]);
+	for (int i = 0; players[i] != nullptr; i++)
+		gEngine->assetJobs->Queue(ASSETJOB_MAPPINGS, std::string(players[i]) + ".map");
+}
+
 //Unload data function
 void LEVEL::UnloadAll()
 {
+	//Stop decoding assets (any we didn't take are freed with it)
+	if (gEngine->assetJobs != nullptr)
+	{
+		delete gEngine->assetJobs;
+		gEngine->assetJobs = nullptr;
+	}
+	
 	//Free memory
 	delete[] layout.foreground;
 	delete[] chunkMapping;
@@ -584,30 +649,51 @@ void LEVEL::UnloadAll()
 	CLEAR_INSTANCE_LINKEDLIST(coreObjectList);
 	CLEAR_INSTANCE_LINKEDLIST(objectLoadList);
 	
+	if (objectGrid != nullptr)
+		delete objectGrid;
+	if (playerIndex != nullptr)
+		delete playerIndex;
+	if (objectJobs != nullptr)
+		delete objectJobs;
+	if (ringManager != nullptr)
+		delete ringManager;
 	if (camera != nullptr)
 		delete camera;
 	if (titleCard != nullptr)
 		delete titleCard;
 	if (hud != nullptr)
 		delete hud;
+	if (perfHud != nullptr)
+		delete perfHud;
 	
 	//Unload object textures and mappings
 	CLEAR_INSTANCE_LINKEDLIST(objTextureCache);
 	CLEAR_INSTANCE_LINKEDLIST(objMappingsCache);
+	
+	//Free our reserved objects
+	FreeObjectPool();
 }
 
 //Level class
 LEVEL::LEVEL(int id, const char *players[])
 {
+	PROFILE_ZONE("Level load");
 	LOG(("Loading level ID %d...\n", id));
 	
 	//Set us as the global level
-	gLevel = this;
+	gEngine->level = this;
 	
 	//Get data from this table entry
 	LEVELTABLE *tableEntry = &gLevelTable[levelId = (LEVELID)id];
 	zone = tableEntry->zone;
 	
+	//Start decoding our art on the asset job system while everything else loads
+	if (gAssetJobThreads != 0)
+	{
+		gEngine->assetJobs = new ASSETJOBS(gAssetJobThreads);
+		QueueAssets(tableEntry, players);
+	}
+	
 	//Load data
 	if (LoadMappings(tableEntry) || LoadLayout(tableEntry) || LoadCollisionTiles(tableEntry) || LoadObjects(tableEntry) || LoadArt(tableEntry))
 	{
@@ -619,7 +705,7 @@ LEVEL::LEVEL(int id, const char *players[])
 	//Preload generic assets
 	for (int i = 0; preloadTexture[i] != ""; i++)
 	{
-		TEXTURE *tex = GetObjectTexture(preloadTexture[i]);
+		TEXTURE *tex = GetObjectTexture(preloadTexture[i].c_str());
 		if (tex->fail != nullptr)
 		{
 			fail = tex->fail;
@@ -630,7 +716,7 @@ LEVEL::LEVEL(int id, const char *players[])
 			
 	for (int i = 0; preloadMappings[i] != ""; i++)
 	{
-		MAPPINGS *map = GetObjectMappings(preloadMappings[i]);
+		MAPPINGS *map = GetObjectMappings(preloadMappings[i].c_str());
 		if (map->fail != nullptr)
 		{
 			fail = map->fail;
@@ -642,7 +728,7 @@ LEVEL::LEVEL(int id, const char *players[])
 	//Preload stage's assets
 	for (int i = 0; tableEntry->preloadTexture[i] != ""; i++)
 	{
-		TEXTURE *tex = GetObjectTexture(tableEntry->preloadTexture[i]);
+		TEXTURE *tex = GetObjectTexture(tableEntry->preloadTexture[i].c_str());
 		if (tex->fail != nullptr)
 		{
 			fail = tex->fail;
@@ -653,7 +739,7 @@ LEVEL::LEVEL(int id, const char *players[])
 			
 	for (int i = 0; tableEntry->preloadMappings[i] != ""; i++)
 	{
-		MAPPINGS *map = GetObjectMappings(tableEntry->preloadMappings[i]);
+		MAPPINGS *map = GetObjectMappings(tableEntry->preloadMappings[i].c_str());
 		if (map->fail != nullptr)
 		{
 			fail = map->fail;
@@ -662,6 +748,10 @@ LEVEL::LEVEL(int id, const char *players[])
 		}
 	}
 	
+	//Give our ring manager its graphics (preloaded above)
+	ringManager->texture = GetObjectTexture("data/Object/Generic.bmp");
+	ringManager->mappings = GetObjectMappings("data/Object/Ring.map");
+	
 	//Create our players
 	PLAYER *follow = nullptr;
 	
@@ -681,6 +771,13 @@ LEVEL::LEVEL(int id, const char *players[])
 		playerList.link_back(newPlayer);
 	}
 	
+	//Create our player index for solid objects
+	playerIndex = new PLAYERINDEX;
+	
+	//Start our object job system if enabled
+	if (gObjectJobThreads != 0)
+		objectJobs = new OBJECTJOBS(gObjectJobThreads);
+	
 	//Create our camera
 	camera = new CAMERA(playerList[0]);
 	
@@ -702,6 +799,25 @@ LEVEL::LEVEL(int id, const char *players[])
 		return;
 	}
 	
+	//Performance HUD
+	#ifdef PERF_HUD
+		perfHud = new PERFHUD();
+		if (perfHud->fail != nullptr)
+		{
+			fail = perfHud->fail;
+			UnloadAll();
+			return;
+		}
+	#endif
+	
+	//Publish any decoded assets that haven't been used yet to our caches, then stop the asset job system
+	if (gEngine->assetJobs != nullptr)
+	{
+		gEngine->assetJobs->Finish(&objTextureCache, &objMappingsCache);
+		delete gEngine->assetJobs;
+		gEngine->assetJobs = nullptr;
+	}
+	
 	//Initialize oscillatory values
 	OscillatoryInit();
 	
@@ -715,6 +831,9 @@ LEVEL::LEVEL(int id, const char *players[])
 	ClearControllerInput();
 	UpdateStage();
 	
+	//Start our music
+	PlayMusic(tableEntry->music.c_str(), 0);
+	
 	LOG(("Success!\n"));
 }
 
@@ -775,9 +894,9 @@ void LEVEL::DynamicEvents()
 			{
 				//Get this player and the tile we're on
 				PLAYER *player = playerList[i];
-				if (player->x.pos < 0 || player->x.pos >= (int16_t)(gLevel->layout.width * 16) || player->y.pos < 0 || player->y.pos >= (int16_t)(gLevel->layout.height * 16))
+				if (player->x.pos < 0 || player->x.pos >= (int16_t)(gEngine->level->layout.width * 16) || player->y.pos < 0 || player->y.pos >= (int16_t)(gEngine->level->layout.height * 16))
 					continue;
-				TILE *tile = &gLevel->layout.foreground[(size_t)(player->y.pos / 16) * gLevel->layout.width + (size_t)(player->x.pos / 16)];
+				TILE *tile = &gEngine->level->layout.foreground[(size_t)(player->y.pos / 16) * gEngine->level->layout.width + (size_t)(player->x.pos / 16)];
 				
 				//If this is an S-tube chunk tile, roll
 				bool doRoll = false;
@@ -805,8 +924,8 @@ void LEVEL::DynamicEvents()
 	}
 	
 	//Level specific events
-	uint16_t checkX = camera->xPos + (gRenderSpec.width - 320) / 2;
-	uint16_t checkY = camera->yPos + (gRenderSpec.height - 224) / 2;
+	uint16_t checkX = camera->xPos + (gEngine->renderSpec.width - 320) / 2;
+	uint16_t checkY = camera->yPos + (gEngine->renderSpec.height - 224) / 2;
 	
 	switch (levelId)
 	{
@@ -879,8 +998,8 @@ void LEVEL::DynamicEvents()
 	if (bottomBoundaryTarget < bottomBoundary)
 	{
 		//Move up to the boundary smoothly
-		if ((camera->yPos + gRenderSpec.height) > bottomBoundaryTarget)
-			bottomBoundary = (camera->yPos + gRenderSpec.height);
+		if ((camera->yPos + gEngine->renderSpec.height) > bottomBoundaryTarget)
+			bottomBoundary = (camera->yPos + gEngine->renderSpec.height);
 		
 		//Move
 		bottomBoundary -= move;
@@ -890,7 +1009,7 @@ void LEVEL::DynamicEvents()
 	else if (bottomBoundaryTarget > bottomBoundary)
 	{
 		//Move faster if in mid-air
-		if ((camera->yPos + 8 + gRenderSpec.height) >= bottomBoundary && playerList[0]->status.inAir)
+		if ((camera->yPos + 8 + gEngine->renderSpec.height) >= bottomBoundary && playerList[0]->status.inAir)
 			move *= 4;
 		
 		//Move
@@ -901,7 +1020,7 @@ void LEVEL::DynamicEvents()
 	
 	//Set boundaries to target
 	int16_t left = camera->xPos;
-	int16_t right = camera->xPos + gRenderSpec.width;
+	int16_t right = camera->xPos + gEngine->renderSpec.width;
 	
 	if (leftBoundary < leftBoundaryTarget)
 	{
@@ -929,20 +1048,21 @@ void LEVEL::DynamicEvents()
 }
 
 //Texture cache and mappings cache
-TEXTURE *LEVEL::GetObjectTexture(std::string path)
+TEXTURE *LEVEL::GetObjectTexture(const char *path)
 {
+	//Find our texture in the cache (objects get theirs every time they're created, so this doesn't make a string from the path)
 	for (size_t i = 0; i < objTextureCache.size(); i++)
 	{
 		if (objTextureCache[i]->source == path)
 			return objTextureCache[i];
 	}
 	
-	TEXTURE *newTexture = new TEXTURE(path);
+	TEXTURE *newTexture = TakeTexture(path);
 	objTextureCache.link_back(newTexture);
 	return newTexture;
 }
 
-MAPPINGS *LEVEL::GetObjectMappings(std::string path)
+MAPPINGS *LEVEL::GetObjectMappings(const char *path)
 {
 	for (size_t i = 0; i < objMappingsCache.size(); i++)
 	{
@@ -950,7 +1070,7 @@ MAPPINGS *LEVEL::GetObjectMappings(std::string path)
 			return objMappingsCache[i];
 	}
 	
-	MAPPINGS *newMappings = new MAPPINGS(path);
+	MAPPINGS *newMappings = TakeMappings(path);
 	objMappingsCache.link_back(newMappings);
 	return newMappings;
 }
@@ -965,8 +1085,28 @@ OBJECT_LOAD *LEVEL::GetObjectLoad(OBJECT *object)
 	return nullptr;
 }
 
+void LEVEL::LinkObject(OBJECT *object)
+{
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_LINKOBJECT)->object = object;
+		return;
+	}
+	
+	//Link to the end of the object list
+	objectList.link_back(object);
+}
+
 void LEVEL::LinkObjectLoad(OBJECT *object)
 {
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_LINKOBJECTLOAD)->object = object;
+		return;
+	}
+	
 	//Define our object load struct and link it
 	OBJECT_LOAD *objectLoad = new OBJECT_LOAD;
 	objectLoad->function = object->function;
@@ -984,6 +1124,13 @@ void LEVEL::LinkObjectLoad(OBJECT *object)
 
 void LEVEL::ReleaseObjectLoad(OBJECT *object)
 {
+	//If updating an object on a worker thread, defer to the object's command buffer
+	if (gObjectCommands != nullptr)
+	{
+		gObjectCommands->Push(OBJECTCOMMAND_RELEASEOBJECTLOAD)->object = object;
+		return;
+	}
+	
 	//Remove object from object load list
 	for (size_t i = 0; i < objectLoadList.size(); i++)
 	{
@@ -1007,12 +1154,14 @@ void LEVEL::UnrefObjectLoad(OBJECT *object)
 
 void LEVEL::CheckObjectLoad()
 {
+	PROFILE_ZONE("CheckObjectLoad");
+	
 	//Check all object loads if they should be loaded
 	for (size_t i = 0; i < objectLoadList.size(); i++)
 	{
 		//Check if this object load is in load range
 		uint16_t xOff = (objectLoadList[i]->x.pos & 0xFF80) - ((camera->xPos - 0x80) & 0xFF80);
-		bool isLoadRange = xOff <= upperRound(0x80 + gRenderSpec.width + 0x80, 0x80);
+		bool isLoadRange = xOff <= upperRound(0x80 + gEngine->renderSpec.width + 0x80, 0x80);
 		
 		//Check if we're just now in range, and load object if so
 		if (isLoadRange == true && objectLoadList[i]->loadRange == false && objectLoadList[i]->loaded == nullptr)
@@ -1025,12 +1174,15 @@ void LEVEL::CheckObjectLoad()
 			newObject->subtype = objectLoadList[i]->subtype;
 			objectLoadList[i]->loaded = newObject;
 			
-			gLevel->objectList.link_back(newObject);
+			gEngine->level->objectList.link_back(newObject);
 		}
 		
 		//Update the object load's state
 		objectLoadList[i]->loadRange = isLoadRange;
 	}
+	
+	//Update the rings in load range
+	ringManager->UpdateWindow(camera->xPos, gEngine->renderSpec.width);
 }
 
 //Object layer function
@@ -1125,36 +1277,47 @@ void LEVEL::OscillatoryUpdate()
 //Level update and draw
 bool LEVEL::UpdateStage()
 {
-	if (updateStage)
+	PROFILE_ZONE("UpdateStage");
+	
+	//Refresh the object grid for player touch checks
+	objectGrid->Refresh(&objectList);
+	
+	//Update players
 	{
-		//Update players and objects
+		PROFILE_ZONE("Players");
 		for (size_t i = 0; i < playerList.size(); i++)
 			playerList[i]->Update();
+		playerIndex->Rebuild(&playerList);
+	}
 	
-		for (size_t i = 0; i < objectList.size(); i++)
+	//Update objects (if not to update the stage, only players and core objects are updated)
+	if (updateStage)
+	{
+		PROFILE_ZONE("Objects");
+		
+		//Update objects away from players in parallel first, their global state changes are made once we reach them below
+		if (objectJobs != nullptr && objectJobs->Run(&objectList))
 		{
-			if (objectList[i]->Update())
-			{
-				fail = objectList[i]->fail;
-				return true;
-			}
+			fail = objectJobs->fail;
+			return true;
 		}
 		
-		for (size_t i = 0; i < coreObjectList.size(); i++)
+		for (size_t i = 0; i < objectList.size(); i++)
 		{
-			if (coreObjectList[i]->Update())
+			OBJECT *object = objectList[i];
+			if (object->job != nullptr ? objectJobs->Finish(object) : object->Update())
 			{
-				fail = coreObjectList[i]->fail;
+				fail = object->fail;
 				return true;
 			}
 		}
+		
+		//Update bouncing rings and sparkles
+		ringManager->Update();
 	}
-	else
+	
 	{
-		//If not to update the stage, only update players and core objects
-		for (size_t i = 0; i < playerList.size(); i++)
-			playerList[i]->Update();
-		
+		PROFILE_ZONE("Core objects");
 		for (size_t i = 0; i < coreObjectList.size(); i++)
 		{
 			if (coreObjectList[i]->Update())
@@ -1200,13 +1363,22 @@ bool LEVEL::Update()
 	OscillatoryUpdate();
 	
 	//Increase our time
-	if (gLevel->updateTime)
-		gTime++;
+	if (gEngine->level->updateTime)
+		gEngine->time++;
+	
+	//Log our state
+	if (gEngine->stateHash != nullptr && gEngine->stateHash->Capture(frameCounter))
+	{
+		fail = gEngine->stateHash->fail;
+		return true;
+	}
 	return false;
 }
 
 void LEVEL::Draw()
 {
+	PROFILE_ZONE("LEVEL::Draw");
+	
 	//Update palette cycling
 	if (!fading)
 	{
@@ -1226,8 +1398,8 @@ void LEVEL::Draw()
 	{
 		size_t cLeft = mmax(camera->xPos / 16, 0);
 		size_t cTop = mmax(camera->yPos / 16, 0);
-		size_t cRight = mmin(upperRound(camera->xPos + (size_t)gRenderSpec.width, 16) / 16, (size_t)gLevel->layout.width - 1);
-		size_t cBottom = mmin(upperRound(camera->yPos + (size_t)gRenderSpec.height, 16) / 16, (size_t)gLevel->layout.height - 1);
+		size_t cRight = mmin(upperRound(camera->xPos + (size_t)gEngine->renderSpec.width, 16) / 16, (size_t)gEngine->level->layout.width - 1);
+		size_t cBottom = mmin(upperRound(camera->yPos + (size_t)gEngine->renderSpec.height, 16) / 16, (size_t)gEngine->level->layout.height - 1);
 		
 		for (size_t ty = cTop; ty < cBottom; ty++)
 		{
@@ -1241,8 +1413,8 @@ void LEVEL::Draw()
 				//Draw tile
 				RECT backSrc = {0, tile->tile * 16, 16, 16};
 				RECT frontSrc = {16, tile->tile * 16, 16, 16};
-				gSoftwareBuffer->DrawTexture(tileTexture, tileTexture->loadedPalette, &backSrc, LEVEL_RENDERLAYER_FOREGROUND_LOW, tx * 16 - camera->xPos, ty * 16 - camera->yPos, tile->xFlip, tile->yFlip);
-				gSoftwareBuffer->DrawTexture(tileTexture, tileTexture->loadedPalette, &frontSrc, LEVEL_RENDERLAYER_FOREGROUND_HIGH, tx * 16 - camera->xPos, ty * 16 - camera->yPos, tile->xFlip, tile->yFlip);
+				gEngine->softwareBuffer->DrawTexture(tileTexture, tileTexture->loadedPalette, &backSrc, LEVEL_RENDERLAYER_FOREGROUND_LOW, tx * 16 - camera->xPos, ty * 16 - camera->yPos, tile->xFlip, tile->yFlip);
+				gEngine->softwareBuffer->DrawTexture(tileTexture, tileTexture->loadedPalette, &frontSrc, LEVEL_RENDERLAYER_FOREGROUND_HIGH, tx * 16 - camera->xPos, ty * 16 - camera->yPos, tile->xFlip, tile->yFlip);
 			}
 		}
 	}
@@ -1254,7 +1426,10 @@ void LEVEL::Draw()
 		objectList[i]->Draw();
 	for (size_t i = 0; i < coreObjectList.size(); i++)
 		coreObjectList[i]->Draw();
+	ringManager->Draw();
 	
-	//Draw HUD
+	//Draw HUD and performance HUD
 	hud->Draw();
+	if (perfHud != nullptr)
+		perfHud->Draw();
 }
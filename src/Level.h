@@ -8,9 +8,15 @@
 #include "LevelSpecific.h"
 #include "Player.h"
 #include "Object.h"
+#include "ObjectGrid.h"
+#include "PlayerIndex.h"
+#include "ObjectJobs.h"
+#include "AssetJobs.h"
+#include "RingManager.h"
 #include "Camera.h"
 #include "TitleCard.h"
 #include "Hud.h"
+#include "PerfHud.h"
 #include "Background.h"
 
 #define OSCILLATORY_VALUES 16
@@ -19,6 +25,8 @@
 #define OBJECT_LAYERS 8
 enum LEVEL_RENDERLAYER
 {
+	LEVEL_RENDERLAYER_PERFHUD,
+	LEVEL_RENDERLAYER_PERFHUD_BACK,
 	LEVEL_RENDERLAYER_TITLECARD,
 	LEVEL_RENDERLAYER_HUD,
 	LEVEL_RENDERLAYER_OBJECT_HIGH_0,
@@ -204,14 +212,19 @@ class LEVEL
 		
 		//Players and objects
 		LINKEDLIST<PLAYER*> playerList;
+		PLAYERINDEX *playerIndex = nullptr;
 		LINKEDLIST<OBJECT*> coreObjectList;
 		LINKEDLIST<OBJECT_LOAD*> objectLoadList;
 		LINKEDLIST<OBJECT*> objectList;
+		OBJECTGRID *objectGrid = nullptr;
+		OBJECTJOBS *objectJobs = nullptr;
+		RINGMANAGER *ringManager = nullptr;
 		
-		//Title card, camera, and HUD
+		//Title card, camera, HUD, and performance HUD
 		CAMERA *camera = nullptr;
 		TITLECARD *titleCard = nullptr;
 		HUD *hud = nullptr;
+		PERFHUD *perfHud = nullptr;
 		
 		//Object texture cache
 		LINKEDLIST<TEXTURE*> objTextureCache;
@@ -237,6 +250,8 @@ class LEVEL
 		bool LoadCollisionTiles(LEVELTABLE *tableEntry);
 		bool LoadObjects(LEVELTABLE *tableEntry);
 		bool LoadArt(LEVELTABLE *tableEntry);
+		bool ReloadCollisionTiles();
+		void QueueAssets(LEVELTABLE *tableEntry, const char *players[]);
 		void UnloadAll();
 		
 		//Fading
@@ -247,8 +262,11 @@ class LEVEL
 		void DynamicEvents();
 		
 		//Object texture and mapping cache functions
-		TEXTURE *GetObjectTexture(std::string path);
-		MAPPINGS *GetObjectMappings(std::string path);
+		TEXTURE *GetObjectTexture(const char *path);
+		MAPPINGS *GetObjectMappings(const char *path);
+		
+		//Object functions
+		void LinkObject(OBJECT *object);
 		
 		//Object load functions
 		OBJECT_LOAD *GetObjectLoad(OBJECT *object);
@@ -2,13 +2,14 @@
 #include "Level.h"
 #include "Game.h"
 #include "Log.h"
+#include "PerfHud.h"
 
 //Get the layout tile at the given x,y coordinate
 TILE *GetTileAt(int16_t x, int16_t y)
 {
-	if (x < 0 || (size_t)(x / 16) >= gLevel->layout.width || y < 0 || (size_t)(y / 16) >= gLevel->layout.height)
+	if (x < 0 || (size_t)(x / 16) >= gEngine->level->layout.width || y < 0 || (size_t)(y / 16) >= gEngine->level->layout.height)
 		return nullptr;
-	return &gLevel->layout.foreground[(size_t)(y / 16) * gLevel->layout.width + (size_t)(x / 16)];
+	return &gEngine->level->layout.foreground[(size_t)(y / 16) * gEngine->level->layout.width + (size_t)(x / 16)];
 }
 
 #define TILE_ON_LAYER(alt, lrb, tile) (!(alt ? ((!lrb && !tile->altTop) || (lrb && !tile->altLRB)) : ((!lrb && !tile->norTop) || (lrb && !tile->norLRB))))
@@ -21,10 +22,10 @@ int16_t GetCollisionH_Tile2(int16_t x, int16_t y, COLLISIONLAYER layer, bool fli
 	
 	if (tile != nullptr && tile->tile != 0 && TILE_ON_LAYER(LAYER_IS_ALT(layer), LAYER_IS_LRB(layer), tile))
 	{
-		TILEMAPPING *tileMap = &gLevel->tileMapping[tile->tile];
-		COLLISIONTILE *collisionTile = &gLevel->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
+		TILEMAPPING *tileMap = &gEngine->level->tileMapping[tile->tile];
+		COLLISIONTILE *collisionTile = &gEngine->level->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
 		
-		if (collisionTile != gLevel->collisionTile)
+		if (collisionTile != gEngine->level->collisionTile)
 		{
 			//Get our angle
 			if (angle != nullptr)
@@ -69,6 +70,8 @@ int16_t GetCollisionH_Tile2(int16_t x, int16_t y, COLLISIONLAYER layer, bool fli
 
 int16_t GetCollisionH(int16_t x, int16_t y, COLLISIONLAYER layer, bool flipped, uint8_t *angle)
 {
+	PERF_COUNT(collisionProbes);
+	
 	//Flip our x-position if flipped
 	if (flipped)
 		x ^= 0xF;
@@ -78,10 +81,10 @@ int16_t GetCollisionH(int16_t x, int16_t y, COLLISIONLAYER layer, bool flipped,
 	
 	if (tile != nullptr && tile->tile != 0 && TILE_ON_LAYER(LAYER_IS_ALT(layer), LAYER_IS_LRB(layer), tile))
 	{
-		TILEMAPPING *tileMap = &gLevel->tileMapping[tile->tile];
-		COLLISIONTILE *collisionTile = &gLevel->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
+		TILEMAPPING *tileMap = &gEngine->level->tileMapping[tile->tile];
+		COLLISIONTILE *collisionTile = &gEngine->level->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
 		
-		if (collisionTile != gLevel->collisionTile)
+		if (collisionTile != gEngine->level->collisionTile)
 		{
 			//Get our angle
 			if (angle != nullptr)
@@ -135,10 +138,10 @@ int16_t GetCollisionV_Tile2(int16_t x, int16_t y, COLLISIONLAYER layer, bool fli
 	//Flip our y-position if flipped
 	if (tile != nullptr && tile->tile != 0 && TILE_ON_LAYER(LAYER_IS_ALT(layer), LAYER_IS_LRB(layer), tile))
 	{
-		TILEMAPPING *tileMap = &gLevel->tileMapping[tile->tile];
-		COLLISIONTILE *collisionTile = &gLevel->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
+		TILEMAPPING *tileMap = &gEngine->level->tileMapping[tile->tile];
+		COLLISIONTILE *collisionTile = &gEngine->level->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
 		
-		if (collisionTile != gLevel->collisionTile)
+		if (collisionTile != gEngine->level->collisionTile)
 		{
 			//Get our angle
 			if (angle != nullptr)
@@ -183,6 +186,8 @@ int16_t GetCollisionV_Tile2(int16_t x, int16_t y, COLLISIONLAYER layer, bool fli
 
 int16_t GetCollisionV(int16_t x, int16_t y, COLLISIONLAYER layer, bool flipped, uint8_t *angle)
 {
+	PERF_COUNT(collisionProbes);
+	
 	//Flip our y-position if flipped
 	if (flipped)
 		y ^= 0xF;
@@ -192,10 +197,10 @@ int16_t GetCollisionV(int16_t x, int16_t y, COLLISIONLAYER layer, bool flipped,
 	
 	if (tile != nullptr && tile->tile != 0 && TILE_ON_LAYER(LAYER_IS_ALT(layer), LAYER_IS_LRB(layer), tile))
 	{
-		TILEMAPPING *tileMap = &gLevel->tileMapping[tile->tile];
-		COLLISIONTILE *collisionTile = &gLevel->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
+		TILEMAPPING *tileMap = &gEngine->level->tileMapping[tile->tile];
+		COLLISIONTILE *collisionTile = &gEngine->level->collisionTile[LAYER_IS_ALT(layer) ? (tileMap->alternateColTile) : (tileMap->normalColTile)];
 		
-		if (collisionTile != gLevel->collisionTile)
+		if (collisionTile != gEngine->level->collisionTile)
 		{
 			//Get our angle
 			if (angle != nullptr)
@@ -3,6 +3,19 @@
 
 typedef void (*PALETTECYCLEFUNCTION)();
 
+//Level specific state, kept in the engine context
+struct LEVELSPECIFICSTATE
+{
+	//Green Hill Zone
+	int ghzPaletteTimer = 0;
+	uint32_t ghzCloudScroll[3] = {0, 0, 0};
+	
+	//Emerald Hill Zone
+	int ehzPaletteTimer = 0;
+	int ehzHorWaterTimer = 4;
+	uint16_t ehzHorWaterRipple = 0;
+};
+
 void GHZ_PaletteCycle();
 void EHZ_PaletteCycle();
 void GHZ_Background(BACKGROUND *background, bool doScroll, int cameraX, int cameraY);
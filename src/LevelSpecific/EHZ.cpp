@@ -4,24 +4,24 @@
 void EHZ_PaletteCycle()
 {
 	//Waterfall and water palette cycle
-	static int timer = 0;
+	LEVELSPECIFICSTATE *state = &gEngine->levelSpecific;
 	
-	if (--timer < 0)
+	if (--state->ehzPaletteTimer < 0)
 	{
 		//Cycle colours and reset timer
-		timer = 7;
+		state->ehzPaletteTimer = 7;
 		
 		//Cycle the tile texture (using the background palette, because it won't change until after)
-		gLevel->tileTexture->loadedPalette->colour[0x1F] = gLevel->background->texture->loadedPalette->colour[0x1E];
-		gLevel->tileTexture->loadedPalette->colour[0x1E] = gLevel->background->texture->loadedPalette->colour[0x14];
-		gLevel->tileTexture->loadedPalette->colour[0x14] = gLevel->background->texture->loadedPalette->colour[0x13];
-		gLevel->tileTexture->loadedPalette->colour[0x13] = gLevel->background->texture->loadedPalette->colour[0x1F];
+		gEngine->level->tileTexture->loadedPalette->colour[0x1F] = gEngine->level->background->texture->loadedPalette->colour[0x1E];
+		gEngine->level->tileTexture->loadedPalette->colour[0x1E] = gEngine->level->background->texture->loadedPalette->colour[0x14];
+		gEngine->level->tileTexture->loadedPalette->colour[0x14] = gEngine->level->background->texture->loadedPalette->colour[0x13];
+		gEngine->level->tileTexture->loadedPalette->colour[0x13] = gEngine->level->background->texture->loadedPalette->colour[0x1F];
 		
 		//Copy the background's palette from the tile texture
-		gLevel->background->texture->loadedPalette->colour[0x13] = gLevel->tileTexture->loadedPalette->colour[0x13];
-		gLevel->background->texture->loadedPalette->colour[0x14] = gLevel->tileTexture->loadedPalette->colour[0x14];
-		gLevel->background->texture->loadedPalette->colour[0x1E] = gLevel->tileTexture->loadedPalette->colour[0x1E];
-		gLevel->background->texture->loadedPalette->colour[0x1F] = gLevel->tileTexture->loadedPalette->colour[0x1F];
+		gEngine->level->background->texture->loadedPalette->colour[0x13] = gEngine->level->tileTexture->loadedPalette->colour[0x13];
+		gEngine->level->background->texture->loadedPalette->colour[0x14] = gEngine->level->tileTexture->loadedPalette->colour[0x14];
+		gEngine->level->background->texture->loadedPalette->colour[0x1E] = gEngine->level->tileTexture->loadedPalette->colour[0x1E];
+		gEngine->level->background->texture->loadedPalette->colour[0x1F] = gEngine->level->tileTexture->loadedPalette->colour[0x1F];
 	}
 }
 
@@ -50,19 +50,18 @@ void EHZ_Background(BACKGROUND *background, bool doScroll, int cameraX, int came
 	background->DrawStrip(&sky, LEVEL_RENDERLAYER_BACKGROUND, 0, -scrollBG1, -scrollBG1);
 	
 	//Rippling water at the horizon (change ripple every 8 frames)
-	static int horWaterTimer = 4;
-	static uint16_t horWaterRipple = 0;
+	LEVELSPECIFICSTATE *state = &gEngine->levelSpecific;
 	
 	if (doScroll)
 	{
-		if ((horWaterTimer++ & 0x7) == 0)
-			--horWaterRipple;
+		if ((state->ehzHorWaterTimer++ & 0x7) == 0)
+			--state->ehzHorWaterRipple;
 	}
 	
 	RECT waterRipple = {0,  80, background->texture->width,  1};
 	for (int i = 0; i < 21; i++)
 	{
-		int x = -(scrollBG1 + ehzScrollRipple[(horWaterRipple & 0x1F) + i]);
+		int x = -(scrollBG1 + ehzScrollRipple[(state->ehzHorWaterRipple & 0x1F) + i]);
 		background->DrawStrip(&waterRipple, LEVEL_RENDERLAYER_BACKGROUND, waterRipple.y++, x, x);
 	}
 	
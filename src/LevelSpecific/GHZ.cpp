@@ -5,24 +5,24 @@
 void GHZ_PaletteCycle()
 {
 	//Waterfall and water palette cycle
-	static int timer = 0;
+	LEVELSPECIFICSTATE *state = &gEngine->levelSpecific;
 	
-	if (--timer < 0)
+	if (--state->ghzPaletteTimer < 0)
 	{
 		//Cycle colours and reset timer
-		timer = 5;
+		state->ghzPaletteTimer = 5;
 		
 		//Cycle the tile texture (using the background palette, because it won't change until after)
-		gLevel->tileTexture->loadedPalette->colour[0x28] = gLevel->background->texture->loadedPalette->colour[0x2B];
-		gLevel->tileTexture->loadedPalette->colour[0x29] = gLevel->background->texture->loadedPalette->colour[0x28];
-		gLevel->tileTexture->loadedPalette->colour[0x2A] = gLevel->background->texture->loadedPalette->colour[0x29];
-		gLevel->tileTexture->loadedPalette->colour[0x2B] = gLevel->background->texture->loadedPalette->colour[0x2A];
+		gEngine->level->tileTexture->loadedPalette->colour[0x28] = gEngine->level->background->texture->loadedPalette->colour[0x2B];
+		gEngine->level->tileTexture->loadedPalette->colour[0x29] = gEngine->level->background->texture->loadedPalette->colour[0x28];
+		gEngine->level->tileTexture->loadedPalette->colour[0x2A] = gEngine->level->background->texture->loadedPalette->colour[0x29];
+		gEngine->level->tileTexture->loadedPalette->colour[0x2B] = gEngine->level->background->texture->loadedPalette->colour[0x2A];
 		
 		//Copy the background's palette from the tile texture
-		gLevel->background->texture->loadedPalette->colour[0x28] = gLevel->tileTexture->loadedPalette->colour[0x28];
-		gLevel->background->texture->loadedPalette->colour[0x29] = gLevel->tileTexture->loadedPalette->colour[0x29];
-		gLevel->background->texture->loadedPalette->colour[0x2A] = gLevel->tileTexture->loadedPalette->colour[0x2A];
-		gLevel->background->texture->loadedPalette->colour[0x2B] = gLevel->tileTexture->loadedPalette->colour[0x2B];
+		gEngine->level->background->texture->loadedPalette->colour[0x28] = gEngine->level->tileTexture->loadedPalette->colour[0x28];
+		gEngine->level->background->texture->loadedPalette->colour[0x29] = gEngine->level->tileTexture->loadedPalette->colour[0x29];
+		gEngine->level->background->texture->loadedPalette->colour[0x2A] = gEngine->level->tileTexture->loadedPalette->colour[0x2A];
+		gEngine->level->background->texture->loadedPalette->colour[0x2B] = gEngine->level->tileTexture->loadedPalette->colour[0x2B];
 	}
 }
 
@@ -35,7 +35,7 @@ void GHZ_Background(BACKGROUND *background, bool doScroll, int cameraX, int came
 	int16_t backY = mmin(-(cameraY / -0x20 + 0x20), 0);
 	
 	//Scroll clouds
-	static uint32_t cloudScroll[3] = {0, 0, 0};
+	uint32_t *cloudScroll = gEngine->levelSpecific.ghzCloudScroll;
 	if (doScroll)
 	{
 		(cloudScroll[0] += 0x10) %= (background->texture->width * 0x10);
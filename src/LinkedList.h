@@ -1,6 +1,7 @@
 #pragma once
 #include <stddef.h>
 #include <stdio.h>
+#include <mutex>
 
 template <typename T> struct LL_NODE
 {
@@ -16,16 +17,102 @@ template <typename T> class LINKEDLIST
 		LL_NODE<T> *tail = nullptr;
 		size_t llSize = 0;
 		
+		//Erased nodes, reused by the next links (so a list that's emptied and refilled every frame doesn't allocate once it's grown)
+		LL_NODE<T> *spare = nullptr;
+		LINKEDLIST<T> *spareOwner = nullptr;	//List whose erased nodes we share, nullptr to keep our own (it must outlive us)
+		
+		//Nodes shared by every list of this type, taken once a list has no erased nodes of its own, and given back when a list is destroyed (so short-lived lists don't allocate either)
+		static LL_NODE<T> *pool;
+		static std::mutex poolMutex;
+		
 	public:
 		//Constructor and destructor
 		LINKEDLIST() { return; }
-		~LINKEDLIST() { clear(); }
+		~LINKEDLIST() { clear(); free_spare(); }
+		
+		//Node allocation
+		inline LL_NODE<T> **spare_list() { return (spareOwner != nullptr) ? &spareOwner->spare : &spare; }
+		
+		inline LL_NODE<T> *new_node()
+		{
+			//Reuse an erased node if we have one
+			LL_NODE<T> **spareList = spare_list();
+			if (*spareList == nullptr)
+				return pool_node();
+			LL_NODE<T> *node = *spareList;
+			*spareList = node->next;
+			return node;
+		}
+		
+		static LL_NODE<T> *pool_node()
+		{
+			//Take a node from our pool, or allocate one if it's empty
+			std::lock_guard<std::mutex> lock(poolMutex);
+			if (pool == nullptr)
+				return new LL_NODE<T>;
+			LL_NODE<T> *node = pool;
+			pool = node->next;
+			return node;
+		}
+		
+		inline void reserve(size_t nodes)
+		{
+			//Allocate erased nodes up front, so the first links don't allocate either
+			LL_NODE<T> **spareList = spare_list();
+			for (size_t i = 0; i < nodes; i++)
+			{
+				LL_NODE<T> *node = new LL_NODE<T>;
+				node->next = *spareList;
+				*spareList = node;
+			}
+		}
+		
+		inline void free_spare()
+		{
+			//Give our own erased nodes back to our pool
+			if (spare == nullptr)
+				return;
+			
+			LL_NODE<T> *last = spare;
+			while (last->next != nullptr)
+				last = last->next;
+			
+			std::lock_guard<std::mutex> lock(poolMutex);
+			last->next = pool;
+			pool = spare;
+			spare = nullptr;
+		}
+		
+		//Pool functions
+		static void reserve_pool(size_t nodes)
+		{
+			//Allocate nodes into our pool up front
+			std::lock_guard<std::mutex> lock(poolMutex);
+			for (size_t i = 0; i < nodes; i++)
+			{
+				LL_NODE<T> *node = new LL_NODE<T>;
+				node->next = pool;
+				pool = node;
+			}
+		}
+		
+		static void free_pool()
+		{
+			//Free every node in our pool
+			std::lock_guard<std::mutex> lock(poolMutex);
+			while (pool != nullptr)
+			{
+				LL_NODE<T> *node = pool;
+				pool = node->next;
+				delete node;
+			}
+		}
 		
 		//Linking functions
 		inline LL_NODE<T> *link_front(T push)
 		{
-			//Allocate a new node and link to the head
-			LL_NODE<T> *newNode = new LL_NODE<T>;
+			//Get a new node and link to the head
+			LL_NODE<T> *newNode = new_node();
 			newNode->node_entry = push;
 			newNode->next = head;
 			newNode->prev = nullptr;
@@ -45,8 +132,8 @@ template <typename T> class LINKEDLIST
 		
 		inline LL_NODE<T> *link_back(T push)
 		{
-			//Allocate a new node and link to the tail
-			LL_NODE<T> *newNode = new LL_NODE<T>;
+			//Get a new node and link to the tail
+			LL_NODE<T> *newNode = new_node();
 			newNode->node_entry = push;
 			newNode->prev = tail;
 			newNode->next = nullptr;
@@ -126,7 +213,7 @@ template <typename T> class LINKEDLIST
 			if (node == nullptr)
 				return;
 			
-			//Adjust linked list correctly and destroy node
+			//Adjust linked list correctly and keep node to be reused
 			if (node->prev != nullptr)
 				node->prev->next = node->next;
 			else
@@ -136,7 +223,11 @@ template <typename T> class LINKEDLIST
 			else
 				tail = node->prev;
 			llSize--;
-			delete node;
+			
+			LL_NODE<T> **spareList = spare_list();
+			node->next = *spareList;
+			node->prev = nullptr;
+			*spareList = node;
 		}
 		
 		inline void clear()
@@ -152,6 +243,9 @@ template <typename T> class LINKEDLIST
 		T operator[](size_t index) { return at(index); };
 };
 
+template <typename T> LL_NODE<T> *LINKEDLIST<T>::pool = nullptr;
+template <typename T> std::mutex LINKEDLIST<T>::poolMutex;
+
 #define CLEAR_INSTANCE_LINKEDLIST(linkedList)	while (linkedList.head)	\
 												{	\
 													delete linkedList.head->node_entry;	\
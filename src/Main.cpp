@@ -1,10 +1,16 @@
+#include <stdlib.h>
+
 #include "Log.h"
 #include "Filesystem.h"
+#include "HotReload.h"
 #include "Render.h"
 #include "Audio.h"
 #include "Input.h"
 #include "Error.h"
 #include "Game.h"
+#include "Headless.h"
+#include "Profiler.h"
+#include "ObjectJobs.h"
 
 //Include backend cores
 #include "Backend/Core.h"
@@ -19,26 +25,41 @@
 
 int main(int argc, char *argv[])
 {
-	(void)argc; (void)argv;
-	
 	#ifdef ENABLE_NXLINK
 		//Enable NXLink for Switch debugging
 		socketInitializeDefault();
 		nxlinkStdio();
 	#endif
 	
-	//Initialize game sub-systems and backend core, then enter game loop
+	//Check if we've been asked to run a headless simulation
+	HEADLESSSPEC headlessSpec;
+	bool headless = (ParseHeadlessArguments(argc, argv, &headlessSpec) == false);
+	
+	//Get how many object job threads to use
+	const char *objectJobs = getenv("CUCKYSONIC_OBJECT_JOBS");
+	if (objectJobs != nullptr)
+		gObjectJobThreads = (unsigned int)strtoul(objectJobs, nullptr, 0);
+	
+	//Create our engine context and bind it to the main thread
+	gEngine = new ENGINE();
+	
+	//Initialize game sub-systems and backend core, then enter game loop (or run our headless simulation)
 	bool error = false;
-	if ((error = (Backend_InitCore() || InitializePath() || InitializeRender() || InitializeAudio() || InitializeInput())) == false)
-		error = EnterGameLoop();
+	if ((error = (Backend_InitCore() || InitializePath() || InitializeProfiler() || InitializeHotReload() || InitializeRender() || InitializeAudio() || InitializeInput())) == false)
+		error = headless ? RunHeadless(&headlessSpec) : EnterGameLoop();
 	
 	//End game sub-systems and backend core
 	QuitInput();
 	QuitAudio();
 	QuitRender();
+	QuitHotReload();
+	QuitProfiler();
 	QuitPath();
 	Backend_QuitCore();
 	
+	delete gEngine;
+	gEngine = nullptr;
+	
 	#ifdef ENABLE_NXLINK
 		//End NXLink
 		socketExit();
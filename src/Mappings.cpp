@@ -5,9 +5,11 @@
 #include "Mappings.h"
 #include "Error.h"
 #include "Log.h"
+#include "Profiler.h"
 
 MAPPINGS::MAPPINGS(std::string path)
 {
+	PROFILE_ZONE("Mappings load");
 	LOG(("Loading mappings from %s... ", path.c_str()));
 	
 	//Open the file given
@@ -32,19 +34,45 @@ MAPPINGS::MAPPINGS(std::string path)
 	}
 	
 	//Read from the file
+	uint16_t *frame = new uint16_t[size * 6];
+	fp.ReadBE16(frame, size * 6);
+	
 	for (size_t i = 0; i < size; i++)
 	{
-		rect[i].x = fp.ReadBE16();
-		rect[i].y = fp.ReadBE16();
-		rect[i].w = fp.ReadBE16();
-		rect[i].h = fp.ReadBE16();
-		origin[i].x = (int16_t)fp.ReadBE16();
-		origin[i].y = (int16_t)fp.ReadBE16();
+		rect[i].x = frame[i * 6 + 0];
+		rect[i].y = frame[i * 6 + 1];
+		rect[i].w = frame[i * 6 + 2];
+		rect[i].h = frame[i * 6 + 3];
+		origin[i].x = (int16_t)frame[i * 6 + 4];
+		origin[i].y = (int16_t)frame[i * 6 + 5];
 	}
 	
+	delete[] frame;
+	
 	LOG(("Success!\n"));
 }
 
+bool MAPPINGS::Reload()
+{
+	//Load our source again, keeping our current frames if that fails
+	MAPPINGS newMappings(source);
+	if (newMappings.fail != nullptr)
+		return true;
+	
+	//Swap the new frames into us, so anything pointing to us stays valid, the old frames are freed with newMappings
+	RECT *oldRect = rect;
+	rect = newMappings.rect;
+	newMappings.rect = oldRect;
+	
+	POINT *oldOrigin = origin;
+	origin = newMappings.origin;
+	newMappings.origin = oldOrigin;
+	
+	size = newMappings.size;
+	fail = nullptr;
+	return false;
+}
+
 MAPPINGS::~MAPPINGS()
 {
 	//Free allocated data
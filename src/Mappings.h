@@ -19,4 +19,6 @@ class MAPPINGS
 	public:
 		MAPPINGS(std::string path);
 		~MAPPINGS();
+		
+		bool Reload();
 };
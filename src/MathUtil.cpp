@@ -1,4 +1,5 @@
 #include "MathUtil.h"
+#include "Engine.h"
 
 const int16_t sineTable[] =
 {
@@ -108,6 +109,17 @@ uint8_t GetAtan(int16_t x, int16_t y)
 	return angle;
 }
 
+//Random number seed
+uint32_t GetRandomSeed()
+{
+	return gEngine->randomSeed;
+}
+
+void SetRandomSeed(uint32_t seed)
+{
+	gEngine->randomSeed = seed;
+}
+
 uint32_t RandomNumber()
 {
 	struct M68KREG
@@ -128,7 +140,8 @@ uint32_t RandomNumber()
 			} w;
 			uint32_t l = 0x00000000;
 		};
-	} static seed;
+	} seed;
+	seed.l = gEngine->randomSeed;
 	
 	//Re-seed if 0
 	if (seed.l == 0)
@@ -146,5 +159,6 @@ uint32_t RandomNumber()
 	retSeed.w.low += seed.w.high;	//add.w		d1,d0
 	seed.w.high = retSeed.w.low;	//move.w	d0,d1
 	
+	gEngine->randomSeed = seed.l;
 	return retSeed.l;
 }
\ No newline at end of file
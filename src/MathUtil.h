@@ -12,3 +12,5 @@ int16_t GetSin(uint8_t angle);
 int16_t GetCos(uint8_t angle);
 uint8_t GetAtan(int16_t x, int16_t y);
 uint32_t RandomNumber();
+uint32_t GetRandomSeed();
+void SetRandomSeed(uint32_t seed);
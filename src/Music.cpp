@@ -0,0 +1,715 @@
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#ifdef AUDIO_STB_VORBIS
+	#include "stb_vorbis.c" //Compile stb_vorbis here, everywhere else only includes the header
+#endif
+
+#include "Music.h"
+#include "Engine.h"
+#include "RingQueue.h"
+#include "MathUtil.h"
+#include "Error.h"
+#include "Log.h"
+#include "Profiler.h"
+
+//Music stream class
+MUSICSTREAM::MUSICSTREAM() : ringWrite(0), ringRead(0), ended(true), stopped(false)
+{
+	//We're opened with Open once we're given to a slot
+}
+
+MUSICSTREAM::~MUSICSTREAM()
+{
+	Close();
+}
+
+bool MUSICSTREAM::Open(const char *setName)
+{
+	LOG(("Loading music %s... ", setName));
+	
+	//Reset our state from the last track we played
+	fail = nullptr;
+	format = MUSICFORMAT_WAV;
+	loopStart = -1;
+	wavStart = wavPosition = 0;
+	decodeFrames = decodePosition = 0;
+	phase = 0;
+	step = 0x10000;
+	last[0] = last[1] = next[0] = next[1] = 0.0f;
+	ringWrite = 0;
+	ringRead = 0;
+	ended = false;
+	stopped = false;
+	
+	//Get our path without an extension, leaving room for one (paths are built in a fixed buffer, so starting a track doesn't allocate)
+	char path[MUSIC_PATH_LENGTH];
+	size_t pathLength = (size_t)snprintf(path, sizeof(path) - 4, "%sdata/Audio/Music/%s", gBasePath.c_str(), setName);
+	if ((size_t)snprintf(name, sizeof(name), "%s", setName) >= sizeof(name) || pathLength >= sizeof(path) - 4)
+	{
+		fail = "Music name is too long";
+		return true;
+	}
+	
+	//Open our file, using the .ogg if we can decode it, otherwise a .wav
+	#ifdef AUDIO_STB_VORBIS
+		int error;
+		memcpy(path + pathLength, ".ogg", 5);
+		if ((vorbis = stb_vorbis_open_filename(path, &error, nullptr)) != nullptr)
+		{
+			stb_vorbis_info info = stb_vorbis_get_info(vorbis);
+			format = MUSICFORMAT_VORBIS;
+			frequency = info.sample_rate;
+			vorbisChannels = info.channels;
+		}
+		else
+	#endif
+	{
+		memcpy(path + pathLength, ".wav", 5);
+		wavFile.OpenFile(path, "rb");
+		if (wavFile.fail != nullptr)
+		{
+			fail = "Failed to open music file";
+			return true;
+		}
+		
+		if ((fail = OpenWAV(&wavFile, &wavFormat)) != nullptr)
+			return true;
+		
+		format = MUSICFORMAT_WAV;
+		frequency = wavFormat.frequency;
+		wavStart = wavFile.Tell();
+	}
+	
+	//Read our loop start from our meta file (big endian, -1 if we don't loop)
+	memcpy(path + pathLength, ".mmt", 5);
+	FS_FILE metaFile(path, "rb");
+	if (metaFile.fail == nullptr)
+		loopStart = (int64_t)metaFile.ReadBE64();
+	
+	//Prime our resampler with the first two frames
+	step = (uint32_t)(((uint64_t)frequency << 16) / AUDIO_FREQUENCY);
+	if (NextFrame(last) || NextFrame(next))
+		ended = true;
+	LOG(("Success!\n"));
+	return false;
+}
+
+void MUSICSTREAM::Close()
+{
+	//Close our file
+	#ifdef AUDIO_STB_VORBIS
+		if (vorbis != nullptr)
+			stb_vorbis_close(vorbis);
+		vorbis = nullptr;
+	#endif
+	wavFile.Close();
+}
+
+//Source reading functions
+size_t MUSICSTREAM::ReadSource(float *buffer, size_t frames)
+{
+	switch (format)
+	{
+	#ifdef AUDIO_STB_VORBIS
+		case MUSICFORMAT_VORBIS:
+		{
+			//Read our frames then expand mono to stereo (backwards, since it's in place)
+			size_t read = stb_vorbis_get_samples_float_interleaved(vorbis, mmin(vorbisChannels, 2u), buffer, frames * mmin(vorbisChannels, 2u));
+			if (vorbisChannels == 1)
+			{
+				for (size_t i = read; i-- > 0;)
+				{
+					buffer[i * 2 + 1] = buffer[i];
+					buffer[i * 2 + 0] = buffer[i];
+				}
+			}
+			return read;
+		}
+	#endif
+		case MUSICFORMAT_WAV:
+		{
+			//Read up to the end of our data
+			size_t read = mmin(frames, wavFormat.frames - wavPosition);
+			ReadWAV(&wavFile, &wavFormat, buffer, read);
+			wavPosition += read;
+			return read;
+		}
+		default:
+			return 0;
+	}
+}
+
+void MUSICSTREAM::SeekSource(uint64_t frame)
+{
+	switch (format)
+	{
+	#ifdef AUDIO_STB_VORBIS
+		case MUSICFORMAT_VORBIS:
+			if (!stb_vorbis_seek(vorbis, (unsigned int)frame))
+				stb_vorbis_seek_start(vorbis);
+			break;
+	#endif
+		case MUSICFORMAT_WAV:
+			wavPosition = mmin((size_t)frame, wavFormat.frames);
+			wavFile.Seek(wavStart + wavPosition * wavFormat.channels * (wavFormat.bits / 8), SEEK_SET);
+			break;
+		default:
+			break;
+	}
+}
+
+bool MUSICSTREAM::NextFrame(float *frame)
+{
+	//Decode more frames if we've used up our decoded frames
+	if (decodePosition >= decodeFrames)
+	{
+		decodePosition = 0;
+		decodeFrames = ReadSource(decode, MUSIC_DECODE_FRAMES);
+		
+		//If we've reached the end, loop, or end if there's no loop point
+		if (decodeFrames == 0)
+		{
+			if (loopStart < 0)
+				return true;
+			SeekSource(loopStart);
+			if ((decodeFrames = ReadSource(decode, MUSIC_DECODE_FRAMES)) == 0)
+				return true;
+		}
+	}
+	
+	//Get our next frame
+	frame[0] = decode[decodePosition * 2 + 0];
+	frame[1] = decode[decodePosition * 2 + 1];
+	decodePosition++;
+	return false;
+}
+
+//Fill our ring with resampled frames, returns true if any were written
+bool MUSICSTREAM::Fill()
+{
+	if (ended.load(std::memory_order_relaxed))
+		return false;
+	
+	//Only fill once there's room for a full decode
+	uint32_t write = ringWrite.load(std::memory_order_relaxed);
+	if (MUSIC_BUFFER_FRAMES - (write - ringRead.load(std::memory_order_acquire)) < MUSIC_DECODE_FRAMES)
+		return false;
+	
+	//Resample into our ring (linearly interpolating between our last two source frames)
+	bool reachedEnd = false;
+	
+	for (int i = 0; i < MUSIC_DECODE_FRAMES && !reachedEnd; i++)
+	{
+		float fraction = phase / 65536.0f;
+		float *out = &ring[(write++ & (MUSIC_BUFFER_FRAMES - 1)) * 2];
+		out[0] = last[0] + (next[0] - last[0]) * fraction;
+		out[1] = last[1] + (next[1] - last[1]) * fraction;
+		
+		for (phase += step; phase >= 0x10000 && !reachedEnd; phase -= 0x10000)
+		{
+			last[0] = next[0];
+			last[1] = next[1];
+			reachedEnd = NextFrame(next);
+		}
+	}
+	
+	//Publish our frames, then if we've ended, let the mixer know no more are coming
+	ringWrite.store(write, std::memory_order_release);
+	if (reachedEnd)
+		ended.store(true, std::memory_order_release);
+	return true;
+}
+
+//Mixer state, only touched by the audio thread
+struct MUSICVOICE
+{
+	MUSICSTREAM *stream;
+	uint32_t id;
+	bool started, paused, stopAtSilence;
+	float volume, target, volumeStep;
+	int resume;			//Slot to resume once we end (-1 for none)
+	uint32_t resumeId;
+};
+
+static MUSICVOICE musicVoice[MUSIC_STREAMS];
+
+//Commands from the game thread to the mixer
+enum MUSICCOMMAND_TYPE
+{
+	MUSICCOMMAND_START,
+	MUSICCOMMAND_FADE,
+	MUSICCOMMAND_PAUSE,
+	MUSICCOMMAND_RESUME,
+	MUSICCOMMAND_STOP,
+	MUSICCOMMAND_RESUMETO,
+};
+
+struct MUSICCOMMAND
+{
+	MUSICCOMMAND_TYPE type;
+	int slot;
+	uint32_t id;			//Identifies the stream in the slot, so stale commands are ignored
+	MUSICSTREAM *stream;
+	uint32_t fadeFrames;
+	float target;
+	bool stopAtSilence;
+	int resume;
+	uint32_t resumeId;
+};
+
+static RINGQUEUE<MUSICCOMMAND, MUSIC_COMMANDS> musicCommand;
+
+//Streams, each slot has its own stream allocated up front and points to it while it's open
+//Shared between the game and music thread (guarded by our mutex, the mixer is given its streams through commands)
+static MUSICSTREAM *musicStream = nullptr;
+static MUSICSTREAM *musicSlot[MUSIC_STREAMS];
+static uint32_t musicSlotId[MUSIC_STREAMS];
+static uint32_t musicNextId = 1;
+
+static MUSICSTREAM *musicFilling = nullptr;	//Stream the music thread is decoding into, which mustn't be closed until it's done
+
+static std::mutex musicMutex;
+static std::condition_variable musicCondition;
+static std::thread *musicThread = nullptr;
+static bool musicQuit = false;
+
+//Playing tracks, the last is the one being heard and the ones under it are paused (game thread only)
+static int musicStack[MUSIC_STREAMS];
+static int musicStackSize = 0;
+
+//Mixer functions
+static void SetMusicFade(MUSICVOICE *voice, float target, uint32_t fadeFrames)
+{
+	//Ramp towards the given volume over the given amount of frames
+	voice->target = target;
+	if (fadeFrames == 0)
+	{
+		voice->volume = target;
+		voice->volumeStep = 0.0f;
+	}
+	else
+	{
+		voice->volumeStep = (target - voice->volume) / fadeFrames;
+	}
+}
+
+static void StopMusicVoice(MUSICVOICE *voice)
+{
+	//Let the game know it can close our stream
+	voice->stream->stopped.store(true, std::memory_order_release);
+	voice->stream = nullptr;
+}
+
+static MUSICVOICE *GetMusicVoice(const MUSICCOMMAND *command)
+{
+	//Get the voice the given command is for, if the stream is still playing
+	MUSICVOICE *voice = &musicVoice[command->slot];
+	if (voice->stream == nullptr || voice->id != command->id)
+		return nullptr;
+	return voice;
+}
+
+void MixMusic(float *stream, int frames)
+{
+	//Handle the commands the game has sent us
+	MUSICCOMMAND command;
+	while (!musicCommand.pop(&command))
+	{
+		MUSICVOICE *voice;
+		switch (command.type)
+		{
+			case MUSICCOMMAND_START:
+				voice = &musicVoice[command.slot];
+				voice->stream = command.stream;
+				voice->id = command.id;
+				voice->started = false;
+				voice->paused = false;
+				voice->stopAtSilence = false;
+				voice->volume = (command.fadeFrames != 0) ? 0.0f : 1.0f;
+				voice->resume = command.resume;
+				voice->resumeId = command.resumeId;
+				SetMusicFade(voice, 1.0f, command.fadeFrames);
+				break;
+			case MUSICCOMMAND_FADE:
+				if ((voice = GetMusicVoice(&command)) != nullptr)
+				{
+					voice->stopAtSilence = command.stopAtSilence;
+					SetMusicFade(voice, command.target, command.fadeFrames);
+					if (voice->stopAtSilence && voice->volume <= 0.0f)
+						StopMusicVoice(voice);
+				}
+				break;
+			case MUSICCOMMAND_PAUSE:
+				if ((voice = GetMusicVoice(&command)) != nullptr)
+					voice->paused = true;
+				break;
+			case MUSICCOMMAND_RESUME:
+				if ((voice = GetMusicVoice(&command)) != nullptr)
+				{
+					voice->paused = false;
+					voice->volume = 0.0f;
+					SetMusicFade(voice, 1.0f, command.fadeFrames);
+				}
+				break;
+			case MUSICCOMMAND_STOP:
+				if ((voice = GetMusicVoice(&command)) != nullptr)
+					StopMusicVoice(voice);
+				break;
+			case MUSICCOMMAND_RESUMETO:
+				if ((voice = GetMusicVoice(&command)) != nullptr)
+				{
+					voice->resume = command.resume;
+					voice->resumeId = command.resumeId;
+				}
+				break;
+		}
+	}
+	
+	//Mix our playing streams
+	for (int i = 0; i < MUSIC_STREAMS; i++)
+	{
+		MUSICVOICE *voice = &musicVoice[i];
+		if (voice->stream == nullptr || voice->paused)
+			continue;
+		
+		//Get how many frames are ready (check if we've ended first, so we know these are our last frames)
+		MUSICSTREAM *music = voice->stream;
+		bool ended = music->ended.load(std::memory_order_acquire);
+		uint32_t read = music->ringRead.load(std::memory_order_relaxed);
+		uint32_t available = music->ringWrite.load(std::memory_order_acquire) - read;
+		
+		#ifdef MUSIC_WAIT_FOR_DECODE
+			while (available < (uint32_t)frames && !ended)
+			{
+				musicCondition.notify_one();
+				std::this_thread::yield();
+				ended = music->ended.load(std::memory_order_acquire);
+				available = music->ringWrite.load(std::memory_order_acquire) - read;
+			}
+		#endif
+		
+		//Wait until the music thread has decoded enough to start
+		if (!voice->started)
+		{
+			if (available < (uint32_t)frames && !ended)
+				continue;
+			voice->started = true;
+		}
+		
+		//Copy our frames into the stream, applying our volume
+		uint32_t mix = mmin(available, (uint32_t)frames);
+		float *out = stream;
+		
+		for (uint32_t v = 0; v < mix; v++)
+		{
+			if (voice->volumeStep != 0.0f)
+			{
+				voice->volume += voice->volumeStep;
+				if ((voice->volumeStep > 0.0f) ? (voice->volume >= voice->target) : (voice->volume <= voice->target))
+				{
+					voice->volume = voice->target;
+					voice->volumeStep = 0.0f;
+				}
+			}
+			
+			const float *in = &music->ring[((read + v) & (MUSIC_BUFFER_FRAMES - 1)) * 2];
+			*out++ += in[0] * voice->volume;
+			*out++ += in[1] * voice->volume;
+		}
+		
+		music->ringRead.store(read + mix, std::memory_order_release);
+		
+		//Stop once faded out, or once we've played our last frames (resuming the track under us)
+		if (voice->stopAtSilence && voice->volume <= 0.0f)
+		{
+			StopMusicVoice(voice);
+		}
+		else if (ended && mix == available)
+		{
+			StopMusicVoice(voice);
+			
+			if (voice->resume >= 0)
+			{
+				MUSICVOICE *resume = &musicVoice[voice->resume];
+				if (resume->stream != nullptr && resume->id == voice->resumeId)
+				{
+					resume->paused = false;
+					resume->volume = 0.0f;
+					SetMusicFade(resume, 1.0f, MUSIC_RESUME_FADE * AUDIO_FREQUENCY / 1000);
+				}
+			}
+		}
+	}
+}
+
+//Music thread
+static void MusicThread()
+{
+	PROFILE_THREAD("Music");
+	std::unique_lock<std::mutex> lock(musicMutex);
+	
+	while (!musicQuit)
+	{
+		//Keep every stream's ring full, waiting if they're all full
+		bool filled = false;
+		for (int i = 0; i < MUSIC_STREAMS; i++)
+		{
+			//Only hold our lock to claim the stream, so the game thread isn't held up while we decode
+			MUSICSTREAM *stream = musicFilling = musicSlot[i];
+			if (stream == nullptr)
+				continue;
+			
+			lock.unlock();
+			if (stream->Fill())
+				filled = true;
+			lock.lock();
+			
+			musicFilling = nullptr;
+		}
+		
+		if (!filled)
+			musicCondition.wait_for(lock, std::chrono::milliseconds(MUSIC_THREAD_WAIT));
+	}
+}
+
+//Game thread functions
+static void CollectMusic()
+{
+	//Close the streams the mixer is done with (leaving the one being decoded into for next time)
+	std::unique_lock<std::mutex> lock(musicMutex);
+	
+	for (int i = 0; i < MUSIC_STREAMS; i++)
+	{
+		if (musicSlot[i] == nullptr || !musicSlot[i]->stopped.load(std::memory_order_acquire))
+			continue;
+		
+		if (musicSlot[i] != musicFilling)
+		{
+			musicSlot[i]->Close();
+			musicSlot[i] = nullptr;
+		}
+		
+		//Remove from our stack
+		for (int v = 0; v < musicStackSize; v++)
+		{
+			if (musicStack[v] == i)
+			{
+				memmove(&musicStack[v], &musicStack[v + 1], (musicStackSize - v - 1) * sizeof(int));
+				musicStackSize--;
+				break;
+			}
+		}
+	}
+}
+
+static void SendMusicCommand(MUSICCOMMAND_TYPE type, int slot, uint32_t fadeMilliseconds, float target, bool stopAtSilence)
+{
+	MUSICCOMMAND command;
+	memset(&command, 0, sizeof(command));
+	command.type = type;
+	command.slot = slot;
+	command.id = musicSlotId[slot];
+	command.fadeFrames = fadeMilliseconds * AUDIO_FREQUENCY / 1000;
+	command.target = target;
+	command.stopAtSilence = stopAtSilence;
+	command.resume = -1;
+	musicCommand.push(command);
+}
+
+static int StartMusic(const char *name, unsigned int fadeMilliseconds, int resume)
+{
+	//Get a free slot
+	int slot = -1;
+	for (int i = 0; i < MUSIC_STREAMS && slot < 0; i++)
+		if (musicSlot[i] == nullptr)
+			slot = i;
+	
+	if (slot < 0)
+	{
+		Warn("Too many music streams open");
+		return -1;
+	}
+	
+	//Open our slot's stream (nothing else is using it while the slot's free)
+	MUSICSTREAM *stream = &musicStream[slot];
+	if (stream->Open(name))
+	{
+		Warn(stream->fail);
+		stream->Close();
+		return -1;
+	}
+	
+	//Give our stream to the music thread and the mixer
+	MUSICCOMMAND command;
+	memset(&command, 0, sizeof(command));
+	command.type = MUSICCOMMAND_START;
+	command.slot = slot;
+	command.id = musicNextId++;
+	command.stream = stream;
+	command.fadeFrames = fadeMilliseconds * AUDIO_FREQUENCY / 1000;
+	command.resume = resume;
+	command.resumeId = (resume >= 0) ? musicSlotId[resume] : 0;
+	
+	if (musicCommand.push(command))
+	{
+		stream->Close();
+		return -1;
+	}
+	
+	{
+		std::unique_lock<std::mutex> lock(musicMutex);
+		musicSlot[slot] = stream;
+		musicSlotId[slot] = command.id;
+	}
+	musicCondition.notify_one();
+	
+	musicStack[musicStackSize++] = slot;
+	return slot;
+}
+
+void PlayMusic(const char *name, unsigned int fadeMilliseconds)
+{
+	//Simulations that aren't being presented don't touch the mixer
+	if (gEngine->mute)
+		return;
+	
+	//Crossfade from the track being heard, and stop the tracks under it
+	CollectMusic();
+	for (int i = 0; i < musicStackSize; i++)
+	{
+		if (i == musicStackSize - 1 && fadeMilliseconds != 0)
+			SendMusicCommand(MUSICCOMMAND_FADE, musicStack[i], fadeMilliseconds, 0.0f, true);
+		else
+			SendMusicCommand(MUSICCOMMAND_STOP, musicStack[i], 0, 0.0f, false);
+	}
+	musicStackSize = 0;
+	
+	StartMusic(name, fadeMilliseconds, -1);
+}
+
+void PushMusic(const char *name)
+{
+	if (gEngine->mute)
+		return;
+	
+	//Pause the track being heard (keeping its position), and play the given track over it until it ends or is popped
+	CollectMusic();
+	int under = -1;
+	if (musicStackSize > 0)
+	{
+		under = musicStack[musicStackSize - 1];
+		SendMusicCommand(MUSICCOMMAND_PAUSE, under, 0, 0.0f, false);
+	}
+	
+	if (StartMusic(name, 0, under) < 0 && under >= 0)
+		SendMusicCommand(MUSICCOMMAND_RESUME, under, 0, 1.0f, false);
+}
+
+void PopMusic(const char *name, unsigned int fadeMilliseconds)
+{
+	if (gEngine->mute)
+		return;
+	
+	//Find the most recently pushed track with the given name (it may have already ended)
+	CollectMusic();
+	int index = -1;
+	for (int i = musicStackSize; i-- > 0 && index < 0;)
+		if (strcmp(musicSlot[musicStack[i]]->name, name) == 0)
+			index = i;
+	
+	if (index < 0)
+		return;
+	
+	if (index == musicStackSize - 1)
+	{
+		//Fade out the track being heard, and resume the track under it where it left off
+		SendMusicCommand(MUSICCOMMAND_FADE, musicStack[index], fadeMilliseconds, 0.0f, true);
+		if (index > 0)
+			SendMusicCommand(MUSICCOMMAND_RESUME, musicStack[index - 1], fadeMilliseconds, 1.0f, false);
+	}
+	else
+	{
+		//Stop the paused track, and have the track played over it resume the track under it instead
+		SendMusicCommand(MUSICCOMMAND_STOP, musicStack[index], 0, 0.0f, false);
+		
+		MUSICCOMMAND command;
+		memset(&command, 0, sizeof(command));
+		command.type = MUSICCOMMAND_RESUMETO;
+		command.slot = musicStack[index + 1];
+		command.id = musicSlotId[command.slot];
+		command.resume = (index > 0) ? musicStack[index - 1] : -1;
+		command.resumeId = (index > 0) ? musicSlotId[command.resume] : 0;
+		musicCommand.push(command);
+	}
+	
+	//Remove from our stack
+	memmove(&musicStack[index], &musicStack[index + 1], (musicStackSize - index - 1) * sizeof(int));
+	musicStackSize--;
+}
+
+void FadeOutMusic(unsigned int fadeMilliseconds)
+{
+	if (gEngine->mute)
+		return;
+	
+	//Fade out the track being heard, and stop the tracks under it
+	CollectMusic();
+	for (int i = 0; i < musicStackSize; i++)
+		SendMusicCommand((i == musicStackSize - 1) ? MUSICCOMMAND_FADE : MUSICCOMMAND_STOP, musicStack[i], fadeMilliseconds, 0.0f, true);
+	musicStackSize = 0;
+}
+
+void StopMusic()
+{
+	if (gEngine->mute)
+		return;
+	
+	//Stop every track
+	CollectMusic();
+	for (int i = 0; i < musicStackSize; i++)
+		SendMusicCommand(MUSICCOMMAND_STOP, musicStack[i], 0, 0.0f, false);
+	musicStackSize = 0;
+}
+
+//Music sub-system functions
+bool InitializeMusic()
+{
+	//Allocate our streams, then start our music thread
+	musicStream = new MUSICSTREAM[MUSIC_STREAMS];
+	musicQuit = false;
+	musicThread = new std::thread(MusicThread);
+	return false;
+}
+
+void QuitMusic()
+{
+	//Stop our music thread
+	{
+		std::unique_lock<std::mutex> lock(musicMutex);
+		musicQuit = true;
+	}
+	musicCondition.notify_one();
+	if (musicThread != nullptr)
+	{
+		musicThread->join();
+		delete musicThread;
+		musicThread = nullptr;
+	}
+	
+	//Close and free our streams (the mixer must no longer be running)
+	for (int i = 0; i < MUSIC_STREAMS; i++)
+	{
+		musicSlot[i] = nullptr;
+		musicVoice[i].stream = nullptr;
+	}
+	delete[] musicStream;
+	musicStream = nullptr;
+	
+	musicStackSize = 0;
+	musicCommand.clear();
+}
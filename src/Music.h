@@ -0,0 +1,99 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <atomic>
+
+#include "Filesystem.h"
+#include "Audio.h"
+
+#ifdef AUDIO_STB_VORBIS
+	#define STB_VORBIS_HEADER_ONLY
+	#include "stb_vorbis.c"
+#endif
+
+//Constants
+#define MUSIC_STREAMS		6		//Most music streams that can be open at once (the playing track, tracks paused under it, and tracks fading out)
+#define MUSIC_BUFFER_FRAMES	0x4000	//Frames decoded ahead of the mixer for each stream (~340ms), must be a power of 2
+#define MUSIC_DECODE_FRAMES	0x400	//Frames decoded from the file at a time
+#define MUSIC_COMMANDS		0x40	//Size of the music command queue between the game and the mixer
+#define MUSIC_RESUME_FADE	250		//Milliseconds a track fades back in over when the track played over it ends
+#define MUSIC_THREAD_WAIT	5		//Milliseconds the music thread waits for when every stream is full
+#define MUSIC_NAME_LENGTH	0x20	//Longest track name (including the terminator)
+#define MUSIC_PATH_LENGTH	0x400	//Longest path to a track's files
+
+//When the mixer's pulled by the game rather than a realtime audio device (the void backend), wait for the music thread rather than letting streams underrun, so output is the same every run
+#ifdef BACKEND_VOID
+	#define MUSIC_WAIT_FOR_DECODE
+#endif
+
+//Music formats
+enum MUSICFORMAT
+{
+	MUSICFORMAT_VORBIS,	//.ogg file (requires stb_vorbis)
+	MUSICFORMAT_WAV,	//.wav file
+};
+
+//Music stream, decoded and resampled on the music thread into a ring which the mixer only copies from
+//Every stream is allocated up front and opened and closed in place, so tracks can be started during gameplay without allocating
+class MUSICSTREAM
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Source file and format
+		char name[MUSIC_NAME_LENGTH] = {};
+		MUSICFORMAT format = MUSICFORMAT_WAV;
+		unsigned int frequency = 0;
+		int64_t loopStart = -1;	//Frame to loop back to once the end is reached (-1 doesn't loop)
+		
+		#ifdef AUDIO_STB_VORBIS
+			stb_vorbis *vorbis = nullptr;
+			unsigned int vorbisChannels = 0;
+		#endif
+		FS_FILE wavFile;
+		WAVFORMAT wavFormat;
+		size_t wavStart = 0, wavPosition = 0;
+		
+		//Decoded frames and resampler state
+		float decode[MUSIC_DECODE_FRAMES * 2];
+		size_t decodeFrames = 0, decodePosition = 0;
+		uint32_t phase = 0, step = 0x10000;	//16.16 fixed point
+		float last[2] = {0.0f, 0.0f}, next[2] = {0.0f, 0.0f};
+		
+		//Ring of interleaved stereo frames at the mixer's frequency
+		float ring[MUSIC_BUFFER_FRAMES * 2];
+		std::atomic<uint32_t> ringWrite, ringRead;
+		
+		std::atomic<bool> ended;	//Set once the file's end is reached without a loop point, the mixer stops us once the ring is empty
+		std::atomic<bool> stopped;	//Set by the mixer once it's done with us, so we can be deleted
+	
+	public:
+		MUSICSTREAM();
+		~MUSICSTREAM();
+		
+		bool Open(const char *setName);
+		void Close();
+		
+		bool Fill();
+	
+	private:
+		size_t ReadSource(float *buffer, size_t frames);
+		void SeekSource(uint64_t frame);
+		bool NextFrame(float *frame);
+};
+
+//Music functions
+void PlayMusic(const char *name, unsigned int fadeMilliseconds);
+void PushMusic(const char *name);
+void PopMusic(const char *name, unsigned int fadeMilliseconds);
+void FadeOutMusic(unsigned int fadeMilliseconds);
+void StopMusic();
+
+//Mixer function, called by the audio mixer
+void MixMusic(float *stream, int frames);
+
+//Music sub-system functions
+bool InitializeMusic();
+void QuitMusic();
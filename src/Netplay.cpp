@@ -0,0 +1,458 @@
+#include <string.h>
+#include <chrono>
+
+#include "Netplay.h"
+#include "Engine.h"
+#include "Level.h"
+#include "Replay.h"
+#include "Render.h"
+#include "Error.h"
+#include "Log.h"
+
+#ifdef NETPLAY_UNIX_SOCKET
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+#endif
+
+//Packet byte order functions (packets are big-endian)
+static void WritePacketBE32(uint8_t *data, uint32_t value)
+{
+	data[0] = (uint8_t)(value >> 24);
+	data[1] = (uint8_t)(value >> 16);
+	data[2] = (uint8_t)(value >> 8);
+	data[3] = (uint8_t)value;
+}
+
+static uint32_t ReadPacketBE32(const uint8_t *data)
+{
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | (uint32_t)data[3];
+}
+
+//Loopback transport
+static bool LoopbackSend(NETTRANSPORT *transport, const uint8_t *data, size_t size)
+{
+	//Packets sent before our peer is connected are lost
+	if (transport->peer != nullptr)
+		transport->peer->Hold(data, size);
+	return false;
+}
+
+static size_t LoopbackReceive(NETTRANSPORT *transport, uint8_t *data, size_t capacity)
+{
+	//Our peer's packets are already in our queue
+	(void)transport; (void)data; (void)capacity;
+	return 0;
+}
+
+//UNIX socket transport
+#ifdef NETPLAY_UNIX_SOCKET
+static bool SocketAddress(struct sockaddr_un *address, const std::string *path)
+{
+	//Returns true if the path doesn't fit
+	memset(address, 0, sizeof(struct sockaddr_un));
+	address->sun_family = AF_UNIX;
+	if (path->size() >= sizeof(address->sun_path))
+		return true;
+	strcpy(address->sun_path, path->c_str());
+	return false;
+}
+
+static bool SocketSend(NETTRANSPORT *transport, const uint8_t *data, size_t size)
+{
+	struct sockaddr_un address;
+	SocketAddress(&address, &transport->remotePath);
+	
+	//Packets sent before the remote's bound its socket (or while its buffer's full) are lost, like any other datagram
+	if (sendto(transport->socketFd, data, size, 0, (struct sockaddr*)&address, sizeof(address)) < 0 && errno != ENOENT && errno != ECONNREFUSED && errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS)
+		return Error(transport->fail = "Failed to send to the netplay socket");
+	return false;
+}
+
+static size_t SocketReceive(NETTRANSPORT *transport, uint8_t *data, size_t capacity)
+{
+	ssize_t size = recv(transport->socketFd, data, capacity, 0);
+	return (size > 0) ? (size_t)size : 0;
+}
+#endif
+
+//Transport constructors and destructor
+NETTRANSPORT::NETTRANSPORT(NETTRANSPORT *loopbackPeer)
+{
+	//Connect to our peer, if given (the first end of a loopback is given nullptr, and is connected by the second)
+	sendFunction = LoopbackSend;
+	receiveFunction = LoopbackReceive;
+	queue = new NETPACKET[NETPLAY_QUEUE];
+	
+	if (loopbackPeer != nullptr)
+	{
+		peer = loopbackPeer;
+		loopbackPeer->peer = this;
+	}
+}
+
+NETTRANSPORT::NETTRANSPORT(std::string path, int index)
+{
+	//Bind our socket to our path (the path with our index appended), the remote binds the other index
+	LOG(("Opening netplay socket %s.%d...\n", path.c_str(), index));
+	
+	queue = new NETPACKET[NETPLAY_QUEUE];
+	localPath = path + "." + std::to_string(index);
+	remotePath = path + "." + std::to_string(index ^ 1);
+
+#ifdef NETPLAY_UNIX_SOCKET
+	sendFunction = SocketSend;
+	receiveFunction = SocketReceive;
+	
+	struct sockaddr_un address;
+	if (SocketAddress(&address, &localPath))
+	{
+		Error(fail = "Netplay socket path is too long");
+		return;
+	}
+	
+	if ((socketFd = socket(AF_UNIX, SOCK_DGRAM, 0)) < 0)
+	{
+		Error(fail = "Failed to create the netplay socket");
+		return;
+	}
+	
+	unlink(localPath.c_str());
+	if (bind(socketFd, (struct sockaddr*)&address, sizeof(address)) < 0)
+	{
+		Error(fail = "Failed to bind the netplay socket");
+		return;
+	}
+	
+	if (fcntl(socketFd, F_SETFL, fcntl(socketFd, F_GETFL, 0) | O_NONBLOCK) < 0)
+	{
+		Error(fail = "Failed to make the netplay socket non-blocking");
+		return;
+	}
+#else
+	Error(fail = "UNIX socket netplay isn't supported on this platform");
+#endif
+}
+
+NETTRANSPORT::NETTRANSPORT(NETSENDFUNCTION setSendFunction, NETRECEIVEFUNCTION setReceiveFunction)
+{
+	//Custom transport
+	sendFunction = setSendFunction;
+	receiveFunction = setReceiveFunction;
+	queue = new NETPACKET[NETPLAY_QUEUE];
+}
+
+NETTRANSPORT::~NETTRANSPORT()
+{
+	//Disconnect from our peer, and close our socket
+	if (peer != nullptr)
+		peer->peer = nullptr;
+
+#ifdef NETPLAY_UNIX_SOCKET
+	if (socketFd >= 0)
+	{
+		close(socketFd);
+		unlink(localPath.c_str());
+	}
+#endif
+
+	delete[] queue;
+}
+
+//Artificial delay and jitter, for testing, received packets are held for the delay plus up to the jitter (which reorders them)
+void NETTRANSPORT::SetDelay(unsigned int setDelay, unsigned int setJitter, uint32_t seed)
+{
+	delay = setDelay;
+	jitter = setJitter;
+	jitterSeed = seed;
+}
+
+void NETTRANSPORT::Tick()
+{
+	time++;
+}
+
+//Packet functions
+bool NETTRANSPORT::Send(const uint8_t *data, size_t size)
+{
+	if (fail != nullptr)
+		return true;
+	return sendFunction(this, data, size);
+}
+
+void NETTRANSPORT::Hold(const uint8_t *data, size_t size)
+{
+	//Packets that don't fit are dropped
+	if (queued >= NETPLAY_QUEUE || size > NETPLAY_PACKET_SIZE)
+		return;
+	
+	//Get this packet's jitter (our own generator, so the engine's random number seed isn't touched)
+	uint32_t thisJitter = 0;
+	if (jitter != 0)
+	{
+		jitterSeed = jitterSeed * 1103515245 + 12345;
+		thisJitter = (jitterSeed >> 16) % (jitter + 1);
+	}
+	
+	NETPACKET *packet = &queue[queued++];
+	packet->time = time + delay + thisJitter;
+	packet->size = size;
+	memcpy(packet->data, data, size);
+}
+
+size_t NETTRANSPORT::Receive(uint8_t *data, size_t capacity)
+{
+	if (fail != nullptr)
+		return 0;
+	
+	//Hold everything our implementation's received
+	uint8_t received[NETPLAY_PACKET_SIZE];
+	size_t receivedSize;
+	while (queued < NETPLAY_QUEUE && (receivedSize = receiveFunction(this, received, sizeof(received))) != 0)
+		Hold(received, receivedSize);
+	
+	//Get the first held packet that's due
+	for (size_t i = 0; i < queued; i++)
+	{
+		if ((int32_t)(queue[i].time - time) > 0)
+			continue;
+		
+		size_t size = (queue[i].size < capacity) ? queue[i].size : capacity;
+		memcpy(data, queue[i].data, size);
+		memmove(&queue[i], &queue[i + 1], (queued - i - 1) * sizeof(NETPACKET));
+		queued--;
+		return size;
+	}
+	return 0;
+}
+
+//Rollback session constructor
+ROLLBACK::ROLLBACK(NETTRANSPORT *setTransport, size_t setLocalController, size_t setRemoteController, unsigned int inputDelay)
+{
+	transport = setTransport;
+	localController = setLocalController;
+	remoteController = setRemoteController;
+	
+	//Our first frames (before our delayed input starts) have no input
+	if (inputDelay >= ROLLBACK_INPUT_FRAMES / 2)
+	{
+		Error(fail = "Netplay input delay is too long");
+		return;
+	}
+	localFrames = inputDelay;
+}
+
+//Packet functions
+void ROLLBACK::Send()
+{
+	//Send our inputs the remote hasn't acknowledged, and acknowledge the remote's inputs we've received
+	uint8_t packet[NETPLAY_PACKET_SIZE];
+	uint32_t inputs = localFrames - remoteAck;
+	if (inputs > NETPLAY_PACKET_INPUTS)
+		inputs = NETPLAY_PACKET_INPUTS;
+	
+	packet[0] = (uint8_t)(NETPLAY_SIGNATURE >> 8);
+	packet[1] = (uint8_t)NETPLAY_SIGNATURE;
+	WritePacketBE32(&packet[2], remoteFrames);
+	WritePacketBE32(&packet[6], remoteAck);
+	packet[10] = (uint8_t)inputs;
+	for (uint32_t i = 0; i < inputs; i++)
+		packet[11 + i] = localInput[(remoteAck + i) % ROLLBACK_INPUT_FRAMES];
+	
+	if (transport->Send(packet, 11 + inputs))
+		fail = transport->fail;
+}
+
+void ROLLBACK::Receive()
+{
+	uint8_t packet[NETPLAY_PACKET_SIZE];
+	size_t size;
+	
+	while ((size = transport->Receive(packet, sizeof(packet))) != 0)
+	{
+		//Check our packet's valid
+		if (size < 11 || ((packet[0] << 8) | packet[1]) != NETPLAY_SIGNATURE || size < (size_t)(11 + packet[10]))
+			continue;
+		
+		//Get how many of our inputs the remote has received
+		uint32_t ack = ReadPacketBE32(&packet[2]);
+		if ((int32_t)(ack - remoteAck) > 0 && (int32_t)(ack - localFrames) <= 0)
+			remoteAck = ack;
+		
+		//Take the inputs that follow on from the ones we have (ones we have are repeats, and ones after a gap are resent later)
+		uint32_t start = ReadPacketBE32(&packet[6]);
+		for (uint32_t i = 0; i < packet[10]; i++)
+		{
+			uint32_t inputFrame = start + i;
+			if (inputFrame != remoteFrames)
+			{
+				if ((int32_t)(inputFrame - remoteFrames) > 0)
+					break;
+				continue;
+			}
+			if ((int32_t)(inputFrame - frame) >= ROLLBACK_INPUT_FRAMES / 2)
+				break;
+			
+			//If we've already simulated this frame with a different input, roll back to it
+			uint8_t input = packet[11 + i];
+			remoteInput[inputFrame % ROLLBACK_INPUT_FRAMES] = input;
+			remoteFrames++;
+			
+			if (inputFrame < frame && inputFrame < rollbackFrame && simulatedInput[inputFrame % ROLLBACK_INPUT_FRAMES] != input)
+				rollbackFrame = inputFrame;
+		}
+	}
+}
+
+//Simulation functions
+bool ROLLBACK::Simulate(uint32_t simulateFrame, bool resimulating)
+{
+	//Get our inputs, remote input we don't have yet is predicted to be the same as the last we got
+	uint8_t remote = 0;
+	if (simulateFrame < remoteFrames)
+		remote = remoteInput[simulateFrame % ROLLBACK_INPUT_FRAMES];
+	else if (remoteFrames != 0)
+		remote = remoteInput[(remoteFrames - 1) % ROLLBACK_INPUT_FRAMES];
+	simulatedInput[simulateFrame % ROLLBACK_INPUT_FRAMES] = remote;
+	
+	for (size_t i = 0; i < CONTROLLERS; i++)
+	{
+		if (i == localController)
+			gEngine->controller[i].SetHeld(UnpackControlMask(localInput[simulateFrame % ROLLBACK_INPUT_FRAMES]));
+		else if (i == remoteController)
+			gEngine->controller[i].SetHeld(UnpackControlMask(remote));
+		else
+			gEngine->controller[i].SetHeld(CONTROLMASK{});
+	}
+	
+	//Re-simulated frames aren't heard or seen, but are still drawn (drawing updates state like objects being on-screen)
+	bool mute = gEngine->mute, discard = gEngine->softwareBuffer->discard;
+	if (resimulating)
+	{
+		gEngine->mute = true;
+		gEngine->softwareBuffer->discard = true;
+	}
+	
+	//Update our level, and fade in (fading out is left to the caller, as it ends the level)
+	bool error = gEngine->level->Update();
+	if (!error)
+	{
+		if (gEngine->level->fading && gEngine->level->isFadingIn)
+			gEngine->level->fading = !gEngine->level->UpdateFade();
+		if (resimulating)
+			gEngine->level->Draw();
+	}
+	
+	gEngine->mute = mute;
+	gEngine->softwareBuffer->discard = discard;
+	
+	if (error)
+		fail = "Level failed to update";
+	return error;
+}
+
+bool ROLLBACK::Correct()
+{
+	if (fail != nullptr)
+		return true;
+	
+	//Receive the remote's inputs
+	Receive();
+	if (fail != nullptr)
+		return true;
+	
+	//If we mispredicted, restore the state of the first frame we got wrong, and re-simulate every frame since
+	if (rollbackFrame < frame)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		
+		if (snapshot[rollbackFrame % (ROLLBACK_MAX_FRAMES + 1)].Restore())
+		{
+			fail = snapshot[rollbackFrame % (ROLLBACK_MAX_FRAMES + 1)].fail;
+			return true;
+		}
+		
+		for (uint32_t i = rollbackFrame; i < frame; i++)
+		{
+			if (i != rollbackFrame && snapshot[i % (ROLLBACK_MAX_FRAMES + 1)].Save())
+			{
+				fail = snapshot[i % (ROLLBACK_MAX_FRAMES + 1)].fail;
+				return true;
+			}
+			if (Simulate(i, true))
+				return true;
+		}
+		
+		std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+		unsigned int depth = frame - rollbackFrame;
+		stats.rollbacks++;
+		stats.rollbackFrames += depth;
+		if (depth > stats.maxDepth)
+			stats.maxDepth = depth;
+		stats.resimulateTime += time.count();
+		if (time.count() > stats.maxResimulateTime)
+			stats.maxResimulateTime = time.count();
+		
+		rollbackFrame = frame;
+	}
+	
+	transport->Tick();
+	return false;
+}
+
+//Session functions
+bool ROLLBACK::Poll()
+{
+	//Receive and correct without advancing (while waiting for the remote), still acknowledging what we've received
+	if (Correct())
+		return true;
+	Send();
+	return fail != nullptr;
+}
+
+bool ROLLBACK::Advance(CONTROLMASK local, bool *advanced)
+{
+	//Receive the remote's inputs and correct any mispredictions
+	*advanced = false;
+	if (Correct())
+		return true;
+	
+	//Stall if we're too far ahead of the remote to predict any further (or it's not received too much of our input)
+	if ((int32_t)(frame - remoteFrames) >= ROLLBACK_MAX_FRAMES || localFrames - remoteAck >= ROLLBACK_INPUT_FRAMES / 2)
+	{
+		stats.stalls++;
+		Send();
+		return fail != nullptr;
+	}
+	
+	//Record and send our input, it's for the frame our input delay ahead
+	localInput[localFrames++ % ROLLBACK_INPUT_FRAMES] = PackControlMask(&local);
+	Send();
+	if (fail != nullptr)
+		return true;
+	
+	//Save this frame's state, so we can roll back to it, then simulate it
+	if (frame >= remoteFrames)
+		stats.predictedFrames++;
+	
+	if (snapshot[frame % (ROLLBACK_MAX_FRAMES + 1)].Save())
+	{
+		fail = snapshot[frame % (ROLLBACK_MAX_FRAMES + 1)].fail;
+		return true;
+	}
+	if (Simulate(frame, false))
+		return true;
+	
+	rollbackFrame = ++frame;
+	stats.frames++;
+	*advanced = true;
+	return false;
+}
+
+bool ROLLBACK::Synchronized()
+{
+	//We've got the remote's input for every frame we've simulated, and the remote's got ours
+	return (int32_t)(remoteFrames - frame) >= 0 && rollbackFrame == frame && remoteAck == localFrames;
+}
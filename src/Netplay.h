@@ -0,0 +1,133 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "Input.h"
+#include "Snapshot.h"
+
+//Rollback netplay, two engines run the same level with each one's local input sent to the other
+//Remote input that hasn't arrived yet is predicted (the last input we got is held), and when it arrives different to what we predicted, we restore the snapshot of the frame it was for and re-simulate up to the present in one display frame
+
+//Constants
+#define NETPLAY_SIGNATURE		0x4E50	//"NP"
+#define NETPLAY_PACKET_SIZE		0x100	//Largest packet
+#define NETPLAY_PACKET_INPUTS	0x80	//Most inputs sent in one packet (the oldest ones the remote hasn't acknowledged)
+#define NETPLAY_QUEUE			0x100	//Most packets a transport can hold before receiving them (further packets are dropped)
+
+#define ROLLBACK_MAX_FRAMES		8		//Furthest we can predict ahead of the remote's input, and so the deepest rollback, we stall rather than go further
+#define ROLLBACK_INPUT_FRAMES	0x400	//Input history kept for each side (power of two, must cover every input that's not been acknowledged)
+
+//UNIX datagram socket transport, where available
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(SWITCH)
+	#define NETPLAY_UNIX_SOCKET
+#endif
+
+//Transport, sends and receives packets, implementations provide the send and receive functions
+class NETTRANSPORT;
+typedef bool (*NETSENDFUNCTION)(NETTRANSPORT *transport, const uint8_t *data, size_t size);	//Returns true on error
+typedef size_t (*NETRECEIVEFUNCTION)(NETTRANSPORT *transport, uint8_t *data, size_t capacity);	//Returns the size of the packet received, 0 if none
+
+struct NETPACKET
+{
+	uint32_t time;	//Tick the packet is received on
+	size_t size;
+	uint8_t data[NETPLAY_PACKET_SIZE];
+};
+
+class NETTRANSPORT
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Implementation
+		NETSENDFUNCTION sendFunction = nullptr;
+		NETRECEIVEFUNCTION receiveFunction = nullptr;
+		
+		//Loopback peer, packets we send go straight into its queue (both ends must be used from the same thread)
+		NETTRANSPORT *peer = nullptr;
+		
+		//UNIX socket, bound to our path, and sending to the remote's path
+		int socketFd = -1;
+		std::string localPath, remotePath;
+		
+		//Artificial delay and jitter (in ticks), packets are held in our queue until the tick they're received on
+		unsigned int delay = 0, jitter = 0;
+		uint32_t jitterSeed = 1;
+		uint32_t time = 0;
+		
+		NETPACKET *queue = nullptr;
+		size_t queued = 0;
+	
+	public:
+		NETTRANSPORT(NETTRANSPORT *loopbackPeer);
+		NETTRANSPORT(std::string path, int index);
+		NETTRANSPORT(NETSENDFUNCTION setSendFunction, NETRECEIVEFUNCTION setReceiveFunction);
+		~NETTRANSPORT();
+		
+		void SetDelay(unsigned int setDelay, unsigned int setJitter, uint32_t seed);
+		void Tick();
+		
+		bool Send(const uint8_t *data, size_t size);
+		size_t Receive(uint8_t *data, size_t capacity);
+		void Hold(const uint8_t *data, size_t size);
+};
+
+//Rollback statistics
+struct ROLLBACKSTATS
+{
+	unsigned int frames = 0;			//Frames advanced
+	unsigned int predictedFrames = 0;	//Frames advanced without the remote's input
+	unsigned int stalls = 0;			//Display frames we couldn't advance on, being too far ahead of the remote
+	unsigned int rollbacks = 0;			//Mispredictions corrected
+	unsigned int rollbackFrames = 0;	//Frames re-simulated in total
+	unsigned int maxDepth = 0;			//Most frames re-simulated in one rollback
+	double resimulateTime = 0.0;		//Time spent restoring and re-simulating (in microseconds)
+	double maxResimulateTime = 0.0;		//Longest rollback (in microseconds)
+};
+
+//Rollback session, runs the level of the engine context it's used on, local and remote input are given to their own controllers
+class ROLLBACK
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Transport, and our controllers
+		NETTRANSPORT *transport;
+		size_t localController, remoteController;
+		
+		//Frames simulated, local inputs recorded (local input is delayed by the input delay), remote inputs received, and local inputs the remote has received
+		uint32_t frame = 0;
+		uint32_t localFrames = 0;
+		uint32_t remoteFrames = 0;
+		uint32_t remoteAck = 0;
+		
+		//First frame we mispredicted, equal to frame if we haven't
+		uint32_t rollbackFrame = 0;
+		
+		//Input history (packed buttons), and the remote input each frame was simulated with
+		uint8_t localInput[ROLLBACK_INPUT_FRAMES] = {};
+		uint8_t remoteInput[ROLLBACK_INPUT_FRAMES] = {};
+		uint8_t simulatedInput[ROLLBACK_INPUT_FRAMES] = {};
+		
+		//Snapshot of the state at the start of each frame in our window
+		SNAPSHOT snapshot[ROLLBACK_MAX_FRAMES + 1];
+		
+		//Statistics
+		ROLLBACKSTATS stats;
+	
+	public:
+		ROLLBACK(NETTRANSPORT *setTransport, size_t setLocalController, size_t setRemoteController, unsigned int inputDelay);
+		
+		bool Advance(CONTROLMASK local, bool *advanced);
+		bool Poll();
+		bool Synchronized();
+	
+	private:
+		void Send();
+		void Receive();
+		bool Correct();
+		bool Simulate(uint32_t simulateFrame, bool resimulating);
+};
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <string.h>
+#include <mutex>
 
 #include "Object.h"
 #include "Objects.h"
@@ -19,30 +20,169 @@
 //#define SONIC12_SOLIDOBJECT_VERTICAL          //In Sonic 3, the Solid Object routine was adjusted to prefer vertical collision
 //#define SONIC12_SOLIDOBJECT_BOTTOM_INERTIA    //In Sonic 3, touching the bottom of an object clears your inertia
 
+//Object pool, deleted objects' memory is kept to be reused by the next new objects
+static void *objectPool = nullptr;
+static std::mutex objectPoolMutex;
+
+void *OBJECT::operator new(size_t size)
+{
+	//Take an object from our pool, or allocate one if it's empty
+	std::lock_guard<std::mutex> lock(objectPoolMutex);
+	if (objectPool == nullptr)
+		return ::operator new(size);
+	void *pointer = objectPool;
+	objectPool = *((void**)pointer);
+	return pointer;
+}
+
+void OBJECT::operator delete(void *pointer)
+{
+	//Give this object back to our pool
+	if (pointer == nullptr)
+		return;
+	std::lock_guard<std::mutex> lock(objectPoolMutex);
+	*((void**)pointer) = objectPool;
+	objectPool = pointer;
+}
+
+void ReserveObjects(size_t objects)
+{
+	//Allocate objects into our pool, and nodes for their lists
+	std::lock_guard<std::mutex> lock(objectPoolMutex);
+	for (size_t i = 0; i < objects; i++)
+	{
+		void *pointer = ::operator new(sizeof(OBJECT));
+		*((void**)pointer) = objectPool;
+		objectPool = pointer;
+	}
+	
+	LINKEDLIST<OBJECT*>::reserve_pool(objects);
+	LINKEDLIST<OBJECT_DRAWINSTANCE>::reserve_pool(objects);
+}
+
+void FreeObjectPool()
+{
+	//Free every object in our pool, and our lists' nodes
+	std::lock_guard<std::mutex> lock(objectPoolMutex);
+	while (objectPool != nullptr)
+	{
+		void *pointer = objectPool;
+		objectPool = *((void**)pointer);
+		::operator delete(pointer);
+	}
+	
+	LINKEDLIST<OBJECT*>::free_pool();
+	LINKEDLIST<OBJECT_DRAWINSTANCE>::free_pool();
+}
+
+//Object function table, only add to the end so indices stay the same and state hash logs from older builds can still be compared
+static const OBJECTFUNCTION objectFunctionTable[] = {
+	&ObjPathSwitcher,
+	&ObjRing,
+	&ObjRingSpawner,
+	&ObjBouncingRing_Spawner,
+	&ObjAttractRing,
+	&ObjMonitor,
+	&ObjSpring,
+	&ObjExplosion,
+	&ObjBridge,
+	&ObjGoalpost,
+	&ObjSpiral,
+	&ObjSonic1Scenery,
+	&ObjMotobug,
+	&ObjChopper,
+	&ObjCrabmeat,
+	&ObjBuzzBomber,
+	&ObjNewtron,
+	&ObjGHZWaterfallSound,
+	&ObjGHZPlatform,
+	&ObjGHZLedge,
+	&ObjGHZSwingingPlatform,
+	&ObjGHZSpikes,
+	&ObjGHZEdgeWall,
+	&ObjGHZSmashableWall,
+	&ObjGHZSpikeLog,
+	&ObjGHZPurpleRock,
+	&ObjMinecart,
+	&ObjMonitorContents,
+	&ObjAnimal,
+	&ObjScore,
+	&ObjBridgeSegment,
+	&ObjBuzzBomberMissile,
+	&ObjCrabmeatProjectile,
+	&ObjNewtronMissile,
+	&ObjGHZSpikeLog_Segment,
+	&ObjGHZLedge_Fragment,
+	&ObjGHZWallFragment,
+	&ObjSpindashDust,
+	&ObjSkidDust,
+	&ObjBarrier,
+	&ObjInvincibilityStars,
+};
+
+uint32_t GetObjectFunctionIndex(OBJECTFUNCTION function)
+{
+	if (function == nullptr)
+		return 0;
+	
+	//Functions missing from our table all share the index past its end
+	uint32_t i;
+	for (i = 0; i < sizeof(objectFunctionTable) / sizeof(objectFunctionTable[0]); i++)
+		if (function == objectFunctionTable[i])
+			break;
+	return i + 1;
+}
+
 //Object class
-OBJECT::OBJECT(OBJECTFUNCTION objectFunction) : function(objectFunction) { return; }
+OBJECT::OBJECT(OBJECTFUNCTION objectFunction) : function(objectFunction)
+{
+	//Let our level's object grid know there's a new object to link (objects created before it exists are linked by its first refresh)
+	if (gEngine->level->objectGrid != nullptr)
+		gEngine->level->objectGrid->spawns.fetch_add(1, std::memory_order_relaxed);
+}
 
 OBJECT::~OBJECT()
 {
 	//Remove player references to us (prevent terrible crashes, we're no longer on Genesis hardware)
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
+	for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 	{
-		PLAYER *player = gLevel->playerList[i];
+		PLAYER *player = gEngine->level->playerList[i];
 		if (player->interact == this)
 			player->interact = nullptr;
 	}
 	
 	//Remove object load references to us
-	gLevel->UnrefObjectLoad(this);
+	gEngine->level->UnrefObjectLoad(this);
+	
+	//Remove us from the object grid
+	if (grid.linked)
+		gEngine->level->objectGrid->Unlink(this);
 	
 	//Free allocated scratch memory
 	free(scratch);
 	
 	//Destroy draw instances and children
-	CLEAR_INSTANCE_LINKEDLIST(drawInstances);
+	drawInstances.clear();
 	CLEAR_INSTANCE_LINKEDLIST(children);
 }
 
+//Player contact list overflow
+OBJECT_CONTACT &OBJECT_CONTACTLIST::Overflow(size_t i)
+{
+	//Grow our overflow array to fit every player in the level
+	if (i >= overflowSize)
+	{
+		size_t newSize = mmax(i + 1, gEngine->level->playerList.size());
+		OBJECT_CONTACT *newOverflow = new OBJECT_CONTACT[newSize];
+		for (size_t v = 0; v < overflowSize; v++)
+			newOverflow[v] = overflow[v];
+		delete[] overflow;
+		overflow = newOverflow;
+		overflowSize = newSize;
+	}
+	return overflow[i];
+}
+
 //Generic object functions
 void OBJECT::Move()
 {
@@ -202,8 +342,8 @@ int16_t OBJECT::CheckCollisionRight_1Point(COLLISIONLAYER layer, int16_t xPos, i
 
 void OBJECT::DrawInstance(OBJECT_RENDERFLAGS iRenderFlags, TEXTURE *iTexture, OBJECT_MAPPING iMapping, bool iHighPriority, uint8_t iPriority, uint16_t iMappingFrame, int16_t iXPos, int16_t iYPos)
 {
-	//Create a draw instance with the properties given
-	OBJECT_DRAWINSTANCE *newInstance = new OBJECT_DRAWINSTANCE;
+	//Create a draw instance with the properties given (in a node kept from last update's instances, once we've drawn this many before)
+	OBJECT_DRAWINSTANCE *newInstance = &drawInstances.link_back(OBJECT_DRAWINSTANCE())->node_entry;
 	newInstance->renderFlags = iRenderFlags;
 	newInstance->texture = iTexture;
 	newInstance->mapping = iMapping;
@@ -212,14 +352,13 @@ void OBJECT::DrawInstance(OBJECT_RENDERFLAGS iRenderFlags, TEXTURE *iTexture, OB
 	newInstance->mappingFrame = iMappingFrame;
 	newInstance->xPos = iXPos;
 	newInstance->yPos = iYPos;
-	drawInstances.link_back(newInstance);
 }
 
 void OBJECT::UnloadOffscreen(int16_t xPos)
 {
 	//Check if we're within loaded range
-	uint16_t xOff = (xPos & 0xFF80) - ((gLevel->camera->xPos - 0x80) & 0xFF80);
-	if (xOff > upperRound(0x80 + gRenderSpec.width + 0x80, 0x80))
+	uint16_t xOff = (xPos & 0xFF80) - ((gEngine->level->camera->xPos - 0x80) & 0xFF80);
+	if (xOff > upperRound(0x80 + gEngine->renderSpec.width + 0x80, 0x80))
 		deleteFlag = true;
 }
 
@@ -230,7 +369,7 @@ bool OBJECT::Hurt(PLAYER *player)
 {
 	//Release if set to release when destroyed
 	if (status.releaseDestroyed)
-		gLevel->ReleaseObjectLoad(this);
+		gEngine->level->ReleaseObjectLoad(this);
 	
 	//Handle chain point bonus
 	uint16_t lastCounter = player->chainPointCounter;
@@ -276,42 +415,46 @@ bool OBJECT::Hurt(PLAYER *player)
 
 void OBJECT::ClearSolidContact()
 {
-	//Check all players and clear all contact
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
-	{
-		//Get the player
-		PLAYER *player = gLevel->playerList[i];
+	//Clear all contact of the players we're in contact with
+	for (size_t v = 0; v < OBJECT_CONTACT_SLOTS; v++)
+		if (!playerContact.slot[v].contact.IsClear())
+			ClearSolidContact(gEngine->level->playerList[playerContact.slot[v].player], &playerContact.slot[v].contact);
+	for (size_t i = 0; i < playerContact.overflowSize; i++)
+		if (!playerContact.overflow[i].IsClear())
+			ClearSolidContact(gEngine->level->playerList[i], &playerContact.overflow[i]);
+}
+
+void OBJECT::ClearSolidContact(PLAYER *player, OBJECT_CONTACT *contact)
+{
+	#ifndef FIX_LAZY_CONTACT_CLEAR
+		//Clear pushing and standing together
+		if (contact->standing || contact->pushing)
+		{
+			//Clear all of our contact flags
+			player->status.shouldNotFall = false;
+			player->status.pushing = false;
+			contact->standing = false;
+			contact->pushing = false;
+			player->status.inAir = true;
+		}
+	#else
+		//Clear standing
+		if (contact->standing)
+		{
+			//Clear all of our contact flags
+			player->status.shouldNotFall = false;
+			contact->standing = false;
+			player->status.inAir = true;
+		}
 		
-		#ifndef FIX_LAZY_CONTACT_CLEAR
-			//Clear pushing and standing together
-			if (playerContact[i].standing || playerContact[i].pushing)
-			{
-				//Clear all of our contact flags
-				player->status.shouldNotFall = false;
-				player->status.pushing = false;
-				playerContact[i].standing = false;
-				playerContact[i].pushing = false;
-				player->status.inAir = true;
-			}
-		#else
-			//Clear standing
-			if (playerContact[i].standing)
-			{
-				//Clear all of our contact flags
-				player->status.shouldNotFall = false;
-				playerContact[i].standing = false;
-				player->status.inAir = true;
-			}
-			
-			//Clear pushing
-			if (playerContact[i].pushing)
-			{
-				//Clear all of our contact flags
-				player->status.pushing = false;
-				playerContact[i].pushing = false;
-			}
-		#endif
-	}
+		//Clear pushing
+		if (contact->pushing)
+		{
+			//Clear all of our contact flags
+			player->status.pushing = false;
+			contact->pushing = false;
+		}
+	#endif
 }
 
 void OBJECT::Smash(size_t num, const OBJECT_SMASHMAP *smashmap, OBJECTFUNCTION fragmentFunction)
@@ -361,7 +504,7 @@ void OBJECT::Smash(size_t num, const OBJECT_SMASHMAP *smashmap, OBJECTFUNCTION f
 		
 		//Do an initial update, and link to level
 		fragmentFunction(newFragment);
-		gLevel->objectList.link_back(newFragment);
+		gEngine->level->LinkObject(newFragment);
 		smashmap++;
 	}
 	
@@ -415,7 +558,7 @@ void OBJECT::Fragment(size_t num, const OBJECT_FRAGMENTMAP *fragmap, OBJECTFUNCT
 		
 		//Do an initial update, and link to level
 		fragmentFunction(newFragment);
-		gLevel->objectList.link_back(newFragment);
+		gEngine->level->LinkObject(newFragment);
 		fragmap++;
 	}
 	
@@ -428,7 +571,7 @@ void OBJECT::AttachPlayer(PLAYER *player, size_t i)
 {
 	//If already standing on an object, clear that object's standing bit
 	if (player->status.shouldNotFall && player->interact != nullptr)
-		player->interact->playerContact[i].standing = false; //Clear the previous object stood on's standing bit
+		player->interact->playerContact.SetStanding(i, false); //Clear the previous object stood on's standing bit
 	
 	//Set to stand on this object
 	player->interact = this;
@@ -438,7 +581,7 @@ void OBJECT::AttachPlayer(PLAYER *player, size_t i)
 	
 	//Land on object
 	player->status.shouldNotFall = true;
-	playerContact[i].standing = true;
+	playerContact.SetStanding(i, true);
 	
 	if (player->status.inAir)
 	{
@@ -511,12 +654,23 @@ void OBJECT::MovePlayer(PLAYER *player, int16_t width, int16_t height, int16_t l
 		player->y.pos = top - player->yRadius;
 }
 
+void OBJECT::GetSolidPlayers(OBJECT_PLAYERMASK *mask, int16_t left, int16_t right)
+{
+	//Get players within the given horizontal range, and players already in contact with us (so they can be released)
+	gEngine->level->playerIndex->Query(left, right, mask);
+	playerContact.GetSolidPlayers(mask);
+}
+
 void OBJECT::SolidObjectTop(int16_t width, int16_t height, int16_t lastXPos, bool setAirOnExit, const int8_t *slope)
 {
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
+	//Get the players that could land on or be released from us
+	OBJECT_PLAYERMASK check;
+	GetSolidPlayers(&check, lastXPos - width, lastXPos + width - 1);
+	
+	for (size_t i = check.Next(0); i < OBJECT_PLAYER_REFERENCES; i = check.Next(i + 1))
 	{
 		//Get the player
-		PLAYER *player = gLevel->playerList[i];
+		PLAYER *player = gEngine->level->playerIndex->player[i];
 		
 		//If the player is already standing on us
 		if (playerContact[i].standing == true)
@@ -525,7 +679,10 @@ void OBJECT::SolidObjectTop(int16_t width, int16_t height, int16_t lastXPos, boo
 			int16_t xDiff = player->x.pos - lastXPos + width;
 			
 			if (!player->status.inAir && xDiff >= 0 && xDiff < width * 2)
+			{
 				MovePlayer(player, width, height, lastXPos, slope, false);
+				gEngine->level->playerIndex->Move(i);
+			}
 			else
 				ReleasePlayer(player, i, setAirOnExit);
 		}
@@ -588,7 +745,7 @@ bool OBJECT::LandOnTopSolid(PLAYER *player, size_t i, int16_t width1, int16_t wi
 void OBJECT::ReleasePlayer(PLAYER *player, size_t i, bool setAirOnExit)
 {
 	player->status.shouldNotFall = false;
-	playerContact[i].standing = false;
+	playerContact.SetStanding(i, false);
 	if (setAirOnExit)
 		player->status.inAir = true;
 }
@@ -598,10 +755,13 @@ OBJECT_SOLIDTOUCH OBJECT::SolidObjectFull(int16_t width, int16_t height_air, int
 	//Check all players for solid contact
 	OBJECT_SOLIDTOUCH solidTouch;
 	
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
+	OBJECT_PLAYERMASK check;
+	GetSolidPlayers(&check, x.pos - width, x.pos + width);
+	
+	for (size_t i = check.Next(0); i < OBJECT_PLAYER_REFERENCES; i = check.Next(i + 1))
 	{
 		//Get the player
-		PLAYER *player = gLevel->playerList[i];
+		PLAYER *player = gEngine->level->playerIndex->player[i];
 		
 		//Check if we're still standing on the object
 		if (playerContact[i].standing)
@@ -617,6 +777,7 @@ OBJECT_SOLIDTOUCH OBJECT::SolidObjectFull(int16_t width, int16_t height_air, int
 			
 			//Move with the object
 			MovePlayer(player, width, height_standing, lastXPos, slope, doubleSlope);
+			gEngine->level->playerIndex->Move(i);
 			continue;
 		}
 		else
@@ -713,7 +874,7 @@ void OBJECT::SolidObjectFull_Cont(OBJECT_SOLIDTOUCH *solidTouch, PLAYER *player,
 								//Crush the player and set the bottom touch flag
 								player->Kill(SOUNDID_HURT);
 								if (solidTouch != nullptr)
-									solidTouch->bottom[i] = true;
+									solidTouch->bottom.Set(i);
 								return;
 							}
 							
@@ -738,7 +899,7 @@ void OBJECT::SolidObjectFull_Cont(OBJECT_SOLIDTOUCH *solidTouch, PLAYER *player,
 							
 							//Set bottom touch flag
 							if (solidTouch != nullptr)
-								solidTouch->bottom[i] = true;
+								solidTouch->bottom.Set(i);
 							return;
 						}
 					}
@@ -764,7 +925,7 @@ void OBJECT::SolidObjectFull_Cont(OBJECT_SOLIDTOUCH *solidTouch, PLAYER *player,
 								
 								//Set top touch flag
 								if (solidTouch != nullptr)
-									solidTouch->top[i] = true;
+									solidTouch->top.Set(i);
 							}
 							
 							return;
@@ -805,21 +966,22 @@ void OBJECT::SolidObjectFull_Cont(OBJECT_SOLIDTOUCH *solidTouch, PLAYER *player,
 				
 				//Clip out of side
 				player->x.pos -= xDiff;
+				gEngine->level->playerIndex->Move(i);
 				
 				if (!player->status.inAir)
 				{
 					//Contact on ground: Set side touch and set pushing flags
 					if (solidTouch != nullptr)
-						solidTouch->side[i] = true;
-					playerContact[i].pushing = true;
+						solidTouch->side.Set(i);
+					playerContact.SetPushing(i, true);
 					player->status.pushing = true;
 				}
 				else
 				{
 					//Contact in mid-air: Set side touch and clear pushing flags
 					if (solidTouch != nullptr)
-						solidTouch->side[i] = true;
-					playerContact[i].pushing = false;
+						solidTouch->side.Set(i);
+					playerContact.SetPushing(i, false);
 					player->status.pushing = false;
 				}
 				return;
@@ -841,24 +1003,28 @@ void OBJECT::SolidObjectFull_ClearPush(PLAYER *player, size_t i)
 			player->anim = PLAYERANIMATION_RUN; //wrong animation id
 		
 		//Clear pushing flags
-		playerContact[i].pushing = false;
+		playerContact.SetPushing(i, false);
 		player->status.pushing = false;
 	}
 }
 
 void OBJECT::CollideStandingPlayersWithLevel()
 {
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
+	//Only players in contact with us can be standing on us
+	OBJECT_PLAYERMASK check;
+	playerContact.GetSolidPlayers(&check);
+	
+	for (size_t i = check.Next(0); i < OBJECT_PLAYER_REFERENCES; i = check.Next(i + 1))
 	{
 		//Get the player
-		PLAYER *player = gLevel->playerList[i];
+		PLAYER *player = gEngine->level->playerIndex->player[i];
 		
 		//Check floor if touching and release if so
 		if (playerContact[i].standing)
 		{
 			if (CheckCollisionDown_1Point(COLLISIONLAYER_NORMAL_TOP, player->x.pos, player->y.pos + player->yRadius, nullptr) < 0)
 			{
-				playerContact[i].standing = false;
+				playerContact.SetStanding(i, false);
 				player->status.inAir = true;
 			}
 		}
@@ -880,7 +1046,7 @@ bool OBJECT::Update()
 	}
 	
 	//Destroy draw instances from last update
-	CLEAR_INSTANCE_LINKEDLIST(drawInstances);
+	drawInstances.clear();
 	
 	//Run our object code
 	if (function != nullptr)
@@ -919,19 +1085,19 @@ void OBJECT::Draw()
 	if (drawInstances.size() > 0)
 	{
 		//On-screen check (checks the first draw instance, which is basically how the original does it)
-		int alignX = renderFlags.alignPlane ? gLevel->camera->xPos : 0;
-		int alignY = renderFlags.alignPlane ? gLevel->camera->yPos : 0;
-		int16_t xPos = drawInstances[0]->xPos;
-		int16_t yPos = drawInstances[0]->yPos;
+		int alignX = renderFlags.alignPlane ? gEngine->level->camera->xPos : 0;
+		int alignY = renderFlags.alignPlane ? gEngine->level->camera->yPos : 0;
+		int16_t xPos = drawInstances.head->node_entry.xPos;
+		int16_t yPos = drawInstances.head->node_entry.yPos;
 		
 		renderFlags.isOnscreen = false;
 		
-		if (!(xPos - alignX < -widthPixels || xPos - alignX > gRenderSpec.width + widthPixels) &&
-			!(yPos - alignY < -heightPixels || yPos - alignY > gRenderSpec.height + heightPixels))
+		if (!(xPos - alignX < -widthPixels || xPos - alignX > gEngine->renderSpec.width + widthPixels) &&
+			!(yPos - alignY < -heightPixels || yPos - alignY > gEngine->renderSpec.height + heightPixels))
 		{
 			//Draw our draw instances if on-screen and set flag
-			for (size_t i = 0; i < drawInstances.size(); i++)
-				RenderDrawInstance(drawInstances[i]);
+			for (LL_NODE<OBJECT_DRAWINSTANCE> *node = drawInstances.head; node != nullptr; node = node->next)
+				RenderDrawInstance(&node->node_entry);
 			renderFlags.isOnscreen = true;
 		}
 	}
@@ -975,8 +1141,8 @@ void OBJECT::RenderDrawInstance(OBJECT_DRAWINSTANCE *drawInstance)
 			origY = mapRect.h - origY;
 		
 		//Draw to screen at the given position
-		int alignX = drawInstance->renderFlags.alignPlane ? gLevel->camera->xPos : 0;
-		int alignY = drawInstance->renderFlags.alignPlane ? gLevel->camera->yPos : 0;
-		gSoftwareBuffer->DrawTexture(drawInstance->texture, drawInstance->texture->loadedPalette, &mapRect, gLevel->GetObjectLayer(highPriority, priority), drawInstance->xPos - origX - alignX, drawInstance->yPos - origY - alignY, drawInstance->renderFlags.xFlip, drawInstance->renderFlags.yFlip);
+		int alignX = drawInstance->renderFlags.alignPlane ? gEngine->level->camera->xPos : 0;
+		int alignY = drawInstance->renderFlags.alignPlane ? gEngine->level->camera->yPos : 0;
+		gEngine->softwareBuffer->DrawTexture(drawInstance->texture, drawInstance->texture->loadedPalette, &mapRect, gEngine->level->GetObjectLayer(highPriority, priority), drawInstance->xPos - origX - alignX, drawInstance->yPos - origY - alignY, drawInstance->renderFlags.xFlip, drawInstance->renderFlags.yFlip);
 	}
 }
@@ -2,8 +2,10 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "LinkedList.h"
+#include "ObjectGrid.h"
 #include "Render.h"
 #include "Mappings.h"
 #include "LevelCollision.h"
@@ -12,12 +14,15 @@
 //Declare the object and player classes
 class OBJECT;
 class PLAYER;
+struct OBJECTJOB;
 
 //Object function type
 typedef void (*OBJECTFUNCTION)(OBJECT*);
 
 //Constants
-#define OBJECT_PLAYER_REFERENCES 0x100
+#define OBJECT_PLAYER_REFERENCES 0x100	//Maximum amount of players an object can keep track of (player indices must fit in a uint8_t)
+#define OBJECT_CONTACT_SLOTS 4			//Amount of players an object can be in contact with before spilling into the overflow array
+#define OBJECT_RESERVE 0x100			//Objects (and list nodes for their draw instances and children) reserved when a level loads, so loading and spawning objects doesn't allocate
 
 //Common macros
 #define CHECK_LINKEDLIST_OBJECTDELETE(linkedList)	for (LL_NODE<OBJECT*> *node = linkedList.head; node != nullptr;)	\
@@ -75,11 +80,137 @@ struct OBJECT_STATUS
 	bool objectSpecific = false;	//Used for anything any specific object wants
 };
 
+//Per-player bitmask (one bit per player index)
+struct OBJECT_PLAYERMASK
+{
+	uint32_t word[OBJECT_PLAYER_REFERENCES / 32] = {0};
+	
+	inline void Set(size_t i) { word[i >> 5] |= (1U << (i & 0x1F)); }
+	inline bool operator[](size_t i) const { return (word[i >> 5] & (1U << (i & 0x1F))) != 0; }
+	
+	//Get the first set bit at or after i, returns OBJECT_PLAYER_REFERENCES if there's none
+	inline size_t Next(size_t i) const
+	{
+		for (; i < OBJECT_PLAYER_REFERENCES; i++)
+		{
+			if ((word[i >> 5] >> (i & 0x1F)) == 0)
+				i |= 0x1F; //Skip the rest of this word
+			else if ((*this)[i])
+				return i;
+		}
+		return OBJECT_PLAYER_REFERENCES;
+	}
+};
+
 struct OBJECT_SOLIDTOUCH
 {
-	bool side[OBJECT_PLAYER_REFERENCES] = {0};
-	bool bottom[OBJECT_PLAYER_REFERENCES] = {0};
-	bool top[OBJECT_PLAYER_REFERENCES] = {0};
+	OBJECT_PLAYERMASK side;
+	OBJECT_PLAYERMASK bottom;
+	OBJECT_PLAYERMASK top;
+};
+
+//Player contact status
+struct OBJECT_CONTACT
+{
+	bool standing = false;
+	bool pushing = false;
+	bool objectSpecific = false;
+	
+	inline bool IsClear() const { return !(standing || pushing || objectSpecific); }
+};
+
+//Sparse player contact list, only players actually in contact with the object take up an entry
+//An entry with all of its flags clear is considered free, so entries are never explicitly removed
+class OBJECT_CONTACTLIST
+{
+	public:
+		//Inline entries
+		struct
+		{
+			uint8_t player = 0;
+			OBJECT_CONTACT contact;
+		} slot[OBJECT_CONTACT_SLOTS];
+		
+		//Overflow array indexed by player, allocated if more than OBJECT_CONTACT_SLOTS players are in contact at once
+		OBJECT_CONTACT *overflow = nullptr;
+		size_t overflowSize = 0;
+		
+	public:
+		//Constructor and destructor (we own our overflow array, so we can't be copied)
+		OBJECT_CONTACTLIST() { return; }
+		OBJECT_CONTACTLIST(const OBJECT_CONTACTLIST&) = delete;
+		OBJECT_CONTACTLIST &operator=(const OBJECT_CONTACTLIST&) = delete;
+		~OBJECT_CONTACTLIST() { delete[] overflow; }
+		
+		//Get the given player's contact, returns nullptr if there's no contact
+		inline OBJECT_CONTACT *Find(size_t i)
+		{
+			for (size_t v = 0; v < OBJECT_CONTACT_SLOTS; v++)
+				if (slot[v].player == i && !slot[v].contact.IsClear())
+					return &slot[v].contact;
+			if (i < overflowSize && !overflow[i].IsClear())
+				return &overflow[i];
+			return nullptr;
+		}
+		
+		//Get the given player's contact for reading (all clear if there's no contact)
+		inline OBJECT_CONTACT operator[](size_t i)
+		{
+			OBJECT_CONTACT *contact = Find(i);
+			return (contact != nullptr) ? *contact : OBJECT_CONTACT();
+		}
+		
+		//Get the given player's contact for writing, only taking an entry if a flag's being set (returns nullptr if there's no contact and none was taken)
+		inline OBJECT_CONTACT *Write(size_t i, bool set)
+		{
+			//Use our existing entry if we have one
+			OBJECT_CONTACT *contact = Find(i);
+			if (contact != nullptr || !set)
+				return contact;
+			
+			//Otherwise take a free inline entry (it's claimed once its flag is set, so the next lookup can't take it too)
+			for (size_t v = 0; v < OBJECT_CONTACT_SLOTS; v++)
+			{
+				if (slot[v].contact.IsClear())
+				{
+					slot[v].player = (uint8_t)i;
+					return &slot[v].contact;
+				}
+			}
+			
+			//All inline entries are in use, use the overflow array
+			return &Overflow(i);
+		}
+		
+		//Set or clear the given player's contact flags
+		inline void SetStanding(size_t i, bool value)		{ OBJECT_CONTACT *contact = Write(i, value); if (contact != nullptr) contact->standing = value; }
+		inline void SetPushing(size_t i, bool value)		{ OBJECT_CONTACT *contact = Write(i, value); if (contact != nullptr) contact->pushing = value; }
+		inline void SetObjectSpecific(size_t i, bool value)	{ OBJECT_CONTACT *contact = Write(i, value); if (contact != nullptr) contact->objectSpecific = value; }
+		
+		//Check if any player is standing on us
+		inline bool AnyStanding()
+		{
+			for (size_t v = 0; v < OBJECT_CONTACT_SLOTS; v++)
+				if (slot[v].contact.standing)
+					return true;
+			for (size_t i = 0; i < overflowSize; i++)
+				if (overflow[i].standing)
+					return true;
+			return false;
+		}
+		
+		//Set the bits of every player standing on or pushing the object
+		inline void GetSolidPlayers(OBJECT_PLAYERMASK *mask)
+		{
+			for (size_t v = 0; v < OBJECT_CONTACT_SLOTS; v++)
+				if (slot[v].contact.standing || slot[v].contact.pushing)
+					mask->Set(slot[v].player);
+			for (size_t i = 0; i < overflowSize; i++)
+				if (overflow[i].standing || overflow[i].pushing)
+					mask->Set(i);
+		}
+		
+		OBJECT_CONTACT &Overflow(size_t i);
 };
 
 struct OBJECT_SMASHMAP
@@ -125,7 +256,7 @@ class OBJECT
 		
 		//Rendering stuff
 		OBJECT_RENDERFLAGS renderFlags;
-		LINKEDLIST<OBJECT_DRAWINSTANCE*> drawInstances;
+		LINKEDLIST<OBJECT_DRAWINSTANCE> drawInstances;
 		
 		//Our texture and mappings
 		TEXTURE *texture = nullptr;
@@ -173,12 +304,7 @@ class OBJECT
 		OBJECT_STATUS status;
 		
 		//Player contact status
-		struct
-		{
-			bool standing = false;
-			bool pushing = false;
-			bool objectSpecific = false;
-		} playerContact[OBJECT_PLAYER_REFERENCES];
+		OBJECT_CONTACTLIST playerContact;
 		
 		//Routine
 		uint8_t routine = 0;			//Routine
@@ -195,8 +321,15 @@ class OBJECT
 		//Children linked list
 		LINKEDLIST<OBJECT*> children;
 		
+		//Object grid state
+		OBJECTGRID_ENTRY grid;
+		
+		//Job if being updated in parallel this frame
+		OBJECTJOB *job = nullptr;
+		
 		//Scratch memory
 		void *scratch = nullptr; //No specific type - whatever an object specifies
+		size_t scratchSize = 0;
 		
 		//Our object-specific function
 		OBJECTFUNCTION function = nullptr;
@@ -210,6 +343,10 @@ class OBJECT
 		OBJECT(OBJECTFUNCTION object);
 		~OBJECT();
 		
+		//Allocation (from our pool of deleted objects)
+		static void *operator new(size_t size);
+		static void operator delete(void *pointer);
+		
 		//Scratch allocation function
 		template <typename T> inline T *Scratch()
 		{
@@ -217,6 +354,8 @@ class OBJECT
 			if (scratch == nullptr)
 			{
 				scratch = malloc(sizeof(T)); //Allocate memory (have to use malloc because destructor doesn't know scratch type)
+				scratchSize = sizeof(T);
+				memset(scratch, 0, sizeof(T)); //Clear padding too, so scratch can be hashed
 				*((T*)scratch) = {}; //Explicitly initialize because we used malloc
 			}
 			return (T*)scratch;
@@ -244,8 +383,10 @@ class OBJECT
 		//Object interaction functions
 		bool Hurt(PLAYER *player);
 		void ClearSolidContact();
+		void ClearSolidContact(PLAYER *player, OBJECT_CONTACT *contact);
 		
 		//Player solid contact functions
+		void GetSolidPlayers(OBJECT_PLAYERMASK *mask, int16_t left, int16_t right);
 		void AttachPlayer(PLAYER *player, size_t i);
 		void MovePlayer(PLAYER *player, int16_t width, int16_t height, int16_t lastXPos, const int8_t *slope, bool doubleSlope);
 		
@@ -264,3 +405,10 @@ class OBJECT
 		void Draw();
 		void RenderDrawInstance(OBJECT_DRAWINSTANCE *drawInstance);
 };
+
+//Object pool functions
+void ReserveObjects(size_t objects);
+void FreeObjectPool();
+
+//Object function index, the same in every build (unlike the function's address), 0 for none
+uint32_t GetObjectFunctionIndex(OBJECTFUNCTION function);
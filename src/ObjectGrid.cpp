@@ -0,0 +1,204 @@
+#include "ObjectGrid.h"
+#include "Object.h"
+#include "MathUtil.h"
+
+//Constructor and destructor
+OBJECTGRID::OBJECTGRID(size_t levelWidth, size_t levelHeight) : spawns(0)
+{
+	//Allocate our cells to cover the level (given in pixels)
+	width = (int)((levelWidth >> OBJECTGRID_CELL_SHIFT) + 1);
+	height = (int)((levelHeight >> OBJECTGRID_CELL_SHIFT) + 1);
+	cell = new OBJECTGRID_CELL[width * height];
+	
+	//Give each cell its reserved objects
+	reserved = new OBJECT*[width * height * OBJECTGRID_CELL_RESERVE];
+	for (int i = 0; i < width * height; i++)
+	{
+		cell[i].object = &reserved[i * OBJECTGRID_CELL_RESERVE];
+		cell[i].capacity = OBJECTGRID_CELL_RESERVE;
+	}
+	
+	candidateCapacity = 0x40;
+	candidate = new OBJECT*[candidateCapacity];
+}
+
+OBJECTGRID::~OBJECTGRID()
+{
+	//Free our cells and query results
+	for (int i = 0; i < width * height; i++)
+		if (cell[i].capacity > OBJECTGRID_CELL_RESERVE)
+			delete[] cell[i].object;
+	delete[] cell;
+	delete[] reserved;
+	delete[] candidate;
+}
+
+//Linking functions
+void OBJECTGRID::Link(OBJECT *object, int left, int top, int right, int bottom)
+{
+	//Link into every cell we cover
+	for (int y = top; y <= bottom; y++)
+	{
+		for (int x = left; x <= right; x++)
+		{
+			OBJECTGRID_CELL *thisCell = &cell[y * width + x];
+			
+			//Grow cell if full
+			if (thisCell->size >= thisCell->capacity)
+			{
+				size_t newCapacity = thisCell->capacity * 2;
+				OBJECT **newObject = new OBJECT*[newCapacity];
+				for (size_t i = 0; i < thisCell->size; i++)
+					newObject[i] = thisCell->object[i];
+				if (thisCell->capacity > OBJECTGRID_CELL_RESERVE)
+					delete[] thisCell->object;
+				thisCell->object = newObject;
+				thisCell->capacity = newCapacity;
+			}
+			
+			thisCell->object[thisCell->size++] = object;
+		}
+	}
+	
+	//Remember the cells we're linked into
+	object->grid.linked = true;
+	object->grid.left = left;
+	object->grid.top = top;
+	object->grid.right = right;
+	object->grid.bottom = bottom;
+}
+
+void OBJECTGRID::Unlink(OBJECT *object)
+{
+	if (!object->grid.linked)
+		return;
+	
+	//Remove from every cell we were linked into (order within a cell doesn't matter)
+	for (int y = object->grid.top; y <= object->grid.bottom; y++)
+	{
+		for (int x = object->grid.left; x <= object->grid.right; x++)
+		{
+			OBJECTGRID_CELL *thisCell = &cell[y * width + x];
+			for (size_t i = 0; i < thisCell->size; i++)
+			{
+				if (thisCell->object[i] == object)
+				{
+					thisCell->object[i] = thisCell->object[--thisCell->size];
+					break;
+				}
+			}
+		}
+	}
+	
+	object->grid.linked = false;
+}
+
+//Get the area an object and its children can be touched or attracted in
+static void GetObjectBounds(OBJECT *object, int *left, int *top, int *right, int *bottom)
+{
+	//Our position (ring attraction)
+	*left = mmin(*left, (int)object->x.pos);
+	*top = mmin(*top, (int)object->y.pos);
+	*right = mmax(*right, (int)object->x.pos);
+	*bottom = mmax(*bottom, (int)object->y.pos);
+	
+	//Our touch hitbox
+	if (object->collisionType != COLLISIONTYPE_NULL)
+	{
+		int touchWidth = mabs(object->touchWidth);
+		int touchHeight = mabs(object->touchHeight);
+		*left = mmin(*left, object->x.pos - touchWidth);
+		*top = mmin(*top, object->y.pos - touchHeight);
+		*right = mmax(*right, object->x.pos + touchWidth);
+		*bottom = mmax(*bottom, object->y.pos + touchHeight);
+	}
+	
+	//Our children
+	for (LL_NODE<OBJECT*> *node = object->children.head; node != nullptr; node = node->next)
+		GetObjectBounds(node->node_entry, left, top, right, bottom);
+}
+
+//Update the grid from the object list, only relinking objects that have moved cells
+void OBJECTGRID::Refresh(LINKEDLIST<OBJECT*> *objectList)
+{
+	refreshList = objectList;
+	refreshSpawns = spawns.load(std::memory_order_relaxed);
+	
+	uint32_t order = 0;
+	
+	for (LL_NODE<OBJECT*> *node = objectList->head; node != nullptr; node = node->next)
+	{
+		//Get the cells this object covers
+		OBJECT *object = node->node_entry;
+		int left = object->x.pos, top = object->y.pos, right = object->x.pos, bottom = object->y.pos;
+		GetObjectBounds(object, &left, &top, &right, &bottom);
+		
+		left = mmax(mmin(left >> OBJECTGRID_CELL_SHIFT, width - 1), 0);
+		top = mmax(mmin(top >> OBJECTGRID_CELL_SHIFT, height - 1), 0);
+		right = mmax(mmin(right >> OBJECTGRID_CELL_SHIFT, width - 1), 0);
+		bottom = mmax(mmin(bottom >> OBJECTGRID_CELL_SHIFT, height - 1), 0);
+		
+		//Relink if we've moved cells
+		if (!object->grid.linked || object->grid.left != left || object->grid.top != top || object->grid.right != right || object->grid.bottom != bottom)
+		{
+			Unlink(object);
+			Link(object, left, top, right, bottom);
+		}
+		
+		//Remember our position in the object list
+		object->grid.order = order++;
+	}
+}
+
+//Gather the objects in the given area, sorted by object list order
+size_t OBJECTGRID::Query(int16_t left, int16_t top, int16_t right, int16_t bottom)
+{
+	//Get the cells to check
+	int cLeft = mmax(mmin(left >> OBJECTGRID_CELL_SHIFT, width - 1), 0);
+	int cTop = mmax(mmin(top >> OBJECTGRID_CELL_SHIFT, height - 1), 0);
+	int cRight = mmax(mmin(right >> OBJECTGRID_CELL_SHIFT, width - 1), 0);
+	int cBottom = mmax(mmin(bottom >> OBJECTGRID_CELL_SHIFT, height - 1), 0);
+	
+	//Link objects spawned since we were refreshed (by an earlier player's touch, for example), the object list used to be scanned directly so they'd be found
+	if (refreshList != nullptr && spawns.load(std::memory_order_relaxed) != refreshSpawns)
+		Refresh(refreshList);
+	
+	//Gather every object in these cells, only once each
+	queryStamp++;
+	candidates = 0;
+	
+	for (int y = cTop; y <= cBottom; y++)
+	{
+		for (int x = cLeft; x <= cRight; x++)
+		{
+			OBJECTGRID_CELL *thisCell = &cell[y * width + x];
+			for (size_t i = 0; i < thisCell->size; i++)
+			{
+				OBJECT *object = thisCell->object[i];
+				if (object->grid.queryStamp == queryStamp)
+					continue;
+				object->grid.queryStamp = queryStamp;
+				
+				//Grow our results if full
+				if (candidates >= candidateCapacity)
+				{
+					size_t newCapacity = candidateCapacity * 2;
+					OBJECT **newCandidate = new OBJECT*[newCapacity];
+					for (size_t v = 0; v < candidates; v++)
+						newCandidate[v] = candidate[v];
+					delete[] candidate;
+					candidate = newCandidate;
+					candidateCapacity = newCapacity;
+				}
+				
+				//Insert sorted by list order, so objects are checked in the same order as the object list
+				size_t v = candidates++;
+				for (; v > 0 && candidate[v - 1]->grid.order > object->grid.order; v--)
+					candidate[v] = candidate[v - 1];
+				candidate[v] = object;
+			}
+		}
+	}
+	
+	return candidates;
+}
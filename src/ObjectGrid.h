@@ -0,0 +1,63 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "LinkedList.h"
+
+//Declare the object class
+class OBJECT;
+
+//Constants
+#define OBJECTGRID_CELL_SHIFT	6	//64x64 pixel cells
+#define OBJECTGRID_CELL_RESERVE	8	//Objects reserved for in each cell up front (so linking doesn't allocate until a cell holds more)
+
+//Object grid cell
+struct OBJECTGRID_CELL
+{
+	OBJECT **object = nullptr;
+	size_t size = 0;
+	size_t capacity = 0;
+};
+
+//Object grid state kept by each object
+struct OBJECTGRID_ENTRY
+{
+	bool linked = false;
+	int left = 0, top = 0, right = 0, bottom = 0;	//Cells we're linked into
+	uint32_t order = 0;								//Our position in the object list
+	uint32_t queryStamp = 0;						//Last query we were gathered by (prevents duplicates)
+};
+
+//Uniform grid of objects, used to only check objects near a player for touch and ring attraction
+class OBJECTGRID
+{
+	public:
+		//Cells
+		int width = 0, height = 0;
+		OBJECTGRID_CELL *cell = nullptr;
+		OBJECT **reserved = nullptr;	//Every cell's reserved objects, cells only free their objects once they've grown out of these
+		
+		//Objects created in our level so far, queries refresh us if any have been created since we were last refreshed (so objects spawned earlier in the frame are found)
+		std::atomic<uint32_t> spawns;
+		
+		//Object list we were last refreshed from, and how many objects had been created then
+		LINKEDLIST<OBJECT*> *refreshList = nullptr;
+		uint32_t refreshSpawns = 0;
+		
+		//Query results (sorted by object list order)
+		OBJECT **candidate = nullptr;
+		size_t candidates = 0;
+		size_t candidateCapacity = 0;
+		uint32_t queryStamp = 0;
+	
+	public:
+		OBJECTGRID(size_t levelWidth, size_t levelHeight);
+		~OBJECTGRID();
+		
+		void Link(OBJECT *object, int left, int top, int right, int bottom);
+		void Unlink(OBJECT *object);
+		
+		void Refresh(LINKEDLIST<OBJECT*> *objectList);
+		size_t Query(int16_t left, int16_t top, int16_t right, int16_t bottom);
+};
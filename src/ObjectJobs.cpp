@@ -0,0 +1,374 @@
+#include <string.h>
+
+#include "ObjectJobs.h"
+#include "Object.h"
+#include "Objects.h"
+#include "Game.h"
+#include "Error.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "MathUtil.h"
+
+//Amount of worker threads to use for object updates
+unsigned int gObjectJobThreads = 0;
+
+//Command buffer of the object being updated on this thread
+thread_local OBJECTCOMMANDBUFFER *gObjectCommands = nullptr;
+
+//Objects that only interact with themselves, their children, read-only level state, and the command buffer, when no player is nearby
+static const OBJECTFUNCTION parallelFunctions[] = {
+	&ObjRing,
+	&ObjExplosion,
+	&ObjSonic1Scenery,
+	&ObjMotobug,
+	&ObjChopper,
+	&ObjCrabmeat,
+	&ObjGHZWaterfallSound,
+	&ObjGHZPlatform,
+	&ObjGHZSwingingPlatform,
+	&ObjGHZSpikeLog,
+	&ObjGHZPurpleRock,
+};
+
+//Command buffer
+OBJECTCOMMANDBUFFER::~OBJECTCOMMANDBUFFER()
+{
+	delete[] command;
+}
+
+OBJECTCOMMAND *OBJECTCOMMANDBUFFER::Push(OBJECTCOMMAND_TYPE type)
+{
+	//Grow our buffer if full
+	if (commands >= capacity)
+	{
+		size_t newCapacity = mmax(capacity * 2, (size_t)0x40);
+		OBJECTCOMMAND *newCommand = new OBJECTCOMMAND[newCapacity];
+		memcpy(newCommand, command, commands * sizeof(OBJECTCOMMAND));
+		delete[] command;
+		command = newCommand;
+		capacity = newCapacity;
+	}
+	
+	command[commands].type = type;
+	return &command[commands++];
+}
+
+void OBJECTCOMMANDBUFFER::Replay(size_t from, size_t to)
+{
+	//Perform the recorded commands in order
+	for (size_t i = from; i < to; i++)
+	{
+		switch (command[i].type)
+		{
+			case OBJECTCOMMAND_ADDTOSCORE:
+				AddToScore(command[i].value);
+				break;
+			case OBJECTCOMMAND_ADDTORINGS:
+				AddToRings(command[i].value);
+				break;
+			case OBJECTCOMMAND_ADDTOLIVES:
+				AddToLives(command[i].value);
+				break;
+			case OBJECTCOMMAND_PLAYSOUND:
+				PlaySound(command[i].sound);
+				break;
+			case OBJECTCOMMAND_STOPSOUND:
+				StopSound(command[i].sound);
+				break;
+			case OBJECTCOMMAND_STOPCHANNEL:
+				StopChannel(command[i].channel);
+				break;
+			case OBJECTCOMMAND_LINKOBJECT:
+				gEngine->level->LinkObject(command[i].object);
+				break;
+			case OBJECTCOMMAND_LINKOBJECTLOAD:
+				gEngine->level->LinkObjectLoad(command[i].object);
+				break;
+			case OBJECTCOMMAND_RELEASEOBJECTLOAD:
+				gEngine->level->ReleaseObjectLoad(command[i].object);
+				break;
+		}
+	}
+}
+
+//Constructor and destructor
+OBJECTJOBS::OBJECTJOBS(size_t workerThreads)
+{
+	//Start our worker threads
+	threads = mmin(workerThreads, (size_t)OBJECTJOBS_MAX_THREADS);
+	thread = new std::thread[threads];
+	for (size_t i = 0; i < threads; i++)
+		thread[i] = std::thread(&OBJECTJOBS::Worker, this, i);
+	
+	LOG(("Started %d object job threads\n", (int)threads));
+}
+
+OBJECTJOBS::~OBJECTJOBS()
+{
+	//Stop our worker threads
+	mutex.lock();
+	quit = true;
+	mutex.unlock();
+	startCondition.notify_all();
+	
+	for (size_t i = 0; i < threads; i++)
+		thread[i].join();
+	delete[] thread;
+	
+	//Free our arrays
+	delete[] job;
+	delete[] island;
+	delete[] hot;
+}
+
+//Worker thread
+void OBJECTJOBS::Worker(size_t index)
+{
+	PROFILE_THREAD("Object jobs");
+	uint32_t lastGeneration = 0;
+	
+	while (1)
+	{
+		//Wait for the next frame's jobs
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!quit && generation == lastGeneration)
+				startCondition.wait(lock);
+			if (quit)
+				return;
+			lastGeneration = generation;
+		}
+		
+		//Update objects then signal that we're done
+		WorkIslands(index);
+		
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (--working == 0)
+				endCondition.notify_one();
+		}
+	}
+}
+
+void OBJECTJOBS::WorkIslands(size_t index)
+{
+	PROFILE_ZONE("Object islands");
+	
+	//Use the engine context of the level we're updating, and record global state changes to our own buffer
+	gEngine = engine;
+	
+	OBJECTCOMMANDBUFFER *commands = &buffer[index];
+	gObjectCommands = commands;
+	
+	//Update every object in each island we take, in object list order
+	for (size_t i = nextIsland++; i < islands; i = nextIsland++)
+	{
+		for (size_t v = island[i]; v < island[i + 1]; v++)
+		{
+			OBJECTJOB *thisJob = &job[v];
+			thisJob->buffer = commands;
+			thisJob->commandStart = commands->commands;
+			thisJob->failed = thisJob->object->Update();
+			thisJob->commandEnd = commands->commands;
+		}
+	}
+	
+	gObjectCommands = nullptr;
+}
+
+//Check if the given object can be updated in parallel
+static bool IsParallelFunction(OBJECTFUNCTION function)
+{
+	for (size_t i = 0; i < sizeof(parallelFunctions) / sizeof(parallelFunctions[0]); i++)
+		if (function == parallelFunctions[i])
+			return true;
+	return false;
+}
+
+//Update all objects that can be updated in parallel, this should be done after the players update and the object grid is refreshed
+bool OBJECTJOBS::Run(LINKEDLIST<OBJECT*> *objectList)
+{
+	OBJECTGRID *grid = gEngine->level->objectGrid;
+	PLAYERINDEX *playerIndex = gEngine->level->playerIndex;
+	
+	//Mark the grid cells near players, objects here may interact with players and are updated serially
+	size_t cells = grid->width * grid->height;
+	if (cells != hotSize)
+	{
+		delete[] hot;
+		hot = new uint8_t[cells];
+		hotSize = cells;
+	}
+	memset(hot, 0, cells);
+	
+	for (size_t i = 0; i < playerIndex->players; i++)
+	{
+		PLAYER *player = playerIndex->player[i];
+		int cx = player->x.pos >> OBJECTGRID_CELL_SHIFT, cy = player->y.pos >> OBJECTGRID_CELL_SHIFT;
+		
+		for (int y = mmax(cy - OBJECTJOBS_PLAYER_MARGIN, 0); y <= mmin(cy + OBJECTJOBS_PLAYER_MARGIN, grid->height - 1); y++)
+			for (int x = mmax(cx - OBJECTJOBS_PLAYER_MARGIN, 0); x <= mmin(cx + OBJECTJOBS_PLAYER_MARGIN, grid->width - 1); x++)
+				hot[y * grid->width + x] = 1;
+	}
+	
+	//Gather the objects we can update, and count how many are in each island (the second half of our job array is used for sorting)
+	size_t columns = (grid->width >> OBJECTJOBS_ISLAND_SHIFT) + 1;
+	if (columns + 1 > islandCapacity)
+	{
+		delete[] island;
+		island = new size_t[columns + 1];
+		islandCapacity = columns + 1;
+	}
+	memset(island, 0, (columns + 1) * sizeof(size_t));
+	
+	if (objectList->size() * 2 > jobCapacity)
+	{
+		delete[] job;
+		jobCapacity = objectList->size() * 2;
+		job = new OBJECTJOB[jobCapacity];
+	}
+	
+	size_t eligible = 0;
+	for (LL_NODE<OBJECT*> *node = objectList->head; node != nullptr; node = node->next)
+	{
+		OBJECT *object = node->node_entry;
+		object->job = nullptr;
+		
+		//Objects must be initialized and be able to update without interacting with anything else
+		if (!object->grid.linked || object->function != object->prevFunction || !IsParallelFunction(object->function))
+			continue;
+		
+		//Objects must not be near any player
+		bool nearPlayer = false;
+		for (int y = object->grid.top; y <= object->grid.bottom && !nearPlayer; y++)
+			for (int x = object->grid.left; x <= object->grid.right && !nearPlayer; x++)
+				nearPlayer = hot[y * grid->width + x] != 0;
+		if (nearPlayer)
+			continue;
+		
+		//Remember this object and count it towards its island
+		job[eligible++].object = object;
+		island[(object->grid.left >> OBJECTJOBS_ISLAND_SHIFT) + 1]++;
+	}
+	
+	if (eligible == 0)
+		return false;
+	
+	//Sort our jobs into islands (stable, so each island remains in object list order)
+	for (size_t i = 0; i < columns; i++)
+		island[i + 1] += island[i];
+	
+	for (size_t i = 0; i < eligible; i++)
+	{
+		OBJECT *object = job[i].object;
+		size_t v = island[object->grid.left >> OBJECTJOBS_ISLAND_SHIFT]++;
+		job[eligible + v].object = object;
+	}
+	
+	//Copy back and compact our islands, skipping empty columns
+	jobs = eligible;
+	islands = 0;
+	
+	size_t start = 0;
+	for (size_t i = 0; i < columns; i++)
+	{
+		//Read this column's end before writing over it (islands never passes i)
+		size_t end = island[i];
+		if (end != start)
+		{
+			island[islands++] = start;
+			start = end;
+		}
+	}
+	island[islands] = jobs;
+	
+	for (size_t i = 0; i < jobs; i++)
+	{
+		job[i].object = job[eligible + i].object;
+		job[i].object->job = &job[i];
+	}
+	
+	//Make sure every island holds its own columns' objects, otherwise islands were merged and run serially (this doesn't change the result, so state hashes can't catch it)
+	#ifdef DEBUG
+		for (size_t i = 0; i < islands; i++)
+		{
+			int column = job[island[i]].object->grid.left >> OBJECTJOBS_ISLAND_SHIFT;
+			if (i != 0 && (job[island[i - 1]].object->grid.left >> OBJECTJOBS_ISLAND_SHIFT) == column)
+				return Error(fail = "Object job islands share a column");
+			for (size_t v = island[i]; v < island[i + 1]; v++)
+				if ((job[v].object->grid.left >> OBJECTJOBS_ISLAND_SHIFT) != column)
+					return Error(fail = "Object job island holds objects from other columns");
+		}
+	#endif
+	
+	//Clear our command buffers and start our workers
+	for (size_t i = 0; i <= threads; i++)
+		buffer[i].commands = 0;
+	nextIsland = 0;
+	engine = gEngine;
+	
+	mutex.lock();
+	working = threads;
+	generation++;
+	mutex.unlock();
+	startCondition.notify_all();
+	
+	//Work on the main thread too, then wait for our workers to finish
+	WorkIslands(threads);
+	
+	std::unique_lock<std::mutex> lock(mutex);
+	while (working != 0)
+		endCondition.wait(lock);
+	return false;
+}
+
+//Finish the given object's job once the serial update reaches it, replaying its global state changes in object list order
+bool OBJECTJOBS::Finish(OBJECT *object)
+{
+	OBJECTJOB *thisJob = object->job;
+	object->job = nullptr;
+	
+	if (thisJob->failed)
+		return true;
+	thisJob->buffer->Replay(thisJob->commandStart, thisJob->commandEnd);
+	return false;
+}
+
+//Hash the state of every object (FNV-1a)
+static void HashData(uint64_t *hash, const void *data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		*hash ^= ((const uint8_t*)data)[i];
+		*hash *= 0x100000001B3ULL;
+	}
+}
+
+static void HashObject(uint64_t *hash, OBJECT *object)
+{
+	//Function pointers move between runs and builds, so hash the function's index instead
+	uint32_t function = GetObjectFunctionIndex(object->function);
+	HashData(hash, &function, sizeof(function));
+	HashData(hash, &object->routine, sizeof(object->routine));
+	HashData(hash, &object->routineSecondary, sizeof(object->routineSecondary));
+	HashData(hash, &object->xLong, sizeof(object->xLong));
+	HashData(hash, &object->yLong, sizeof(object->yLong));
+	HashData(hash, &object->xVel, sizeof(object->xVel));
+	HashData(hash, &object->yVel, sizeof(object->yVel));
+	HashData(hash, &object->anim, sizeof(object->anim));
+	HashData(hash, &object->mappingFrame, sizeof(object->mappingFrame));
+	HashData(hash, &object->deleteFlag, sizeof(object->deleteFlag));
+	
+	for (LL_NODE<OBJECT*> *node = object->children.head; node != nullptr; node = node->next)
+		HashObject(hash, node->node_entry);
+}
+
+uint64_t OBJECTJOBS::Hash(LINKEDLIST<OBJECT*> *objectList)
+{
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (LL_NODE<OBJECT*> *node = objectList->head; node != nullptr; node = node->next)
+		HashObject(&hash, node->node_entry);
+	HashData(&hash, &gEngine->score, sizeof(gEngine->score));
+	HashData(&hash, &gEngine->rings, sizeof(gEngine->rings));
+	return hash;
+}
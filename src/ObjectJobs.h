@@ -0,0 +1,124 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "LinkedList.h"
+#include "Audio.h"
+
+//Declare the object and engine classes
+class OBJECT;
+class ENGINE;
+
+//Constants
+#define OBJECTJOBS_MAX_THREADS		16
+#define OBJECTJOBS_PLAYER_MARGIN	2	//Grid cells around each player where objects are always updated serially
+#define OBJECTJOBS_ISLAND_SHIFT		2	//Grid columns per island (1 << shift)
+
+//To check parallel updates are identical to serial ones, write a state hash log of a serial and a parallel run and compare them:
+//CuckySonic -headless 0 3000 -bot -jobs 0 -statehash serial.csh, CuckySonic -headless 0 3000 -bot -jobs 4 -statehash parallel.csh, then bisectstate serial.csh parallel.csh
+
+//Object command buffer, global state changes made by objects updated on a worker thread are recorded and replayed in object list order
+enum OBJECTCOMMAND_TYPE
+{
+	OBJECTCOMMAND_ADDTOSCORE,
+	OBJECTCOMMAND_ADDTORINGS,
+	OBJECTCOMMAND_ADDTOLIVES,
+	OBJECTCOMMAND_PLAYSOUND,
+	OBJECTCOMMAND_STOPSOUND,
+	OBJECTCOMMAND_STOPCHANNEL,
+	OBJECTCOMMAND_LINKOBJECT,
+	OBJECTCOMMAND_LINKOBJECTLOAD,
+	OBJECTCOMMAND_RELEASEOBJECTLOAD,
+};
+
+struct OBJECTCOMMAND
+{
+	OBJECTCOMMAND_TYPE type;
+	union
+	{
+		unsigned int value;
+		SOUNDID sound;
+		SOUNDCHANNEL_TYPE channel;
+		OBJECT *object;
+	};
+};
+
+class OBJECTCOMMANDBUFFER
+{
+	public:
+		OBJECTCOMMAND *command = nullptr;
+		size_t commands = 0;
+		size_t capacity = 0;
+	
+	public:
+		~OBJECTCOMMANDBUFFER();
+		
+		OBJECTCOMMAND *Push(OBJECTCOMMAND_TYPE type);
+		void Replay(size_t from, size_t to);
+};
+
+//Command buffer of the object being updated on this thread, nullptr if global state should be changed directly
+extern thread_local OBJECTCOMMANDBUFFER *gObjectCommands;
+
+//Object job, an object being updated on a worker thread
+struct OBJECTJOB
+{
+	OBJECT *object;
+	OBJECTCOMMANDBUFFER *buffer;
+	size_t commandStart, commandEnd;
+	bool failed;
+};
+
+//Object job system, updates objects away from players (which can't interact with anything but themselves) in parallel
+class OBJECTJOBS
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Worker threads (the main thread also takes part as the last buffer)
+		size_t threads = 0;
+		std::thread *thread = nullptr;
+		OBJECTCOMMANDBUFFER buffer[OBJECTJOBS_MAX_THREADS + 1];
+		
+		std::mutex mutex;
+		std::condition_variable startCondition, endCondition;
+		uint32_t generation = 0;
+		size_t working = 0;
+		bool quit = false;
+		
+		ENGINE *engine = nullptr;	//Engine context of the level being updated, bound to our workers while they update its objects
+		
+		//This frame's jobs, grouped into islands (runs of jobs in the same grid columns)
+		OBJECTJOB *job = nullptr;
+		size_t jobs = 0, jobCapacity = 0;
+		
+		size_t *island = nullptr;	//Index of the first job of each island, plus the end
+		size_t islands = 0, islandCapacity = 0;
+		std::atomic<size_t> nextIsland;
+		
+		//Grid cells near players
+		uint8_t *hot = nullptr;
+		size_t hotSize = 0;
+	
+	public:
+		OBJECTJOBS(size_t workerThreads);
+		~OBJECTJOBS();
+		
+		bool Run(LINKEDLIST<OBJECT*> *objectList);
+		bool Finish(OBJECT *object);
+		
+		static uint64_t Hash(LINKEDLIST<OBJECT*> *objectList);
+	
+	private:
+		void Worker(size_t index);
+		void WorkIslands(size_t index);
+};
+
+//Amount of worker threads to use for object updates, 0 updates all objects serially
+//Set by the CUCKYSONIC_OBJECT_JOBS environment variable, or -jobs in headless mode (which overrides it)
+extern unsigned int gObjectJobThreads;
@@ -4,7 +4,6 @@
 void ObjPathSwitcher(OBJECT *object);
 void ObjRing(OBJECT *object);
 void ObjRingSpawner(OBJECT *object);
-void ObjBouncingRing(OBJECT *object);
 void ObjBouncingRing_Spawner(OBJECT *object);
 void ObjAttractRing(OBJECT *object);
 void ObjMonitor(OBJECT *object);
@@ -32,3 +31,20 @@ void ObjGHZSpikeLog(OBJECT *object);
 void ObjGHZPurpleRock(OBJECT *object);
 
 void ObjMinecart(OBJECT *object);
+
+//Objects created by other objects and players
+void ObjMonitorContents(OBJECT *object);
+void ObjAnimal(OBJECT *object);
+void ObjScore(OBJECT *object);
+void ObjBridgeSegment(OBJECT *object);
+void ObjBuzzBomberMissile(OBJECT *object);
+void ObjCrabmeatProjectile(OBJECT *object);
+void ObjNewtronMissile(OBJECT *object);
+void ObjGHZSpikeLog_Segment(OBJECT *object);
+void ObjGHZLedge_Fragment(OBJECT *object);
+void ObjGHZWallFragment(OBJECT *object);
+
+void ObjSpindashDust(OBJECT *object);
+void ObjSkidDust(OBJECT *object);
+void ObjBarrier(OBJECT *object);
+void ObjInvincibilityStars(OBJECT *object);
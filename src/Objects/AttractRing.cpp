@@ -18,8 +18,8 @@ void ObjAttractRing(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Ring.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Ring.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -38,10 +38,9 @@ void ObjAttractRing(OBJECT *object)
 			//If player lost the lightning barrier, turn into a bouncing ring
 			if (object->parentPlayer->barrier != BARRIER_LIGHTNING)
 			{
-				object->function = ObjBouncingRing;
-				object->routine = 0;
-				object->xRadius = 8;
-				object->yRadius = 8;
+				gEngine->level->ringManager->AddBouncingRing(object->x.pos, object->y.pos, object->xVel, object->yVel, object->parentPlayer);
+				object->deleteFlag = true;
+				break;
 			}
 			
 			//Horizontal pull
@@ -81,7 +80,7 @@ void ObjAttractRing(OBJECT *object)
 			//Move and draw to the screen
 			object->Move();
 			
-			object->mappingFrame = (gLevel->frameCounter >> 3) & 0x3;
+			object->mappingFrame = (gEngine->level->frameCounter >> 3) & 0x3;
 			object->DrawInstance(object->renderFlags, object->texture, object->mapping, object->highPriority, object->priority, object->mappingFrame, object->x.pos, object->y.pos);
 			break;
 		}
@@ -2,168 +2,10 @@
 #include "../Audio.h"
 #include "../MathUtil.h"
 
-//#define BOUNCINGRING_BLINK              //When set, the rings will blink shortly before despawning
-//#define BOUNCINGRING_ONLY_FLOOR	      //When set, like in the originals, bouncing rings will only check for floor collision
-
-#define BOUNCINGRING_COLLISIONSTEP 0x0 //0x0 - check every frame, 0x3 - Sonic 1 checking every 4 frames, 0x7 - Sonic 2 checking every 8 frames
-
-static const uint8_t animationCollect[] =	{0x05,0x04,0x05,0x06,0x07,ANICOMMAND_ADVANCE_ROUTINE};
-
-static const uint8_t *animationList[] = {
-	animationCollect,
-};
-
-void ObjBouncingRing(OBJECT *object)
-{
-	//Define and allocate our scratch
-	struct SCRATCH
-	{
-		uint8_t animCount = 255;
-		uint16_t animAccum = 0;
-	};
-	
-	SCRATCH *scratch = object->Scratch<SCRATCH>();
-	
-	switch (object->routine)
-	{
-		case 0:
-		{
-			//Initialize collision
-			object->xRadius = 8;
-			object->yRadius = 8;
-			
-			//Initialize render properties and load graphics
-			object->widthPixels = 8;
-			object->heightPixels = 8;
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Ring.map");
-			object->renderFlags.alignPlane = true;
-			object->priority = 3;
-			
-			//Initialize collision with Sonic and other properties
-			object->collisionType = COLLISIONTYPE_OTHER;
-			object->touchWidth = 6;
-			object->touchHeight = 6;
-			
-			object->routine++;
-		}
-	//Fallthrough
-		case 1:
-		{
-			//Move and fall
-			object->xLong += object->xVel * 0x100;
-			if (object->parentPlayer != nullptr && object->parentPlayer->status.reverseGravity)
-				object->yLong -= object->yVel * 0x100;
-			else
-				object->yLong += object->yVel * 0x100;
-			object->yVel += 0x18;
-			
-			if (((gLevel->frameCounter + gLevel->objectList.pos_of_val(object)) & BOUNCINGRING_COLLISIONSTEP) == 0)
-			{
-				//Check for collision with the floor or ceiling
-				int16_t checkVel = object->yVel;
-				if (object->parentPlayer != nullptr && object->parentPlayer->status.reverseGravity)
-					checkVel = -checkVel;
-				
-				if (checkVel >= 0)
-				{
-					int16_t distance = GetCollisionV(object->x.pos, object->y.pos + object->yRadius, COLLISIONLAYER_NORMAL_TOP, false, nullptr);
-					
-					//If touching the floor, bounce off
-					if (distance < 0)
-					{
-						object->y.pos += distance;
-						object->yVel = object->yVel * 3 / -4;
-					}
-				}
-			#ifndef BOUNCINGRING_ONLY_FLOOR
-				else
-				{
-					int16_t distance = GetCollisionV(object->x.pos, object->y.pos - object->yRadius, COLLISIONLAYER_NORMAL_LRB, true, nullptr);
-					
-					//If touching a ceiling, bounce off
-					if (distance < 0)
-					{
-						object->y.pos -= distance;
-						object->yVel = -object->yVel;
-					}
-				}
-				
-				//Check for collision with walls
-				if (object->xVel > 0)
-				{
-					int16_t distance = GetCollisionH(object->x.pos + object->xRadius, object->y.pos, COLLISIONLAYER_NORMAL_LRB, false, nullptr);
-					
-					//If touching a wall, bounce off
-					if (distance < 0)
-					{
-						object->x.pos += distance;
-						object->xVel = object->xVel / -2;
-					}
-				}
-				else if (object->xVel < 0)
-				{
-					int16_t distance = GetCollisionH(object->x.pos - object->xRadius, object->y.pos, COLLISIONLAYER_NORMAL_LRB, true, nullptr);
-					
-					//If touching a wall, bounce off
-					if (distance < 0)
-					{
-						object->x.pos -= distance;
-						object->xVel = object->xVel / -2;
-					}
-				}
-			#endif
-			}
-			
-			//Animate
-			if (scratch->animCount != 0)
-			{
-				scratch->animAccum += scratch->animCount--;
-				object->mappingFrame = (scratch->animAccum >> 9) & 0x3;
-			}
-			
-			//Check for deletion
-			if (scratch->animCount == 0)
-				object->deleteFlag = true;
-			else
-			
-		#ifdef BOUNCINGRING_BLINK
-			if (scratch->animCount > 60 || gLevel->frameCounter & (scratch->animCount > 30 ? 0x4 : 0x2))
-		#endif
-				object->DrawInstance(object->renderFlags, object->texture, object->mapping, object->highPriority, object->priority, object->mappingFrame, object->x.pos, object->y.pos);
-			break;
-		}
-		case 2: //Touched player, collect a ring
-		{
-			//Increment routine
-			object->routine++;
-			
-			//Clear collision and change priority
-			object->collisionType = COLLISIONTYPE_NULL;
-			object->priority = 1;
-			
-			//Collect the ring
-			AddToRings(1);
-		}
-	//Fallthrough
-		case 3: //Sparkling
-		{
-			object->Animate(animationList);
-			object->DrawInstance(object->renderFlags, object->texture, object->mapping, object->highPriority, object->priority, object->mappingFrame, object->x.pos, object->y.pos);
-			break;
-		}
-		case 4: //Deleting after sparkle
-		{
-			object->deleteFlag = true;
-			break;
-		}
-	}
-}
-
 void ObjBouncingRing_Spawner(OBJECT *object)
 {
 	//Cap our rings
-	unsigned int *rings = &gRings;
+	unsigned int *rings = &gEngine->rings;
 	if (*rings >= 32)
 		*rings = 32;
 	
@@ -190,13 +32,6 @@ void ObjBouncingRing_Spawner(OBJECT *object)
 	int16_t xVel = 0, yVel = 0;
 	for (unsigned int i = 0; i < *rings; i++)
 	{
-		//Create the ring object
-		OBJECT *ring = new OBJECT(&ObjBouncingRing);
-		ring->parentPlayer = object->parentPlayer;
-		ring->x.pos = object->x.pos;
-		ring->y.pos = object->y.pos;
-		gLevel->objectList.link_back(ring);
-		
 		//Get the ring's velocity
 		if (angleSpeed >= 0)
 		{
@@ -215,9 +50,8 @@ void ObjBouncingRing_Spawner(OBJECT *object)
 			}
 		}
 		
-		//Set the ring's velocity
-		ring->xVel = xVel;
-		ring->yVel = yVel;
+		//Create the bouncing ring
+		gEngine->level->ringManager->AddBouncingRing(object->x.pos, object->y.pos, xVel, yVel, object->parentPlayer);
 		
 		xVel = -xVel;
 		angleSpeed = -angleSpeed;
@@ -15,15 +15,15 @@ void ObjBridgeSegment(OBJECT *object)
 		object->priority = 3;
 		
 		//Load graphics
-		switch (gLevel->zone)
+		switch (gEngine->level->zone)
 		{
 			case ZONEID_GHZ:
-				object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-				object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZBridge.map");
+				object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+				object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZBridge.map");
 				break;
 			case ZONEID_EHZ:
-				object->texture = gLevel->GetObjectTexture("data/Object/EHZGeneric.bmp");
-				object->mapping.mappings = gLevel->GetObjectMappings("data/Object/EHZBridge.map");
+				object->texture = gEngine->level->GetObjectTexture("data/Object/EHZGeneric.bmp");
+				object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/EHZBridge.map");
 				break;
 		}
 	}
@@ -77,10 +77,7 @@ void ObjBridge(OBJECT *object)
 				depressForce[i] = (v += 2);
 			
 			//Is a player standing on us?
-			bool touching = false;
-			for (int i = 0; i < OBJECT_PLAYER_REFERENCES; i++)
-				if (object->playerContact[i].standing)
-					touching = true;
+			bool touching = object->playerContact.AnyStanding();
 			
 			//Handle bridge depression stuff depending on players standing on us
 			int16_t bridgeWidth = object->subtype * 8;
@@ -96,10 +93,10 @@ void ObjBridge(OBJECT *object)
 			else
 			{
 				//Check for any players standing on us and handle appropriately
-				for (size_t i = 0; i < gLevel->playerList.size(); i++)
+				for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 				{
 					//Get the player
-					PLAYER *player = gLevel->playerList[i];
+					PLAYER *player = gEngine->level->playerList[i];
 					
 					//Check if this specific player is standing on us
 					if (object->playerContact[i].standing)
@@ -144,10 +141,10 @@ void ObjBridge(OBJECT *object)
 			}
 			
 			//Act as a solid platform
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (object->playerContact[i].standing)
 				{
@@ -158,7 +155,7 @@ void ObjBridge(OBJECT *object)
 					{
 						//Leave the platform (don't set us to be inAir so walking or rolling off the bridge doesn't not work)
 						player->status.shouldNotFall = false;
-						object->playerContact[i].standing = false;
+						object->playerContact.SetStanding(i, false);
 					}
 					else
 					{
@@ -41,8 +41,8 @@ void ObjBuzzBomberMissile(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Missile.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Missile.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -92,7 +92,7 @@ void ObjBuzzBomberMissile(OBJECT *object)
 			object->DrawInstance(object->renderFlags, object->texture, object->mapping, object->highPriority, object->priority, object->mappingFrame, object->x.pos, object->y.pos);
 			
 			//Delete if below stage
-			if (object->y.pos >= gLevel->bottomBoundaryTarget)
+			if (object->y.pos >= gEngine->level->bottomBoundaryTarget)
 				object->deleteFlag = true;
 			break;
 		}
@@ -123,8 +123,8 @@ void ObjBuzzBomber(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/BuzzBomber.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/BuzzBomber.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -176,7 +176,7 @@ void ObjBuzzBomber(OBJECT *object)
 							projectile->y.pos = object->y.pos + 28;
 							projectile->status = object->status;
 							projectile->parentObject = object;
-							gLevel->objectList.link_back(projectile);
+							gEngine->level->LinkObject(projectile);
 							
 							//Update our state
 							scratch->state = STATE_FIRED;
@@ -198,9 +198,9 @@ void ObjBuzzBomber(OBJECT *object)
 						{
 							//Check all players and get the nearest absolute x-difference
 							int16_t nearestX = 0x7FFF;
-							for (size_t i = 0; i < gLevel->playerList.size(); i++)
+							for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 							{
-								int16_t xDiff = mabs(gLevel->playerList[i]->x.pos - object->x.pos);
+								int16_t xDiff = mabs(gEngine->level->playerList[i]->x.pos - object->x.pos);
 								if (xDiff < nearestX)
 									nearestX = xDiff;
 							}
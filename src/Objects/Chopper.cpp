@@ -28,8 +28,8 @@ void ObjChopper(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Chopper.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Chopper.map");
 			
 			//Initialize render properties
 			object->renderFlags.alignPlane = true;
@@ -31,8 +31,8 @@ void ObjCrabmeatProjectile(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Crabmeat.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Crabmeat.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -56,7 +56,7 @@ void ObjCrabmeatProjectile(OBJECT *object)
 			object->DrawInstance(object->renderFlags, object->texture, object->mapping, object->highPriority, object->priority, object->mappingFrame, object->x.pos, object->y.pos);
 			
 			//Delete if fell off stage
-			if (object->y.pos >= gLevel->bottomBoundaryTarget)
+			if (object->y.pos >= gEngine->level->bottomBoundaryTarget)
 				object->deleteFlag = true;
 			break;
 		}
@@ -104,8 +104,8 @@ void ObjCrabmeat(OBJECT *object)
 			object->yRadius = 16;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Crabmeat.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Crabmeat.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -168,13 +168,13 @@ void ObjCrabmeat(OBJECT *object)
 							projLeft->x.pos = object->x.pos - 16;
 							projLeft->y.pos = object->y.pos;
 							projLeft->xVel = -0x100;
-							gLevel->objectList.link_back(projLeft);
+							gEngine->level->LinkObject(projLeft);
 							
 							OBJECT *projRight = new OBJECT(&ObjCrabmeatProjectile);
 							projRight->x.pos = object->x.pos + 16;
 							projRight->y.pos = object->y.pos;
 							projRight->xVel = 0x100;
-							gLevel->objectList.link_back(projRight);
+							gEngine->level->LinkObject(projRight);
 						}
 					}
 					break;
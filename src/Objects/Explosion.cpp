@@ -39,8 +39,8 @@ void ObjScore(OBJECT *object)
 	{
 		case 0:
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Score.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Score.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -80,13 +80,13 @@ void ObjExplosion(OBJECT *object)
 			//OBJECT *newAnimal = new OBJECT(&ObjAnimal);
 			//newAnimal->x.pos = object->x.pos;
 			//newAnimal->y.pos = object->y.pos;
-			//gLevel->objectList.link_back(newAnimal);
+			//gEngine->level->objectList.link_back(newAnimal);
 			
 			OBJECT *newScore = new OBJECT(&ObjScore);
 			newScore->x.pos = object->x.pos;
 			newScore->y.pos = object->y.pos;
 			newScore->mappingFrame = object->subtype;
-			gLevel->objectList.link_back(newScore);
+			gEngine->level->LinkObject(newScore);
 		}
 	//Fallthrough
 		case 1: //Explosion without an animal
@@ -98,8 +98,8 @@ void ObjExplosion(OBJECT *object)
 			PlaySound(SOUNDID_POP);
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Explosion.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Explosion.map");
 			
 			//Initialize other properties
 			object->renderFlags.xFlip = false;
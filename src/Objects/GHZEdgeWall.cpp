@@ -68,18 +68,19 @@ void ObjGHZEdgeWall_Solid_Individual(PLAYER *player, int i, OBJECT *object, int1
 				player->xVel = 0;
 			}
 		}
+		gEngine->level->playerIndex->Move(i);
 		
 		//Clip out of wall and start pushing
 		if (!player->status.inAir)
 		{
 			//On ground, set pushing
-			object->playerContact[i].pushing = true;
+			object->playerContact.SetPushing(i, true);
 			player->status.pushing = true;
 		}
 		else
 		{
 			//In mid-air, clear pushing
-			object->playerContact[i].pushing = false;
+			object->playerContact.SetPushing(i, false);
 			player->status.pushing = false;
 		}
 	}
@@ -100,7 +101,7 @@ void ObjGHZEdgeWall_Solid_Individual(PLAYER *player, int i, OBJECT *object, int1
 		{
 			if (player->anim != PLAYERANIMATION_ROLL && player->anim != PLAYERANIMATION_DROPDASH)
 				player->anim = PLAYERANIMATION_RUN; //wrong animation again
-			object->playerContact[i].pushing = false;
+			object->playerContact.SetPushing(i, false);
 			player->status.pushing = false;
 		}
 	}
@@ -108,9 +109,9 @@ void ObjGHZEdgeWall_Solid_Individual(PLAYER *player, int i, OBJECT *object, int1
 
 void ObjGHZEdgeWall_Solid(OBJECT *object, int16_t width, int16_t height)
 {
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
+	for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 	{
-		PLAYER *player = gLevel->playerList[i];
+		PLAYER *player = gEngine->level->playerList[i];
 		ObjGHZEdgeWall_Solid_Individual(player, i, object, width, height); //Handle collision
 	}
 }
@@ -125,8 +126,8 @@ void ObjGHZEdgeWall(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZEdgeWall.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZEdgeWall.map");
 			
 			//Set other render properties
 			object->renderFlags.alignPlane = true;
@@ -77,8 +77,8 @@ void ObjGHZLedge(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZLedge.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZLedge.map");
 			
 			//Initialize render properties
 			object->renderFlags.alignPlane = true;
@@ -91,7 +91,7 @@ void ObjGHZLedge(OBJECT *object)
 		case 1:
 		{
 			//Set collapse flag if a player standing on us
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				if (object->playerContact[i].standing && scratch->flag == 0)
 				{
@@ -122,9 +122,9 @@ void ObjGHZLedge(OBJECT *object)
 				if (scratch->delay == 0)
 				{
 					//Release players standing
-					for (size_t i = 0; i < gLevel->playerList.size(); i++)
+					for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 					{
-						PLAYER *player = gLevel->playerList[i];
+						PLAYER *player = gEngine->level->playerList[i];
 					#ifndef FIX_PLAYER_RELEASE
 						if (player->status.shouldNotFall)
 					#else
@@ -139,7 +139,7 @@ void ObjGHZLedge(OBJECT *object)
 					
 					//Delete us
 					object->deleteFlag = true;
-					gLevel->ReleaseObjectLoad(object);
+					gEngine->level->ReleaseObjectLoad(object);
 					break;
 				}
 				
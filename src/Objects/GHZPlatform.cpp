@@ -33,7 +33,7 @@ void ObjGHZPlatform_Move(OBJECT *object)
 				angle -= 0x40;
 			
 			object->x.pos = (scratch->origX >> 16) + angle;
-			object->angle = (gLevel->oscillate[6][0] >> 8);
+			object->angle = (gEngine->level->oscillate[6][0] >> 8);
 			break;
 		}
 		case 0xC: //Up and down
@@ -43,16 +43,16 @@ void ObjGHZPlatform_Move(OBJECT *object)
 		{
 			int8_t angle;
 			if (type == 0xC)
-				angle = -(gLevel->oscillate[3][0] >> 8) + 0x30;
+				angle = -(gEngine->level->oscillate[3][0] >> 8) + 0x30;
 			else if (type == 0xB)
-				angle = (gLevel->oscillate[3][0] >> 8) - 0x30;
+				angle = (gEngine->level->oscillate[3][0] >> 8) - 0x30;
 			else if (type == 0x6)
 				angle = -object->angle + 0x40;
 			else
 				angle = object->angle - 0x40;
 			
 			scratch->y = (((scratch->origY >> 16) + angle) << 16) | (scratch->y & 0x0000FFFF);
-			object->angle = (gLevel->oscillate[6][0] >> 8);
+			object->angle = (gEngine->level->oscillate[6][0] >> 8);
 			break;
 		}
 		case 0x3: //Falling (stationary)
@@ -60,9 +60,9 @@ void ObjGHZPlatform_Move(OBJECT *object)
 			if (!scratch->fallTime)
 			{
 				//Wait for the player to stand on us
-				for (size_t i = 0; i < gLevel->playerList.size(); i++)
+				for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 				{
-					PLAYER *player = gLevel->playerList[i];
+					PLAYER *player = gEngine->level->playerList[i];
 					if (player->status.shouldNotFall && player->interact == (void*)object)
 						scratch->fallTime = 30; //Wait for 0.5 seconds
 				}
@@ -84,17 +84,17 @@ void ObjGHZPlatform_Move(OBJECT *object)
 			if (scratch->fallTime != 0 && --scratch->fallTime == 0)
 			{
 				//Make players standing on us fall off
-				for (size_t i = 0; i < gLevel->playerList.size(); i++)
+				for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 				{
 					//Get the player
-					PLAYER *player = gLevel->playerList[i];
+					PLAYER *player = gEngine->level->playerList[i];
 					
 					if (player->status.shouldNotFall && player->interact == (void*)object)
 					{
 						//Make player airborne
 						player->status.inAir = true;
 						player->status.shouldNotFall = false;
-						object->playerContact[i].standing = false;
+						object->playerContact.SetStanding(i, false);
 						player->yVel = object->yVel;
 					}
 				}
@@ -108,7 +108,7 @@ void ObjGHZPlatform_Move(OBJECT *object)
 			object->yVel += 0x38;
 			
 			//Delete if reached bottom boundary
-			if ((scratch->y >> 16) >= gLevel->bottomBoundaryTarget)
+			if ((scratch->y >> 16) >= gEngine->level->bottomBoundaryTarget)
 				object->deleteFlag = true;
 			break;
 		}
@@ -116,7 +116,7 @@ void ObjGHZPlatform_Move(OBJECT *object)
 		{
 			//Move up and down
 			scratch->y = (((scratch->origY >> 16) + (object->angle - 0x40) / 2) << 16) | (scratch->y & 0x0000FFFF);
-			object->angle = (gLevel->oscillate[6][0] >> 8);
+			object->angle = (gEngine->level->oscillate[6][0] >> 8);
 			break;
 		}
 	}
@@ -137,8 +137,8 @@ void ObjGHZPlatform(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZPlatform.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZPlatform.map");
 			
 			//Initialize render properties
 			object->renderFlags.alignPlane = true;
@@ -159,10 +159,7 @@ void ObjGHZPlatform(OBJECT *object)
 		case 1:
 		{
 			//Is a player standing on us?
-			bool touching = false;
-			for (int i = 0; i < OBJECT_PLAYER_REFERENCES; i++)
-				if (object->playerContact[i].standing)
-					touching = true;
+			bool touching = object->playerContact.AnyStanding();
 			
 			//Decrease / increase our weight
 			if (touching)
@@ -10,8 +10,8 @@ void ObjGHZPurpleRock(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZPurpleRock.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZPurpleRock.map");
 			
 			//Set render properties
 			object->renderFlags.alignPlane = true;
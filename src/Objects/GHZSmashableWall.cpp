@@ -47,8 +47,8 @@ void ObjGHZSmashableWall(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZSmashableWall.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZSmashableWall.map");
 			
 			//Initialize other render properties
 			object->renderFlags.alignPlane = true;
@@ -60,10 +60,10 @@ void ObjGHZSmashableWall(OBJECT *object)
 	//Fallthrough
 		case 1:
 		{
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get our player
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 			
 				//Act as solid, and check if we're going into the wall
 				int16_t oldXVel = player->xVel;
@@ -89,18 +89,19 @@ void ObjGHZSmashableWall(OBJECT *object)
 							player->x.pos -= 8;
 							smashmap = smashmapLeft;
 						}
+						gEngine->level->playerIndex->Move(i);
 						
 						//Smash
 						player->xVel = oldXVel;
 						player->inertia = player->xVel;
 						player->status.pushing = false;
 						
-						object->playerContact[i].pushing = false;
+						object->playerContact.SetPushing(i, false);
 						object->Smash(8, smashmap, &ObjGHZWallFragment);
 						
 						//Delete us
 						object->deleteFlag = true;
-						gLevel->ReleaseObjectLoad(object);
+						gEngine->level->ReleaseObjectLoad(object);
 						break;
 					}
 				}
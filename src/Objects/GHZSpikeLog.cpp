@@ -10,8 +10,8 @@ void ObjGHZSpikeLog_Segment(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZSpikeLog.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZSpikeLog.map");
 			
 			//Initialize render properties
 			object->renderFlags.alignPlane = true;
@@ -23,7 +23,7 @@ void ObjGHZSpikeLog_Segment(OBJECT *object)
 		case 1:
 		{
 			//Rotate and check if we should hurt
-			if ((object->mappingFrame = ((gLevel->frameCounter / -12) + object->subtype) & 0x7) == 0)
+			if ((object->mappingFrame = ((gEngine->level->frameCounter / -12) + object->subtype) & 0x7) == 0)
 			{
 				object->collisionType = COLLISIONTYPE_HURT;
 				object->touchWidth = 4;
@@ -48,8 +48,8 @@ void ObjGHZSpikes(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZSpikes.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZSpikes.map");
 			
 			//Initialize render properties
 			object->renderFlags.alignPlane = true;
@@ -85,10 +85,10 @@ void ObjGHZSpikes(OBJECT *object)
 					object->SolidObjectFull(27, height, height + 1, object->x.pos, false, nullptr, false);
 					
 					//Check for players touching us and getting hurt
-					for (size_t i = 0; i < gLevel->playerList.size(); i++)
+					for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 					{
 						if (object->playerContact[i].standing == false && object->playerContact[i].pushing == true)
-							ObjGHZSpikes_Hurt(object, gLevel->playerList[i]);
+							ObjGHZSpikes_Hurt(object, gEngine->level->playerList[i]);
 					}
 					break;
 				}
@@ -99,10 +99,10 @@ void ObjGHZSpikes(OBJECT *object)
 					object->SolidObjectFull(object->widthPixels + 11, 16, 17, object->x.pos, false, nullptr, false);
 					
 					//Check for players touching us and getting hurt
-					for (size_t i = 0; i < gLevel->playerList.size(); i++)
+					for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 					{
 						if (object->playerContact[i].standing == true)
-							ObjGHZSpikes_Hurt(object, gLevel->playerList[i]);
+							ObjGHZSpikes_Hurt(object, gEngine->level->playerList[i]);
 					}
 					break;
 				}
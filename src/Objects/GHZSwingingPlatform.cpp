@@ -28,7 +28,7 @@ void ObjGHZSwingingPlatform_Move_Individual(OBJECT *parent, OBJECT *child, int16
 void ObjGHZSwingingPlatform_Move(OBJECT *object)
 {
 	//Get our swing angle
-	int8_t oscillate = gLevel->oscillate[6][0] >> 8;
+	int8_t oscillate = gEngine->level->oscillate[6][0] >> 8;
 	if (object->status.xFlip)
 		oscillate = (-oscillate) - 0x80;
 	
@@ -52,8 +52,8 @@ void ObjGHZSwingingPlatform(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZSwingingPlatform.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZSwingingPlatform.map");
 			
 			//Initialize render properties
 			object->renderFlags.alignPlane = true;
@@ -76,8 +76,8 @@ void ObjGHZSwingingPlatform(OBJECT *object)
 			{
 				//Create a segment
 				OBJECT *newSegment = new OBJECT(&ObjGHZSwingingPlatform);
-				newSegment->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-				newSegment->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZSwingingPlatform.map");
+				newSegment->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+				newSegment->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZSwingingPlatform.map");
 				newSegment->renderFlags.alignPlane = true;
 				newSegment->widthPixels = 8;
 				newSegment->heightPixels = 32;
@@ -4,7 +4,7 @@
 void ObjGHZWaterfallSound(OBJECT *object)
 {
 	//Play waterfall sound while on-screen every 64 frames
-	if ((gLevel->frameCounter & 0x3F) == 0)
+	if ((gEngine->level->frameCounter & 0x3F) == 0)
 		PlaySound(SOUNDID_WATERFALL);
 	object->UnloadOffscreen(object->x.pos);
 }
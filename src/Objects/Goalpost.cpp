@@ -44,8 +44,8 @@ void ObjGoalpost(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Goalpost.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Goalpost.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -57,18 +57,18 @@ void ObjGoalpost(OBJECT *object)
 		case 1: //Check for contact
 		{
 			//If near the end of the level, lock screen
-			int16_t boundary = gLevel->rightBoundaryTarget - gRenderSpec.width - 0x100;
-			if (gLevel->camera->xPos >= boundary)
-				gLevel->leftBoundaryTarget = boundary;
+			int16_t boundary = gEngine->level->rightBoundaryTarget - gEngine->renderSpec.width - 0x100;
+			if (gEngine->level->camera->xPos >= boundary)
+				gEngine->level->leftBoundaryTarget = boundary;
 			
 			//If the main player is near us, start spinning
-			PLAYER *player = gLevel->playerList[0];
+			PLAYER *player = gEngine->level->playerList[0];
 			
 			if (player->x.pos >= object->x.pos && player->x.pos < (object->x.pos + 32))
 			{
 				//Lock the camera, timer, and increment routine
-				gLevel->leftBoundaryTarget = gLevel->rightBoundaryTarget - gRenderSpec.width;
-				gLevel->updateTime = false;
+				gEngine->level->leftBoundaryTarget = gEngine->level->rightBoundaryTarget - gEngine->renderSpec.width;
+				gEngine->level->updateTime = false;
 				
 				//Play sound and increment routine
 				PlaySound(SOUNDID_GOALPOST_SPIN);
@@ -102,16 +102,16 @@ void ObjGoalpost(OBJECT *object)
 				sparkle->anim = 1;
 				sparkle->x.pos = object->x.pos + goalpostSparklePos[scratch->sparkle][0];
 				sparkle->y.pos = object->y.pos + goalpostSparklePos[scratch->sparkle][1];
-				gLevel->objectList.link_back(sparkle);
+				gEngine->level->LinkObject(sparkle);
 			}
 			break;
 		}
 		case 3: //Make players run to the right of the screen
 		{
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				if (player->debug)
 					continue;
 				
@@ -124,7 +124,7 @@ void ObjGoalpost(OBJECT *object)
 				}
 				
 				//If the main player, and near the right of the screen, increment routine
-				if (i == 0 && player->x.pos >= gLevel->rightBoundaryTarget)
+				if (i == 0 && player->x.pos >= gEngine->level->rightBoundaryTarget)
 					object->routine++;
 			}
 			break;
@@ -132,9 +132,9 @@ void ObjGoalpost(OBJECT *object)
 		case 4: //End of level
 		{
 			//TEMP: Load next level
-			gLevel->SetFade(false, false);
-			gGameLoadLevel++;
-			gGameLoadLevel %= LEVELID_MAX;
+			gEngine->level->SetFade(false, false);
+			gEngine->loadLevel++;
+			gEngine->loadLevel %= LEVELID_MAX;
 			break;
 		}
 	}
@@ -16,8 +16,8 @@ void ObjMinecart(OBJECT *object)
 		case 0:
 		{
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Minecart.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Minecart.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Minecart.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Minecart.map");
 			
 			//Initialize other properties
 			object->routine++;
@@ -89,7 +89,7 @@ void ObjMinecart(OBJECT *object)
 					
 					//Set our mapping frame
 					object->mappingFrame = (scratch->roll / 0xA00) % 2;
-					if (abs(object->xVel) > 0x200 && gLevel->frameCounter & 0x1)
+					if (abs(object->xVel) > 0x200 && gEngine->level->frameCounter & 0x1)
 						object->mappingFrame += 2;
 				}
 			}
@@ -159,10 +159,10 @@ void ObjMinecart(OBJECT *object)
 			//Act as a solid and be pushed
 			OBJECT_SOLIDTOUCH solid = object->SolidObjectFull(object->xRadius + 8, 16, 6, lastX, true, nullptr, false);
 			
-			for (size_t v = 0; v < gLevel->playerList.size(); v++)
+			for (size_t v = 0; v < gEngine->level->playerList.size(); v++)
 			{
 				//Get the player
-				PLAYER *player = gLevel->playerList[v];
+				PLAYER *player = gEngine->level->playerList[v];
 				
 				//Push velocity stuff
 				if (solid.side[v] && player->forceRollOrSpindash == false)
@@ -237,6 +237,9 @@ void ObjMinecart(OBJECT *object)
 							object->inertia = 0x100;
 						}
 					}
+					
+					//Update our position in the player index
+					gEngine->level->playerIndex->Move(v);
 				}
 				
 				//Friction when standing on minecart
@@ -261,10 +264,10 @@ void ObjMinecart(OBJECT *object)
 			object->routineSecondary = 60;
 			object->mappingFrame = 4;
 			
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (object->playerContact[i].standing)
 				{
@@ -290,6 +293,6 @@ void ObjMinecart(OBJECT *object)
 	}
 	
 	//If below the stage, delete us
-	if (object->y.pos >= gLevel->bottomBoundaryTarget + 48)
+	if (object->y.pos >= gEngine->level->bottomBoundaryTarget + 48)
 		object->deleteFlag = true;
 }
@@ -25,7 +25,7 @@ void ObjMonitor_ChkOverEdge(OBJECT *object, int i, PLAYER *player)
 		//Leave the top of the monitor
 		player->status.shouldNotFall = false;
 		player->status.inAir = true;
-		object->playerContact[i].standing = false;
+		object->playerContact.SetStanding(i, false);
 	}
 }
 
@@ -41,7 +41,7 @@ void ObjMonitor_SolidObject_Lead(OBJECT *object, int i, PLAYER *player)
 	{
 		//Clear pushing
 		player->status.pushing = false;
-		object->playerContact[i].pushing = false;
+		object->playerContact.SetPushing(i, false);
 	}
 #endif
 }
@@ -58,12 +58,12 @@ void ObjMonitor_SolidObject_Follower(OBJECT *object, int i, PLAYER *player)
 void ObjMonitor_SolidObject(OBJECT *object)
 {
 	//Check for contact with all players (followers cannot break monitors)
-	for (size_t i = 0; i < gLevel->playerList.size(); i++)
+	for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 	{
 		if (i == 0)
-			ObjMonitor_SolidObject_Lead(object, i, gLevel->playerList[i]);
+			ObjMonitor_SolidObject_Lead(object, i, gEngine->level->playerList[i]);
 		else
-			ObjMonitor_SolidObject_Follower(object, i, gLevel->playerList[i]);
+			ObjMonitor_SolidObject_Follower(object, i, gEngine->level->playerList[i]);
 	}
 }
 
@@ -119,8 +119,8 @@ void ObjMonitorContents(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/MonitorContents.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/MonitorContents.map");
 			
 			//Set render properties and velocity
 			object->renderFlags.alignPlane = true;
@@ -214,8 +214,8 @@ void ObjMonitor(OBJECT *object)
 			object->yRadius = 14;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Monitor.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Monitor.map");
 			
 			//Set render properties
 			object->renderFlags.alignPlane = true;
@@ -224,7 +224,7 @@ void ObjMonitor(OBJECT *object)
 			object->heightPixels = 14;
 			
 			//Set our animation / state
-			if (gLevel->GetObjectLoad(object)->specificBit)
+			if (gEngine->level->GetObjectLoad(object)->specificBit)
 			{
 				//Broken
 				object->routine = 3;
@@ -239,7 +239,7 @@ void ObjMonitor(OBJECT *object)
 				object->touchHeight = 16;
 				
 				//Use subtype animation
-				object->anim = zoneItemByZone[gLevel->zone][object->subtype];
+				object->anim = zoneItemByZone[gEngine->level->zone][object->subtype];
 			}
 		}
 	//Fallthrough
@@ -283,17 +283,17 @@ void ObjMonitor(OBJECT *object)
 			content->y.pos = object->y.pos;
 			content->anim = object->anim;
 			content->parentObject = object;
-			gLevel->objectList.link_back(content);
+			gEngine->level->LinkObject(content);
 			
 			//Create the explosion
 			OBJECT *explosion = new OBJECT(&ObjExplosion);
 			explosion->x.pos = object->x.pos;
 			explosion->y.pos = object->y.pos;
 			explosion->routine++; //Don't create animal or score
-			gLevel->objectList.link_back(explosion);
+			gEngine->level->LinkObject(explosion);
 			
 			//Set to broken animation and draw
-			gLevel->GetObjectLoad(object)->specificBit = true;
+			gEngine->level->GetObjectLoad(object)->specificBit = true;
 			object->anim = MONITOR_ITEM_BROKEN;
 			object->DrawInstance(object->renderFlags, object->texture, object->mapping, object->highPriority, object->priority, object->mappingFrame, object->x.pos, object->y.pos);
 			break;
@@ -24,8 +24,8 @@ void ObjMotobug(OBJECT *object)
 	if (object->routine == 0)
 	{
 		//Load graphics
-		object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-		object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Motobug.map");
+		object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+		object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Motobug.map");
 		
 		//Initialize other properties
 		object->routine++;
@@ -116,7 +116,7 @@ void ObjMotobug(OBJECT *object)
 						newSmoke->y.pos = object->y.pos;
 						newSmoke->status = object->status;
 						newSmoke->anim = 2;
-						gLevel->objectList.link_back(newSmoke);
+						gEngine->level->LinkObject(newSmoke);
 					}
 					break;
 				}
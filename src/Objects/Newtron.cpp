@@ -34,8 +34,8 @@ void ObjNewtronMissile(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/Missile.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/Missile.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -87,11 +87,11 @@ void ObjNewtron(OBJECT *object)
 			object->routine++;
 			
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Sonic1Badnik.bmp");
 			if (object->subtype == 0)
-				object->mapping.mappings = gLevel->GetObjectMappings("data/Object/NewtronBlue.map");
+				object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/NewtronBlue.map");
 			else
-				object->mapping.mappings = gLevel->GetObjectMappings("data/Object/NewtronGreen.map");
+				object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/NewtronGreen.map");
 			
 			//Initialize other properties
 			object->renderFlags.alignPlane = true;
@@ -107,9 +107,9 @@ void ObjNewtron(OBJECT *object)
 		{
 			//Check all players and get the nearest x-difference (non-absolute)
 			int16_t nearestX = 0x7FFF;
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
-				int16_t xDiff = gLevel->playerList[i]->x.pos - object->x.pos;
+				int16_t xDiff = gEngine->level->playerList[i]->x.pos - object->x.pos;
 				if (mabs(xDiff) < mabs(nearestX))
 					nearestX = xDiff;
 			}
@@ -244,7 +244,7 @@ void ObjNewtron(OBJECT *object)
 						projectile->x.pos = object->x.pos + xOff;
 						projectile->y.pos = object->y.pos - 8;
 						projectile->status = object->status;
-						gLevel->objectList.link_back(projectile);
+						gEngine->level->LinkObject(projectile);
 					}
 					break;
 				}
@@ -260,7 +260,7 @@ void ObjNewtron(OBJECT *object)
 		{
 			//Green - deleted after firing missile
 			object->deleteFlag = true;
-			gLevel->ReleaseObjectLoad(object);
+			gEngine->level->ReleaseObjectLoad(object);
 			break;
 		}
 	}
@@ -21,23 +21,23 @@ void ObjPathSwitcher(OBJECT *object)
 			object->routine++;
 			
 			//Check each player to see if they're to the right / below us
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				if (object->subtype & MASK_VERTICAL)
-					object->playerContact[i].objectSpecific = player->y.pos >= object->y.pos;
+					object->playerContact.SetObjectSpecific(i, player->y.pos >= object->y.pos);
 				else
-					object->playerContact[i].objectSpecific = player->x.pos >= object->x.pos;
+					object->playerContact.SetObjectSpecific(i, player->x.pos >= object->x.pos);
 			}
 		}
 //Fallthrough
 		case 1:
 		{
 			//Check each player to see if they're to the right / below us and change their priority and path
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				//Don't check if in debug mode
 				if (player->debug)
@@ -64,7 +64,7 @@ void ObjPathSwitcher(OBJECT *object)
 				if (newSide != object->playerContact[i].objectSpecific)
 				{
 					//Set our side, path, and priority
-					object->playerContact[i].objectSpecific = newSide;
+					object->playerContact.SetObjectSpecific(i, newSide);
 					
 					//Check if we're grounded (ground-only?)
 					if ((object->subtype & MASK_GROUND_ONLY) == 0 || !player->status.inAir)
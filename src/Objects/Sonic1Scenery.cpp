@@ -15,8 +15,8 @@ void ObjSonic1Scenery(OBJECT *object)
 				case 3:
 					//Load graphics
 					object->mappingFrame = 1;
-					object->texture = gLevel->GetObjectTexture("data/Object/GHZGeneric.bmp");
-					object->mapping.mappings = gLevel->GetObjectMappings("data/Object/GHZBridge.map");
+					object->texture = gEngine->level->GetObjectTexture("data/Object/GHZGeneric.bmp");
+					object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/GHZBridge.map");
 					object->widthPixels = 16;
 					object->heightPixels = 32;
 					object->priority = 1;
@@ -95,10 +95,10 @@ void ObjSpiral(OBJECT *object) //Also MTZ cylinder
 	{
 		case 1: //EHZ Spiral
 		{
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (object->playerContact[i].standing == false) //Not already on the spiral
 				{
@@ -177,7 +177,7 @@ void ObjSpiral(OBJECT *object) //Also MTZ cylinder
 					
 					//Fall off
 					player->status.shouldNotFall = false;
-					object->playerContact[i].standing = false;
+					object->playerContact.SetStanding(i, false);
 					player->flipsRemaining = false;
 					player->flipSpeed = 4;
 				}
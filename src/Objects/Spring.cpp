@@ -71,11 +71,11 @@ void ObjSpring(OBJECT *object)
 		case 0:
 		{
 			//Load graphics
-			object->texture = gLevel->GetObjectTexture("data/Object/Generic.bmp");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/Generic.bmp");
 			if (object->subtype & MASK_IS_YELLOW)
-				object->mapping.mappings = gLevel->GetObjectMappings("data/Object/YellowSpring.map");
+				object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/YellowSpring.map");
 			else
-				object->mapping.mappings = gLevel->GetObjectMappings("data/Object/RedSpring.map");
+				object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/RedSpring.map");
 			
 			//Set render properties
 			object->renderFlags.alignPlane = true;
@@ -115,10 +115,10 @@ void ObjSpring(OBJECT *object)
 			//Act as solid
 			object->SolidObjectFull(27, 8, 16, object->x.pos, true, nullptr, false);
 			
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player and check if we touched the spring
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (object->playerContact[i].standing)
 				{
@@ -187,10 +187,10 @@ void ObjSpring(OBJECT *object)
 			//Act as solid
 			OBJECT_SOLIDTOUCH touch = object->SolidObjectFull(19, 14, 15, object->x.pos, true, nullptr, false);
 			
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player and check if we touched the spring
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (touch.side[i])
 				{
@@ -216,6 +216,7 @@ void ObjSpring(OBJECT *object)
 						player->xVel = -force;
 						player->status.xFlip = false;
 					}
+					gEngine->level->playerIndex->Move(i);
 					
 					//Handle ground movement and animation
 					player->moveLock = 15;
@@ -269,10 +270,10 @@ void ObjSpring(OBJECT *object)
 			//Act as solid
 			OBJECT_SOLIDTOUCH touch = object->SolidObjectFull(27, 8, 9, object->x.pos, true, nullptr, false);
 			
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player and check if we touched the spring
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (touch.bottom[i])
 				{
@@ -337,10 +338,10 @@ void ObjSpring(OBJECT *object)
 			//Act as solid
 			object->SolidObjectFull(27, 16, 16, object->x.pos, true, upDiagonalSlope, false);
 			
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player and check if we touched the spring
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (object->playerContact[i].standing)
 				{
@@ -376,6 +377,7 @@ void ObjSpring(OBJECT *object)
 						player->x.pos -= 6;
 						player->xVel = -force;
 					}
+					gEngine->level->playerIndex->Move(i);
 					
 					//Make us airborne
 					player->status.inAir = true;
@@ -426,10 +428,10 @@ void ObjSpring(OBJECT *object)
 			//Act as solid
 			OBJECT_SOLIDTOUCH touch = object->SolidObjectFull(27, 16, 16, object->x.pos, true, downDiagonalSlope, false);
 			
-			for (size_t i = 0; i < gLevel->playerList.size(); i++)
+			for (size_t i = 0; i < gEngine->level->playerList.size(); i++)
 			{
 				//Get the player and check if we touched the spring
-				PLAYER *player = gLevel->playerList[i];
+				PLAYER *player = gEngine->level->playerList[i];
 				
 				if (touch.bottom[i])
 				{
@@ -453,6 +455,7 @@ void ObjSpring(OBJECT *object)
 						player->x.pos -= 6;
 						player->xVel = -force;
 					}
+					gEngine->level->playerIndex->Move(i);
 					
 					//Make us airborne
 					player->status.inAir = true;
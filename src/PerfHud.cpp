@@ -0,0 +1,242 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <chrono>
+
+#include "PerfHud.h"
+#include "BitmapFont.h"
+#include "Backend/Input.h"
+#include "Profiler.h"
+#include "Level.h"
+#include "Game.h"
+#include "Error.h"
+#include "Log.h"
+
+//Performance counters
+PERFCOUNTERS gPerfCounters;
+
+//Profiler zones shown, and their labels
+static const char *zoneName[PERFHUD_ZONES] = {
+	"HandleEvents",
+	"Players",
+	"Objects",
+	"Core objects",
+	"CheckObjectLoad",
+	"LEVEL::Draw",
+	"BlitQueue",
+};
+
+static const char *zoneLabel[PERFHUD_ZONES] = {
+	"Events",
+	"Player",
+	"Object",
+	"Core",
+	"Loads",
+	"Draw",
+	"Blit",
+};
+
+//Colours
+enum PERFHUD_COLOUR
+{
+	PERFHUD_COLOUR_BACK,
+	PERFHUD_COLOUR_BAR,
+	PERFHUD_COLOUR_OVER,
+	PERFHUD_COLOUR_BUDGET,
+	PERFHUD_COLOUR_PERCENTILE,
+	PERFHUD_COLOUR_MAX,
+};
+
+//Layout
+#define PERFHUD_COLUMNS			26		//Characters per line
+#define PERFHUD_MARGIN			8
+#define PERFHUD_LINE_HEIGHT		11
+#define PERFHUD_GRAPH_HEIGHT	64		//Frame times past the top of the graph are cut off
+
+//Constructor and destructor
+PERFHUD::PERFHUD()
+{
+	//Load our font (the same as the HUD's)
+	TEXTURE *fontTexture = gEngine->level->GetObjectTexture("data/GenericFont.bmp");
+	if (fontTexture->fail != nullptr)
+	{
+		Error(fail = fontTexture->fail);
+		return;
+	}
+	font = new BITMAPFONT(fontTexture, 0, 49, 8, 11, 0, 0, 0x20, 0x20);
+	
+	//Get our colours
+	colour = new COLOUR[PERFHUD_COLOUR_MAX];
+	colour[PERFHUD_COLOUR_BACK] = COLOUR(0x00, 0x00, 0x20);
+	colour[PERFHUD_COLOUR_BAR] = COLOUR(0x00, 0xC0, 0x40);
+	colour[PERFHUD_COLOUR_OVER] = COLOUR(0xE0, 0x20, 0x20);
+	colour[PERFHUD_COLOUR_BUDGET] = COLOUR(0xFF, 0xFF, 0xFF);
+	colour[PERFHUD_COLOUR_PERCENTILE] = COLOUR(0xE0, 0xE0, 0x00);
+}
+
+PERFHUD::~PERFHUD()
+{
+	delete font;
+	delete[] colour;
+}
+
+//Frame timing, called at the start of every frame to take the last frame's time and counters
+static int CompareFrameTime(const void *a, const void *b)
+{
+	float timeA = *(const float*)a, timeB = *(const float*)b;
+	return (timeA > timeB) - (timeA < timeB);
+}
+
+void PERFHUD::BeginFrame()
+{
+	//Toggle the overlay when F11 is pressed
+	bool toggle = Backend_IsKeyDown(IBK_F11);
+	if (toggle && !toggleHeld)
+		visible = !visible;
+	toggleHeld = toggle;
+	
+	uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	
+	if (frameStart != 0)
+	{
+		//Take our last frame's time (without the time spent presenting and waiting for the next frame), and flag it if it's over budget
+		uint64_t time = now - frameStart;
+		uint64_t outputTime = gPerfCounters.outputTime.exchange(0, std::memory_order_relaxed);
+		time -= (outputTime < time) ? outputTime : time;
+		
+		float milliseconds = time / 1000000.0f;
+		frameTime[frames++ % PERFHUD_HISTORY] = milliseconds;
+		if (milliseconds > PERFHUD_BUDGET)
+		{
+			overBudgetTotal++;
+			LOG(("Frame %u took %.2fms, over the %.1fms budget\n", frames, milliseconds, PERFHUD_BUDGET));
+		}
+		
+		//Get the time of each of our profiler zones
+		#ifdef PROFILER
+			for (int i = 0; i < PERFHUD_ZONES; i++)
+				zoneTime[i] = ProfilerZoneTime(zoneName[i], frameStart, now) / 1000000.0f;
+		#else
+			(void)zoneName;
+		#endif
+		
+		//Get the percentiles of our frame times, and how many are over budget
+		unsigned int history = (frames < PERFHUD_HISTORY) ? frames : PERFHUD_HISTORY;
+		float sorted[PERFHUD_HISTORY];
+		overBudget = 0;
+		for (unsigned int i = 0; i < history; i++)
+		{
+			sorted[i] = frameTime[i];
+			if (frameTime[i] > PERFHUD_BUDGET)
+				overBudget++;
+		}
+		qsort(sorted, history, sizeof(float), CompareFrameTime);
+		
+		percentile50 = sorted[(history - 1) * 50 / 100];
+		percentile95 = sorted[(history - 1) * 95 / 100];
+		percentile99 = sorted[(history - 1) * 99 / 100];
+	}
+	
+	//Take our counters and start counting again
+	collisionProbes = gPerfCounters.collisionProbes.exchange(0, std::memory_order_relaxed);
+	allocations = gPerfCounters.allocations.exchange(0, std::memory_order_relaxed);
+	pixelsWritten = gPerfCounters.pixelsWritten.exchange(0, std::memory_order_relaxed);
+	gPerfCounters.outputTime.store(0, std::memory_order_relaxed);
+	
+	frameStart = now;
+}
+
+//Object counting
+static size_t CountObjects(LINKEDLIST<OBJECT*> *list)
+{
+	size_t objects = 0;
+	for (LL_NODE<OBJECT*> *node = list->head; node != nullptr; node = node->next)
+		objects += 1 + CountObjects(&node->node_entry->children);
+	return objects;
+}
+
+//Draw function, called once everything else in the level has been drawn
+void PERFHUD::Draw()
+{
+	if (!visible || frames == 0)
+		return;
+	
+	LEVEL *level = gEngine->level;
+	SOFTWAREBUFFER *buffer = gEngine->softwareBuffer;
+	
+	//Count our render queue entries by layer
+	size_t background = buffer->queue[LEVEL_RENDERLAYER_BACKGROUND].size();
+	size_t foreground = buffer->queue[LEVEL_RENDERLAYER_FOREGROUND_LOW].size() + buffer->queue[LEVEL_RENDERLAYER_FOREGROUND_HIGH].size();
+	size_t objects = 0;
+	for (int i = 0; i < OBJECT_LAYERS; i++)
+		objects += buffer->queue[LEVEL_RENDERLAYER_OBJECT_LOW_0 + i].size() + buffer->queue[LEVEL_RENDERLAYER_OBJECT_HIGH_0 + i].size();
+	size_t hud = buffer->queue[LEVEL_RENDERLAYER_HUD].size() + buffer->queue[LEVEL_RENDERLAYER_TITLECARD].size();
+	
+	//Count our live objects and object loads in range
+	size_t liveObjects = CountObjects(&level->objectList) + CountObjects(&level->coreObjectList);
+	size_t loadsInRange = 0;
+	for (LL_NODE<OBJECT_LOAD*> *node = level->objectLoadList.head; node != nullptr; node = node->next)
+		loadsInRange += node->node_entry->loadRange;
+	
+	//Write our lines
+	char line[16][PERFHUD_COLUMNS + 1];
+	int lines = 0;
+	float lastFrame = frameTime[(frames - 1) % PERFHUD_HISTORY];
+	
+	snprintf(line[lines++], sizeof(line[0]), "Frame %.2fms%s", lastFrame, (lastFrame > PERFHUD_BUDGET) ? " OVER" : "");
+	snprintf(line[lines++], sizeof(line[0]), "p50 %.1f p95 %.1f p99 %.1f", percentile50, percentile95, percentile99);
+	snprintf(line[lines++], sizeof(line[0]), "Over %.1fms: %u/%u", PERFHUD_BUDGET, overBudget, (frames < PERFHUD_HISTORY) ? frames : PERFHUD_HISTORY);
+	snprintf(line[lines++], sizeof(line[0]), "Over in level: %u/%u", overBudgetTotal, frames);
+	#ifdef PROFILER
+		for (int i = 0; i < PERFHUD_ZONES; i += 2)
+		{
+			if (i + 1 < PERFHUD_ZONES)
+				snprintf(line[lines++], sizeof(line[0]), "%-6s %5.2f %-6s %5.2f", zoneLabel[i], zoneTime[i], zoneLabel[i + 1], zoneTime[i + 1]);
+			else
+				snprintf(line[lines++], sizeof(line[0]), "%-6s %5.2f", zoneLabel[i], zoneTime[i]);
+		}
+	#else
+		(void)zoneLabel;
+		snprintf(line[lines++], sizeof(line[0]), "(No PROFILER zones)");
+	#endif
+	snprintf(line[lines++], sizeof(line[0]), "Queue %u", (unsigned int)(background + foreground + objects + hud));
+	snprintf(line[lines++], sizeof(line[0]), "bg %u fg %u obj %u hud %u", (unsigned int)background, (unsigned int)foreground, (unsigned int)objects, (unsigned int)hud);
+	snprintf(line[lines++], sizeof(line[0]), "Pixels %llu", (unsigned long long)pixelsWritten);
+	snprintf(line[lines++], sizeof(line[0]), "Objects %u Loads %u", (unsigned int)liveObjects, (unsigned int)loadsInRange);
+	snprintf(line[lines++], sizeof(line[0]), "Allocs %u Probes %u", allocations, collisionProbes);
+	
+	//Draw our lines over our background
+	int left = gEngine->renderSpec.width - PERFHUD_MARGIN - PERFHUD_COLUMNS * 8;
+	int top = PERFHUD_MARGIN;
+	int graphTop = top + lines * PERFHUD_LINE_HEIGHT + 4;
+	
+	RECT back = {left - 2, top - 2, PERFHUD_COLUMNS * 8 + 4, (graphTop - top) + PERFHUD_GRAPH_HEIGHT + 4};
+	buffer->DrawQuad(LEVEL_RENDERLAYER_PERFHUD_BACK, &back, &colour[PERFHUD_COLOUR_BACK]);
+	
+	for (int i = 0; i < lines; i++)
+		font->DrawString(line[i], LEVEL_RENDERLAYER_PERFHUD, left, top + i * PERFHUD_LINE_HEIGHT);
+	
+	//Draw our budget and 95th percentile lines over our frame time graph (oldest on the left, frames over budget are red)
+	int graphBottom = graphTop + PERFHUD_GRAPH_HEIGHT;
+	
+	RECT budget = {left, graphBottom - (int)(PERFHUD_BUDGET * PERFHUD_GRAPH_SCALE), PERFHUD_HISTORY, 1};
+	buffer->DrawQuad(LEVEL_RENDERLAYER_PERFHUD, &budget, &colour[PERFHUD_COLOUR_BUDGET]);
+	
+	int percentileHeight = (int)(percentile95 * PERFHUD_GRAPH_SCALE);
+	if (percentileHeight < PERFHUD_GRAPH_HEIGHT)
+	{
+		RECT percentile = {left, graphBottom - percentileHeight, PERFHUD_HISTORY, 1};
+		buffer->DrawQuad(LEVEL_RENDERLAYER_PERFHUD, &percentile, &colour[PERFHUD_COLOUR_PERCENTILE]);
+	}
+	
+	unsigned int history = (frames < PERFHUD_HISTORY) ? frames : PERFHUD_HISTORY;
+	for (unsigned int i = 0; i < history; i++)
+	{
+		float time = frameTime[(frames - history + i) % PERFHUD_HISTORY];
+		int height = (int)(time * PERFHUD_GRAPH_SCALE) + 1;
+		if (height > PERFHUD_GRAPH_HEIGHT)
+			height = PERFHUD_GRAPH_HEIGHT;
+		
+		RECT bar = {left + (int)(PERFHUD_HISTORY - history + i), graphBottom - height, 1, height};
+		buffer->DrawQuad(LEVEL_RENDERLAYER_PERFHUD, &bar, &colour[(time > PERFHUD_BUDGET) ? PERFHUD_COLOUR_OVER : PERFHUD_COLOUR_BAR]);
+	}
+}
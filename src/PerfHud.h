@@ -0,0 +1,74 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+//Performance HUD, an overlay over the level showing frame time, a graph of recent frame times, the time of each part of the frame (from the profiler's zones), and counters of the work done
+//#define PERF_HUD	//When set, the performance counters are kept, and the overlay is toggled with F11 (subsystem times also need PROFILER, see Profiler.h)
+
+//Constants
+#define PERFHUD_HISTORY		120		//Frames in the frame time graph and its percentiles
+#define PERFHUD_BUDGET		16.6	//Frame time budget (in milliseconds), frames over it are flagged
+#define PERFHUD_GRAPH_SCALE	2		//Graph pixels per millisecond
+#define PERFHUD_ZONES		7		//Profiler zones shown
+
+//Performance counters, counted over a frame then taken by the overlay (headless instances may count on their own threads too)
+struct PERFCOUNTERS
+{
+	std::atomic<uint32_t> collisionProbes;	//GetCollisionH and GetCollisionV calls (these may be made on object job threads)
+	std::atomic<uint32_t> allocations;		//Heap allocations (counted by operator new, see AllocationTracker.cpp)
+	std::atomic<uint64_t> pixelsWritten;	//Pixels written by BlitQueue (every pixel of unspanned textures, only opaque ones of spanned textures)
+	std::atomic<uint64_t> outputTime;		//Nanoseconds spent in Backend_OutputBuffer (presenting and waiting for the next frame, left out of the frame time)
+};
+
+extern PERFCOUNTERS gPerfCounters;
+
+#ifdef PERF_HUD
+	#define PERF_COUNT(counter)			gPerfCounters.counter.fetch_add(1, std::memory_order_relaxed)
+	#define PERF_ADD(counter, value)	gPerfCounters.counter.fetch_add(value, std::memory_order_relaxed)
+#else
+	#define PERF_COUNT(counter)
+	#define PERF_ADD(counter, value)
+#endif
+
+//Declare the font and colour classes
+class BITMAPFONT;
+class COLOUR;
+
+//Performance HUD class
+class PERFHUD
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Font and colours
+		BITMAPFONT *font = nullptr;
+		COLOUR *colour = nullptr;
+		
+		//If the overlay is shown, and if its key was held last frame
+		bool visible = false;
+		bool toggleHeld = false;
+		
+		//Frame times (in milliseconds, the oldest are overwritten), and when the current frame started
+		float frameTime[PERFHUD_HISTORY] = {};
+		unsigned int frames = 0;
+		uint64_t frameStart = 0;
+		
+		//Percentiles of our frame times, and how many are over budget (in our history, and since the level started)
+		float percentile50 = 0.0f, percentile95 = 0.0f, percentile99 = 0.0f;
+		unsigned int overBudget = 0, overBudgetTotal = 0;
+		
+		//Last frame's zone times (in milliseconds) and counters
+		float zoneTime[PERFHUD_ZONES] = {};
+		uint32_t collisionProbes = 0, allocations = 0;
+		uint64_t pixelsWritten = 0;
+	
+	public:
+		PERFHUD();
+		~PERFHUD();
+		
+		void BeginFrame();
+		void Draw();
+};
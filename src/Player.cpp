@@ -1,6 +1,7 @@
 #include "Player.h"
 #include "MathUtil.h"
 #include "Audio.h"
+#include "Music.h"
 #include "Filesystem.h"
 #include "Log.h"
 #include "Error.h"
@@ -289,8 +290,8 @@ void ObjSpindashDust(OBJECT *object)
 			{
 				case 1: //Spindashing
 					//Load graphics
-					object->texture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
-					object->mapping.mappings = gLevel->GetObjectMappings("data/Object/SpindashDust.map");
+					object->texture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+					object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/SpindashDust.map");
 					
 					//Is the player still spindashing?
 					if (object->parentPlayer->routine != PLAYERROUTINE_CONTROL || object->parentPlayer->forceRollOrSpindash == false)
@@ -301,8 +302,8 @@ void ObjSpindashDust(OBJECT *object)
 					break;
 				case 2: //Dropdash dust
 					//Load graphics
-					object->texture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
-					object->mapping.mappings = gLevel->GetObjectMappings("data/Object/DropdashDust.map");
+					object->texture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+					object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/DropdashDust.map");
 					break;
 			}
 			
@@ -352,8 +353,8 @@ void ObjSkidDust(OBJECT *object)
 	{
 		case 0:
 			//Initialize render properties
-			object->texture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
-			object->mapping.mappings = gLevel->GetObjectMappings("data/Object/SkidDust.map");
+			object->texture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+			object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/SkidDust.map");
 			
 			object->priority = 1;
 			object->widthPixels = 4;
@@ -389,7 +390,7 @@ void ObjSkidDust(OBJECT *object)
 					dust->y.pos = object->parentPlayer->y.pos + (object->parentPlayer->status.reverseGravity ? -16 : 16);
 					dust->highPriority = object->parentPlayer->highPriority;
 					dust->anim = 2;
-					gLevel->objectList.link_back(dust);
+					gEngine->level->objectList.link_back(dust);
 					
 					//Offset if our height is atypical (for a short character like Tails)
 					int heightDifference = 19 - object->parentPlayer->defaultYRadius;
@@ -496,8 +497,8 @@ void ObjBarrier(OBJECT *object)
 		}
 		
 		//Load mappings and textures
-		object->texture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
-		object->mapping.mappings = gLevel->GetObjectMappings("data/Object/SuperStars.map");
+		object->texture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+		object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/SuperStars.map");
 		
 		//Set our render properties
 		object->priority = 1;
@@ -682,8 +683,8 @@ void ObjBarrier(OBJECT *object)
 		}
 		
 		//Load the given mappings and textures
-		object->texture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
-		object->mapping.mappings = gLevel->GetObjectMappings(useMapping);
+		object->texture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+		object->mapping.mappings = gEngine->level->GetObjectMappings(useMapping);
 		
 		//Animate
 		object->Animate(useAniList);
@@ -767,8 +768,8 @@ void ObjInvincibilityStars(OBJECT *object)
 	if (object->routine == 0)
 	{
 		//Load mappings and textures
-		object->texture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
-		object->mapping.mappings = gLevel->GetObjectMappings("data/Object/InvincibilityStars.map");
+		object->texture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+		object->mapping.mappings = gEngine->level->GetObjectMappings("data/Object/InvincibilityStars.map");
 		
 		//Set our render properties
 		object->priority = 1;
@@ -869,14 +870,14 @@ void ObjInvincibilityStars(OBJECT *object)
 PLAYER::PLAYER(std::string specPath, int16_t xPos, int16_t yPos, PLAYER *myFollow, size_t myController) : controller(myController), follow(myFollow)
 {
 	//Load art and mappings
-	texture = gLevel->GetObjectTexture(specPath + ".bmp");
+	texture = gEngine->level->GetObjectTexture((specPath + ".bmp").c_str());
 	if (texture->fail)
 	{
 		fail = texture->fail;
 		return;
 	}
 	
-	mappings = gLevel->GetObjectMappings(specPath + ".map");
+	mappings = gEngine->level->GetObjectMappings((specPath + ".map").c_str());
 	if (mappings->fail != nullptr)
 	{
 		fail = mappings->fail;
@@ -937,22 +938,22 @@ PLAYER::PLAYER(std::string specPath, int16_t xPos, int16_t yPos, PLAYER *myFollo
 	//Load our objects
 	spindashDust = new OBJECT(&ObjSpindashDust);
 	spindashDust->parentPlayer = this;
-	gLevel->coreObjectList.link_back(spindashDust);
+	gEngine->level->coreObjectList.link_back(spindashDust);
 	
 	skidDust = new OBJECT(&ObjSkidDust);
 	skidDust->parentPlayer = this;
-	gLevel->coreObjectList.link_back(skidDust);
+	gEngine->level->coreObjectList.link_back(skidDust);
 	
 	barrierObject = new OBJECT(&ObjBarrier);
 	barrierObject->parentPlayer = this;
-	gLevel->coreObjectList.link_back(barrierObject);
+	gEngine->level->coreObjectList.link_back(barrierObject);
 	
 	for (int i = 0; i < INVINCIBILITYSTARS; i++)
 	{
 		invincibilityStarObject[i] = new OBJECT(&ObjInvincibilityStars);
 		invincibilityStarObject[i]->parentPlayer = this;
 		invincibilityStarObject[i]->subtype = i;
-		gLevel->coreObjectList.link_back(invincibilityStarObject[i]);
+		gEngine->level->coreObjectList.link_back(invincibilityStarObject[i]);
 	}
 }
 
@@ -2283,7 +2284,7 @@ void PLAYER::CheckDropdashRelease()
 			scrollDelay = 0x2000 - (mabs(inertia) - 0x800) * 2;
 			
 			if (super)
-				gLevel->camera->shake = 30;
+				gEngine->level->camera->shake = 30;
 			
 			//Make our dropdash dust visible
 			if (spindashDust != nullptr)
@@ -3453,12 +3454,12 @@ void PLAYER::RollMovement()
 void PLAYER::DeadCheckOffscreen()
 {
 	//Lock our camera
-	int16_t cameraY = gLevel->camera->yPos;
+	int16_t cameraY = gEngine->level->camera->yPos;
 	cameraLock = true;
 	
 	//Stop the timer if lead player
 	if (follow == nullptr)
-		gLevel->updateTime = false;
+		gEngine->level->updateTime = false;
 	
 	//Check if we're off-screen
 	#ifndef SONIC12_DEATH_RESPAWN
@@ -3469,11 +3470,11 @@ void PLAYER::DeadCheckOffscreen()
 		}
 		else
 		{
-			if (y.pos < cameraY + (gRenderSpec.height + 0x20))
+			if (y.pos < cameraY + (gEngine->renderSpec.height + 0x20))
 				return;
 		}
 	#else
-		if ((unsigned)y.pos < gLevel->bottomBoundaryTarget + 0x20)
+		if ((unsigned)y.pos < gEngine->level->bottomBoundaryTarget + 0x20)
 			return;
 	#endif
 	
@@ -3482,7 +3483,7 @@ void PLAYER::DeadCheckOffscreen()
 		//Lose a life and enter respawn state if lead player
 		routine = PLAYERROUTINE_RESET_LEVEL;
 		restartCountdown = 60;
-		gLives--;
+		gEngine->lives--;
 	}
 	else
 	{
@@ -3497,7 +3498,7 @@ void PLAYER::HurtCheckGround()
 	//Check if we've fallen off the stage, and die
 	if (status.reverseGravity)
 	{
-		if (y.pos < gLevel->topBoundaryTarget)
+		if (y.pos < gEngine->level->topBoundaryTarget)
 		{
 			Kill(SOUNDID_HURT);
 			return;
@@ -3505,7 +3506,7 @@ void PLAYER::HurtCheckGround()
 	}
 	else
 	{
-		if (y.pos >= gLevel->bottomBoundaryTarget)
+		if (y.pos >= gEngine->level->bottomBoundaryTarget)
 		{
 			Kill(SOUNDID_HURT);
 			return;
@@ -3543,7 +3544,10 @@ bool PLAYER::Kill(SOUNDID soundId)
 {
 	if (debug == 0)
 	{
-		//Reset our state
+		//Reset our state (stopping our invincibility music if we're the lead player)
+		if (item.isInvincible && follow == nullptr)
+			PopMusic("Invincibility", 0);
+		
 		barrier = BARRIER_NULL;
 		item = {};
 		
@@ -3561,7 +3565,7 @@ bool PLAYER::Kill(SOUNDID soundId)
 		
 		//If the lead player, freeze level
 		if (follow == nullptr)
-			gLevel->updateStage = false;
+			gEngine->level->updateStage = false;
 		
 		//Do animation and sound
 		anim = PLAYERANIMATION_DEATH;
@@ -3581,7 +3585,7 @@ bool PLAYER::Hurt(OBJECT *hit)
 		soundId = SOUNDID_SPIKE_HURT;
 	
 	//Get which ring count to use
-	unsigned int *rings = &gRings; //TODO: multiplayer stuff
+	unsigned int *rings = &gEngine->rings; //TODO: multiplayer stuff
 	
 	//If we have a barrier, lose it, otherwise, lose rings
 	if (barrier != BARRIER_NULL)
@@ -3607,7 +3611,7 @@ bool PLAYER::Hurt(OBJECT *hit)
 			ringObject->x.pos = x.pos;
 			ringObject->y.pos = y.pos;
 			ringObject->parentPlayer = this;
-			gLevel->objectList.link_back(ringObject);
+			gEngine->level->objectList.link_back(ringObject);
 		}
 	}
 	
@@ -3696,8 +3700,8 @@ void PLAYER::LevelBoundaries()
 	#endif
 	
 	lbType nextPos = (xLong + (xVel << 8)) >> 16;
-	lbType leftBound = gLevel->leftBoundary + 0x10;
-	lbType rightBound = gLevel->rightBoundary + 0x40 - 0x18;
+	lbType leftBound = gEngine->level->leftBoundary + 0x10;
+	lbType rightBound = gEngine->level->rightBoundary + 0x40 - 0x18;
 	
 	//Clip us into the boundaries
 	if (nextPos < leftBound)
@@ -3707,9 +3711,9 @@ void PLAYER::LevelBoundaries()
 	
 	//Die if reached bottom boundary
 #ifndef SONIC1_DEATH_BOUNDARY
-	if (status.reverseGravity ? (y.pos <= gLevel->topBoundaryTarget) : (y.pos >= gLevel->bottomBoundaryTarget))
+	if (status.reverseGravity ? (y.pos <= gEngine->level->topBoundaryTarget) : (y.pos >= gEngine->level->bottomBoundaryTarget))
 #else
-	if (status.reverseGravity ? (y.pos <= gLevel->topBoundary) : (y.pos >= gLevel->bottomBoundary))
+	if (status.reverseGravity ? (y.pos <= gEngine->level->topBoundary) : (y.pos >= gEngine->level->bottomBoundary))
 #endif
 	{
 		x.pos = nextPos;
@@ -3747,7 +3751,7 @@ static const uint8_t sonicPalette[16][4][3] = {
 
 void PLAYER::SuperPaletteCycle()
 {
-	TEXTURE *plGenTexture = gLevel->GetObjectTexture("data/Object/PlayerGeneric.bmp");
+	TEXTURE *plGenTexture = gEngine->level->GetObjectTexture("data/Object/PlayerGeneric.bmp");
 	
 	switch (paletteState)
 	{
@@ -3817,11 +3821,11 @@ void PLAYER::SuperPaletteCycle()
 bool PLAYER::SuperTransform()
 {
 	#ifndef SONIC2REV01_SUPER_SOFTLOCK
-		if (!gLevel->updateTime)
+		if (!gEngine->level->updateTime)
 			return false;
 	#endif
 	
-	if (!super && gRings >= 50) //Super transformation
+	if (!super && gEngine->rings >= 50) //Super transformation
 	{
 		//Set our super state
 		paletteState = PALETTESTATE_FADING_IN;
@@ -3858,7 +3862,7 @@ void PLAYER::UpdateSuper()
 	if (super)
 	{
 		//Revert to regular if the stage is no longer updating or we're not the lead player
-		if (gLevel->updateTime && follow == nullptr)
+		if (gEngine->level->updateTime && follow == nullptr)
 		{
 			//Wait about 60 frames (61) before depleting rings
 			if (--superTimer >= 0)
@@ -3866,9 +3870,9 @@ void PLAYER::UpdateSuper()
 			superTimer = 60;
 			
 			//Check if we've run out of rings
-			if (gRings != 0)
+			if (gEngine->rings != 0)
 			{
-				if (--gRings > 0)
+				if (--gEngine->rings > 0)
 					return;
 			}
 		}
@@ -4088,7 +4092,7 @@ void PLAYER::Animate()
 						
 						//Set frame
 						mappingFrame = animation[1 + animFrame] + angleIncrement;
-						if (animation == aniList[PLAYERANIMATION_WALK] && gLevel->frameCounter & 0x3)
+						if (animation == aniList[PLAYERANIMATION_WALK] && gEngine->level->frameCounter & 0x3)
 							mappingFrame += WALK_FRAMES * 4;
 
 					#ifndef SONIC1_WALK_ANIMATION
@@ -4418,7 +4422,7 @@ void PLAYER::CPU_RespawnOffscreen()
 void PLAYER::CPU_Control()
 {
 	//If our is making inputs, let them move for 10 seconds
-	if (gController[controller].held.start || gController[controller].held.a || gController[controller].held.b || gController[controller].held.c || gController[controller].held.right || gController[controller].held.left || gController[controller].held.down || gController[controller].held.up)
+	if (gEngine->controller[controller].held.start || gEngine->controller[controller].held.a || gEngine->controller[controller].held.b || gEngine->controller[controller].held.c || gEngine->controller[controller].held.right || gEngine->controller[controller].held.left || gEngine->controller[controller].held.down || gEngine->controller[controller].held.up)
 		cpuTimer = 60 * 10;
 	
 	switch (cpuRoutine)
@@ -4436,7 +4440,7 @@ void PLAYER::CPU_Control()
 			//Check if we should exit this routine (waiting to respawn)
 			if (!(controlHeld.a || controlHeld.b || controlHeld.c || controlHeld.start))
 			{
-				if (gLevel->frameCounter & 0x3F)
+				if (gEngine->level->frameCounter & 0x3F)
 					break;
 				if (follow->objectControl.disableObjectInteract)
 					break;
@@ -4696,7 +4700,7 @@ void PLAYER::CPU_Control()
 						}
 						
 						//Prioritize copying inputs if far away
-						if ((gLevel->frameCounter & 0xFF) != 0 && tgtX >= 0x40)
+						if ((gEngine->level->frameCounter & 0xFF) != 0 && tgtX >= 0x40)
 						{
 							//Copy current follow control state
 							controlHeld = followHeld;
@@ -4728,7 +4732,7 @@ void PLAYER::CPU_Control()
 					}
 					
 					//Check if we should jump every about $40 frames
-					if ((gLevel->frameCounter & 0x3F) == 0 && anim != PLAYERANIMATION_DUCK)
+					if ((gEngine->level->frameCounter & 0x3F) == 0 && anim != PLAYERANIMATION_DUCK)
 					{
 						//Jump up
 						followHeld.a = true; followPress.a = true;
@@ -4775,7 +4779,7 @@ void PLAYER::CPU_Control()
 					controlPress = {}; controlPress.down = true;
 					
 					//Wait for us to finally be ducking, but give up after up to $80 frames
-					if ((gLevel->frameCounter & 0x7F) != 0)
+					if ((gEngine->level->frameCounter & 0x7F) != 0)
 					{
 						if (anim != PLAYERANIMATION_DUCK)
 							break;
@@ -4793,10 +4797,10 @@ void PLAYER::CPU_Control()
 					controlPress = {}; controlPress.down = true;
 					
 					//Release eventually (up to $80 frames)
-					if ((gLevel->frameCounter & 0x7F) != 0)
+					if ((gEngine->level->frameCounter & 0x7F) != 0)
 					{
 						//Charge every about $20 frames
-						if ((gLevel->frameCounter & 0x1F) == 0)
+						if ((gEngine->level->frameCounter & 0x1F) == 0)
 						{
 							controlHeld.a = true; controlPress.a = true;
 							controlHeld.b = true; controlPress.b = true;
@@ -4971,17 +4975,17 @@ void PLAYER::Update()
 					if (gDebugEnabled && controller == 0)
 					{
 						//Toggle our reverse gravity
-						if (gController[controller].press.a)
+						if (gEngine->controller[controller].press.a)
 							status.reverseGravity ^= 1;
 						
 						//Enable debug mode
-						if (gController[controller].press.b)
+						if (gEngine->controller[controller].press.b)
 						{
 							//Unlock controls
 							controlLock = false;
 							
 							//Enter the debug mode
-							if (gController[controller].held.c)
+							if (gEngine->controller[controller].held.c)
 								debug = 2; //Mapping tester
 							else
 								debug = 1; //Object placement
@@ -4995,8 +4999,8 @@ void PLAYER::Update()
 						//If the lead, just directly copy our controller inputs
 						if (!controlLock)
 						{
-							controlHeld = gController[controller].held;
-							controlPress = gController[controller].press;
+							controlHeld = gEngine->controller[controller].held;
+							controlPress = gEngine->controller[controller].press;
 						}
 					}
 					else
@@ -5004,8 +5008,8 @@ void PLAYER::Update()
 						//Copy our controller inputs
 						if (!controlLock)
 						{
-							controlHeld = gController[controller].held;
-							controlPress = gController[controller].press;
+							controlHeld = gEngine->controller[controller].held;
+							controlPress = gEngine->controller[controller].press;
 						}
 						
 						//Use our CPU to update our input
@@ -5050,7 +5054,7 @@ void PLAYER::Update()
 					//Handle our debug buttons
 					if (gDebugEnabled && controller == 0)
 					{
-						if (gController[controller].press.b)
+						if (gEngine->controller[controller].press.b)
 						{
 							controlLock = false;
 							debug = 1;
@@ -5088,7 +5092,7 @@ void PLAYER::Update()
 					//Handle our debug buttons
 					if (gDebugEnabled && controller == 0)
 					{
-						if (gController[controller].press.b)
+						if (gEngine->controller[controller].press.b)
 						{
 							controlLock = false;
 							debug = 1;
@@ -5120,7 +5124,7 @@ void PLAYER::Update()
 				case PLAYERROUTINE_RESET_LEVEL:
 					//After 1 second, fade the level out to restart
 					if (--restartCountdown == 0)
-						gLevel->SetFade(false, false);
+						gEngine->level->SetFade(false, false);
 					break;
 			}
 			break;
@@ -5134,7 +5138,7 @@ void PLAYER::Update()
 		case 2: //Mapping test mode
 		{
 			//Exit if B is pressed
-			if (gController[controller].press.b)
+			if (gEngine->controller[controller].press.b)
 				debug = 0;
 			
 			//Cycle through our mappings
@@ -5148,17 +5152,17 @@ void PLAYER::Update()
 	}
 	
 	//Restart if start + a
-	if (gController[controller].press.start && gController[controller].held.a)
-		gLevel->SetFade(false, false);
+	if (gEngine->controller[controller].press.start && gEngine->controller[controller].held.a)
+		gEngine->level->SetFade(false, false);
 	//Next stage if start + b
-	if (gController[controller].press.start && gController[controller].held.b)
+	if (gEngine->controller[controller].press.start && gEngine->controller[controller].held.b)
 	{
-		gLevel->SetFade(false, false);
-		gGameLoadLevel++;
-		gGameLoadLevel %= LEVELID_MAX;
+		gEngine->level->SetFade(false, false);
+		gEngine->loadLevel++;
+		gEngine->loadLevel %= LEVELID_MAX;
 	}
 	//Barrier cycle if start + c
-	if (gController[controller].press.start && gController[controller].held.c)
+	if (gEngine->controller[controller].press.start && gEngine->controller[controller].held.c)
 	{
 		if (barrier == BARRIER_NULL)
 			GiveBarrier(SOUNDID_GET_BLUE_BARRIER, BARRIER_BLUE);
@@ -5182,16 +5186,19 @@ void PLAYER::Draw_UpdateStatus()
 		Draw();
 	
 	//Handle invincibility (every 8 frames)
-	if (item.isInvincible && invincibilityTime != 0 && (gLevel->frameCounter & 0x7) == 0 && --invincibilityTime == 0)
+	if (item.isInvincible && invincibilityTime != 0 && (gEngine->level->frameCounter & 0x7) == 0 && --invincibilityTime == 0)
 	{
-		//Lose invincibility
+		//Lose invincibility (and go back to the level's music if we're the lead player)
 		item.isInvincible = false;
 		for (int i = 0; i < INVINCIBILITYSTARS; i++)
 			invincibilityStarObject[i]->routineSecondary = 0;
+		
+		if (follow == nullptr)
+			PopMusic("Invincibility", MUSIC_RESUME_FADE);
 	}
 	
 	//Handle speed shoes (every 8 frames)
-	if (item.hasSpeedShoes && speedShoesTime != 0 && (gLevel->frameCounter & 0x7) == 0 && --speedShoesTime == 0)
+	if (item.hasSpeedShoes && speedShoesTime != 0 && (gEngine->level->frameCounter & 0x7) == 0 && --speedShoesTime == 0)
 	{
 		//Lose speed shoes
 		item.hasSpeedShoes = false;
@@ -5223,24 +5230,24 @@ void PLAYER::DrawToScreen()
 			if (renderFlags.yFlip)
 				origY = mapRect->h - origY;
 			
-			int alignX = renderFlags.alignPlane ? gLevel->camera->xPos : 0;
-			int alignY = renderFlags.alignPlane ? gLevel->camera->yPos : 0;
+			int alignX = renderFlags.alignPlane ? gEngine->level->camera->xPos : 0;
+			int alignY = renderFlags.alignPlane ? gEngine->level->camera->yPos : 0;
 			
 			//Check if on-screen
 			renderFlags.isOnscreen = false;
 			
-			if (!(x.pos - alignX < -widthPixels || x.pos - alignX > gRenderSpec.width + widthPixels) &&
-				!(y.pos - alignY < -heightPixels || y.pos - alignY > gRenderSpec.height + heightPixels))
+			if (!(x.pos - alignX < -widthPixels || x.pos - alignX > gEngine->renderSpec.width + widthPixels) &&
+				!(y.pos - alignY < -heightPixels || y.pos - alignY > gEngine->renderSpec.height + heightPixels))
 			{
 				//We're on-screen, now set flag and draw
 				renderFlags.isOnscreen = true;
-				gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, mapRect, gLevel->GetObjectLayer(highPriority, priority), x.pos - origX - alignX, y.pos - origY - alignY, renderFlags.xFlip, renderFlags.yFlip);
+				gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, mapRect, gEngine->level->GetObjectLayer(highPriority, priority), x.pos - origX - alignX, y.pos - origY - alignY, renderFlags.xFlip, renderFlags.yFlip);
 				
 				//Draw trail when using speed shoes or hyper
 				if (item.hasSpeedShoes || hyper)
 				{
 					//If an even frame, use the position from 3 frames ago, odd frame, 5 frames ago
-					int trailSeek = (gLevel->frameCounter & 0x1) ? 5 : 3;
+					int trailSeek = (gEngine->level->frameCounter & 0x1) ? 5 : 3;
 					
 					//Shorten if running out of speed shoes time
 					if (hyper == false && item.hasSpeedShoes && speedShoesTime <= 1)
@@ -5248,7 +5255,7 @@ void PLAYER::DrawToScreen()
 					
 					//Draw at the position from the frame above
 					int x = record[(recordPos - trailSeek) % (unsigned)PLAYER_RECORD_LENGTH].x, y = record[(recordPos - trailSeek) % (unsigned)PLAYER_RECORD_LENGTH].y;
-					gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, mapRect, gLevel->GetObjectLayer(highPriority, priority), x - origX - alignX, y - origY - alignY, renderFlags.xFlip, renderFlags.yFlip);
+					gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, mapRect, gEngine->level->GetObjectLayer(highPriority, priority), x - origX - alignX, y - origY - alignY, renderFlags.xFlip, renderFlags.yFlip);
 				}
 			}
 		}
@@ -5280,9 +5287,9 @@ void PLAYER::RestoreStateDebug()
 void PLAYER::DebugControl()
 {
 	//Move in the direction held
-	CONTROLMASK selectedControl = gController[controller].held;
+	CONTROLMASK selectedControl = gEngine->controller[controller].held;
 	
-	if (gController[controller].held.up || gController[controller].held.down || gController[controller].held.left || gController[controller].held.right)
+	if (gEngine->controller[controller].held.up || gEngine->controller[controller].held.down || gEngine->controller[controller].held.left || gEngine->controller[controller].held.right)
 	{
 		//Handle our acceleration and speed
 		if (--debugAccel == 0)
@@ -5292,7 +5299,7 @@ void PLAYER::DebugControl()
 				debugSpeed = 0xFF;
 		}
 		else
-			selectedControl = gController[controller].press;
+			selectedControl = gEngine->controller[controller].press;
 		
 		//Move according to our speed and direction
 		int32_t calcSpeed = (debugSpeed + 1) << 12;
@@ -5300,14 +5307,14 @@ void PLAYER::DebugControl()
 		if (selectedControl.up)
 		{
 			yLong -= calcSpeed;
-			if (yLong < gLevel->topBoundaryTarget << 16)
-				yLong = gLevel->topBoundaryTarget << 16;
+			if (yLong < gEngine->level->topBoundaryTarget << 16)
+				yLong = gEngine->level->topBoundaryTarget << 16;
 		}
 		else if (selectedControl.down)
 		{
 			yLong += calcSpeed;
-			if (yLong > gLevel->bottomBoundaryTarget << 16)
-				yLong = gLevel->bottomBoundaryTarget << 16;
+			if (yLong > gEngine->level->bottomBoundaryTarget << 16)
+				yLong = gEngine->level->bottomBoundaryTarget << 16;
 		}
 		
 		if (selectedControl.left)
@@ -5330,12 +5337,12 @@ void PLAYER::DebugControl()
 	}
 	
 	//Handle pressed buttons
-	if (gController[controller].press.b)
+	if (gEngine->controller[controller].press.b)
 	{
 		//Exit debug mode
 		debug = 0;
-		gLevel->updateStage = true;
-		gLevel->updateTime = true;
+		gEngine->level->updateStage = true;
+		gEngine->level->updateTime = true;
 		RestoreStateDebug();
 		xRadius = defaultXRadius;
 		yRadius = defaultYRadius;
@@ -5376,7 +5383,7 @@ void PLAYER::RingAttractCheck(OBJECT *object)
 		if (xDiff >= 0 && xDiff <= RING_ATTRACT_RADIUS * 2 && yDiff >= 0 && yDiff <= RING_ATTRACT_RADIUS * 2)
 		{
 			//Turn this ring into an attracted ring
-			gLevel->ReleaseObjectLoad(object);
+			gEngine->level->ReleaseObjectLoad(object);
 			object->function = ObjAttractRing;
 			object->parent = (void*)this;
 		}
@@ -5486,8 +5493,13 @@ void PLAYER::CheckObjectTouch()
 {
 	//Check for ring attraction
 	if (barrier == BARRIER_LIGHTNING)
-		for (size_t i = 0; i < gLevel->objectList.size(); i++)
-			RingAttractCheck(gLevel->objectList[i]);
+	{
+		//Only check objects in grid cells within our attraction radius
+		size_t candidates = gEngine->level->objectGrid->Query(x.pos - RING_ATTRACT_RADIUS, y.pos - RING_ATTRACT_RADIUS, x.pos + RING_ATTRACT_RADIUS, y.pos + RING_ATTRACT_RADIUS);
+		for (size_t i = 0; i < candidates; i++)
+			RingAttractCheck(gEngine->level->objectGrid->candidate[i]);
+		gEngine->level->ringManager->Attract(this, RING_ATTRACT_RADIUS);
+	}
 	
 	//Get our collision hitbox
 	bool wasInvincible = item.isInvincible; //Remember if we were invincible, since this gets temporarily overwritten by the double spin attack
@@ -5529,11 +5541,15 @@ void PLAYER::CheckObjectTouch()
 		#endif
 	}
 	
-	//Iterate through every object
-	for (size_t i = 0; i < gLevel->objectList.size(); i++)
+	//Check for collision with rings
+	gEngine->level->ringManager->Touch(this, playerLeft, playerTop, playerWidth, playerHeight);
+	
+	//Iterate through every object in grid cells overlapping our hitbox (in object list order)
+	size_t candidates = gEngine->level->objectGrid->Query(playerLeft, playerTop, playerLeft + playerWidth, playerTop + playerHeight);
+	for (size_t i = 0; i < candidates; i++)
 	{
 		//Check for collision with this object
-		if (ObjectTouch(gLevel->objectList[i], playerLeft, playerTop, playerWidth, playerHeight))
+		if (ObjectTouch(gEngine->level->objectGrid->candidate[i], playerLeft, playerTop, playerWidth, playerHeight))
 			break;
 	}
 	
@@ -5558,6 +5574,10 @@ void PLAYER::GiveInvincibility()
 {
 	if (!super)
 	{
+		//Play the invincibility music over the level's music if we're the lead player, and weren't already invincible
+		if (!item.isInvincible && follow == nullptr)
+			PushMusic("Invincibility");
+		
 		//Give invincibility
 		item.isInvincible = true;
 		invincibilityTime = 150;
@@ -0,0 +1,109 @@
+#include "PlayerIndex.h"
+#include "Player.h"
+#include "Object.h"
+
+//Destructor
+PLAYERINDEX::~PLAYERINDEX()
+{
+	//Free our arrays
+	delete[] player;
+	delete[] sortedX;
+	delete[] sortedPlayer;
+	delete[] position;
+}
+
+//Rebuild from the player list, this should be done after the players update and before the objects do
+void PLAYERINDEX::Rebuild(LINKEDLIST<PLAYER*> *playerList)
+{
+	//Reallocate if the amount of players has changed
+	if (playerList->size() != players)
+	{
+		delete[] player;
+		delete[] sortedX;
+		delete[] sortedPlayer;
+		delete[] position;
+		
+		players = playerList->size();
+		player = new PLAYER*[players];
+		sortedX = new int16_t[players];
+		sortedPlayer = new size_t[players];
+		position = new size_t[players];
+		
+		for (size_t i = 0; i < players; i++)
+			sortedPlayer[i] = i;
+	}
+	
+	//Get our players
+	size_t i = 0;
+	for (LL_NODE<PLAYER*> *node = playerList->head; node != nullptr; node = node->next)
+		player[i++] = node->node_entry;
+	
+	//Insertion sort by x-position (players rarely pass each other, so this is usually already sorted)
+	for (size_t v = 0; v < players; v++)
+	{
+		size_t thisPlayer = sortedPlayer[v];
+		int16_t thisX = player[thisPlayer]->x.pos;
+		
+		size_t p = v;
+		for (; p > 0 && sortedX[p - 1] > thisX; p--)
+		{
+			sortedX[p] = sortedX[p - 1];
+			sortedPlayer[p] = sortedPlayer[p - 1];
+		}
+		
+		sortedX[p] = thisX;
+		sortedPlayer[p] = thisPlayer;
+	}
+	
+	for (size_t v = 0; v < players; v++)
+		position[sortedPlayer[v]] = v;
+}
+
+//Update the given player's entry, this must be done whenever an object moves a player horizontally
+void PLAYERINDEX::Move(size_t i)
+{
+	//Update our x-position
+	int16_t thisX = player[i]->x.pos;
+	size_t p = position[i];
+	sortedX[p] = thisX;
+	
+	//Move our entry left or right until sorted
+	while (p > 0 && sortedX[p - 1] > thisX)
+	{
+		sortedX[p] = sortedX[p - 1];
+		sortedPlayer[p] = sortedPlayer[p - 1];
+		position[sortedPlayer[p]] = p;
+		p--;
+	}
+	
+	while (p + 1 < players && sortedX[p + 1] < thisX)
+	{
+		sortedX[p] = sortedX[p + 1];
+		sortedPlayer[p] = sortedPlayer[p + 1];
+		position[sortedPlayer[p]] = p;
+		p++;
+	}
+	
+	sortedX[p] = thisX;
+	sortedPlayer[p] = i;
+	position[i] = p;
+}
+
+//Set the bits of every player within the given horizontal range (inclusive)
+void PLAYERINDEX::Query(int16_t left, int16_t right, OBJECT_PLAYERMASK *mask)
+{
+	//Binary search for the first entry at or after left
+	size_t low = 0, high = players;
+	while (low < high)
+	{
+		size_t middle = (low + high) / 2;
+		if (sortedX[middle] < left)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	
+	//Set every player until we pass right
+	for (size_t v = low; v < players && sortedX[v] <= right; v++)
+		mask->Set(sortedPlayer[v]);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "LinkedList.h"
+
+//Declare the player class and mask
+class PLAYER;
+struct OBJECT_PLAYERMASK;
+
+//Players sorted by x-position, used by solid objects to only check players within their horizontal range
+class PLAYERINDEX
+{
+	public:
+		//Players (by player list index)
+		PLAYER **player = nullptr;
+		size_t players = 0;
+		
+		//Sorted x-positions
+		int16_t *sortedX = nullptr;		//X-position of each entry
+		size_t *sortedPlayer = nullptr;	//Player index of each entry
+		size_t *position = nullptr;		//Entry of each player
+		
+	public:
+		~PLAYERINDEX();
+		
+		void Rebuild(LINKEDLIST<PLAYER*> *playerList);
+		void Move(size_t i);
+		void Query(int16_t left, int16_t right, OBJECT_PLAYERMASK *mask);
+};
@@ -0,0 +1,234 @@
+#include "Profiler.h"
+#include "Log.h"
+
+#ifdef PROFILER
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+
+#include "Backend/Input.h"
+
+//Registered threads, a thread's slot is freed when it exits and reused by the next new thread (its zones are kept)
+static PROFILERTHREAD *profilerThread[PROFILER_THREADS];
+static std::atomic<uint32_t> profilerThreads(0);
+static std::mutex registerMutex;
+
+struct PROFILEROWNER
+{
+	PROFILERTHREAD *thread = nullptr;
+	bool dropped = false;
+	
+	~PROFILEROWNER()
+	{
+		if (thread != nullptr)
+			thread->owned.store(false, std::memory_order_release);
+	}
+};
+
+static thread_local PROFILEROWNER thisThread;
+
+//Trace start (zone times are written relative to it) and dump key state
+static uint64_t profilerStart = 0;
+static bool dumpKeyHeld = false;
+
+//Thread functions
+static PROFILERTHREAD *GetThread()
+{
+	//Register this thread on its first zone
+	if (thisThread.thread != nullptr || thisThread.dropped)
+		return thisThread.thread;
+	
+	std::lock_guard<std::mutex> lock(registerMutex);
+	
+	//Reuse the slot of a thread that's exited, otherwise take a new one
+	uint32_t threads = profilerThreads.load(std::memory_order_relaxed);
+	for (uint32_t i = 0; i < threads; i++)
+	{
+		if (!profilerThread[i]->owned.load(std::memory_order_acquire))
+		{
+			thisThread.thread = profilerThread[i];
+			thisThread.thread->owned.store(true, std::memory_order_relaxed);
+			snprintf(thisThread.thread->name, PROFILER_NAME_LENGTH, "Thread %u", i);
+			return thisThread.thread;
+		}
+	}
+	
+	if (threads >= PROFILER_THREADS)
+	{
+		thisThread.dropped = true;
+		return nullptr;
+	}
+	
+	PROFILERTHREAD *thread = new PROFILERTHREAD;
+	snprintf(thread->name, PROFILER_NAME_LENGTH, "Thread %u", threads);
+	thread->written.store(0, std::memory_order_relaxed);
+	thread->owned.store(true, std::memory_order_relaxed);
+	profilerThread[threads] = thread;
+	profilerThreads.store(threads + 1, std::memory_order_release);
+	
+	thisThread.thread = thread;
+	return thread;
+}
+
+void ProfilerNameThread(const char *name)
+{
+	PROFILERTHREAD *thread = GetThread();
+	if (thread == nullptr)
+		return;
+	strncpy(thread->name, name, PROFILER_NAME_LENGTH - 1);
+	thread->name[PROFILER_NAME_LENGTH - 1] = '\0';
+}
+
+//Zone recording
+void ProfilerRecord(const char *name, uint64_t start, uint64_t end)
+{
+	PROFILERTHREAD *thread = GetThread();
+	if (thread == nullptr)
+		return;
+	
+	//Write our zone, then publish it for dumping
+	uint32_t written = thread->written.load(std::memory_order_relaxed);
+	PROFILERZONE *zone = &thread->zone[written % PROFILER_ZONES];
+	zone->name = name;
+	zone->start = start;
+	zone->end = end;
+	thread->written.store(written + 1, std::memory_order_release);
+}
+
+uint64_t ProfilerZoneTime(const char *name, uint64_t start, uint64_t end)
+{
+	//Get the total time of every zone with the given name this thread recorded between the given times (from newest to oldest, until we're before the start)
+	PROFILERTHREAD *thread = GetThread();
+	if (thread == nullptr)
+		return 0;
+	
+	uint32_t written = thread->written.load(std::memory_order_relaxed);
+	uint32_t oldest = (written > PROFILER_ZONES) ? (written - PROFILER_ZONES) : 0;
+	uint64_t time = 0;
+	
+	for (uint32_t v = written; v-- > oldest;)
+	{
+		const PROFILERZONE *zone = &thread->zone[v % PROFILER_ZONES];
+		if (zone->end <= start)
+			break;
+		if (zone->start >= start && zone->end <= end && strcmp(zone->name, name) == 0)
+			time += zone->end - zone->start;
+	}
+	return time;
+}
+
+//Profiler functions
+bool ProfilerDump(const char *path)
+{
+	//Open our trace
+	LOG(("Dumping profile to %s... ", path));
+	
+	FILE *fp = fopen(path, "wb");
+	if (fp == nullptr)
+	{
+		LOG(("Failed to open file\n"));
+		return true;
+	}
+	
+	//Write every thread's name, then every zone still in its ring buffer as a complete event (times are in microseconds)
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fp);
+	
+	uint32_t threads = profilerThreads.load(std::memory_order_acquire);
+	
+	bool first = true;
+	unsigned long zones = 0;
+	
+	for (uint32_t i = 0; i < threads; i++)
+	{
+		PROFILERTHREAD *thread = profilerThread[i];
+		if (thread == nullptr)
+			continue;
+		
+		fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", first ? "" : ",\n", i, thread->name);
+		first = false;
+		
+		uint32_t written = thread->written.load(std::memory_order_acquire);
+		uint32_t oldest = (written > PROFILER_ZONES) ? (written - PROFILER_ZONES) : 0;
+		
+		for (uint32_t v = oldest; v < written; v++)
+		{
+			const PROFILERZONE *zone = &thread->zone[v % PROFILER_ZONES];
+			if (zone->start < profilerStart)
+				continue;
+			fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", zone->name, i, (zone->start - profilerStart) / 1000.0, (zone->end - zone->start) / 1000.0);
+			zones++;
+		}
+	}
+	
+	fputs("\n]}\n", fp);
+	fclose(fp);
+	
+	LOG(("Success! (%lu zones)\n", zones));
+	return false;
+}
+
+void UpdateProfiler()
+{
+	//Dump our trace when F12 is pressed
+	bool dumpKey = Backend_IsKeyDown(IBK_F12);
+	if (dumpKey && !dumpKeyHeld)
+	{
+		const char *path = getenv("CUCKYSONIC_PROFILE");
+		ProfilerDump((path != nullptr) ? path : PROFILER_DEFAULT_PATH);
+	}
+	dumpKeyHeld = dumpKey;
+}
+
+//Profiler sub-system functions
+bool InitializeProfiler()
+{
+	//Start our trace, and name the main thread
+	profilerStart = ProfilerTime();
+	ProfilerNameThread("Main");
+	return false;
+}
+
+void QuitProfiler()
+{
+	//Dump our trace (every other thread should have finished by now), then free every thread's ring buffer
+	const char *path = getenv("CUCKYSONIC_PROFILE");
+	ProfilerDump((path != nullptr) ? path : PROFILER_DEFAULT_PATH);
+	
+	std::lock_guard<std::mutex> lock(registerMutex);
+	
+	uint32_t threads = profilerThreads.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < threads; i++)
+	{
+		delete profilerThread[i];
+		profilerThread[i] = nullptr;
+	}
+	profilerThreads.store(0);
+	thisThread.thread = nullptr;
+}
+
+#else
+
+//Stubs for when the profiler is disabled
+bool ProfilerDump(const char *path)
+{
+	(void)path;
+	return true;
+}
+
+void UpdateProfiler()
+{
+	return;
+}
+
+bool InitializeProfiler()
+{
+	return false;
+}
+
+void QuitProfiler()
+{
+	return;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+
+//Frame profiler, scoped timing zones are recorded into a ring buffer on each thread, which can be dumped as a Chrome trace (chrome://tracing or ui.perfetto.dev)
+//#define PROFILER	//When set, zones are recorded (otherwise PROFILE_ZONE compiles to nothing), the trace is dumped when F12 is pressed, and when the game quits (to the path in the CUCKYSONIC_PROFILE environment variable, or profile.json)
+
+//Constants
+#define PROFILER_ZONES			0x10000	//Zones kept on each thread (power of two, the oldest are overwritten)
+#define PROFILER_THREADS		32		//Threads that can record zones (zones on any more are dropped)
+#define PROFILER_NAME_LENGTH	0x20	//Longest thread name (including terminator)
+#define PROFILER_DEFAULT_PATH	"profile.json"
+
+#ifdef PROFILER
+//Recorded zone, names are static strings
+struct PROFILERZONE
+{
+	const char *name;
+	uint64_t start, end;	//Nanoseconds
+};
+
+//Thread's zone ring buffer, allocated on a thread's first zone and kept until the profiler quits
+struct PROFILERTHREAD
+{
+	char name[PROFILER_NAME_LENGTH];
+	PROFILERZONE zone[PROFILER_ZONES];
+	std::atomic<uint32_t> written;
+	std::atomic<bool> owned;	//If a running thread is recording into us
+};
+
+//Timer (steady clock, which is CLOCK_MONOTONIC on Linux)
+static inline uint64_t ProfilerTime()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Zone recording
+void ProfilerRecord(const char *name, uint64_t start, uint64_t end);
+void ProfilerNameThread(const char *name);
+uint64_t ProfilerZoneTime(const char *name, uint64_t start, uint64_t end);
+
+//Scoped zone, recorded when it goes out of scope
+class PROFILESCOPE
+{
+	public:
+		const char *name;
+		uint64_t start;
+	
+	public:
+		inline PROFILESCOPE(const char *setName) : name(setName), start(ProfilerTime()) { return; }
+		inline ~PROFILESCOPE() { ProfilerRecord(name, start, ProfilerTime()); }
+};
+
+#define PROFILE_CONCAT_(a, b)	a##b
+#define PROFILE_CONCAT(a, b)	PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name)		PROFILESCOPE PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name)	ProfilerNameThread(name)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_THREAD(name)
+#endif
+
+//Profiler functions
+bool ProfilerDump(const char *path);
+void UpdateProfiler();
+
+//Profiler sub-system functions
+bool InitializeProfiler();
+void QuitProfiler();
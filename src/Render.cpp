@@ -1,14 +1,14 @@
+#include <string.h>
 #include "Backend/Render.h"
 #include "Render.h"
+#include "Engine.h"
 #include "GameConstants.h"
 #include "Log.h"
+#include "Profiler.h"
+#include "PerfHud.h"
 #include "Error.h"
 #include "Filesystem.h"
-
-//Render specification
-RENDERSPEC gRenderSpec = {426, 240, 2, 60.001, false, false};
-
-SOFTWAREBUFFER *gSoftwareBuffer;
+#include "MathUtil.h"
 
 //Render format
 PIXELFORMAT gPixelFormat;
@@ -23,10 +23,39 @@ enum BMPCMP
 };
 
 //Texture class
-TEXTURE::TEXTURE(std::string path)
+static_assert(sizeof(COLOUR) == 12, "Cooked textures store palettes in our COLOUR layout");
+static_assert(sizeof(TEXTURESPAN) == 4, "Cooked texture spans are read as pairs of 16-bit values");
+
+TEXTURE::TEXTURE(std::string path, bool cooked)
 {
+	PROFILE_ZONE("Texture load");
 	LOG(("Loading texture from %s... ", path.c_str()));
 	
+	//If there's a cooked version of this bitmap, load that instead (falling back to the bitmap if it's corrupt or out of date)
+	if (cooked && path.length() > 4 && path.compare(path.length() - 4, 4, ".bmp") == 0)
+	{
+		FS_FILE cooked(gBasePath + path.substr(0, path.length() - 4) + TEXTURE_COOKED_EXTENSION, "rb");
+		if (cooked.fail == nullptr)
+		{
+			if (LoadCooked(&cooked) == false)
+			{
+				source = path;
+				LOG(("Success!\n"));
+				return;
+			}
+			
+			//Free whatever we read before failing
+			delete loadedPalette;
+			loadedPalette = nullptr;
+			delete[] texture;
+			texture = nullptr;
+			delete[] spanLine;
+			spanLine = nullptr;
+			delete[] span;
+			span = nullptr;
+		}
+	}
+	
 	//Open our given file file
 	FS_FILE fp(gBasePath + (source = path), "rb");
 	if (fp.fail)
@@ -111,16 +140,32 @@ TEXTURE::TEXTURE(std::string path)
 	//Verify that image is indexed and uncompressed
 	if (bitmapCompression == BMPCMP_RGB && bitmapColours > 0)
 	{
+		//Check our bit depth and get how many bytes each line is
+		if (bitmapBPP != 1 && bitmapBPP != 4 && bitmapBPP != 8)
+		{
+			Error(fail = "Invalid bit depth");
+			return;
+		}
+		
+		size_t lineBytes = (width * bitmapBPP + 7) / 8;
+		
 		//Read our palette
+		const uint8_t *paletteData = fp.GetSpan(bitmapColours * 4);
+		if (paletteData == nullptr)
+		{
+			Error(fail = "Bitmap palette is cut off");
+			return;
+		}
+		
 		loadedPalette = new PALETTE(bitmapColours);
 		for (uint32_t i = 0; i < bitmapColours; i++)
 		{
 			//Read our colours
 			uint8_t r, g, b;
-			b = fp.ReadU8();	//Colours are read as BGR
-			g = fp.ReadU8();
-			r = fp.ReadU8();
-				fp.ReadU8();	//RESERVED - ???
+			b = *paletteData++;	//Colours are read as BGR
+			g = *paletteData++;
+			r = *paletteData++;
+				paletteData++;	//RESERVED - ???
 			
 			//Copy to the loaded palette
 			loadedPalette->colour[i].SetColour(true, true, true, r, g, b);
@@ -132,9 +177,27 @@ TEXTURE::TEXTURE(std::string path)
 		
 		for (int y = 0; y < height; y++)
 		{
+			//Get this line's data
+			const uint8_t *line = fp.GetSpan(lineBytes);
+			if (line == nullptr)
+			{
+				Error(fail = "Bitmap data is cut off");
+				return;
+			}
+			
+			//8-bit lines are copied as is
+			if (bitmapBPP == 8)
+			{
+				memcpy(txPnt, line, width);
+				txPnt += width;
+				if (!bitmapIsTopDown)
+					txPnt -= width * 2;
+				continue;
+			}
+			
 			for (int x = 0; x < width;)
 			{
-				uint8_t src = fp.ReadU8();
+				uint8_t src = *line++;
 				switch (bitmapBPP)
 				{
 					case 1:
@@ -153,13 +216,6 @@ TEXTURE::TEXTURE(std::string path)
 						*txPnt++ = (src & 0x0F) >> 0;
 						x += 2;
 						break;
-					case 8:
-						*txPnt++ = src;
-						x++;
-						break;
-					default:
-						Error(fail = "Invalid bit depth");
-						return;
 				}
 			}
 			
@@ -176,10 +232,101 @@ TEXTURE::TEXTURE(std::string path)
 	LOG(("Success!\n"));
 }
 
+bool TEXTURE::LoadCooked(FS_FILE *fp)
+{
+	//Read and validate our header
+	if (fp->ReadBE32() != TEXTURE_COOKED_SIGNATURE)
+		return Warn("Not a cooked texture (invalid header)");
+	if (fp->ReadBE32() != TEXTURE_COOKED_VERSION)
+		return Warn("Cooked texture is from a different version");
+	
+	width = (int32_t)fp->ReadBE32();
+	height = (int32_t)fp->ReadBE32();
+	uint32_t colours = fp->ReadBE32();
+	uint32_t flags = fp->ReadBE32();
+	uint32_t spans = fp->ReadBE32();
+		fp->ReadBE32(); //RESERVED
+	
+	if (width <= 0 || height <= 0 || width >= 0x10000 || colours == 0 || colours > 0x100)
+		return Warn("Cooked texture has invalid dimensions");
+	
+	//Get our palette and pixel data
+	const uint8_t *paletteData = fp->GetSpan(colours * sizeof(COLOUR));
+	const uint8_t *pixelData = fp->GetSpan((size_t)width * height);
+	if (paletteData == nullptr || pixelData == nullptr)
+		return Warn("Cooked texture is cut off");
+	
+	//Copy our palette, then get the native colours (these depend on the pixel format we're rendering in)
+	loadedPalette = new PALETTE(colours);
+	memcpy(loadedPalette->colour, paletteData, colours * sizeof(COLOUR));
+	for (uint32_t i = 0; i < colours; i++)
+		loadedPalette->colour[i].Regen(loadedPalette->colour[i].r, loadedPalette->colour[i].g, loadedPalette->colour[i].b);
+	
+	//Copy our texture data
+	texture = new uint8_t[width * height];
+	memcpy(texture, pixelData, (size_t)width * height);
+	
+	//Read our opaque spans
+	if (flags & TEXTURE_COOKED_SPANS)
+	{
+		spanLine = new uint32_t[height + 1];
+		span = new TEXTURESPAN[spans];
+		if (fp->ReadBE32(spanLine, height + 1) != (size_t)(height + 1) || fp->ReadBE16((uint16_t*)span, spans * 2) != spans * 2 || spanLine[height] != spans)
+			return Warn("Cooked texture span table is cut off");
+	}
+	
+	return false;
+}
+
+bool TEXTURE::Reload(bool cooked)
+{
+	//Load our source again, keeping our current data if that fails
+	TEXTURE newTexture(source, cooked);
+	if (newTexture.fail != nullptr)
+		return true;
+	
+	//Swap the new data into us, so anything pointing to us (or our palette) stays valid, the old data is freed with newTexture
+	uint8_t *oldTexture = texture;
+	texture = newTexture.texture;
+	newTexture.texture = oldTexture;
+	
+	width = newTexture.width;
+	height = newTexture.height;
+	
+	uint32_t *oldSpanLine = spanLine;
+	spanLine = newTexture.spanLine;
+	newTexture.spanLine = oldSpanLine;
+	
+	TEXTURESPAN *oldSpan = span;
+	span = newTexture.span;
+	newTexture.span = oldSpan;
+	
+	if (loadedPalette == nullptr)
+	{
+		//We failed to load before, so we have no palette of our own
+		loadedPalette = newTexture.loadedPalette;
+	}
+	else
+	{
+		COLOUR *oldColour = loadedPalette->colour;
+		size_t oldColours = loadedPalette->colours;
+		loadedPalette->colour = newTexture.loadedPalette->colour;
+		loadedPalette->colours = newTexture.loadedPalette->colours;
+		newTexture.loadedPalette->colour = oldColour;
+		newTexture.loadedPalette->colours = oldColours;
+		delete newTexture.loadedPalette;
+	}
+	
+	fail = nullptr;
+	return false;
+}
+
 TEXTURE::~TEXTURE()
 {
 	//Unload texture data
 	delete[] texture;
+	delete[] spanLine;
+	delete[] span;
 }
 
 //Software buffer class
@@ -188,11 +335,47 @@ SOFTWAREBUFFER::SOFTWAREBUFFER(const int bufWidth, const int bufHeight)
 	//Set our dimensions
 	width = bufWidth;
 	height = bufHeight;
+	
+	//Share our entries between our layers, and allocate them up front
+	for (int i = 1; i < RENDERLAYERS; i++)
+		queue[i].spareOwner = &queue[0];
+	queue[0].reserve(RENDERQUEUE_RESERVE);
+}
+
+//Texture batch class
+RENDERBATCH::RENDERBATCH(size_t reserve)
+{
+	//Allocate our sprites up front
+	sprite = new RENDERBATCH_SPRITE[reserve];
+	capacity = reserve;
+}
+
+RENDERBATCH::~RENDERBATCH()
+{
+	delete[] sprite;
+}
+
+RENDERBATCH_SPRITE *RENDERBATCH::Push()
+{
+	//Grow our sprites if full
+	if (sprites >= capacity)
+	{
+		size_t newCapacity = mmax(capacity * 2, (size_t)0x20);
+		RENDERBATCH_SPRITE *newSprite = new RENDERBATCH_SPRITE[newCapacity];
+		memcpy(newSprite, sprite, sprites * sizeof(RENDERBATCH_SPRITE));
+		delete[] sprite;
+		sprite = newSprite;
+		capacity = newCapacity;
+	}
+	return &sprite[sprites++];
 }
 
 //Drawing functions
 void SOFTWAREBUFFER::DrawPoint(const int layer, const POINT *point, const COLOUR *colour)
 {
+	if (discard)
+		return;
+	
 	//Check if this is in view bounds (if not, just return, no point in clogging the queue with stuff that will not be rendered)
 	if (point->x < 0 || point->x >= width)
 		return;
@@ -211,6 +394,9 @@ void SOFTWAREBUFFER::DrawPoint(const int layer, const POINT *point, const COLOUR
 
 void SOFTWAREBUFFER::DrawQuad(const int layer, const RECT *quad, const COLOUR *colour)
 {
+	if (discard)
+		return;
+	
 	//Don't draw bad quads
 	if (quad->w <= 0 || quad->h <= 0)
 		return;
@@ -250,51 +436,60 @@ void SOFTWAREBUFFER::DrawQuad(const int layer, const RECT *quad, const COLOUR *c
 	queue[layer].link_front(newEntry);
 }
 
-void SOFTWAREBUFFER::DrawTexture(TEXTURE *texture, PALETTE *palette, const RECT *src, int layer, int x, int y, bool xFlip, bool yFlip)
+static void ClipTexture(RECT *src, int *x, int *y, int width, int height, bool xFlip, bool yFlip)
 {
-	//Get the source rect to use (nullptr = entire texture)
-	RECT newSrc;
-	if (src != nullptr)
-		newSrc = *src;
-	else
-		newSrc = {0, 0, texture->width, texture->height};
-	
-	//Don't draw bad quads
-	if (newSrc.w <= 0 || newSrc.h <= 0)
-		return;
-	
-	//Clip to the destination
-	if (x < 0)
+	//Clip the given source rect and position to a buffer of the given size
+	if (*x < 0)
 	{
 		if (!xFlip)
-			newSrc.x -= x;
-		newSrc.w += x;
-		x -= x;
+			src->x -= *x;
+		src->w += *x;
+		*x = 0;
 	}
 	
-	int dx = x + newSrc.w - width;
+	int dx = *x + src->w - width;
 	if (dx > 0)
 	{
 		if (xFlip)
-			newSrc.x += dx;
-		newSrc.w -= dx;
+			src->x += dx;
+		src->w -= dx;
 	}
 	
-	if (y < 0)
+	if (*y < 0)
 	{
 		if (!yFlip)
-			newSrc.y -= y;
-		newSrc.h += y;
-		y -= y;
+			src->y -= *y;
+		src->h += *y;
+		*y = 0;
 	}
 	
-	int dy = y + newSrc.h - height;
+	int dy = *y + src->h - height;
 	if (dy > 0)
 	{
 		if (yFlip)
-			newSrc.y += dy;
-		newSrc.h -= dy;
+			src->y += dy;
+		src->h -= dy;
 	}
+}
+
+void SOFTWAREBUFFER::DrawTexture(TEXTURE *texture, PALETTE *palette, const RECT *src, int layer, int x, int y, bool xFlip, bool yFlip)
+{
+	if (discard)
+		return;
+	
+	//Get the source rect to use (nullptr = entire texture)
+	RECT newSrc;
+	if (src != nullptr)
+		newSrc = *src;
+	else
+		newSrc = {0, 0, texture->width, texture->height};
+	
+	//Don't draw bad quads
+	if (newSrc.w <= 0 || newSrc.h <= 0)
+		return;
+	
+	//Clip to the destination
+	ClipTexture(&newSrc, &x, &y, width, height, xFlip, yFlip);
 	
 	//Setup our queue entry
 	RENDERQUEUE newEntry;
@@ -311,6 +506,39 @@ void SOFTWAREBUFFER::DrawTexture(TEXTURE *texture, PALETTE *palette, const RECT
 	queue[layer].link_front(newEntry);
 }
 
+void SOFTWAREBUFFER::BatchTexture(RENDERBATCH *batch, const RECT *src, int x, int y)
+{
+	if (discard)
+		return;
+	
+	//Clip to the destination, and skip sprites that are entirely off-screen
+	RECT newSrc = *src;
+	ClipTexture(&newSrc, &x, &y, width, height, false, false);
+	if (newSrc.w <= 0 || newSrc.h <= 0)
+		return;
+	
+	//Add to the batch
+	RENDERBATCH_SPRITE *sprite = batch->Push();
+	sprite->srcX = newSrc.x;
+	sprite->srcY = newSrc.y;
+	sprite->dest = {x, y, newSrc.w, newSrc.h};
+}
+
+void SOFTWAREBUFFER::DrawBatch(TEXTURE *texture, PALETTE *palette, const RENDERBATCH *batch, const int layer)
+{
+	if (discard || batch->sprites == 0)
+		return;
+	
+	//Setup our queue entry and link to queue
+	RENDERQUEUE newEntry;
+	newEntry.type = RENDERQUEUE_BATCH;
+	newEntry.dest = {0, 0, width, height};
+	newEntry.batch.palette = palette;
+	newEntry.batch.texture = texture;
+	newEntry.batch.sprites = batch;
+	queue[layer].link_front(newEntry);
+}
+
 //Primary render function
 bool SOFTWAREBUFFER::RenderToScreen(const COLOUR *backgroundColour)
 {
@@ -323,6 +551,7 @@ bool SOFTWAREBUFFER::RenderToScreen(const COLOUR *backgroundColour)
 	if (outBuffer != nullptr)
 	{
 		//Render to our buffer
+		PROFILE_ZONE("BlitQueue");
 		switch (gPixelFormat.bytesPerPixel)
 		{
 			case 1:
@@ -349,8 +578,17 @@ bool SOFTWAREBUFFER::RenderToScreen(const COLOUR *backgroundColour)
 		queue[i].clear();
 	
 	//Render buffer to output
-	if (Backend_OutputBuffer())
-		return true;
+	PROFILE_ZONE("Backend_OutputBuffer");
+	#ifdef PERF_HUD
+		uint64_t outputStart = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		bool outputFail = Backend_OutputBuffer();
+		PERF_ADD(outputTime, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - outputStart);
+		if (outputFail)
+			return true;
+	#else
+		if (Backend_OutputBuffer())
+			return true;
+	#endif
 	return false;
 }
 
@@ -361,16 +599,16 @@ bool InitializeRender()
 	
 	//Initialize backend rendering
 	BACKEND_RENDER_FORMAT backendRenderFormat;
-	if (Backend_InitRender(gRenderSpec, &backendRenderFormat))
+	if (Backend_InitRender(gEngine->renderSpec, &backendRenderFormat))
 		return true;
 	
 	//Set our format globals
 	gPixelFormat = backendRenderFormat.pixelFormat;
 	
 	//Create our software buffer
-	gSoftwareBuffer = new SOFTWAREBUFFER(gRenderSpec.width, gRenderSpec.height);
-	if (gSoftwareBuffer->fail)
-		return Error(gSoftwareBuffer->fail);
+	gEngine->softwareBuffer = new SOFTWAREBUFFER(gEngine->renderSpec.width, gEngine->renderSpec.height);
+	if (gEngine->softwareBuffer->fail)
+		return Error(gEngine->softwareBuffer->fail);
 	
 	LOG(("Success!\n"));
 	return false;
@@ -381,8 +619,8 @@ void QuitRender()
 	LOG(("Ending renderer... "));
 	
 	//Destroy software buffer
-	if (gSoftwareBuffer)
-		delete gSoftwareBuffer;
+	if (gEngine->softwareBuffer)
+		delete gEngine->softwareBuffer;
 	
 	LOG(("Success!\n"));
 }
@@ -2,6 +2,10 @@
 #include <string>
 #include <stdint.h>
 #include "LinkedList.h"
+#include "PerfHud.h"
+
+//Declare the file class
+class FS_FILE;
 
 //Rect and point structures
 struct RECT { int x, y, w, h; };
@@ -124,6 +128,24 @@ class PALETTE
 		}
 };
 
+//Cooked texture format (made from .bmp files by Tools/CookTextures.cpp), loaded in place of a .bmp with the same name
+//Header: "CTEX", version, width, height, colours, flags, span count, reserved (big endian, 4 bytes each)
+//Then the palette (in our COLOUR layout, only the RGB values are used), the 8-bit pixels (top to bottom), and optionally the opaque span table
+#define TEXTURE_COOKED_EXTENSION	".tex"
+#define TEXTURE_COOKED_SIGNATURE	0x43544558	//"CTEX"
+#define TEXTURE_COOKED_VERSION		1
+
+enum TEXTURE_COOKED_FLAGS
+{
+	TEXTURE_COOKED_SPANS = 1 << 0,	//Has an opaque span table (big endian row start indices, then big endian spans)
+};
+
+//Run of opaque (non-zero) pixels in a texture line
+struct TEXTURESPAN
+{
+	uint16_t start, length;
+};
+
 //Texture class
 class TEXTURE
 {
@@ -140,20 +162,54 @@ class TEXTURE
 		int height;
 		
 		//Loaded palette
-		PALETTE *loadedPalette;
+		PALETTE *loadedPalette = nullptr;
+		
+		//Opaque spans (only from cooked textures), the spans of line y are span[spanLine[y]] to span[spanLine[y + 1]]
+		uint32_t *spanLine = nullptr;
+		TEXTURESPAN *span = nullptr;
 		
 	public:
-		TEXTURE(std::string path);
+		TEXTURE(std::string path, bool cooked = true);	//cooked - Load the cooked version of a .bmp if there is one
 		~TEXTURE();
+		
+		bool Reload(bool cooked = true);
+		
+	private:
+		bool LoadCooked(FS_FILE *fp);
 };
 
 //Render queue structure
 #define RENDERLAYERS 0x100
+#define RENDERQUEUE_RESERVE 0x1000	//Render queue entries allocated up front (shared by every layer, so queueing doesn't allocate unless a frame queues more than this)
 
 enum RENDERQUEUE_TYPE
 {
 	RENDERQUEUE_TEXTURE,
 	RENDERQUEUE_SOLID,
+	RENDERQUEUE_BATCH,
+};
+
+//Texture batch, sprites from one texture drawn by a single render queue entry (it has to be kept until the queue's rendered)
+struct RENDERBATCH_SPRITE
+{
+	int srcX, srcY;
+	RECT dest;	//Already clipped to the buffer
+};
+
+class RENDERBATCH
+{
+	public:
+		RENDERBATCH_SPRITE *sprite = nullptr;
+		size_t sprites = 0, capacity = 0;
+	
+	public:
+		RENDERBATCH(size_t reserve);
+		RENDERBATCH(const RENDERBATCH&) = delete;
+		RENDERBATCH &operator=(const RENDERBATCH&) = delete;
+		~RENDERBATCH();
+		
+		RENDERBATCH_SPRITE *Push();
+		inline void Clear() { sprites = 0; }
 };
 
 struct RENDERQUEUE
@@ -176,6 +232,12 @@ struct RENDERQUEUE
 		{
 			const COLOUR *colour;
 		} solid;
+		struct
+		{
+			const PALETTE *palette;
+			const TEXTURE *texture;
+			const RENDERBATCH *sprites;
+		} batch;
 	};
 };
 
@@ -186,13 +248,16 @@ class SOFTWAREBUFFER
 		//Failure
 		const char *fail = nullptr;
 		
-		//Render queue
+		//Render queue (every layer shares the first layer's erased entries)
 		LINKEDLIST<RENDERQUEUE> queue[RENDERLAYERS];
 		
 		//Dimensions of buffer
 		int width;
 		int height;
 		
+		//When set, nothing is queued (for headless simulation, where drawing is still done for the state it updates, like objects being on-screen)
+		bool discard = false;
+		
 	public:
 		SOFTWAREBUFFER(int bufWidth, int bufHeight);
 		
@@ -200,8 +265,101 @@ class SOFTWAREBUFFER
 		void DrawQuad(const int layer, const RECT *quad, const COLOUR *colour);
 		void DrawTexture(TEXTURE *texture, PALETTE *palette, const RECT *src, const int layer, const int x, const int y, const bool xFlip, const bool yFlip);
 		
+		void BatchTexture(RENDERBATCH *batch, const RECT *src, const int x, const int y);
+		void DrawBatch(TEXTURE *texture, PALETTE *palette, const RENDERBATCH *batch, const int layer);
+		
 		bool RenderToScreen(const COLOUR *backgroundColour);
 		
+		//Texture blit function, draws the given part of a texture to the given destination (already clipped), counting the pixels written for the performance HUD
+		template <typename T> __attribute__((hot)) inline void BlitTexture(T *buffer, const int pitch, const TEXTURE *texture, const PALETTE *palette, const int srcX, const int srcY, RECT dest, const bool xFlip, const bool yFlip, uint64_t *pixels)
+		{
+			#ifndef PERF_HUD
+				(void)pixels;
+			#endif
+			
+			uint8_t *srcBuffer = texture->texture;
+			T *dstBuffer = buffer + (dest.x + dest.y * pitch);
+			
+			//If we have opaque spans, only draw the opaque parts of each line
+			if (texture->span != nullptr)
+			{
+				const int srcRight = srcX + dest.w;
+				const int dstInc = xFlip ? -1 : 1;
+				
+				for (int y = 0; y < dest.h; y++, dstBuffer += pitch)
+				{
+					const int line = yFlip ? (srcY + dest.h - 1 - y) : (srcY + y);
+					const uint8_t *srcLine = srcBuffer + line * texture->width;
+					
+					for (uint32_t s = texture->spanLine[line]; s < texture->spanLine[line + 1]; s++)
+					{
+						//Clip this span to our source rect
+						const TEXTURESPAN *span = &texture->span[s];
+						if (span->start >= srcRight)
+							break;
+						
+						const int left = (span->start > srcX) ? span->start : srcX;
+						const int right = (span->start + span->length < srcRight) ? (span->start + span->length) : srcRight;
+						
+						#ifdef PERF_HUD
+							if (right > left)
+								*pixels += right - left;
+						#endif
+						
+						T *dstPixel = dstBuffer + (xFlip ? (srcRight - 1 - left) : (left - srcX));
+						for (int x = left; x < right; x++, dstPixel += dstInc)
+							*dstPixel = palette->colour[srcLine[x]].colour;
+					}
+				}
+				return;
+			}
+			
+			//Get how to render the texture according to our x and y flipping
+			const int finc = -(xFlip << 1) + 1;
+			int fpitch;
+			
+			//Vertical flip
+			if (yFlip)
+			{
+				//Start at bottom and move upwards
+				srcBuffer += srcX + texture->width * (srcY + (dest.h - 1));
+				fpitch = -(texture->width + dest.w);
+			}
+			else
+			{
+				//Move downwards
+				srcBuffer += (srcX + srcY * texture->width);
+				fpitch = texture->width - dest.w;
+			}
+			
+			//Horizontal flip
+			if (xFlip)
+			{
+				//Start at right side
+				srcBuffer += dest.w - 1;
+				fpitch += dest.w * 2;
+			}
+			
+			#ifdef PERF_HUD
+				*pixels += dest.w * dest.h;
+			#endif
+			
+			//Iterate through each pixel
+			while (dest.h-- > 0)
+			{
+				for (int x = 0; x < dest.w; x++)
+				{
+					if (*srcBuffer)
+						*dstBuffer = palette->colour[*srcBuffer].colour;
+					srcBuffer += finc;
+					dstBuffer++;
+				}
+				
+				srcBuffer += fpitch;
+				dstBuffer += pitch - dest.w;
+			}
+		}
+		
 		//Blit function
 		template <typename T> __attribute__((hot)) inline void BlitQueue(const COLOUR *backgroundColour, T *buffer, const int pitch)
 		{
@@ -213,6 +371,9 @@ class SOFTWAREBUFFER
 					*clrBuffer++ = backgroundColour->colour;
 			}
 			
+			//Count the pixels we write for the performance HUD
+			uint64_t pixels = 0;
+			
 			//Iterate through each layer
 			for (int i = RENDERLAYERS - 1; i >= 0; i--)
 			{
@@ -225,48 +386,16 @@ class SOFTWAREBUFFER
 					{
 						case RENDERQUEUE_TEXTURE:
 						{
-							uint8_t *srcBuffer = entry.texture.texture->texture;
-							T *dstBuffer = buffer + (entry.dest.x + entry.dest.y * pitch);
-							
-							//Get how to render the texture according to our x and y flipping
-							const int finc = -(entry.texture.xFlip << 1) + 1;
-							int fpitch;
-							
-							//Vertical flip
-							if (entry.texture.yFlip)
-							{
-								//Start at bottom and move upwards
-								srcBuffer += entry.texture.srcX + entry.texture.texture->width * (entry.texture.srcY + (entry.dest.h - 1));
-								fpitch = -(entry.texture.texture->width + entry.dest.w);
-							}
-							else
-							{
-								//Move downwards
-								srcBuffer += (entry.texture.srcX + entry.texture.srcY * entry.texture.texture->width);
-								fpitch = entry.texture.texture->width - entry.dest.w;
-							}
-							
-							//Horizontal flip
-							if (entry.texture.xFlip)
-							{
-								//Start at right side
-								srcBuffer += entry.dest.w - 1;
-								fpitch += entry.dest.w * 2;
-							}
-							
-							//Iterate through each pixel
-							while (entry.dest.h-- > 0)
+							BlitTexture(buffer, pitch, entry.texture.texture, entry.texture.palette, entry.texture.srcX, entry.texture.srcY, entry.dest, entry.texture.xFlip, entry.texture.yFlip, &pixels);
+							break;
+						}
+						case RENDERQUEUE_BATCH:
+						{
+							//Draw our sprites last to first, so earlier ones are drawn over later ones (like separately queued textures)
+							for (size_t s = entry.batch.sprites->sprites; s-- > 0;)
 							{
-								for (int x = 0; x < entry.dest.w; x++)
-								{
-									if (*srcBuffer)
-										*dstBuffer = entry.texture.palette->colour[*srcBuffer].colour;
-									srcBuffer += finc;
-									dstBuffer++;
-								}
-								
-								srcBuffer += fpitch;
-								dstBuffer += pitch - entry.dest.w;
+								const RENDERBATCH_SPRITE *sprite = &entry.batch.sprites->sprite[s];
+								BlitTexture(buffer, pitch, entry.batch.texture, entry.batch.palette, sprite->srcX, sprite->srcY, sprite->dest, false, false, &pixels);
 							}
 							break;
 						}
@@ -275,6 +404,10 @@ class SOFTWAREBUFFER
 							//Iterate through each pixel
 							T *dstBuffer = buffer + (entry.dest.x + entry.dest.y * pitch);
 							
+							#ifdef PERF_HUD
+								pixels += entry.dest.w * entry.dest.h;
+							#endif
+							
 							while (entry.dest.h-- > 0)
 							{
 								for (int x = 0; x < entry.dest.w; x++)
@@ -290,6 +423,8 @@ class SOFTWAREBUFFER
 					}
 				}
 			}
+			
+			PERF_ADD(pixelsWritten, pixels);
 		}
 
 };
@@ -305,10 +440,6 @@ struct RENDERSPEC
 	bool forceVsync, forceVsyncValue;
 };
 
-//Globals
-extern RENDERSPEC gRenderSpec;
-extern SOFTWAREBUFFER *gSoftwareBuffer;
-
 //Sub-system functions
 bool InitializeRender();
 void QuitRender();
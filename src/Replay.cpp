@@ -0,0 +1,214 @@
+#include <string.h>
+#include "Replay.h"
+#include "Engine.h"
+#include "Filesystem.h"
+#include "MathUtil.h"
+#include "Error.h"
+#include "Log.h"
+
+//Hash of our build (FNV-1a)
+static uint32_t GetBuildHash()
+{
+	uint32_t hash = 0x811C9DC5;
+	for (const char *i = REPLAY_BUILD; *i != '\0'; i++)
+		hash = (hash ^ (uint8_t)*i) * 0x01000193;
+	return hash;
+}
+
+//Control mask packing
+uint8_t PackControlMask(const CONTROLMASK *mask)
+{
+	return (mask->start << 0) | (mask->a << 1) | (mask->b << 2) | (mask->c << 3)
+		 | (mask->right << 4) | (mask->left << 5) | (mask->down << 6) | (mask->up << 7);
+}
+
+CONTROLMASK UnpackControlMask(uint8_t buttons)
+{
+	CONTROLMASK mask;
+	mask.start = (buttons & 0x01) != 0;
+	mask.a = (buttons & 0x02) != 0;
+	mask.b = (buttons & 0x04) != 0;
+	mask.c = (buttons & 0x08) != 0;
+	mask.right = (buttons & 0x10) != 0;
+	mask.left = (buttons & 0x20) != 0;
+	mask.down = (buttons & 0x40) != 0;
+	mask.up = (buttons & 0x80) != 0;
+	return mask;
+}
+
+//Constructors and destructor
+REPLAY::REPLAY(int level, int characterSet, size_t controllers) : mode(REPLAYMODE_RECORD)
+{
+	//Set up our header, the random seed is taken now, so we must be created before the level is loaded
+	header.level = level;
+	header.characterSet = characterSet;
+	header.randomSeed = GetRandomSeed();
+	header.build = GetBuildHash();
+	header.controllers = mmin(controllers, (size_t)CONTROLLERS);
+	header.frames = 0;
+}
+
+REPLAY::REPLAY(std::string path) : mode(REPLAYMODE_PLAY)
+{
+	LOG(("Loading replay from %s... ", path.c_str()));
+	
+	//Open our replay file
+	FS_FILE fp(path, "rb");
+	if (fp.fail)
+	{
+		Error(fail = fp.fail);
+		return;
+	}
+	
+	//Read and validate our header
+	if (fp.ReadBE32() != REPLAY_SIGNATURE || fp.ReadBE32() != REPLAY_VERSION)
+	{
+		Error(fail = "Not a replay (invalid header)");
+		return;
+	}
+	
+	header.level = fp.ReadBE32();
+	header.characterSet = fp.ReadBE32();
+	header.randomSeed = fp.ReadBE32();
+	header.build = fp.ReadBE32();
+	header.controllers = fp.ReadBE32();
+	header.frames = fp.ReadBE32();
+	
+	if (header.controllers > CONTROLLERS)
+	{
+		Error(fail = "Replay has too many controllers");
+		return;
+	}
+	
+	if (header.build != GetBuildHash())
+	{
+		Warn("Replay was recorded on a different build, it may desync");
+	}
+	
+	//Read our stream
+	streamSize = streamCapacity = fp.GetSize() - fp.Tell();
+	stream = new uint8_t[streamSize];
+	if (streamSize != 0)
+		memcpy(stream, fp.GetSpan(streamSize), streamSize);
+	
+	LOG(("Success! (%d frames, %d bytes)\n", (int)header.frames, (int)streamSize));
+}
+
+REPLAY::~REPLAY()
+{
+	//Free our stream
+	delete[] stream;
+}
+
+//Recording functions
+void REPLAY::PushByte(uint8_t value)
+{
+	//Grow our stream if full
+	if (streamSize >= streamCapacity)
+	{
+		streamCapacity = mmax(streamCapacity * 2, (size_t)0x400);
+		uint8_t *newStream = new uint8_t[streamCapacity];
+		memcpy(newStream, stream, streamSize);
+		delete[] stream;
+		stream = newStream;
+	}
+	
+	stream[streamSize++] = value;
+}
+
+void REPLAY::EndRun()
+{
+	if (runLength == 0)
+		return;
+	
+	//Write our run's length, then its buttons
+	for (; runLength >= 0x80; runLength >>= 7)
+		PushByte((runLength & 0x7F) | 0x80);
+	PushByte(runLength);
+	runLength = 0;
+	
+	for (uint32_t i = 0; i < header.controllers; i++)
+		PushByte(runButtons[i]);
+}
+
+void REPLAY::Record()
+{
+	//Get each controller's held buttons
+	uint8_t buttons[CONTROLLERS];
+	for (uint32_t i = 0; i < header.controllers; i++)
+		buttons[i] = PackControlMask(&gEngine->controller[i].held);
+	
+	//Extend our current run if nothing's changed, otherwise start a new one
+	if (runLength == 0 || runLength == UINT32_MAX || memcmp(buttons, runButtons, header.controllers) != 0)
+	{
+		EndRun();
+		memcpy(runButtons, buttons, header.controllers);
+	}
+	
+	runLength++;
+	header.frames++;
+}
+
+bool REPLAY::Save(std::string path)
+{
+	LOG(("Saving replay to %s... ", path.c_str()));
+	
+	//Write our current run
+	EndRun();
+	
+	//Write our header and stream
+	FS_FILE fp(path, "wb");
+	if (fp.fail)
+		return Error(fp.fail);
+	
+	fp.WriteBE32(REPLAY_SIGNATURE);
+	fp.WriteBE32(REPLAY_VERSION);
+	fp.WriteBE32(header.level);
+	fp.WriteBE32(header.characterSet);
+	fp.WriteBE32(header.randomSeed);
+	fp.WriteBE32(header.build);
+	fp.WriteBE32(header.controllers);
+	fp.WriteBE32(header.frames);
+	fp.Write(stream, 1, streamSize);
+	
+	LOG(("Success! (%d frames, %d bytes)\n", (int)header.frames, (int)streamSize));
+	return false;
+}
+
+//Playing functions
+bool REPLAY::Play()
+{
+	//Start our next run once this one's done
+	if (runLength == 0 && !finished)
+	{
+		uint32_t length = 0;
+		for (int shift = 0; position < streamSize && shift < 32; shift += 7)
+		{
+			uint8_t value = stream[position++];
+			length |= (uint32_t)(value & 0x7F) << shift;
+			if (!(value & 0x80))
+				break;
+		}
+		
+		if (length == 0 || position + header.controllers > streamSize)
+		{
+			//We've reached the end of the replay, release every button
+			finished = true;
+			memset(runButtons, 0, sizeof(runButtons));
+		}
+		else
+		{
+			runLength = length;
+			memcpy(runButtons, stream + position, header.controllers);
+			position += header.controllers;
+		}
+	}
+	
+	//Apply this run's buttons to our controllers
+	for (size_t i = 0; i < CONTROLLERS; i++)
+		gEngine->controller[i].SetHeld((i < header.controllers) ? UnpackControlMask(runButtons[i]) : CONTROLMASK{});
+	
+	if (runLength != 0)
+		runLength--;
+	return finished;
+}
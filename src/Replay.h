@@ -0,0 +1,78 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "Input.h"
+
+//Build ID, set by the Makefile to the git commit we're built from
+#ifndef BUILD_ID
+	#define BUILD_ID	"unknown"
+#endif
+
+//Constants
+#define REPLAY_SIGNATURE	0x43535250	//"CSRP"
+#define REPLAY_VERSION		1
+#define REPLAY_BUILD		BUILD_ID	//Replays recorded on other builds are still played, but may desync
+
+//If the CUCKYSONIC_REPLAY environment variable is set, the given replay is played in place of the controllers, then the game exits
+//If the CUCKYSONIC_RECORD environment variable is set, the controllers are recorded to the given replay file (each level played overwrites it)
+
+//Replay modes
+enum REPLAYMODE
+{
+	REPLAYMODE_RECORD,
+	REPLAYMODE_PLAY,
+};
+
+//Replay header
+struct REPLAYHEADER
+{
+	uint32_t level;			//Level ID
+	uint32_t characterSet;	//Character set (index into GM_Game's character set list)
+	uint32_t randomSeed;	//Random number seed when the level was loaded
+	uint32_t build;			//Hash of REPLAY_BUILD the replay was recorded with
+	uint32_t controllers;	//Controllers recorded
+	uint32_t frames;		//Frames recorded
+};
+
+//Input replay, stores the held buttons of each controller every frame, as runs of identical frames
+class REPLAY
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Mode and header
+		REPLAYMODE mode;
+		REPLAYHEADER header;
+		
+		//Run-length encoded stream, each run is its frame count (7 bits per byte, lowest first, top bit set if there's another byte) followed by a byte of buttons per controller
+		uint8_t *stream = nullptr;
+		size_t streamSize = 0, streamCapacity = 0;
+		size_t position = 0;
+		
+		//Current run
+		uint8_t runButtons[CONTROLLERS] = {};
+		uint32_t runLength = 0;
+		
+		//Set once the whole replay's been played
+		bool finished = false;
+	
+	public:
+		REPLAY(int level, int characterSet, size_t controllers);	//Starts recording
+		REPLAY(std::string path);									//Loads a replay to play
+		~REPLAY();
+		
+		void Record();
+		bool Play();
+		bool Save(std::string path);
+	
+	private:
+		void PushByte(uint8_t value);
+		void EndRun();
+};
+
+//Control mask packing, start, a, b, c, right, left, down, and up from the lowest bit
+uint8_t PackControlMask(const CONTROLMASK *mask);
+CONTROLMASK UnpackControlMask(uint8_t buttons);
@@ -0,0 +1,427 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "RingManager.h"
+#include "Filesystem.h"
+#include "LevelCollision.h"
+#include "MathUtil.h"
+#include "Objects.h"
+#include "Audio.h"
+#include "Game.h"
+#include "Log.h"
+
+//Sonic 1 ring spawner offsets (upper nibble of subtype)
+static const int8_t sonic1RingOffset[16][2] = {
+	{ 0x10, 0x00},
+	{ 0x18, 0x00},
+	{ 0x20, 0x00},
+	{ 0x00, 0x10},
+	{ 0x00, 0x18},
+	{ 0x00, 0x20},
+	{ 0x10, 0x10},
+	{ 0x18, 0x18},
+	{ 0x20, 0x20},
+	{-0x10, 0x10},
+	{-0x18, 0x18},
+	{-0x20, 0x20},
+	{ 0x10, 0x08},
+	{ 0x18, 0x10},
+	{-0x10, 0x08},
+	{-0x18, 0x10},
+};
+
+//Constructor and destructor
+RINGMANAGER::RINGMANAGER() : ringBatch(RINGMANAGER_DRAW_RESERVE), bouncingRingBatch(RINGMANAGER_BOUNCINGRINGS), sparkleBatch(RINGMANAGER_SPARKLES)
+{
+	//Clear our bouncing rings and sparkles
+	memset(bouncingRing, 0, sizeof(bouncingRing));
+	memset(sparkle, 0, sizeof(sparkle));
+}
+
+RINGMANAGER::~RINGMANAGER()
+{
+	//Free our ring arrays
+	delete[] ring;
+	delete[] collected;
+}
+
+//Loading functions
+void RINGMANAGER::AddRing(int16_t x, int16_t y)
+{
+	//Grow our ring array if full
+	if (rings >= ringCapacity)
+	{
+		size_t newCapacity = mmax(ringCapacity * 2, (size_t)0x100);
+		uint32_t *newRing = new uint32_t[newCapacity];
+		memcpy(newRing, ring, rings * sizeof(uint32_t));
+		delete[] ring;
+		ring = newRing;
+		ringCapacity = newCapacity;
+	}
+	
+	ring[rings++] = ((uint32_t)(uint16_t)x << 16) | (uint16_t)y;
+}
+
+void RINGMANAGER::AddSonic1Rings(int16_t x, int16_t y, uint8_t subtype)
+{
+	//Get the amount of rings to make (lowest nibble of subtype)
+	int ringsToMake = (subtype & 0x7);
+	if (ringsToMake == 7)
+		ringsToMake = 6;
+	
+	for (int i = 0; i <= ringsToMake; i++)
+	{
+		AddRing(x, y);
+		
+		//Get next position
+		x += sonic1RingOffset[subtype >> 4][0];
+		y += sonic1RingOffset[subtype >> 4][1];
+	}
+}
+
+bool RINGMANAGER::LoadRingFile(std::string path)
+{
+	//Open our ring file
+	FS_FILE ringFile(path, "rb");
+	if (ringFile.fail != nullptr)
+	{
+		fail = ringFile.fail;
+		return true;
+	}
+	
+	//Read our ring data, each entry is a line of rings
+	size_t entries = ringFile.GetSize() / 4;
+	
+	for (size_t i = 0; i < entries; i++)
+	{
+		int16_t xPos = ringFile.ReadBE16();
+		int16_t word2 = ringFile.ReadBE16();
+		int16_t yPos = word2 & 0x0FFF;
+		
+		int type = (word2 & 0xF000) >> 12;
+		
+		for (int v = 0; v <= (type & 0x7); v++)
+		{
+			AddRing(xPos, yPos);
+			
+			//Offset next position
+			if (type & 0x8)
+				yPos += 0x18;
+			else
+				xPos += 0x18;
+		}
+	}
+	
+	return false;
+}
+
+static int CompareRing(const void *a, const void *b)
+{
+	uint32_t ringA = *((const uint32_t*)a);
+	uint32_t ringB = *((const uint32_t*)b);
+	return (ringA > ringB) - (ringA < ringB);
+}
+
+void RINGMANAGER::Sort()
+{
+	//Sort our rings by position, then allocate and clear our collected bitset
+	qsort(ring, rings, sizeof(uint32_t), CompareRing);
+	
+	delete[] collected;
+	collected = new uint32_t[(rings >> 5) + 1];
+	memset(collected, 0, ((rings >> 5) + 1) * sizeof(uint32_t));
+	
+	LOG(("Loaded %d rings\n", (int)rings));
+}
+
+//Get the first ring at or right of the given x position
+static size_t LowerBoundX(const uint32_t *ring, size_t start, size_t end, int x)
+{
+	while (start < end)
+	{
+		size_t middle = start + (end - start) / 2;
+		if ((int)(ring[middle] >> 16) < x)
+			start = middle + 1;
+		else
+			end = middle;
+	}
+	return start;
+}
+
+//Window function
+void RINGMANAGER::UpdateWindow(int16_t cameraX, int width)
+{
+	//Get the range rings are loaded in, this is the same range as object loads
+	int left = (int16_t)((cameraX - 0x80) & 0xFF80);
+	int right = left + upperRound(0x80 + width + 0x80, 0x80) + 0x7F;
+	
+	windowStart = LowerBoundX(ring, 0, rings, left);
+	windowEnd = LowerBoundX(ring, windowStart, rings, right + 1);
+}
+
+//Player interaction
+bool RINGMANAGER::TouchCheck(int16_t x, int16_t y, int16_t playerLeft, int16_t playerTop, int16_t playerWidth, int16_t playerHeight)
+{
+	//Check if our hitboxes are colliding (same as an object's touch check)
+	int16_t horizontalCheck = playerLeft - (x - RINGMANAGER_TOUCHSIZE);
+	int16_t verticalCheck = playerTop - (y - RINGMANAGER_TOUCHSIZE);
+	return horizontalCheck >= -playerWidth && horizontalCheck <= RINGMANAGER_TOUCHSIZE * 2 && verticalCheck >= -playerHeight && verticalCheck <= RINGMANAGER_TOUCHSIZE * 2;
+}
+
+void RINGMANAGER::Touch(PLAYER *player, int16_t playerLeft, int16_t playerTop, int16_t playerWidth, int16_t playerHeight)
+{
+	//Rings can't be collected shortly after getting hurt
+	if (player->invulnerabilityTime >= 90)
+		return;
+	
+	//Check the level rings in our window that are within our hitbox horizontally
+	for (size_t i = LowerBoundX(ring, windowStart, windowEnd, playerLeft - RINGMANAGER_TOUCHSIZE); i < windowEnd; i++)
+	{
+		int16_t x = ring[i] >> 16;
+		int16_t y = ring[i] & 0xFFFF;
+		if (x > playerLeft + playerWidth + RINGMANAGER_TOUCHSIZE)
+			break;
+		
+		if (!IsCollected(i) && TouchCheck(x, y, playerLeft, playerTop, playerWidth, playerHeight))
+		{
+			//Collect the ring
+			SetCollected(i);
+			AddToRings(1);
+			AddSparkle(x, y);
+		}
+	}
+	
+	//Check our bouncing rings
+	for (int i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+	{
+		BOUNCINGRING *thisRing = &bouncingRing[i];
+		if (!thisRing->active)
+			continue;
+		
+		int16_t x = thisRing->xLong >> 16;
+		int16_t y = thisRing->yLong >> 16;
+		
+		if (TouchCheck(x, y, playerLeft, playerTop, playerWidth, playerHeight))
+		{
+			//Collect the ring
+			thisRing->active = false;
+			AddToRings(1);
+			AddSparkle(x, y);
+		}
+	}
+}
+
+void RINGMANAGER::Attract(PLAYER *player, int radius)
+{
+	//Turn level rings within the given radius into attracted rings
+	for (size_t i = LowerBoundX(ring, windowStart, windowEnd, player->x.pos - radius); i < windowEnd; i++)
+	{
+		int16_t x = ring[i] >> 16;
+		int16_t y = ring[i] & 0xFFFF;
+		if (x > player->x.pos + radius)
+			break;
+		
+		int yDiff = y - player->y.pos + radius;
+		if (IsCollected(i) || yDiff < 0 || yDiff > radius * 2)
+			continue;
+		
+		//Remove this ring and create an attracted ring in its place
+		SetCollected(i);
+		
+		OBJECT *newObject = new OBJECT(&ObjAttractRing);
+		newObject->x.pos = x;
+		newObject->y.pos = y;
+		newObject->parentPlayer = player;
+		gEngine->level->LinkObject(newObject);
+	}
+}
+
+//Bouncing ring and sparkle functions
+void RINGMANAGER::AddBouncingRing(int16_t x, int16_t y, int16_t xVel, int16_t yVel, PLAYER *parentPlayer)
+{
+	//Use the first free bouncing ring, if there's none, this ring is lost
+	for (int i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+	{
+		BOUNCINGRING *thisRing = &bouncingRing[i];
+		if (thisRing->active)
+			continue;
+		
+		thisRing->active = true;
+		thisRing->xLong = x << 16;
+		thisRing->yLong = y << 16;
+		thisRing->xVel = xVel;
+		thisRing->yVel = yVel;
+		thisRing->animCount = 255;
+		thisRing->animAccum = 0;
+		thisRing->mappingFrame = 0;
+		thisRing->parentPlayer = parentPlayer;
+		return;
+	}
+}
+
+void RINGMANAGER::AddSparkle(int16_t x, int16_t y)
+{
+	//Use the first free sparkle, if there's none, don't sparkle
+	for (int i = 0; i < RINGMANAGER_SPARKLES; i++)
+	{
+		if (sparkle[i].active)
+			continue;
+		
+		sparkle[i].active = true;
+		sparkle[i].x = x;
+		sparkle[i].y = y;
+		sparkle[i].timer = 0;
+		return;
+	}
+}
+
+//Update and draw
+void RINGMANAGER::Update()
+{
+	//Update bouncing rings
+	for (int i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+	{
+		BOUNCINGRING *thisRing = &bouncingRing[i];
+		if (!thisRing->active)
+			continue;
+		
+		bool reverseGravity = thisRing->parentPlayer != nullptr && thisRing->parentPlayer->status.reverseGravity;
+		
+		//Move and fall
+		thisRing->xLong += thisRing->xVel * 0x100;
+		if (reverseGravity)
+			thisRing->yLong -= thisRing->yVel * 0x100;
+		else
+			thisRing->yLong += thisRing->yVel * 0x100;
+		thisRing->yVel += 0x18;
+		
+		if (((gEngine->level->frameCounter + i) & BOUNCINGRING_COLLISIONSTEP) == 0)
+		{
+			int16_t x = thisRing->xLong >> 16;
+			int16_t y = thisRing->yLong >> 16;
+			
+			//Check for collision with the floor or ceiling
+			int16_t checkVel = reverseGravity ? -thisRing->yVel : thisRing->yVel;
+			
+			if (checkVel >= 0)
+			{
+				int16_t distance = GetCollisionV(x, y + 8, COLLISIONLAYER_NORMAL_TOP, false, nullptr);
+				
+				//If touching the floor, bounce off
+				if (distance < 0)
+				{
+					thisRing->yLong += distance * 0x10000;
+					thisRing->yVel = thisRing->yVel * 3 / -4;
+				}
+			}
+		#ifndef BOUNCINGRING_ONLY_FLOOR
+			else
+			{
+				int16_t distance = GetCollisionV(x, y - 8, COLLISIONLAYER_NORMAL_LRB, true, nullptr);
+				
+				//If touching a ceiling, bounce off
+				if (distance < 0)
+				{
+					thisRing->yLong -= distance * 0x10000;
+					thisRing->yVel = -thisRing->yVel;
+				}
+			}
+			
+			//Check for collision with walls
+			if (thisRing->xVel > 0)
+			{
+				int16_t distance = GetCollisionH(x + 8, y, COLLISIONLAYER_NORMAL_LRB, false, nullptr);
+				
+				//If touching a wall, bounce off
+				if (distance < 0)
+				{
+					thisRing->xLong += distance * 0x10000;
+					thisRing->xVel = thisRing->xVel / -2;
+				}
+			}
+			else if (thisRing->xVel < 0)
+			{
+				int16_t distance = GetCollisionH(x - 8, y, COLLISIONLAYER_NORMAL_LRB, true, nullptr);
+				
+				//If touching a wall, bounce off
+				if (distance < 0)
+				{
+					thisRing->xLong -= distance * 0x10000;
+					thisRing->xVel = thisRing->xVel / -2;
+				}
+			}
+		#endif
+		}
+		
+		//Animate
+		if (thisRing->animCount != 0)
+		{
+			thisRing->animAccum += thisRing->animCount--;
+			thisRing->mappingFrame = (thisRing->animAccum >> 9) & 0x3;
+		}
+		
+		//Check for deletion
+		if (thisRing->animCount == 0)
+			thisRing->active = false;
+	}
+	
+	//Update sparkles
+	for (int i = 0; i < RINGMANAGER_SPARKLES; i++)
+		if (sparkle[i].active && ++sparkle[i].timer >= 4 * RINGMANAGER_SPARKLEFRAMES)
+			sparkle[i].active = false;
+}
+
+void RINGMANAGER::DrawRing(RENDERBATCH *batch, int16_t x, int16_t y, uint8_t frame)
+{
+	//Don't draw if off-screen
+	int16_t xPos = x - gEngine->level->camera->xPos;
+	int16_t yPos = y - gEngine->level->camera->yPos;
+	if (xPos < -8 || xPos > gEngine->renderSpec.width + 8 || yPos < -8 || yPos > gEngine->renderSpec.height + 8)
+		return;
+	
+	//Add our ring to the batch using the given frame
+	POINT mapOrig = mappings->origin[frame];
+	gEngine->softwareBuffer->BatchTexture(batch, &mappings->rect[frame], xPos - mapOrig.x, yPos - mapOrig.y);
+}
+
+void RINGMANAGER::Draw()
+{
+	//Don't draw if we don't have our graphics
+	if (texture == nullptr || mappings == nullptr || mappings->size < 8)
+		return;
+	
+	//Start our batches (last frame's have been rendered by now)
+	ringBatch.Clear();
+	bouncingRingBatch.Clear();
+	sparkleBatch.Clear();
+	
+	//Draw the level rings in our window
+	uint8_t frame = (gEngine->level->frameCounter >> 3) & 0x3;
+	for (size_t i = windowStart; i < windowEnd; i++)
+		if (!IsCollected(i))
+			DrawRing(&ringBatch, ring[i] >> 16, ring[i] & 0xFFFF, frame);
+	
+	//Draw bouncing rings
+	for (int i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+	{
+		BOUNCINGRING *thisRing = &bouncingRing[i];
+		if (!thisRing->active)
+			continue;
+	
+	#ifdef BOUNCINGRING_BLINK
+		if (thisRing->animCount > 60 || gEngine->level->frameCounter & (thisRing->animCount > 30 ? 0x4 : 0x2))
+	#endif
+			DrawRing(&bouncingRingBatch, thisRing->xLong >> 16, thisRing->yLong >> 16, thisRing->mappingFrame);
+	}
+	
+	//Draw sparkles
+	for (int i = 0; i < RINGMANAGER_SPARKLES; i++)
+		if (sparkle[i].active)
+			DrawRing(&sparkleBatch, sparkle[i].x, sparkle[i].y, 4 + sparkle[i].timer / RINGMANAGER_SPARKLEFRAMES);
+	
+	//Queue our batches
+	SOFTWAREBUFFER *buffer = gEngine->softwareBuffer;
+	buffer->DrawBatch(texture, texture->loadedPalette, &ringBatch, gEngine->level->GetObjectLayer(false, 2));
+	buffer->DrawBatch(texture, texture->loadedPalette, &bouncingRingBatch, gEngine->level->GetObjectLayer(false, 3));
+	buffer->DrawBatch(texture, texture->loadedPalette, &sparkleBatch, gEngine->level->GetObjectLayer(false, 1));
+}
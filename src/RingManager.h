@@ -0,0 +1,103 @@
+#pragma once
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Render.h"
+#include "Mappings.h"
+
+//Declare the player class
+class PLAYER;
+
+//Constants
+#define RINGMANAGER_BOUNCINGRINGS	32	//Most bouncing rings that can exist at once (same as the amount of rings a player can lose)
+#define RINGMANAGER_SPARKLES		64	//Most collected ring sparkles that can exist at once
+
+#define RINGMANAGER_TOUCHSIZE		6	//Touch hitbox radius of a ring
+#define RINGMANAGER_SPARKLEFRAMES	6	//Frames each sparkle mapping frame is displayed for
+#define RINGMANAGER_DRAW_RESERVE	0x80	//Level rings on-screen at once reserved for in our draw batch
+
+//#define BOUNCINGRING_BLINK				//When set, the rings will blink shortly before despawning
+//#define BOUNCINGRING_ONLY_FLOOR			//When set, like in the originals, bouncing rings will only check for floor collision
+
+#define BOUNCINGRING_COLLISIONSTEP 0x0	//0x0 - check every frame, 0x3 - Sonic 1 checking every 4 frames, 0x7 - Sonic 2 checking every 8 frames
+
+//Bouncing ring (lost by a player)
+struct BOUNCINGRING
+{
+	bool active;
+	int32_t xLong, yLong;
+	int16_t xVel, yVel;
+	uint8_t animCount;
+	uint16_t animAccum;
+	uint8_t mappingFrame;
+	PLAYER *parentPlayer;
+};
+
+//Collected ring sparkle
+struct RINGSPARKLE
+{
+	bool active;
+	int16_t x, y;
+	uint8_t timer;
+};
+
+//Ring manager, stores the level's rings as sorted packed positions rather than objects
+class RINGMANAGER
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Level rings, packed as (x << 16) | y and sorted by x then y
+		uint32_t *ring = nullptr;
+		size_t rings = 0, ringCapacity = 0;
+		uint32_t *collected = nullptr;	//Bitset of rings that have been collected
+		
+		//Rings within the object load range of the camera
+		size_t windowStart = 0, windowEnd = 0;
+		
+		//Bouncing rings and sparkles
+		BOUNCINGRING bouncingRing[RINGMANAGER_BOUNCINGRINGS];
+		RINGSPARKLE sparkle[RINGMANAGER_SPARKLES];
+		
+		//Graphics
+		TEXTURE *texture = nullptr;
+		MAPPINGS *mappings = nullptr;
+		
+		//Draw batches, every ring on a layer is drawn by one render queue entry
+		RENDERBATCH ringBatch;
+		RENDERBATCH bouncingRingBatch;
+		RENDERBATCH sparkleBatch;
+	
+	public:
+		RINGMANAGER();
+		~RINGMANAGER();
+		
+		//Loading functions
+		void AddRing(int16_t x, int16_t y);
+		void AddSonic1Rings(int16_t x, int16_t y, uint8_t subtype);
+		bool LoadRingFile(std::string path);
+		void Sort();
+		
+		//Window function
+		void UpdateWindow(int16_t cameraX, int width);
+		
+		//Player interaction
+		void Touch(PLAYER *player, int16_t playerLeft, int16_t playerTop, int16_t playerWidth, int16_t playerHeight);
+		void Attract(PLAYER *player, int radius);
+		
+		//Bouncing ring and sparkle functions
+		void AddBouncingRing(int16_t x, int16_t y, int16_t xVel, int16_t yVel, PLAYER *parentPlayer);
+		void AddSparkle(int16_t x, int16_t y);
+		
+		//Update and draw
+		void Update();
+		void Draw();
+	
+	private:
+		bool IsCollected(size_t i) { return (collected[i >> 5] & (1 << (i & 0x1F))) != 0; }
+		void SetCollected(size_t i) { collected[i >> 5] |= (1 << (i & 0x1F)); }
+		bool TouchCheck(int16_t x, int16_t y, int16_t playerLeft, int16_t playerTop, int16_t playerWidth, int16_t playerHeight);
+		void DrawRing(RENDERBATCH *batch, int16_t x, int16_t y, uint8_t frame);
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+//Single producer, single consumer lock-free queue (one thread pushes, one other thread pops)
+template <typename T, uint32_t SIZE> class RINGQUEUE
+{
+	public:
+		T entry[SIZE];
+		std::atomic<uint32_t> write;
+		std::atomic<uint32_t> read;
+	
+	public:
+		//Constructor
+		RINGQUEUE() : write(0), read(0) { return; }
+		
+		//Producer functions
+		inline bool push(const T &value)
+		{
+			//Fail if full
+			uint32_t thisWrite = write.load(std::memory_order_relaxed);
+			if (thisWrite - read.load(std::memory_order_acquire) >= SIZE)
+				return true;
+			
+			//Write our entry then publish it
+			entry[thisWrite % SIZE] = value;
+			write.store(thisWrite + 1, std::memory_order_release);
+			return false;
+		}
+		
+		//Consumer functions
+		inline bool pop(T *value)
+		{
+			//Fail if empty
+			uint32_t thisRead = read.load(std::memory_order_relaxed);
+			if (thisRead == write.load(std::memory_order_acquire))
+				return true;
+			
+			//Read our entry then release it to the producer
+			*value = entry[thisRead % SIZE];
+			read.store(thisRead + 1, std::memory_order_release);
+			return false;
+		}
+		
+		inline void clear()
+		{
+			read.store(write.load(std::memory_order_acquire), std::memory_order_release);
+		}
+};
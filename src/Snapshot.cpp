@@ -0,0 +1,577 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "Snapshot.h"
+#include "Engine.h"
+#include "Level.h"
+#include "Replay.h"
+#include "MathUtil.h"
+#include "Error.h"
+#include "Log.h"
+
+//Linked list helpers, lists copied along with an object (or detached from the level while restoring) are taken over rather than freed
+template <typename T> static void ForgetList(LINKEDLIST<T> *list)
+{
+	list->head = nullptr;
+	list->tail = nullptr;
+	list->llSize = 0;
+	list->spare = nullptr;
+	list->spareOwner = nullptr;
+}
+
+template <typename T> static void SwapList(LINKEDLIST<T> *a, LINKEDLIST<T> *b)
+{
+	LL_NODE<T> *head = a->head, *tail = a->tail;
+	size_t llSize = a->llSize;
+	a->head = b->head;
+	a->tail = b->tail;
+	a->llSize = b->llSize;
+	b->head = head;
+	b->tail = tail;
+	b->llSize = llSize;
+}
+
+//Object table sorting
+static int CompareObjectEntry(const void *a, const void *b)
+{
+	uintptr_t objectA = (uintptr_t)((const SNAPSHOT_OBJECTENTRY*)a)->object;
+	uintptr_t objectB = (uintptr_t)((const SNAPSHOT_OBJECTENTRY*)b)->object;
+	return (objectA > objectB) - (objectA < objectB);
+}
+
+//Destructor
+SNAPSHOT::~SNAPSHOT()
+{
+	delete[] buffer;
+	delete[] object;
+	delete[] sorted;
+	delete[] player;
+}
+
+//Buffer functions
+void *SNAPSHOT::Write(const void *data, size_t dataSize)
+{
+	//Grow our buffer if this record doesn't fit (doubling, so it only grows a few times before every save fits)
+	size_t end = size + upperRound(dataSize, SNAPSHOT_ALIGN);
+	if (end > capacity)
+	{
+		size_t newCapacity = mmax(capacity * 2, end);
+		uint8_t *newBuffer = new uint8_t[newCapacity];
+		if (buffer != nullptr)
+			memcpy(newBuffer, buffer, size);
+		delete[] buffer;
+		buffer = newBuffer;
+		capacity = newCapacity;
+	}
+	
+	//Copy the record, and return it so handles can be written over its pointers (only valid until the next write)
+	void *record = buffer + size;
+	memcpy(record, data, dataSize);
+	size = end;
+	return record;
+}
+
+const void *SNAPSHOT::Read(size_t dataSize)
+{
+	//Records are read back in the order they were written
+	const void *record = buffer + readPosition;
+	readPosition += upperRound(dataSize, SNAPSHOT_ALIGN);
+	return record;
+}
+
+//Handle functions
+void SNAPSHOT::GetPlayers()
+{
+	//Get every player by list index
+	LEVEL *thisLevel = gEngine->level;
+	if (thisLevel->playerList.size() > playerCapacity)
+	{
+		delete[] player;
+		player = new PLAYER*[playerCapacity = thisLevel->playerList.size()];
+	}
+	
+	players = 0;
+	for (LL_NODE<PLAYER*> *node = thisLevel->playerList.head; node != nullptr; node = node->next)
+		player[players++] = node->node_entry;
+}
+
+void SNAPSHOT::GrowObjects(size_t count)
+{
+	//Grow our object table to fit the given amount of objects
+	if (count <= objectCapacity)
+		return;
+	
+	size_t newCapacity = mmax(objectCapacity * 2, count);
+	OBJECT **newObject = new OBJECT*[newCapacity];
+	for (size_t i = 0; i < objects; i++)
+		newObject[i] = object[i];
+	
+	delete[] object;
+	delete[] sorted;
+	object = newObject;
+	sorted = new SNAPSHOT_OBJECTENTRY[newCapacity];
+	objectCapacity = newCapacity;
+}
+
+void SNAPSHOT::NumberObject(OBJECT *numberObject)
+{
+	//Give the object the next handle, then its children (in the order they're saved)
+	GrowObjects(objects + 1);
+	object[objects++] = numberObject;
+	
+	for (LL_NODE<OBJECT*> *node = numberObject->children.head; node != nullptr; node = node->next)
+		NumberObject(node->node_entry);
+}
+
+uintptr_t SNAPSHOT::ObjectHandle(OBJECT *pointer)
+{
+	//Find the object in our sorted table, objects that aren't in it (nullptr, or already deleted) have no handle
+	size_t low = 0, high = objects;
+	while (low < high)
+	{
+		size_t middle = (low + high) / 2;
+		if ((uintptr_t)sorted[middle].object < (uintptr_t)pointer)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	
+	if (pointer != nullptr && low < objects && sorted[low].object == pointer)
+		return sorted[low].handle;
+	return 0;
+}
+
+uintptr_t SNAPSHOT::PlayerHandle(PLAYER *pointer)
+{
+	for (size_t i = 0; i < players; i++)
+		if (player[i] == pointer)
+			return SNAPSHOT_HANDLE_PLAYER | i;
+	return 0;
+}
+
+uintptr_t SNAPSHOT::ParentHandle(void *pointer)
+{
+	//Parents can be either players or objects
+	if (pointer == nullptr)
+		return 0;
+	uintptr_t handle = PlayerHandle((PLAYER*)pointer);
+	return (handle != 0) ? handle : ObjectHandle((OBJECT*)pointer);
+}
+
+OBJECT *SNAPSHOT::HandleObject(uintptr_t handle)
+{
+	if (handle == 0 || (handle & SNAPSHOT_HANDLE_PLAYER) || handle > objects)
+		return nullptr;
+	return object[handle - 1];
+}
+
+PLAYER *SNAPSHOT::HandlePlayer(uintptr_t handle)
+{
+	if (!(handle & SNAPSHOT_HANDLE_PLAYER) || (handle & ~(uintptr_t)SNAPSHOT_HANDLE_PLAYER) >= players)
+		return nullptr;
+	return player[handle & ~(uintptr_t)SNAPSHOT_HANDLE_PLAYER];
+}
+
+void *SNAPSHOT::HandleParent(uintptr_t handle)
+{
+	if (handle & SNAPSHOT_HANDLE_PLAYER)
+		return (void*)HandlePlayer(handle);
+	return (void*)HandleObject(handle);
+}
+
+//Record functions
+void SNAPSHOT::SavePalette(PALETTE *palette)
+{
+	//Save the colour count, then the colours (textures without a palette have no colours)
+	size_t colours = (palette != nullptr) ? palette->colours : 0;
+	Write(&colours, sizeof(colours));
+	if (colours != 0)
+		Write(palette->colour, colours * sizeof(COLOUR));
+}
+
+void SNAPSHOT::RestorePalette(PALETTE *palette)
+{
+	//Restore the colours, unless the palette's changed size since (the texture's been reloaded)
+	size_t colours = *((const size_t*)Read(sizeof(size_t)));
+	if (colours == 0)
+		return;
+	
+	const void *colour = Read(colours * sizeof(COLOUR));
+	if (palette != nullptr && palette->colours == colours)
+		memcpy(palette->colour, colour, colours * sizeof(COLOUR));
+}
+
+void SNAPSHOT::SaveObject(OBJECT *saveObject)
+{
+	//Save the object itself, with a handle in place of its parent (its other pointers are level assets, or re-made when restored)
+	OBJECT *saved = (OBJECT*)Write(saveObject, sizeof(OBJECT));
+	saved->parent = (void*)ParentHandle(saveObject->parent);
+	
+	//Save our scratch memory, player contact overflow, and draw instances (the saved copy has their sizes)
+	if (saveObject->scratch != nullptr)
+		Write(saveObject->scratch, saveObject->scratchSize);
+	if (saveObject->playerContact.overflow != nullptr)
+		Write(saveObject->playerContact.overflow, saveObject->playerContact.overflowSize * sizeof(OBJECT_CONTACT));
+	for (LL_NODE<OBJECT_DRAWINSTANCE> *node = saveObject->drawInstances.head; node != nullptr; node = node->next)
+		Write(&node->node_entry, sizeof(OBJECT_DRAWINSTANCE));
+	
+	//Save our children
+	for (LL_NODE<OBJECT*> *node = saveObject->children.head; node != nullptr; node = node->next)
+		SaveObject(node->node_entry);
+}
+
+OBJECT *SNAPSHOT::RestoreObject()
+{
+	//Re-create the object from its saved copy
+	const OBJECT *saved = (const OBJECT*)Read(sizeof(OBJECT));
+	OBJECT *restored = new OBJECT(nullptr);
+	memcpy((void*)restored, (const void*)saved, sizeof(OBJECT));
+	object[objects++] = restored;
+	
+	//The copy's lists refer to the saved object's nodes, and its grid and job state to the frame it was saved on, so start them fresh
+	ForgetList(&restored->drawInstances);
+	ForgetList(&restored->children);
+	restored->grid = OBJECTGRID_ENTRY();
+	restored->job = nullptr;
+	
+	//Restore our scratch memory, player contact overflow, and draw instances
+	if (saved->scratch != nullptr)
+	{
+		restored->scratch = malloc(saved->scratchSize);
+		memcpy(restored->scratch, Read(saved->scratchSize), saved->scratchSize);
+	}
+	
+	if (saved->playerContact.overflow != nullptr)
+	{
+		restored->playerContact.overflow = new OBJECT_CONTACT[saved->playerContact.overflowSize];
+		memcpy((void*)restored->playerContact.overflow, Read(saved->playerContact.overflowSize * sizeof(OBJECT_CONTACT)), saved->playerContact.overflowSize * sizeof(OBJECT_CONTACT));
+	}
+	
+	for (size_t i = 0; i < saved->drawInstances.llSize; i++)
+		restored->drawInstances.link_back(*((const OBJECT_DRAWINSTANCE*)Read(sizeof(OBJECT_DRAWINSTANCE))));
+	
+	//Restore our children
+	for (size_t i = 0; i < saved->children.llSize; i++)
+		restored->children.link_back(RestoreObject());
+	return restored;
+}
+
+//Save and restore functions
+bool SNAPSHOT::Save()
+{
+	//Start a new snapshot of the current level
+	level = gEngine->level;
+	size = 0;
+	fail = nullptr;
+	
+	//Get our players, and number our objects
+	GetPlayers();
+	
+	objects = 0;
+	for (LL_NODE<OBJECT*> *node = level->objectList.head; node != nullptr; node = node->next)
+		NumberObject(node->node_entry);
+	for (LL_NODE<OBJECT*> *node = level->coreObjectList.head; node != nullptr; node = node->next)
+		NumberObject(node->node_entry);
+	
+	for (size_t i = 0; i < objects; i++)
+	{
+		sorted[i].object = object[i];
+		sorted[i].handle = (uint32_t)(i + 1);
+	}
+	qsort(sorted, objects, sizeof(SNAPSHOT_OBJECTENTRY), CompareObjectEntry);
+	
+	//Write our header
+	SNAPSHOT_HEADER header;
+	header.signature = SNAPSHOT_SIGNATURE;
+	header.players = (uint32_t)players;
+	header.objects = (uint32_t)objects;
+	header.topObjects = (uint32_t)level->objectList.size();
+	header.coreObjects = (uint32_t)level->coreObjectList.size();
+	header.objectLoads = (uint32_t)level->objectLoadList.size();
+	header.palettes = 2 + (uint32_t)level->objTextureCache.size();
+	Write(&header, sizeof(header));
+	
+	//Save our engine state
+	SNAPSHOT_ENGINE engine = {};
+	engine.score = gEngine->score;
+	engine.nextScoreReward = gEngine->nextScoreReward;
+	engine.time = gEngine->time;
+	engine.rings = gEngine->rings;
+	engine.nextRingReward = gEngine->nextRingReward;
+	engine.lives = gEngine->lives;
+	engine.randomSeed = gEngine->randomSeed;
+	engine.levelSpecific = gEngine->levelSpecific;
+	
+	for (size_t i = 0; i < CONTROLLERS; i++)
+	{
+		engine.held[i] = gEngine->controller[i].held;
+		engine.lastHeld[i] = gEngine->controller[i].lastHeld;
+		engine.press[i] = gEngine->controller[i].press;
+	}
+	
+	if ((engine.replay = (gEngine->replay != nullptr)) == true)
+	{
+		engine.replayStreamSize = gEngine->replay->streamSize;
+		engine.replayPosition = gEngine->replay->position;
+		memcpy(engine.replayRunButtons, gEngine->replay->runButtons, sizeof(engine.replayRunButtons));
+		engine.replayRunLength = gEngine->replay->runLength;
+		engine.replayFrames = gEngine->replay->header.frames;
+		engine.replayFinished = gEngine->replay->finished;
+	}
+	Write(&engine, sizeof(engine));
+	
+	//Save our level state
+	SNAPSHOT_LEVEL levelState = {};
+	memcpy(levelState.oscillateDirection, level->oscillateDirection, sizeof(levelState.oscillateDirection));
+	memcpy(levelState.oscillate, level->oscillate, sizeof(levelState.oscillate));
+	
+	levelState.leftBoundary = level->leftBoundary;
+	levelState.rightBoundary = level->rightBoundary;
+	levelState.topBoundary = level->topBoundary;
+	levelState.bottomBoundary = level->bottomBoundary;
+	levelState.leftBoundaryTarget = level->leftBoundaryTarget;
+	levelState.rightBoundaryTarget = level->rightBoundaryTarget;
+	levelState.topBoundaryTarget = level->topBoundaryTarget;
+	levelState.bottomBoundaryTarget = level->bottomBoundaryTarget;
+	levelState.dynamicEventRoutine = level->dynamicEventRoutine;
+	
+	levelState.frameCounter = level->frameCounter;
+	levelState.updateTime = level->updateTime;
+	levelState.updateStage = level->updateStage;
+	levelState.fading = level->fading;
+	levelState.isFadingIn = level->isFadingIn;
+	levelState.specialFade = level->specialFade;
+	
+	if (level->camera != nullptr)
+	{
+		levelState.cameraX = level->camera->xPos;
+		levelState.cameraY = level->camera->yPos;
+		levelState.cameraXPan = level->camera->xPan;
+		levelState.cameraYPan = level->camera->yPan;
+		levelState.cameraLookPan = level->camera->lookPan;
+		levelState.cameraLookTimer = level->camera->lookTimer;
+		levelState.cameraShake = level->camera->shake;
+	}
+	
+	if (level->titleCard != nullptr)
+	{
+		levelState.titleCardActiveLock = level->titleCard->activeLock;
+		levelState.titleCardFrame = level->titleCard->frame;
+		levelState.titleCardFocusX = level->titleCard->focusX;
+		levelState.titleCardFocusY = level->titleCard->focusY;
+		memcpy(levelState.titleCardLine, level->titleCard->line, sizeof(levelState.titleCardLine));
+	}
+	
+	RINGMANAGER *ringManager = level->ringManager;
+	levelState.ringWindowStart = ringManager->windowStart;
+	levelState.ringWindowEnd = ringManager->windowEnd;
+	memcpy(levelState.bouncingRing, ringManager->bouncingRing, sizeof(levelState.bouncingRing));
+	memcpy(levelState.ringSparkle, ringManager->sparkle, sizeof(levelState.ringSparkle));
+	for (size_t i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+		levelState.bouncingRing[i].parentPlayer = (PLAYER*)PlayerHandle(ringManager->bouncingRing[i].parentPlayer);
+	Write(&levelState, sizeof(levelState));
+	
+	if (ringManager->collected != nullptr)
+		Write(ringManager->collected, ((ringManager->rings >> 5) + 1) * sizeof(uint32_t));
+	
+	//Save our palettes (the same ones fades change)
+	SavePalette((level->tileTexture != nullptr) ? level->tileTexture->loadedPalette : nullptr);
+	SavePalette((level->background != nullptr) ? level->background->texture->loadedPalette : nullptr);
+	for (LL_NODE<TEXTURE*> *node = level->objTextureCache.head; node != nullptr; node = node->next)
+		SavePalette(node->node_entry->loadedPalette);
+	
+	//Save our objects
+	for (LL_NODE<OBJECT*> *node = level->objectList.head; node != nullptr; node = node->next)
+		SaveObject(node->node_entry);
+	for (LL_NODE<OBJECT*> *node = level->coreObjectList.head; node != nullptr; node = node->next)
+		SaveObject(node->node_entry);
+	
+	//Save our players, with handles in place of the objects and players they refer to
+	for (size_t i = 0; i < players; i++)
+	{
+		PLAYER *saved = (PLAYER*)Write(player[i], sizeof(PLAYER));
+		saved->interact = (OBJECT*)ObjectHandle(player[i]->interact);
+		saved->cpuInteract = (OBJECT*)ObjectHandle(player[i]->cpuInteract);
+		saved->spindashDust = (OBJECT*)ObjectHandle(player[i]->spindashDust);
+		saved->skidDust = (OBJECT*)ObjectHandle(player[i]->skidDust);
+		saved->barrierObject = (OBJECT*)ObjectHandle(player[i]->barrierObject);
+		for (int v = 0; v < INVINCIBILITYSTARS; v++)
+			saved->invincibilityStarObject[v] = (OBJECT*)ObjectHandle(player[i]->invincibilityStarObject[v]);
+		saved->follow = (PLAYER*)PlayerHandle(player[i]->follow);
+	}
+	
+	//Save our object loads
+	for (LL_NODE<OBJECT_LOAD*> *node = level->objectLoadList.head; node != nullptr; node = node->next)
+	{
+		OBJECT_LOAD *saved = (OBJECT_LOAD*)Write(node->node_entry, sizeof(OBJECT_LOAD));
+		saved->loaded = (OBJECT*)ObjectHandle(node->node_entry->loaded);
+	}
+	return false;
+}
+
+bool SNAPSHOT::Restore()
+{
+	//We can only be restored into the level we were saved from
+	LEVEL *thisLevel = gEngine->level;
+	if (level == nullptr || level != thisLevel)
+		return Error(fail = "Snapshot wasn't saved from the current level");
+	
+	readPosition = 0;
+	GetPlayers();
+	
+	const SNAPSHOT_HEADER *header = (const SNAPSHOT_HEADER*)Read(sizeof(SNAPSHOT_HEADER));
+	if (header->signature != SNAPSHOT_SIGNATURE || header->players != players)
+		return Error(fail = "Snapshot doesn't match the current level's players");
+	
+	//Restore our engine state
+	const SNAPSHOT_ENGINE *engine = (const SNAPSHOT_ENGINE*)Read(sizeof(SNAPSHOT_ENGINE));
+	gEngine->score = engine->score;
+	gEngine->nextScoreReward = engine->nextScoreReward;
+	gEngine->time = engine->time;
+	gEngine->rings = engine->rings;
+	gEngine->nextRingReward = engine->nextRingReward;
+	gEngine->lives = engine->lives;
+	gEngine->randomSeed = engine->randomSeed;
+	gEngine->levelSpecific = engine->levelSpecific;
+	
+	for (size_t i = 0; i < CONTROLLERS; i++)
+	{
+		gEngine->controller[i].held = engine->held[i];
+		gEngine->controller[i].lastHeld = engine->lastHeld[i];
+		gEngine->controller[i].press = engine->press[i];
+	}
+	
+	if (engine->replay && gEngine->replay != nullptr)
+	{
+		gEngine->replay->streamSize = engine->replayStreamSize;
+		gEngine->replay->position = engine->replayPosition;
+		memcpy(gEngine->replay->runButtons, engine->replayRunButtons, sizeof(engine->replayRunButtons));
+		gEngine->replay->runLength = engine->replayRunLength;
+		gEngine->replay->header.frames = engine->replayFrames;
+		gEngine->replay->finished = engine->replayFinished;
+	}
+	
+	//Restore our level state
+	const SNAPSHOT_LEVEL *levelState = (const SNAPSHOT_LEVEL*)Read(sizeof(SNAPSHOT_LEVEL));
+	memcpy(level->oscillateDirection, levelState->oscillateDirection, sizeof(levelState->oscillateDirection));
+	memcpy(level->oscillate, levelState->oscillate, sizeof(levelState->oscillate));
+	
+	level->leftBoundary = levelState->leftBoundary;
+	level->rightBoundary = levelState->rightBoundary;
+	level->topBoundary = levelState->topBoundary;
+	level->bottomBoundary = levelState->bottomBoundary;
+	level->leftBoundaryTarget = levelState->leftBoundaryTarget;
+	level->rightBoundaryTarget = levelState->rightBoundaryTarget;
+	level->topBoundaryTarget = levelState->topBoundaryTarget;
+	level->bottomBoundaryTarget = levelState->bottomBoundaryTarget;
+	level->dynamicEventRoutine = levelState->dynamicEventRoutine;
+	
+	level->frameCounter = levelState->frameCounter;
+	level->updateTime = levelState->updateTime;
+	level->updateStage = levelState->updateStage;
+	level->fading = levelState->fading;
+	level->isFadingIn = levelState->isFadingIn;
+	level->specialFade = levelState->specialFade;
+	
+	if (level->camera != nullptr)
+	{
+		level->camera->xPos = levelState->cameraX;
+		level->camera->yPos = levelState->cameraY;
+		level->camera->xPan = levelState->cameraXPan;
+		level->camera->yPan = levelState->cameraYPan;
+		level->camera->lookPan = levelState->cameraLookPan;
+		level->camera->lookTimer = levelState->cameraLookTimer;
+		level->camera->shake = levelState->cameraShake;
+	}
+	
+	if (level->titleCard != nullptr)
+	{
+		level->titleCard->activeLock = levelState->titleCardActiveLock;
+		level->titleCard->frame = levelState->titleCardFrame;
+		level->titleCard->focusX = levelState->titleCardFocusX;
+		level->titleCard->focusY = levelState->titleCardFocusY;
+		memcpy(level->titleCard->line, levelState->titleCardLine, sizeof(levelState->titleCardLine));
+	}
+	
+	RINGMANAGER *ringManager = level->ringManager;
+	ringManager->windowStart = levelState->ringWindowStart;
+	ringManager->windowEnd = levelState->ringWindowEnd;
+	memcpy(ringManager->bouncingRing, levelState->bouncingRing, sizeof(levelState->bouncingRing));
+	memcpy(ringManager->sparkle, levelState->ringSparkle, sizeof(levelState->ringSparkle));
+	for (size_t i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+		ringManager->bouncingRing[i].parentPlayer = HandlePlayer((uintptr_t)levelState->bouncingRing[i].parentPlayer);
+	
+	if (ringManager->collected != nullptr)
+		memcpy(ringManager->collected, Read(((ringManager->rings >> 5) + 1) * sizeof(uint32_t)), ((ringManager->rings >> 5) + 1) * sizeof(uint32_t));
+	
+	//Restore our palettes, textures cached since we were saved are left as they are
+	RestorePalette((level->tileTexture != nullptr) ? level->tileTexture->loadedPalette : nullptr);
+	RestorePalette((level->background != nullptr) ? level->background->texture->loadedPalette : nullptr);
+	
+	LL_NODE<TEXTURE*> *textureNode = level->objTextureCache.head;
+	for (uint32_t i = 2; i < header->palettes; i++)
+	{
+		RestorePalette((textureNode != nullptr) ? textureNode->node_entry->loadedPalette : nullptr);
+		if (textureNode != nullptr)
+			textureNode = textureNode->next;
+	}
+	
+	//Delete our current objects, with the object load list detached so their destructors don't each search it (it's restored after)
+	LINKEDLIST<OBJECT_LOAD*> objectLoadList;
+	SwapList(&objectLoadList, &level->objectLoadList);
+	CLEAR_INSTANCE_LINKEDLIST(level->objectList);
+	CLEAR_INSTANCE_LINKEDLIST(level->coreObjectList);
+	SwapList(&objectLoadList, &level->objectLoadList);
+	
+	//Re-create our objects, then turn their parent handles back into pointers
+	objects = 0;
+	GrowObjects(header->objects);
+	
+	for (uint32_t i = 0; i < header->topObjects; i++)
+		level->objectList.link_back(RestoreObject());
+	for (uint32_t i = 0; i < header->coreObjects; i++)
+		level->coreObjectList.link_back(RestoreObject());
+	
+	for (size_t i = 0; i < objects; i++)
+		object[i]->parent = HandleParent((uintptr_t)object[i]->parent);
+	
+	//Restore our players in place
+	for (size_t i = 0; i < players; i++)
+	{
+		const PLAYER *saved = (const PLAYER*)Read(sizeof(PLAYER));
+		memcpy((void*)player[i], (const void*)saved, sizeof(PLAYER));
+		player[i]->interact = HandleObject((uintptr_t)saved->interact);
+		player[i]->cpuInteract = HandleObject((uintptr_t)saved->cpuInteract);
+		player[i]->spindashDust = HandleObject((uintptr_t)saved->spindashDust);
+		player[i]->skidDust = HandleObject((uintptr_t)saved->skidDust);
+		player[i]->barrierObject = HandleObject((uintptr_t)saved->barrierObject);
+		for (int v = 0; v < INVINCIBILITYSTARS; v++)
+			player[i]->invincibilityStarObject[v] = HandleObject((uintptr_t)saved->invincibilityStarObject[v]);
+		player[i]->follow = HandlePlayer((uintptr_t)saved->follow);
+	}
+	
+	//Restore our object loads, reusing the current entries
+	LL_NODE<OBJECT_LOAD*> *loadNode = level->objectLoadList.head;
+	for (uint32_t i = 0; i < header->objectLoads; i++)
+	{
+		const OBJECT_LOAD *saved = (const OBJECT_LOAD*)Read(sizeof(OBJECT_LOAD));
+		if (loadNode == nullptr)
+			loadNode = level->objectLoadList.link_back(new OBJECT_LOAD);
+		
+		*loadNode->node_entry = *saved;
+		loadNode->node_entry->loaded = HandleObject((uintptr_t)saved->loaded);
+		loadNode = loadNode->next;
+	}
+	
+	while (loadNode != nullptr)
+	{
+		LL_NODE<OBJECT_LOAD*> *next = loadNode->next;
+		delete loadNode->node_entry;
+		level->objectLoadList.erase_node(loadNode);
+		loadNode = next;
+	}
+	
+	//Our players have moved, so re-sort them
+	level->playerIndex->Rebuild(&level->playerList);
+	return false;
+}
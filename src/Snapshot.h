@@ -0,0 +1,146 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Input.h"
+#include "Level.h"
+
+//Constants
+#define SNAPSHOT_SIGNATURE		0x43535354	//"CSST"
+#define SNAPSHOT_ALIGN			0x10		//Alignment of every record in the buffer, so records can be read in place
+#define SNAPSHOT_HANDLE_PLAYER	0x80000000	//Set in handles that refer to a player (by player list index) rather than an object
+
+//If the CUCKYSONIC_PRACTICE environment variable is set, a snapshot is saved once the level starts, and dying restores it instantly rather than restarting the level
+
+//Snapshot header
+struct SNAPSHOT_HEADER
+{
+	uint32_t signature;
+	uint32_t players;		//Players in the level
+	uint32_t objects;		//Objects (including children)
+	uint32_t topObjects;	//Objects in the object list (not including children)
+	uint32_t coreObjects;	//Objects in the core object list
+	uint32_t objectLoads;	//Object loads
+	uint32_t palettes;		//Palettes
+};
+
+//Engine state
+struct SNAPSHOT_ENGINE
+{
+	//Score, time, rings, lives, and random number seed
+	unsigned int score, nextScoreReward;
+	unsigned int time;
+	unsigned int rings, nextRingReward;
+	unsigned int lives;
+	uint32_t randomSeed;
+	
+	//Level specific state
+	LEVELSPECIFICSTATE levelSpecific;
+	
+	//Controller state (bindings and axes are left alone)
+	CONTROLMASK held[CONTROLLERS];
+	CONTROLMASK lastHeld[CONTROLLERS];
+	CONTROLMASK press[CONTROLLERS];
+	
+	//Replay position (if there's a replay), restoring a recording discards everything recorded since
+	bool replay;
+	size_t replayStreamSize, replayPosition;
+	uint8_t replayRunButtons[CONTROLLERS];
+	uint32_t replayRunLength, replayFrames;
+	bool replayFinished;
+};
+
+//Level state
+struct SNAPSHOT_LEVEL
+{
+	//Oscillatory values
+	bool oscillateDirection[OSCILLATORY_VALUES];
+	uint16_t oscillate[OSCILLATORY_VALUES][2];
+	
+	//Boundaries and dynamic events
+	uint16_t leftBoundary, rightBoundary, topBoundary, bottomBoundary;
+	uint16_t leftBoundaryTarget, rightBoundaryTarget, topBoundaryTarget, bottomBoundaryTarget;
+	int dynamicEventRoutine;
+	
+	//Other state
+	int frameCounter;
+	bool updateTime, updateStage;
+	bool fading, isFadingIn, specialFade;
+	
+	//Camera
+	int16_t cameraX, cameraY;
+	int16_t cameraXPan, cameraYPan;
+	int16_t cameraLookPan, cameraLookTimer;
+	uint16_t cameraShake;
+	
+	//Title card
+	bool titleCardActiveLock;
+	unsigned int titleCardFrame;
+	int titleCardFocusX, titleCardFocusY;
+	TITLECARD::LINEPOS titleCardLine[LINE_MAX];
+	
+	//Ring manager
+	size_t ringWindowStart, ringWindowEnd;
+	BOUNCINGRING bouncingRing[RINGMANAGER_BOUNCINGRINGS];
+	RINGSPARKLE ringSparkle[RINGMANAGER_SPARKLES];
+};
+
+//Object table entry, the table is sorted by address to find the handle of an object pointer
+struct SNAPSHOT_OBJECTENTRY
+{
+	OBJECT *object;
+	uint32_t handle;
+};
+
+//Full level state snapshot, saves everything the level and engine change while playing into a flat buffer, and restores it
+//Players are restored in place, objects are re-created, and pointers between them are stored as handles (object table indices and player list indices)
+//Textures, mappings, and object functions are stored as they are, so a snapshot can only be restored into the level it was saved from
+class SNAPSHOT
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Snapshot buffer, kept between saves so saving doesn't allocate once it's grown to fit
+		uint8_t *buffer = nullptr;
+		size_t size = 0, capacity = 0;
+		size_t readPosition = 0;
+		
+		//Level we were saved from, nullptr if not saved yet
+		LEVEL *level = nullptr;
+		
+		//Objects by handle (minus one) and players by list index, of the snapshot being saved or restored
+		OBJECT **object = nullptr;
+		SNAPSHOT_OBJECTENTRY *sorted = nullptr;
+		size_t objects = 0, objectCapacity = 0;
+		PLAYER **player = nullptr;
+		size_t players = 0, playerCapacity = 0;
+	
+	public:
+		~SNAPSHOT();
+		
+		bool Save();
+		bool Restore();
+	
+	private:
+		//Buffer functions
+		void *Write(const void *data, size_t dataSize);
+		const void *Read(size_t dataSize);
+		
+		//Handle functions
+		void GetPlayers();
+		void GrowObjects(size_t count);
+		void NumberObject(OBJECT *numberObject);
+		uintptr_t ObjectHandle(OBJECT *pointer);
+		uintptr_t PlayerHandle(PLAYER *pointer);
+		uintptr_t ParentHandle(void *pointer);
+		OBJECT *HandleObject(uintptr_t handle);
+		PLAYER *HandlePlayer(uintptr_t handle);
+		void *HandleParent(uintptr_t handle);
+		
+		//Record functions
+		void SavePalette(PALETTE *palette);
+		void RestorePalette(PALETTE *palette);
+		void SaveObject(OBJECT *saveObject);
+		OBJECT *RestoreObject();
+};
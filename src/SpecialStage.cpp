@@ -7,6 +7,7 @@
 #include "Error.h"
 #include "Audio.h"
 #include "Input.h"
+#include "Engine.h"
 #include "MathUtil.h"
 
 #define SPEEDUP_TIME (30 * 60)
@@ -126,7 +127,7 @@ void SPECIALSTAGE::MovePlayer()
 		if (player.bumperLock == false)
 		{
 			//Start moving if up is pressed
-			if (gController[0].held.up)
+			if (gEngine->controller[0].held.up)
 			{
 				player.advancing = true;
 				player.started = true;
@@ -153,9 +154,9 @@ void SPECIALSTAGE::MovePlayer()
 		//Check if we should turn
 		if (player.turnLock == false)
 		{
-			if (gController[0].held.left)
+			if (gEngine->controller[0].held.left)
 				player.turn =  4;
-			if (gController[0].held.right)
+			if (gEngine->controller[0].held.right)
 				player.turn = -4;
 		}
 		
@@ -252,21 +253,21 @@ static const int ssStageMap[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
 void SPECIALSTAGE::Draw()
 {
 	//Get origin position to draw from
-	const int xCenter = gRenderSpec.width / 2;
-	const int yCenter = gRenderSpec.height / 2;
+	const int xCenter = gEngine->renderSpec.width / 2;
+	const int yCenter = gEngine->renderSpec.height / 2;
 	
 	//Update stage frame
 	UpdateStageFrame();
 	
 	//Draw and update the background
 	UpdateBackgroundPosition();
-	for (int x = -(-backX % (unsigned)backgroundTexture->width); x < gRenderSpec.width; x += backgroundTexture->width)
-		for (int y = -(-backY % (unsigned)backgroundTexture->height); y < gRenderSpec.height; y += backgroundTexture->height)
-			gSoftwareBuffer->DrawTexture(backgroundTexture, backgroundTexture->loadedPalette, nullptr, SPECIALSTAGE_RENDERLAYER_BACKGROUND, x, y, false, false);
+	for (int x = -(-backX % (unsigned)backgroundTexture->width); x < gEngine->renderSpec.width; x += backgroundTexture->width)
+		for (int y = -(-backY % (unsigned)backgroundTexture->height); y < gEngine->renderSpec.height; y += backgroundTexture->height)
+			gEngine->softwareBuffer->DrawTexture(backgroundTexture, backgroundTexture->loadedPalette, nullptr, SPECIALSTAGE_RENDERLAYER_BACKGROUND, x, y, false, false);
 	
 	//Draw the stage (first 16 are just a palette cycle using the first frame, next 8 are just turning animation)
 	RotatePalette();
 	
 	RECT stageRect = {0, ssStageMap[animFrame] * 240, stageTexture->width, 240};
-	gSoftwareBuffer->DrawTexture(stageTexture, stageTexture->loadedPalette, &stageRect, SPECIALSTAGE_RENDERLAYER_STAGE, xCenter - stageTexture->width / 2, yCenter - 240 / 2, false, false);
+	gEngine->softwareBuffer->DrawTexture(stageTexture, stageTexture->loadedPalette, &stageRect, SPECIALSTAGE_RENDERLAYER_STAGE, xCenter - stageTexture->width / 2, yCenter - 240 / 2, false, false);
 }
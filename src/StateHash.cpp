@@ -0,0 +1,272 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "StateHash.h"
+#include "Engine.h"
+#include "Level.h"
+#include "Objects.h"
+#include "MathUtil.h"
+#include "Error.h"
+#include "Log.h"
+
+//Hashing (FNV-1a)
+#define STATEHASH_BASIS	0xCBF29CE484222325ULL
+#define STATEHASH_PRIME	0x100000001B3ULL
+
+static void Mix(uint64_t *hash, const void *data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		*hash ^= ((const uint8_t*)data)[i];
+		*hash *= STATEHASH_PRIME;
+	}
+}
+
+#define MIX(hash, value)	Mix(hash, &(value), sizeof(value))
+
+//Object fields, each is hashed over every object (and their children) in list order
+enum STATEHASH_OBJECTFIELD
+{
+	STATEHASH_OBJECT_FUNCTION,
+	STATEHASH_OBJECT_ROUTINE,
+	STATEHASH_OBJECT_POSITION,
+	STATEHASH_OBJECT_VELOCITY,
+	STATEHASH_OBJECT_ANIMATION,
+	STATEHASH_OBJECT_STATUS,
+	STATEHASH_OBJECT_SCRATCH,
+	STATEHASH_OBJECT_MAX,
+};
+
+static const char *objectFieldName[STATEHASH_OBJECT_MAX] = {
+	"objects.function",
+	"objects.routine",
+	"objects.position",
+	"objects.velocity",
+	"objects.animation",
+	"objects.status",
+	"objects.scratch",
+};
+
+static void HashObject(uint64_t *hash[STATEHASH_OBJECT_MAX], uint64_t *count, OBJECT *object)
+{
+	//Function pointers move between runs and builds, so hash the function's index instead
+	uint32_t function = GetObjectFunctionIndex(object->function);
+	MIX(hash[STATEHASH_OBJECT_FUNCTION], function);
+	
+	MIX(hash[STATEHASH_OBJECT_ROUTINE], object->routine);
+	MIX(hash[STATEHASH_OBJECT_ROUTINE], object->routineSecondary);
+	MIX(hash[STATEHASH_OBJECT_ROUTINE], object->subtype);
+	
+	MIX(hash[STATEHASH_OBJECT_POSITION], object->xLong);
+	MIX(hash[STATEHASH_OBJECT_POSITION], object->yLong);
+	
+	MIX(hash[STATEHASH_OBJECT_VELOCITY], object->xVel);
+	MIX(hash[STATEHASH_OBJECT_VELOCITY], object->yVel);
+	MIX(hash[STATEHASH_OBJECT_VELOCITY], object->inertia);
+	
+	MIX(hash[STATEHASH_OBJECT_ANIMATION], object->anim);
+	MIX(hash[STATEHASH_OBJECT_ANIMATION], object->prevAnim);
+	MIX(hash[STATEHASH_OBJECT_ANIMATION], object->animFrame);
+	MIX(hash[STATEHASH_OBJECT_ANIMATION], object->animFrameDuration);
+	MIX(hash[STATEHASH_OBJECT_ANIMATION], object->mappingFrame);
+	MIX(hash[STATEHASH_OBJECT_ANIMATION], object->angle);
+	
+	MIX(hash[STATEHASH_OBJECT_STATUS], object->status);
+	MIX(hash[STATEHASH_OBJECT_STATUS], object->renderFlags);
+	MIX(hash[STATEHASH_OBJECT_STATUS], object->collisionType);
+	MIX(hash[STATEHASH_OBJECT_STATUS], object->touchWidth);
+	MIX(hash[STATEHASH_OBJECT_STATUS], object->touchHeight);
+	MIX(hash[STATEHASH_OBJECT_STATUS], object->deleteFlag);
+	
+	if (object->scratch != nullptr)
+		Mix(hash[STATEHASH_OBJECT_SCRATCH], object->scratch, object->scratchSize);
+	
+	(*count)++;
+	for (LL_NODE<OBJECT*> *node = object->children.head; node != nullptr; node = node->next)
+		HashObject(hash, count, node->node_entry);
+}
+
+//Constructor and destructor
+STATEHASH::STATEHASH(std::string path)
+{
+	LOG(("Logging state hashes to %s...\n", path.c_str()));
+	
+	//Open our log
+	file = new FS_FILE(path, "wb");
+	if (file->fail != nullptr)
+		Error(fail = file->fail);
+}
+
+STATEHASH::~STATEHASH()
+{
+	delete file;
+}
+
+//Field functions
+STATEHASHFIELD *STATEHASH::AddField(const char *name, STATEHASHFIELD_TYPE type)
+{
+	//Fields past our limit fail the capture (but still need somewhere to go)
+	if (fields >= STATEHASH_FIELDS)
+	{
+		fail = "Too many state hash fields";
+		return &field[STATEHASH_FIELDS - 1];
+	}
+	
+	STATEHASHFIELD *thisField = &field[fields++];
+	strncpy(thisField->name, name, STATEHASH_NAME_LENGTH - 1);
+	thisField->name[STATEHASH_NAME_LENGTH - 1] = '\0';
+	thisField->type = type;
+	return thisField;
+}
+
+void STATEHASH::AddScalar(const char *name, int64_t value)
+{
+	AddField(name, STATEHASHFIELD_SCALAR)->value = (uint64_t)value;
+}
+
+uint64_t *STATEHASH::AddHash(const char *name)
+{
+	//Returns the hash so everything in the field can be mixed into it
+	STATEHASHFIELD *thisField = AddField(name, STATEHASHFIELD_HASH);
+	thisField->value = STATEHASH_BASIS;
+	return &thisField->value;
+}
+
+//Capture function, called at the end of every level frame
+bool STATEHASH::Capture(uint32_t frame)
+{
+	if (fail != nullptr)
+		return true;
+	
+	LEVEL *level = gEngine->level;
+	fields = 0;
+	
+	//Counters and random number generator
+	AddScalar("time", gEngine->time);
+	AddScalar("score", gEngine->score);
+	AddScalar("rings", gEngine->rings);
+	AddScalar("lives", gEngine->lives);
+	AddScalar("nextRingReward", gEngine->nextRingReward);
+	AddScalar("randomSeed", gEngine->randomSeed);
+	
+	//Players
+	for (size_t i = 0; i < level->playerList.size(); i++)
+	{
+		PLAYER *player = level->playerList[i];
+		char name[STATEHASH_NAME_LENGTH];
+		
+		#define PLAYER_NAME(suffix)	(snprintf(name, sizeof(name), "player%d." suffix, (int)i), name)
+		AddScalar(PLAYER_NAME("x"), player->x.pos);
+		AddScalar(PLAYER_NAME("xSub"), player->x.sub);
+		AddScalar(PLAYER_NAME("y"), player->y.pos);
+		AddScalar(PLAYER_NAME("ySub"), player->y.sub);
+		AddScalar(PLAYER_NAME("xVel"), player->xVel);
+		AddScalar(PLAYER_NAME("yVel"), player->yVel);
+		AddScalar(PLAYER_NAME("inertia"), player->inertia);
+		AddScalar(PLAYER_NAME("routine"), player->routine);
+		AddScalar(PLAYER_NAME("angle"), player->angle);
+		
+		uint64_t *status = AddHash(PLAYER_NAME("status"));
+		MIX(status, player->status);
+		MIX(status, player->item);
+		MIX(status, player->barrier);
+		MIX(status, player->moveLock);
+		MIX(status, player->jumpAbility);
+		MIX(status, player->abilityProperty);
+		MIX(status, player->spindashCounter);
+		MIX(status, player->super);
+		
+		uint64_t *timers = AddHash(PLAYER_NAME("timers"));
+		MIX(timers, player->invulnerabilityTime);
+		MIX(timers, player->invincibilityTime);
+		MIX(timers, player->speedShoesTime);
+		MIX(timers, player->superTimer);
+		MIX(timers, player->airRemaining);
+		MIX(timers, player->restartCountdown);
+		
+		uint64_t *animation = AddHash(PLAYER_NAME("animation"));
+		MIX(animation, player->anim);
+		MIX(animation, player->prevAnim);
+		MIX(animation, player->animFrame);
+		MIX(animation, player->animFrameDuration);
+		MIX(animation, player->mappingFrame);
+		#undef PLAYER_NAME
+	}
+	
+	//Objects
+	uint64_t *objectHash[STATEHASH_OBJECT_MAX];
+	for (int i = 0; i < STATEHASH_OBJECT_MAX; i++)
+		objectHash[i] = AddHash(objectFieldName[i]);
+	
+	uint64_t objects = 0;
+	for (LL_NODE<OBJECT*> *node = level->objectList.head; node != nullptr; node = node->next)
+		HashObject(objectHash, &objects, node->node_entry);
+	for (LL_NODE<OBJECT*> *node = level->coreObjectList.head; node != nullptr; node = node->next)
+		HashObject(objectHash, &objects, node->node_entry);
+	AddScalar("objects.count", objects);
+	
+	//Rings
+	RINGMANAGER *ringManager = level->ringManager;
+	uint64_t *collected = AddHash("rings.collected");
+	if (ringManager->collected != nullptr)
+		Mix(collected, ringManager->collected, ((ringManager->rings >> 5) + 1) * sizeof(uint32_t));
+	
+	uint64_t *bouncing = AddHash("rings.bouncing");
+	for (size_t i = 0; i < RINGMANAGER_BOUNCINGRINGS; i++)
+	{
+		BOUNCINGRING *ring = &ringManager->bouncingRing[i];
+		if (!ring->active)
+			continue;
+		MIX(bouncing, i);
+		MIX(bouncing, ring->xLong);
+		MIX(bouncing, ring->yLong);
+		MIX(bouncing, ring->xVel);
+		MIX(bouncing, ring->yVel);
+		MIX(bouncing, ring->animCount);
+	}
+	
+	//Oscillators, camera, and boundaries
+	uint64_t *oscillators = AddHash("oscillators");
+	MIX(oscillators, level->oscillateDirection);
+	MIX(oscillators, level->oscillate);
+	
+	AddScalar("camera.x", level->camera->xPos);
+	AddScalar("camera.y", level->camera->yPos);
+	
+	uint64_t *boundaries = AddHash("boundaries");
+	MIX(boundaries, level->leftBoundary);
+	MIX(boundaries, level->rightBoundary);
+	MIX(boundaries, level->topBoundary);
+	MIX(boundaries, level->bottomBoundary);
+	MIX(boundaries, level->bottomBoundaryTarget);
+	MIX(boundaries, level->dynamicEventRoutine);
+	
+	if (fail != nullptr)
+		return Error(fail);
+	
+	//Write our header on our first frame, every frame after must have the same fields
+	if (!wroteHeader)
+	{
+		file->WriteBE32(STATEHASH_SIGNATURE);
+		file->WriteBE32(STATEHASH_VERSION);
+		file->WriteBE32((uint32_t)fields);
+		for (size_t i = 0; i < fields; i++)
+		{
+			file->Write(field[i].name, 1, STATEHASH_NAME_LENGTH);
+			file->WriteU8(field[i].type);
+		}
+		
+		headerFields = fields;
+		wroteHeader = true;
+	}
+	else if (fields != headerFields)
+	{
+		return Error(fail = "State hash fields changed between frames");
+	}
+	
+	//Write this frame
+	file->WriteBE32(frame);
+	for (size_t i = 0; i < fields; i++)
+		file->WriteBE64(field[i].value);
+	return false;
+}
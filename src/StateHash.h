@@ -0,0 +1,56 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include "Filesystem.h"
+
+//Constants
+#define STATEHASH_SIGNATURE		0x43535348	//"CSSH"
+#define STATEHASH_VERSION		1
+#define STATEHASH_FIELDS		0x100	//Most fields a frame can have
+#define STATEHASH_NAME_LENGTH	0x20	//Length of each field's name (including the terminator)
+
+//If the CUCKYSONIC_STATEHASH environment variable is set, the state of every level frame is logged to the given file (see Tools/BisectState.cpp to compare two logs)
+
+//State hash field, scalars store their value (signed), hashes store an FNV-1a hash of everything in them (like every object's position)
+enum STATEHASHFIELD_TYPE
+{
+	STATEHASHFIELD_SCALAR,
+	STATEHASHFIELD_HASH,
+};
+
+struct STATEHASHFIELD
+{
+	char name[STATEHASH_NAME_LENGTH];
+	STATEHASHFIELD_TYPE type;
+	uint64_t value;
+};
+
+//Per-frame state hash, logs everything the simulation depends on as named fields after every level frame, so two runs can be compared frame by frame
+//Log format: signature, version, and field count (big endian 32-bit), each field's name and type (8-bit), then each frame's number (32-bit) followed by its field values (64-bit)
+class STATEHASH
+{
+	public:
+		//Failure
+		const char *fail = nullptr;
+		
+		//Log file
+		FS_FILE *file = nullptr;
+		bool wroteHeader = false;
+		
+		//Current frame's fields
+		STATEHASHFIELD field[STATEHASH_FIELDS];
+		size_t fields = 0, headerFields = 0;
+	
+	public:
+		STATEHASH(std::string path);
+		~STATEHASH();
+		
+		bool Capture(uint32_t frame);
+	
+	private:
+		STATEHASHFIELD *AddField(const char *name, STATEHASHFIELD_TYPE type);
+		void AddScalar(const char *name, int64_t value);
+		uint64_t *AddHash(const char *name);
+};
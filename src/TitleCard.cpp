@@ -14,21 +14,21 @@
 TITLECARD::TITLECARD(std::string levelName, std::string levelSubtitle) : name(levelName), subtitle(levelSubtitle)
 {
 	//Load title card sheet
-	texture = gLevel->GetObjectTexture("data/TitleCard.bmp");
+	texture = gEngine->level->GetObjectTexture("data/TitleCard.bmp");
 	
 	//Load font texture and font mappings
-	TEXTURE *fontTexture = gLevel->GetObjectTexture("data/GenericFont.bmp");
+	TEXTURE *fontTexture = gEngine->level->GetObjectTexture("data/GenericFont.bmp");
 	nameFont = new BITMAPFONT(fontTexture, 0, 0, 16, 16, 0, 0, 0x20, 0x20);
 	subtitleFont = new BITMAPFONT(fontTexture, 0, 83, 8, 11, 0, 0, 0x20, 0x20);
 	
 	//Get our focus position
-	focusX = gLevel->playerList[0]->x.pos - gLevel->camera->xPos;
-	focusY = gLevel->playerList[0]->y.pos - gLevel->camera->yPos;
+	focusX = gEngine->level->playerList[0]->x.pos - gEngine->level->camera->xPos;
+	focusY = gEngine->level->playerList[0]->y.pos - gEngine->level->camera->yPos;
 	
 	//Initialize lines
 	line[LINE_CUCKYSONIC_LABEL] = {(-64) * 0x100, (8) * 0x100, 0x400, 0x0, -0x20, 0x0, 0x90, 0x7FFF, -0x8000, 0x7FFF};
-	line[LINE_LEVEL_NAME] = {((int)levelName.length() * -16 + (gRenderSpec.width - 398) / 2) * 0x100, (128) * 0x100, 0x780 + ((int)levelName.length() * 0x10), 0x0, -0x22, 0x0, 0x180, 0x7FFF, -0x8000, 0x7FFF};
-	line[LINE_LEVEL_SUBTITLE] = {(gRenderSpec.width) * 0x100, line[LINE_LEVEL_NAME].y + (24) * 0x100, -0x500, 0x0, 0x20, 0x0, -0x8000, -0x100, -0x8000, 0x7FFF};
+	line[LINE_LEVEL_NAME] = {((int)levelName.length() * -16 + (gEngine->renderSpec.width - 398) / 2) * 0x100, (128) * 0x100, 0x780 + ((int)levelName.length() * 0x10), 0x0, -0x22, 0x0, 0x180, 0x7FFF, -0x8000, 0x7FFF};
+	line[LINE_LEVEL_SUBTITLE] = {(gEngine->renderSpec.width) * 0x100, line[LINE_LEVEL_NAME].y + (24) * 0x100, -0x500, 0x0, 0x20, 0x0, -0x8000, -0x100, -0x8000, 0x7FFF};
 }
 
 TITLECARD::~TITLECARD()
@@ -42,10 +42,10 @@ TITLECARD::~TITLECARD()
 void TITLECARD::DrawRibbon(const RECT *rect, int x, int y, int width)
 {
 	//Draw left, middle, and right
-	gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &rect[0], LEVEL_RENDERLAYER_TITLECARD, x, y, false, false); x += rect[0].w;
+	gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &rect[0], LEVEL_RENDERLAYER_TITLECARD, x, y, false, false); x += rect[0].w;
 	for (int i = 0; i < width; i++)
-		{ gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &rect[1], LEVEL_RENDERLAYER_TITLECARD, x, y, false, false); x += rect[1].w; }
-	gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &rect[2], LEVEL_RENDERLAYER_TITLECARD, x, y, false, false);
+		{ gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &rect[1], LEVEL_RENDERLAYER_TITLECARD, x, y, false, false); x += rect[1].w; }
+	gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &rect[2], LEVEL_RENDERLAYER_TITLECARD, x, y, false, false);
 }
 
 //General titlecard function
@@ -71,7 +71,7 @@ void TITLECARD::UpdateAndDraw()
 		{34, 34, 16, 24},
 	};
 	
-	gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &cuckyLabel, LEVEL_RENDERLAYER_TITLECARD, line[LINE_CUCKYSONIC_LABEL].x / 0x100 + 16, line[LINE_CUCKYSONIC_LABEL].y / 0x100 + 4, false, false);
+	gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &cuckyLabel, LEVEL_RENDERLAYER_TITLECARD, line[LINE_CUCKYSONIC_LABEL].x / 0x100 + 16, line[LINE_CUCKYSONIC_LABEL].y / 0x100 + 4, false, false);
 	DrawRibbon(cuckyRibbon, line[LINE_CUCKYSONIC_LABEL].x / 0x100, line[LINE_CUCKYSONIC_LABEL].y / 0x100, 96 / 16);
 	
 	//Draw level name
@@ -86,9 +86,9 @@ void TITLECARD::UpdateAndDraw()
 		{34, 17, 16, 16},
 	};
 	
-	nameFont->DrawString(name, LEVEL_RENDERLAYER_TITLECARD, line[LINE_LEVEL_NAME].x / 0x100 + 8, line[LINE_LEVEL_NAME].y / 0x100 - 8);
+	nameFont->DrawString(name.c_str(), LEVEL_RENDERLAYER_TITLECARD, line[LINE_LEVEL_NAME].x / 0x100 + 8, line[LINE_LEVEL_NAME].y / 0x100 - 8);
 	DrawRibbon(nameRibbon, line[LINE_LEVEL_NAME].x / 0x100, line[LINE_LEVEL_NAME].y / 0x100, mmax((int)name.length() - 1, 192 / 16));
-	gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, &stageDisplay[gLevel->zone], LEVEL_RENDERLAYER_TITLECARD, line[LINE_LEVEL_NAME].x / 0x100, line[LINE_LEVEL_NAME].y / 0x100 - 128 + 8, false, false);
+	gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, &stageDisplay[gEngine->level->zone], LEVEL_RENDERLAYER_TITLECARD, line[LINE_LEVEL_NAME].x / 0x100, line[LINE_LEVEL_NAME].y / 0x100 - 128 + 8, false, false);
 	
 	//Draw level subtitle
 	const RECT subtitleRibbon[3] = {
@@ -97,7 +97,7 @@ void TITLECARD::UpdateAndDraw()
 		{69, 51, 8, 8},
 	};
 	
-	subtitleFont->DrawString(subtitle, LEVEL_RENDERLAYER_TITLECARD, line[LINE_LEVEL_SUBTITLE].x / 0x100 + 4, line[LINE_LEVEL_SUBTITLE].y / 0x100 - 5);
+	subtitleFont->DrawString(subtitle.c_str(), LEVEL_RENDERLAYER_TITLECARD, line[LINE_LEVEL_SUBTITLE].x / 0x100 + 4, line[LINE_LEVEL_SUBTITLE].y / 0x100 - 5);
 	DrawRibbon(subtitleRibbon, line[LINE_LEVEL_SUBTITLE].x / 0x100, line[LINE_LEVEL_SUBTITLE].y / 0x100, subtitle.length() - 1);
 	
 	//Speed lines up when ending
@@ -133,9 +133,9 @@ void TITLECARD::UpdateAndDraw()
 		{51, 17, 16, 16}, //Body
 	};
 	
-	for (int x = -(backX % 16u); x < gRenderSpec.width; x += 16)
+	for (int x = -(backX % 16u); x < gEngine->renderSpec.width; x += 16)
 	{
-		for (int y = -(backY % 16u); y < gRenderSpec.height; y += 16)
+		for (int y = -(backY % 16u); y < gEngine->renderSpec.height; y += 16)
 		{
 			//Get how to draw the hole per tile
 			const RECT *rc = &backRc[4];
@@ -159,7 +159,7 @@ void TITLECARD::UpdateAndDraw()
 			}
 			
 			//Draw tile
-			gSoftwareBuffer->DrawTexture(texture, texture->loadedPalette, rc, LEVEL_RENDERLAYER_TITLECARD, x, y, false, false);
+			gEngine->softwareBuffer->DrawTexture(texture, texture->loadedPalette, rc, LEVEL_RENDERLAYER_TITLECARD, x, y, false, false);
 		}
 	}
 
@@ -0,0 +1,173 @@
+//State hash log comparer, finds the first frame where two runs' state diverged, and the fields that diverged
+//Usage: bisectstate <log a> <log b> [-frames <count>]
+//Logs are written by running with the CUCKYSONIC_STATEHASH environment variable, or with -statehash in headless mode
+//To check a change, play the same replay with the build before and after it, then compare their logs
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../StateHash.h"
+
+//State hash log
+struct STATELOG
+{
+	FILE *fp;
+	const char *path;
+	uint32_t fields;
+	STATEHASHFIELD *field;
+	uint32_t frame;
+};
+
+//File reading functions
+static uint32_t ReadBE32(FILE *fp)
+{
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++)
+		value = (value << 8) | (fgetc(fp) & 0xFF);
+	return value;
+}
+
+static uint64_t ReadBE64(FILE *fp)
+{
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++)
+		value = (value << 8) | (fgetc(fp) & 0xFF);
+	return value;
+}
+
+//Log functions
+static bool OpenLog(STATELOG *log, const char *path)
+{
+	//Open the log and check its header
+	log->path = path;
+	log->fp = fopen(path, "rb");
+	if (log->fp == nullptr)
+	{
+		printf("Failed to open %s\n", path);
+		return true;
+	}
+	
+	if (ReadBE32(log->fp) != STATEHASH_SIGNATURE || ReadBE32(log->fp) != STATEHASH_VERSION)
+	{
+		printf("%s isn't a version %d state hash log\n", path, STATEHASH_VERSION);
+		return true;
+	}
+	
+	log->fields = ReadBE32(log->fp);
+	if (log->fields == 0 || log->fields > STATEHASH_FIELDS)
+	{
+		printf("%s has an invalid field count\n", path);
+		return true;
+	}
+	
+	//Read our field names and types
+	log->field = new STATEHASHFIELD[log->fields];
+	for (uint32_t i = 0; i < log->fields; i++)
+	{
+		fread(log->field[i].name, 1, STATEHASH_NAME_LENGTH, log->fp);
+		log->field[i].name[STATEHASH_NAME_LENGTH - 1] = '\0';
+		log->field[i].type = (STATEHASHFIELD_TYPE)fgetc(log->fp);
+	}
+	return false;
+}
+
+static bool ReadFrame(STATELOG *log)
+{
+	//Read the next frame, returns true at the end of the log
+	log->frame = ReadBE32(log->fp);
+	for (uint32_t i = 0; i < log->fields; i++)
+		log->field[i].value = ReadBE64(log->fp);
+	return feof(log->fp) != 0;
+}
+
+static void PrintValue(const STATEHASHFIELD *field)
+{
+	if (field->type == STATEHASHFIELD_SCALAR)
+		printf("%lld", (long long)(int64_t)field->value);
+	else
+		printf("%016llX", (unsigned long long)field->value);
+}
+
+int main(int argc, char *argv[])
+{
+	//Get our arguments
+	if (argc < 3)
+	{
+		printf("Usage: bisectstate <log a> <log b> [-frames <count>]\n");
+		return 2;
+	}
+	
+	unsigned long maxFrames = 0;
+	for (int i = 3; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-frames") == 0 && i + 1 < argc)
+			maxFrames = strtoul(argv[++i], nullptr, 0);
+	}
+	
+	//Open both logs, they must have the same fields to be compared
+	STATELOG log[2] = {};
+	if (OpenLog(&log[0], argv[1]) || OpenLog(&log[1], argv[2]))
+		return 2;
+	
+	if (log[0].fields != log[1].fields)
+	{
+		printf("Logs have different fields (%u and %u), were they recorded with the same level and characters?\n", log[0].fields, log[1].fields);
+		return 2;
+	}
+	for (uint32_t i = 0; i < log[0].fields; i++)
+	{
+		if (strcmp(log[0].field[i].name, log[1].field[i].name) != 0 || log[0].field[i].type != log[1].field[i].type)
+		{
+			printf("Logs have different fields (%s and %s)\n", log[0].field[i].name, log[1].field[i].name);
+			return 2;
+		}
+	}
+	
+	//Compare frame by frame until the first divergence
+	unsigned long frames = 0;
+	uint32_t lastFrame = 0;
+	
+	while (maxFrames == 0 || frames < maxFrames)
+	{
+		bool endA = ReadFrame(&log[0]);
+		bool endB = ReadFrame(&log[1]);
+		if (endA || endB)
+		{
+			printf("No divergence in %lu frames", frames);
+			if (endA != endB)
+				printf(" (%s ends first)", endA ? log[0].path : log[1].path);
+			printf("\n");
+			return 0;
+		}
+		
+		bool diverged = log[0].frame != log[1].frame;
+		for (uint32_t i = 0; i < log[0].fields && !diverged; i++)
+			diverged = log[0].field[i].value != log[1].field[i].value;
+		
+		if (diverged)
+		{
+			//Report every field that diverged on this frame
+			printf("Diverged at frame %u (after %lu matching frames, last matching frame %u)\n", log[0].frame, frames, lastFrame);
+			if (log[0].frame != log[1].frame)
+				printf("  frame: %u / %u\n", log[0].frame, log[1].frame);
+			
+			for (uint32_t i = 0; i < log[0].fields; i++)
+			{
+				if (log[0].field[i].value == log[1].field[i].value)
+					continue;
+				printf("  %s: ", log[0].field[i].name);
+				PrintValue(&log[0].field[i]);
+				printf(" / ");
+				PrintValue(&log[1].field[i]);
+				printf("\n");
+			}
+			return 1;
+		}
+		
+		lastFrame = log[0].frame;
+		frames++;
+	}
+	
+	printf("No divergence in %lu frames\n", frames);
+	return 0;
+}
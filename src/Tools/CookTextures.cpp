@@ -0,0 +1,173 @@
+//Texture cooker, converts every .bmp in a folder into a cooked texture which the game loads instead
+//Usage: cooktextures <base path> [-spans]
+//Every .bmp under <base path>/data is loaded with the game's own loader and written next to itself as a .tex
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "../Render.h"
+#include "../Filesystem.h"
+
+//Options and totals
+bool writeSpans = false;
+size_t textures = 0, totalSpans = 0;
+
+//File writing functions
+static void WriteBE16(FILE *fp, uint16_t value)
+{
+	fputc(value >> 8, fp);
+	fputc(value & 0xFF, fp);
+}
+
+static void WriteBE32(FILE *fp, uint32_t value)
+{
+	for (int i = 4; i-- != 0;)
+		fputc((value >> (8 * i)) & 0xFF, fp);
+}
+
+//Cooking functions
+static bool CookTexture(std::string name)
+{
+	//Load our bitmap (not the cooked texture we're replacing)
+	std::string cookedName = name.substr(0, name.length() - 4) + TEXTURE_COOKED_EXTENSION;
+	
+	TEXTURE texture(name, false);
+	if (texture.fail != nullptr)
+	{
+		printf("Failed to load %s (%s)\n", name.c_str(), texture.fail);
+		return true;
+	}
+	
+	//Get our opaque spans
+	uint32_t *spanLine = new uint32_t[texture.height + 1];
+	TEXTURESPAN *span = new TEXTURESPAN[(size_t)texture.width * texture.height / 2 + texture.height];
+	uint32_t spans = 0;
+	
+	for (int y = 0; y < texture.height; y++)
+	{
+		const uint8_t *line = texture.texture + (size_t)y * texture.width;
+		spanLine[y] = spans;
+		
+		for (int x = 0; x < texture.width;)
+		{
+			if (line[x] == 0)
+			{
+				x++;
+				continue;
+			}
+			
+			span[spans].start = x;
+			while (x < texture.width && line[x] != 0)
+				x++;
+			span[spans].length = x - span[spans].start;
+			spans++;
+		}
+	}
+	spanLine[texture.height] = spans;
+	
+	//Write our cooked texture
+	FILE *fp = fopen((gBasePath + cookedName).c_str(), "wb");
+	if (fp == nullptr)
+	{
+		printf("Failed to open %s for writing\n", cookedName.c_str());
+		delete[] spanLine;
+		delete[] span;
+		return true;
+	}
+	
+	WriteBE32(fp, TEXTURE_COOKED_SIGNATURE);
+	WriteBE32(fp, TEXTURE_COOKED_VERSION);
+	WriteBE32(fp, texture.width);
+	WriteBE32(fp, texture.height);
+	WriteBE32(fp, texture.loadedPalette->colours);
+	WriteBE32(fp, writeSpans ? TEXTURE_COOKED_SPANS : 0);
+	WriteBE32(fp, writeSpans ? spans : 0);
+	WriteBE32(fp, 0); //RESERVED
+	
+	for (size_t i = 0; i < texture.loadedPalette->colours; i++)
+	{
+		//The native colour is regenerated by the game, so leave it (and the padding) blank
+		COLOUR colour = texture.loadedPalette->colour[i];
+		colour.colour = 0;
+		
+		uint8_t record[sizeof(COLOUR)] = {};
+		memcpy(record, &colour, offsetof(COLOUR, mb) + 1);
+		fwrite(record, sizeof(COLOUR), 1, fp);
+	}
+	
+	fwrite(texture.texture, 1, (size_t)texture.width * texture.height, fp);
+	
+	if (writeSpans)
+	{
+		for (int y = 0; y <= texture.height; y++)
+			WriteBE32(fp, spanLine[y]);
+		for (uint32_t i = 0; i < spans; i++)
+		{
+			WriteBE16(fp, span[i].start);
+			WriteBE16(fp, span[i].length);
+		}
+	}
+	
+	fclose(fp);
+	delete[] spanLine;
+	delete[] span;
+	
+	textures++;
+	totalSpans += spans;
+	return false;
+}
+
+static bool CookFolder(std::string name)
+{
+	//Cook every bitmap in the given folder and its sub-folders
+	DIR *dir = opendir((gBasePath + name).c_str());
+	if (dir == nullptr)
+	{
+		printf("Failed to open folder %s\n", name.c_str());
+		return true;
+	}
+	
+	for (dirent *dirEntry = readdir(dir); dirEntry != nullptr; dirEntry = readdir(dir))
+	{
+		if (strcmp(dirEntry->d_name, ".") == 0 || strcmp(dirEntry->d_name, "..") == 0)
+			continue;
+		
+		std::string entryName = name + "/" + dirEntry->d_name;
+		
+		struct stat entryStat;
+		if (stat((gBasePath + entryName).c_str(), &entryStat) != 0)
+			continue;
+		
+		bool isBitmap = (entryName.length() > 4 && entryName.compare(entryName.length() - 4, 4, ".bmp") == 0);
+		if ((S_ISDIR(entryStat.st_mode) && CookFolder(entryName)) || (S_ISREG(entryStat.st_mode) && isBitmap && CookTexture(entryName)))
+		{
+			closedir(dir);
+			return true;
+		}
+	}
+	
+	closedir(dir);
+	return false;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <base path> [-spans]\n", argv[0]);
+		return 1;
+	}
+	
+	writeSpans = (argc > 2 && strcmp(argv[2], "-spans") == 0);
+	
+	//Cook every bitmap in our data folder
+	gBasePath = std::string(argv[1]) + "/";
+	if (CookFolder("data"))
+		return 1;
+	
+	printf("Cooked %zu textures (%zu opaque spans)\n", textures, totalSpans);
+	return 0;
+}
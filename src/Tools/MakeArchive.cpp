@@ -0,0 +1,246 @@
+//Archive builder, packs every file in a folder into an archive which the game mounts from its base path
+//Usage: makearchive <base path> <output archive> [-lz4]
+//Every file under <base path>/data is added, with its path relative to the base path (e.g. data/Sonic/Sonic.bmp)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "../Archive.h"
+#include "../LZ4.h"
+
+//Constants
+#define LZ4_MIN_SAVING	0x10	//Entries are only stored compressed if it saves at least 1/16th of their size
+
+//Files to pack
+struct PACKFILE
+{
+	char *name;
+	uint64_t hash;
+	uint8_t *data;
+	size_t size;
+	size_t storedSize;
+	uint32_t flags;
+	uint64_t offset;
+	uint32_t nameOffset;
+};
+
+PACKFILE *file = nullptr;
+size_t files = 0, fileCapacity = 0;
+
+//File writing functions
+static void WriteBE32(FILE *fp, uint32_t value)
+{
+	for (int i = 4; i-- != 0;)
+		fputc((value >> (8 * i)) & 0xFF, fp);
+}
+
+static void WriteBE64(FILE *fp, uint64_t value)
+{
+	for (int i = 8; i-- != 0;)
+		fputc((value >> (8 * i)) & 0xFF, fp);
+}
+
+static void WritePadding(FILE *fp, uint64_t *position)
+{
+	for (; *position % ARCHIVE_ALIGNMENT; (*position)++)
+		fputc(0, fp);
+}
+
+//Packing functions
+static bool AddFile(std::string path, std::string name)
+{
+	//Read the given file
+	FILE *fp = fopen(path.c_str(), "rb");
+	if (fp == nullptr)
+	{
+		printf("Failed to open %s\n", path.c_str());
+		return true;
+	}
+	
+	fseek(fp, 0, SEEK_END);
+	size_t size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	
+	uint8_t *data = new uint8_t[size + 1];
+	if (fread(data, 1, size, fp) != size)
+	{
+		printf("Failed to read %s\n", path.c_str());
+		fclose(fp);
+		delete[] data;
+		return true;
+	}
+	fclose(fp);
+	
+	//Add to our file list
+	if (files >= fileCapacity)
+	{
+		fileCapacity = (fileCapacity == 0) ? 0x100 : (fileCapacity * 2);
+		PACKFILE *newFile = new PACKFILE[fileCapacity];
+		for (size_t i = 0; i < files; i++)
+			newFile[i] = file[i];
+		delete[] file;
+		file = newFile;
+	}
+	
+	PACKFILE *thisFile = &file[files++];
+	thisFile->name = new char[name.length() + 1];
+	strcpy(thisFile->name, name.c_str());
+	thisFile->hash = GetArchiveHash(thisFile->name);
+	thisFile->data = data;
+	thisFile->size = thisFile->storedSize = size;
+	thisFile->flags = 0;
+	return false;
+}
+
+static bool AddFolder(std::string path, std::string name)
+{
+	//Add every file in the given folder and its sub-folders
+	DIR *dir = opendir(path.c_str());
+	if (dir == nullptr)
+	{
+		printf("Failed to open folder %s\n", path.c_str());
+		return true;
+	}
+	
+	for (dirent *dirEntry = readdir(dir); dirEntry != nullptr; dirEntry = readdir(dir))
+	{
+		if (strcmp(dirEntry->d_name, ".") == 0 || strcmp(dirEntry->d_name, "..") == 0)
+			continue;
+		
+		std::string entryPath = path + "/" + dirEntry->d_name;
+		std::string entryName = name + "/" + dirEntry->d_name;
+		
+		struct stat entryStat;
+		if (stat(entryPath.c_str(), &entryStat) != 0)
+			continue;
+		
+		if ((S_ISDIR(entryStat.st_mode) ? AddFolder(entryPath, entryName) : AddFile(entryPath, entryName)))
+		{
+			closedir(dir);
+			return true;
+		}
+	}
+	
+	closedir(dir);
+	return false;
+}
+
+static int CompareFiles(const void *a, const void *b)
+{
+	uint64_t hashA = ((const PACKFILE*)a)->hash, hashB = ((const PACKFILE*)b)->hash;
+	return (hashA > hashB) - (hashA < hashB);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		printf("Usage: %s <base path> <output archive> [-lz4]\n", argv[0]);
+		return 1;
+	}
+	
+	bool compress = (argc > 3 && strcmp(argv[3], "-lz4") == 0);
+	
+	//Gather our files and sort them by hash
+	if (AddFolder(std::string(argv[1]) + "/data", "data"))
+		return 1;
+	
+	qsort(file, files, sizeof(PACKFILE), CompareFiles);
+	for (size_t i = 1; i < files; i++)
+	{
+		if (file[i].hash == file[i - 1].hash)
+		{
+			printf("Hash collision between %s and %s\n", file[i - 1].name, file[i].name);
+			return 1;
+		}
+	}
+	
+	//Compress our files
+	size_t totalSize = 0, totalStoredSize = 0;
+	
+	for (size_t i = 0; i < files; i++)
+	{
+		if (compress && file[i].size != 0)
+		{
+			uint8_t *compressed = new uint8_t[LZ4_COMPRESS_BOUND(file[i].size)];
+			size_t compressedSize = LZ4_Compress(file[i].data, file[i].size, compressed, LZ4_COMPRESS_BOUND(file[i].size));
+			
+			if (compressedSize != 0 && compressedSize < file[i].size - file[i].size / LZ4_MIN_SAVING)
+			{
+				delete[] file[i].data;
+				file[i].data = compressed;
+				file[i].storedSize = compressedSize;
+				file[i].flags |= ARCHIVEFLAG_LZ4;
+			}
+			else
+			{
+				delete[] compressed;
+			}
+		}
+		
+		totalSize += file[i].size;
+		totalStoredSize += file[i].storedSize;
+	}
+	
+	//Lay out our names and data
+	uint64_t position = ARCHIVE_HEADER_SIZE + files * ARCHIVE_ENTRY_SIZE;
+	uint32_t nameOffset = 0;
+	for (size_t i = 0; i < files; i++)
+	{
+		file[i].nameOffset = nameOffset;
+		nameOffset += strlen(file[i].name) + 1;
+	}
+	
+	position += nameOffset;
+	for (size_t i = 0; i < files; i++)
+	{
+		position = (position + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+		file[i].offset = position;
+		position += file[i].storedSize;
+	}
+	
+	//Write our archive
+	FILE *fp = fopen(argv[2], "wb");
+	if (fp == nullptr)
+	{
+		printf("Failed to open %s\n", argv[2]);
+		return 1;
+	}
+	
+	WriteBE32(fp, ARCHIVE_SIGNATURE);
+	WriteBE32(fp, ARCHIVE_VERSION);
+	WriteBE32(fp, files);
+	WriteBE32(fp, 0);
+	
+	for (size_t i = 0; i < files; i++)
+	{
+		WriteBE64(fp, file[i].hash);
+		WriteBE64(fp, file[i].offset);
+		WriteBE32(fp, file[i].size);
+		WriteBE32(fp, file[i].storedSize);
+		WriteBE32(fp, file[i].flags);
+		WriteBE32(fp, file[i].nameOffset);
+	}
+	
+	for (size_t i = 0; i < files; i++)
+		fwrite(file[i].name, 1, strlen(file[i].name) + 1, fp);
+	
+	position = ARCHIVE_HEADER_SIZE + files * ARCHIVE_ENTRY_SIZE + nameOffset;
+	for (size_t i = 0; i < files; i++)
+	{
+		WritePadding(fp, &position);
+		fwrite(file[i].data, 1, file[i].storedSize, fp);
+		position += file[i].storedSize;
+		delete[] file[i].data;
+		delete[] file[i].name;
+	}
+	
+	fclose(fp);
+	delete[] file;
+	
+	printf("Packed %d files, %d bytes stored as %d bytes\n", (int)files, (int)totalSize, (int)totalStoredSize);
+	return 0;
+}